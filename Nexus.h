@@ -15,7 +15,15 @@
 #include <stdint.h>
 #include <stdbool.h>
 #endif
+#ifdef _WIN32
 #include <windows.h>
+#else
+/* Host builds (tests, benchmarks) only need the declarations below */
+typedef void* LPVOID;
+#ifndef __stdcall
+#define __stdcall
+#endif
+#endif
 
 #define NEXUS_API_VERSION 6
 
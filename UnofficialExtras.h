@@ -7,7 +7,6 @@
 #define UNOFFICIAL_EXTRAS_H
 
 #include <cstdint>
-#include <ctime>
 
 namespace UnofficialExtras
 {
@@ -33,7 +32,7 @@ namespace UnofficialExtras
     struct UserInfo
     {
         const char* AccountName;
-        __time64_t JoinTime;
+        int64_t JoinTime;   // __time64_t on Windows
         UserRole Role;
         uint8_t Subgroup;
         bool ReadyStatus;
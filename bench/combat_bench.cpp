@@ -0,0 +1,227 @@
+///----------------------------------------------------------------------------------------------------
+/// Combat Bench - Replays WvW fight traces through the real handlers and reports per-event cost
+///
+/// Runs headless against the stub AddonAPI. Every event is timed individually; the report gives
+/// throughput and p50/p99/p99.9/max latency per event kind and overall.
+///
+/// Usage: streamlink_bench [--events N] [--squad N] [--enemies N] [--seed N] [--repeat N]
+///                         [--load trace.txt] [--save trace.txt] [--metrics 1] [--record 1]
+///
+/// --metrics 1 turns on the addon's own latency histograms and prints them after the run, so the
+/// cost of recording shows up in the per-event numbers. --record 1 does the same for the event
+/// recorder, writing to addons/streamlink/bench.slrec.
+///----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "event_queue.h"
+#include "event_recorder.h"
+#include "metrics.h"
+#include "output_writer.h"
+#include "streamlink.h"
+#include "stub_addon_api.h"
+#include "trace_replay.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        FightParams fight;
+        uint32_t    repeat = 3;
+        uint32_t    metrics = 0;
+        uint32_t    record = 0;
+        const char* loadPath = nullptr;
+        const char* savePath = nullptr;
+    };
+
+    struct Stats
+    {
+        std::vector<uint32_t> samples;   // nanoseconds per event
+        double                totalSeconds = 0;
+    };
+}
+
+static bool ParseArgs(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        auto number = [&]() { i++; return static_cast<uint32_t>(strtoul(value, nullptr, 10)); };
+
+        if (!value && strncmp(arg, "--", 2) == 0)
+        {
+            fprintf(stderr, "missing value for %s\n", arg);
+            return false;
+        }
+        if (strcmp(arg, "--events") == 0)       options.fight.events = number();
+        else if (strcmp(arg, "--squad") == 0)   options.fight.squadSize = number();
+        else if (strcmp(arg, "--enemies") == 0) options.fight.enemies = number();
+        else if (strcmp(arg, "--seed") == 0)    options.fight.seed = number();
+        else if (strcmp(arg, "--repeat") == 0)  options.repeat = number();
+        else if (strcmp(arg, "--metrics") == 0) options.metrics = number();
+        else if (strcmp(arg, "--record") == 0)  options.record = number();
+        else if (strcmp(arg, "--load") == 0)    { options.loadPath = value; i++; }
+        else if (strcmp(arg, "--save") == 0)    { options.savePath = value; i++; }
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", arg);
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t Percentile(std::vector<uint32_t>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static void PrintRow(const char* name, Stats& stats)
+{
+    if (stats.samples.empty())
+        return;
+
+    std::sort(stats.samples.begin(), stats.samples.end());
+    double eventsPerSec = stats.totalSeconds > 0 ? static_cast<double>(stats.samples.size()) / stats.totalSeconds : 0;
+    printf("%-14s %10zu %14.0f %8u %8u %8u %10u\n", name, stats.samples.size(), eventsPerSec,
+           Percentile(stats.samples, 0.50), Percentile(stats.samples, 0.99), Percentile(stats.samples, 0.999),
+           stats.samples.back());
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseArgs(argc, argv, options))
+        return 2;
+
+    Trace trace;
+    if (options.loadPath)
+    {
+        if (!LoadTrace(options.loadPath, trace))
+        {
+            fprintf(stderr, "could not load trace %s\n", options.loadPath);
+            return 1;
+        }
+    }
+    else
+    {
+        GenerateFight(options.fight, trace);
+    }
+    if (options.savePath && !SaveTrace(trace, options.savePath))
+        fprintf(stderr, "could not save trace to %s\n", options.savePath);
+
+    FakeMumbleLink mumble;
+    if (!mumble.Create("bench"))
+    {
+        fprintf(stderr, "could not create fake MumbleLink\n");
+        return 1;
+    }
+
+    AddonAPI* api = StubApi::Create("bench");
+    StubApi::SetRecordDebugLogs(false);
+    std::string settings = std::string("addons/streamlink/killstreak.txt\nmumble_link=") + mumble.Name() + "\n";
+    if (options.metrics)
+        settings += "metrics=1\n";
+    if (options.record)
+        settings += "record=1\nrecord_file=addons/streamlink/bench.slrec\n";
+    StubApi::WriteSettings(settings.c_str());
+    mumble.SetMap(MapTypeEternalBattlegrounds, MapIdEternalBattlegrounds);
+    Streamlink::Load(api);
+
+    TraceReplayer replayer;
+    if (!replayer.Bind(&mumble))
+    {
+        fprintf(stderr, "addon did not subscribe to all events\n");
+        return 1;
+    }
+
+    Stats perKind[static_cast<size_t>(TraceKind::Count)];
+    Stats overall;
+    double drainSeconds = 0;
+    uint64_t processedBefore = EventQueue::Processed();
+    for (uint32_t pass = 0; pass <= options.repeat; pass++)
+    {
+        bool warmup = pass == 0;
+        for (const TraceEvent& event : trace.events)
+        {
+            replayer.Prepare(trace, event);
+
+            Clock::time_point start = Clock::now();
+            replayer.Dispatch();
+            Clock::time_point end = Clock::now();
+
+            if (warmup || event.kind == TraceKind::MapChange)
+                continue;
+
+            uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            uint32_t sample = static_cast<uint32_t>(std::min<uint64_t>(ns, UINT32_MAX));
+            double seconds = static_cast<double>(ns) * 1e-9;
+
+            Stats& kind = perKind[static_cast<size_t>(event.kind)];
+            kind.samples.push_back(sample);
+            kind.totalSeconds += seconds;
+            overall.samples.push_back(sample);
+            overall.totalSeconds += seconds;
+        }
+
+        // Callbacks only enqueue; time how far the worker trails the last one
+        Clock::time_point drainStart = Clock::now();
+        EventQueue::WaitProcessed();
+        if (!warmup)
+            drainSeconds += std::chrono::duration<double>(Clock::now() - drainStart).count();
+    }
+    uint64_t processed = EventQueue::Processed() - processedBefore;
+    uint64_t dropped = EventQueue::Dropped();
+    uint64_t droppedCritical = EventQueue::DroppedCritical();
+    uint64_t recordDropped = EventRecorder::Dropped();
+
+    Streamlink::Unload();
+    uint64_t recordBytes = EventRecorder::BytesWritten();
+    StubApi::Destroy();
+
+    // Clock overhead, so small numbers can be read in context
+    Stats clock;
+    for (int i = 0; i < 100000; i++)
+    {
+        Clock::time_point a = Clock::now();
+        Clock::time_point b = Clock::now();
+        clock.samples.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count()));
+    }
+
+    printf("trace: %zu events (%zu local, %zu squad, %zu squad updates / %zu users), %u timed passes\n",
+           trace.events.size(), trace.CountOf(TraceKind::Local), trace.CountOf(TraceKind::Squad),
+           trace.CountOf(TraceKind::SquadUpdate), trace.users.size(), options.repeat);
+    printf("%-14s %10s %14s %8s %8s %8s %10s\n", "kind", "events", "events/sec", "p50 ns", "p99 ns", "p999 ns",
+           "max ns");
+    for (size_t k = 0; k < static_cast<size_t>(TraceKind::Count); k++)
+        PrintRow(TraceKindName(static_cast<TraceKind>(k)), perKind[k]);
+    PrintRow("all", overall);
+    std::sort(clock.samples.begin(), clock.samples.end());
+    printf("worker: %llu records processed, %llu dropped (%llu critical), %.2f ms behind the last event per pass\n",
+           (unsigned long long)processed, (unsigned long long)dropped, (unsigned long long)droppedCritical,
+           options.repeat ? drainSeconds * 1e3 / options.repeat : 0.0);
+    if (options.record)
+    {
+        printf("recorder: %llu bytes written, %llu dropped\n", (unsigned long long)recordBytes,
+               (unsigned long long)recordDropped);
+    }
+    printf("(clock overhead p50 %u ns)\n", Percentile(clock.samples, 0.50));
+    if (options.metrics)
+    {
+        static char report[OutputWriter::MaxRenderSize];
+        size_t length = Metrics::RenderText(report, sizeof(report));
+        printf("\naddon metrics (warm-up pass included):\n%.*s", static_cast<int>(length), report);
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+///----------------------------------------------------------------------------------------------------
+/// Counter Bench - Per-event cost of evaluating counter= filters over a synthetic WvW fight
+///
+/// Compiles a set of typical counter expressions (kills per profession, downs, crits, blocks, ...)
+/// and runs CombatCounters::Match over every combat record of a generated fight, the way the event
+/// queue worker does for each accepted record. Records are timed in blocks, since a single Match is
+/// shorter than a clock read; the report gives the mean cost per event for 1, 5, 10 and the requested
+/// number of counters.
+///
+/// Usage: streamlink_counter_bench [--events N] [--counters N] [--seed N] [--repeat N]
+///----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "combat_counters.h"
+#include "combat_record.h"
+#include "trace_replay.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        FightParams fight;
+        uint32_t    counters = 20;
+        uint32_t    repeat = 5;
+    };
+
+    const char* const Expressions[] = {
+        "result==KILLINGBLOW && src.self && dst.profession==GUARDIAN",
+        "result==KILLINGBLOW && src.self && dst.profession==WARRIOR",
+        "result==KILLINGBLOW && src.self && dst.profession==ENGINEER",
+        "result==KILLINGBLOW && src.self && dst.profession==RANGER",
+        "result==KILLINGBLOW && src.self && dst.profession==THIEF",
+        "result==KILLINGBLOW && src.self && dst.profession==ELEMENTALIST",
+        "result==KILLINGBLOW && src.self && dst.profession==MESMER",
+        "result==KILLINGBLOW && src.self && dst.profession==NECROMANCER",
+        "result==KILLINGBLOW && src.self && dst.profession==REVENANT",
+        "result==DOWNED && src.self && dst.profession in 1..9",
+        "statechange==CHANGEDOWN && src.self",
+        "statechange==CHANGEDEAD && src.self",
+        "result==CRIT && src.self",
+        "result==BLOCK && dst.self",
+        "result==EVADE && dst.self",
+        "statechange==NONE && src.self && value>5000",
+        "iff==FOE && (result==INTERRUPT || result==CROWDCONTROL)",
+        "skill in 9000..9999 && src.self",
+        "result==KILLINGBLOW && dst.self && !src.self",
+        "statechange==NONE && !src.self && dst.self && value in 1000..100000",
+    };
+
+    constexpr size_t ExpressionCount = sizeof(Expressions) / sizeof(Expressions[0]);
+    constexpr size_t BlockSize = 1024;
+}
+
+static bool ParseArgs(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value)
+        {
+            fprintf(stderr, "missing value for %s\n", arg);
+            return false;
+        }
+        uint32_t number = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        i++;
+
+        if (strcmp(arg, "--events") == 0)        options.fight.events = number;
+        else if (strcmp(arg, "--counters") == 0) options.counters = std::min<uint32_t>(number, CombatCounters::MaxCounters);
+        else if (strcmp(arg, "--seed") == 0)     options.fight.seed = number;
+        else if (strcmp(arg, "--repeat") == 0)   options.repeat = std::max<uint32_t>(number, 1);
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", arg);
+            return false;
+        }
+    }
+    return true;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// BuildRecords - The CombatRecords the callbacks would queue for the trace's combat events
+///----------------------------------------------------------------------------------------------------
+static void BuildRecords(const Trace& trace, std::vector<CombatRecord>& out)
+{
+    for (const TraceEvent& event : trace.events)
+    {
+        if (event.kind != TraceKind::Local && event.kind != TraceKind::Squad)
+            continue;
+
+        SyntheticCombatEvent combat;
+        combat.SetAgents(event.src, event.dst);
+        combat.ev.Time = event.time;
+        combat.ev.Result = event.result;
+        combat.ev.IsStatechange = event.statechange;
+        combat.ev.SkillID = event.skill;
+        combat.ev.Value = event.value;
+        combat.ev.IFF = event.iff;
+        combat.data.ev = &combat.ev;
+        out.push_back(MakeCombatRecord(combat.data, event.kind == TraceKind::Local ? CombatSource_Local
+                                                                                    : CombatSource_Squad));
+    }
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Measure - Mean and best-block ns per event of Match with the given counters
+///----------------------------------------------------------------------------------------------------
+static void Measure(const CombatCounters& counters, const std::vector<CombatRecord>& records, uint32_t repeat)
+{
+    uint64_t matches = 0;
+    double totalNs = 0;
+    double bestBlockNs = 1e9;
+    size_t timed = 0;
+    for (uint32_t pass = 0; pass <= repeat; pass++)
+    {
+        for (size_t begin = 0; begin < records.size(); begin += BlockSize)
+        {
+            size_t end = std::min(begin + BlockSize, records.size());
+            Clock::time_point start = Clock::now();
+            for (size_t i = begin; i < end; i++)
+                matches += static_cast<uint64_t>(__builtin_popcount(counters.Match(records[i])));
+            double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+            // The first pass warms the caches and is not counted
+            if (pass == 0)
+                continue;
+            totalNs += ns;
+            timed += end - begin;
+            bestBlockNs = std::min(bestBlockNs, ns / static_cast<double>(end - begin));
+        }
+    }
+
+    double meanNs = timed ? totalNs / static_cast<double>(timed) : 0;
+    printf("%8zu %12.1f %12.1f %14.2f %12llu\n", counters.Count(), meanNs, bestBlockNs,
+           counters.Count() ? meanNs / static_cast<double>(counters.Count()) : 0.0,
+           (unsigned long long)(matches / (repeat + 1)));
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseArgs(argc, argv, options))
+        return 2;
+
+    Trace trace;
+    GenerateFight(options.fight, trace);
+    std::vector<CombatRecord> records;
+    BuildRecords(trace, records);
+
+    printf("trace: %zu combat records, %u timed passes\n", records.size(), options.repeat);
+    printf("%8s %12s %12s %14s %12s\n", "counters", "ns/event", "best ns", "ns/counter", "matches");
+
+    uint32_t sizes[] = {1, 5, 10, options.counters};
+    for (uint32_t size : sizes)
+    {
+        if (size > options.counters)
+            continue;
+
+        CombatCounters counters;
+        for (uint32_t i = 0; i < size; i++)
+        {
+            std::string definition = "c" + std::to_string(i) + " | " + Expressions[i % ExpressionCount];
+            if (!counters.Add(definition))
+            {
+                fprintf(stderr, "could not compile %s\n", definition.c_str());
+                return 1;
+            }
+        }
+        Measure(counters, records, options.repeat);
+        if (size == options.counters)
+            break;
+    }
+    return 0;
+}
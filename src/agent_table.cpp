@@ -0,0 +1,118 @@
+///----------------------------------------------------------------------------------------------------
+/// Agent Table - Fixed-capacity table of tracked agents and their alive state, keyed by AgentShort::ID
+///----------------------------------------------------------------------------------------------------
+
+#include "agent_table.h"
+
+#include "open_addressing.h"
+
+static_assert(static_cast<size_t>(PlayerStatus::Dead) == 2, "one count per PlayerStatus");
+
+static constexpr size_t NotFound = AgentTable::TableSize;
+
+AgentTable::AgentTable()
+{
+    Clear();
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Home - Preferred slot of an agent id. Ids are often small and close together, so they are spread
+///        with a Fibonacci multiply and the top bits are used.
+///----------------------------------------------------------------------------------------------------
+size_t AgentTable::Home(uint64_t id)
+{
+    constexpr unsigned Shift = 64 - 8;
+    static_assert((size_t(1) << (64 - Shift)) == TableSize, "shift must match the table size");
+    return static_cast<size_t>((id * 0x9E3779B97F4A7C15ull) >> Shift);
+}
+
+bool AgentTable::IsUsed(const Slot& slot)
+{
+    return slot.used;
+}
+
+size_t AgentTable::FindSlot(uint64_t id) const
+{
+    return OpenAddressing::Find(m_slots, Home(id), IsUsed, [id](const Slot& slot) { return slot.entry.Id == id; });
+}
+
+void AgentTable::RemoveAt(size_t slot)
+{
+    m_counts[static_cast<size_t>(m_slots[slot].entry.Status)]--;
+    m_size--;
+    OpenAddressing::Erase(m_slots, slot, IsUsed,
+                          [](const Slot& moved) { return Home(moved.entry.Id); },
+                          [](Slot& emptied) { emptied.used = false; });
+}
+
+bool AgentTable::Set(uint64_t id, PlayerStatus status, uint32_t profession, uint16_t team)
+{
+    size_t found = FindSlot(id);
+    if (found != NotFound)
+    {
+        AgentEntry& entry = m_slots[found].entry;
+        if (entry.Status == status && entry.Profession == profession && entry.Team == team)
+            return false;
+
+        m_counts[static_cast<size_t>(entry.Status)]--;
+        m_counts[static_cast<size_t>(status)]++;
+        entry.Status = status;
+        entry.Profession = profession;
+        entry.Team = team;
+        return true;
+    }
+
+    if (m_size >= MaxAgents)
+        return false;
+
+    Slot& slot = m_slots[OpenAddressing::FreeSlot(m_slots, Home(id), IsUsed)];
+    slot.entry.Id = id;
+    slot.entry.Status = status;
+    slot.entry.Profession = profession;
+    slot.entry.Team = team;
+    slot.used = true;
+    m_counts[static_cast<size_t>(status)]++;
+    m_size++;
+    return true;
+}
+
+bool AgentTable::SetStatus(uint64_t id, PlayerStatus status)
+{
+    size_t found = FindSlot(id);
+    if (found == NotFound)
+        return false;
+
+    AgentEntry& entry = m_slots[found].entry;
+    if (entry.Status == status)
+        return false;
+
+    m_counts[static_cast<size_t>(entry.Status)]--;
+    m_counts[static_cast<size_t>(status)]++;
+    entry.Status = status;
+    return true;
+}
+
+bool AgentTable::Remove(uint64_t id)
+{
+    size_t found = FindSlot(id);
+    if (found == NotFound)
+        return false;
+
+    RemoveAt(found);
+    return true;
+}
+
+const AgentEntry* AgentTable::Find(uint64_t id) const
+{
+    size_t found = FindSlot(id);
+    return found != NotFound ? &m_slots[found].entry : nullptr;
+}
+
+void AgentTable::Clear()
+{
+    for (size_t i = 0; i < TableSize; i++)
+        m_slots[i].used = false;
+    for (uint32_t& count : m_counts)
+        count = 0;
+    m_size = 0;
+}
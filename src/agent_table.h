@@ -0,0 +1,74 @@
+///----------------------------------------------------------------------------------------------------
+/// Agent Table - Fixed-capacity table of tracked agents and their alive state, keyed by AgentShort::ID
+///
+/// An open-addressing table with linear probing and backward-shift deletion, indexed by a
+/// multiplicative hash of the agent id. Each entry keeps the alive/downed/dead state, profession and
+/// team from the agent's last event, and the per-state counts are adjusted on every insert, update and
+/// removal, so reading them never walks the table. Nothing is allocated after construction.
+/// Not thread-safe; the owner serialises access.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_AGENT_TABLE_H
+#define STREAMLINK_AGENT_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "combat_tracker.h"
+
+struct AgentEntry
+{
+    uint64_t     Id = 0;
+    uint32_t     Profession = 0;
+    uint16_t     Team = 0;
+    PlayerStatus Status = PlayerStatus::Alive;
+};
+
+class AgentTable
+{
+public:
+    static constexpr size_t MaxAgents = 128;          // squads cap at 50, plus party and despawn churn
+    static constexpr size_t TableSize = MaxAgents * 2;
+
+    AgentTable();
+
+    /// Inserts the agent or updates its entry. Returns false if nothing changed, or if the agent is
+    /// new and the table is full.
+    bool Set(uint64_t id, PlayerStatus status, uint32_t profession, uint16_t team);
+
+    /// Updates only the state of an agent already in the table. Returns false if it is not there or
+    /// the state is unchanged.
+    bool SetStatus(uint64_t id, PlayerStatus status);
+
+    /// Evicts the agent. Returns false if it was not in the table.
+    bool Remove(uint64_t id);
+
+    /// Entry for the agent, or nullptr.
+    const AgentEntry* Find(uint64_t id) const;
+
+    /// Agents currently in the given state.
+    uint32_t Count(PlayerStatus status) const { return m_counts[static_cast<size_t>(status)]; }
+
+    size_t Size() const { return m_size; }
+
+    void Clear();
+
+private:
+    struct Slot
+    {
+        AgentEntry entry;
+        bool       used;
+    };
+
+    static size_t Home(uint64_t id);
+    static bool   IsUsed(const Slot& slot);
+
+    size_t FindSlot(uint64_t id) const;
+    void   RemoveAt(size_t slot);
+
+    Slot     m_slots[TableSize];
+    uint32_t m_counts[3];
+    size_t   m_size;
+};
+
+#endif
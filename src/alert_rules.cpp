@@ -0,0 +1,344 @@
+///----------------------------------------------------------------------------------------------------
+/// Alert Rules - Settings-defined reactions to streaks, kill counts and squad size
+///----------------------------------------------------------------------------------------------------
+
+#include "alert_rules.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "helpers.h"
+
+namespace
+{
+    struct TriggerDef
+    {
+        const char*   name;
+        EAlertTrigger trigger;
+        size_t        minValues;
+        size_t        maxValues;
+        uint32_t      maxValue;
+        const char*   defaultMessage;
+    };
+
+    const TriggerDef TriggerDefs[] = {
+        {"streak",      AlertTrigger_Streak,     1, AlertRule::MaxValues, AlertRules::MaxThreshold, "Killstreak: {n}!"},
+        {"kills_every", AlertTrigger_KillsEvery, 1, 1,                    1000000,                  "{n} kills!"},
+        {"best_streak", AlertTrigger_BestStreak, 0, 0,                    0,                        "New best streak: {n}!"},
+        {"squad_size",  AlertTrigger_SquadSize,  1, AlertRule::MaxValues, AlertRules::MaxThreshold, "Squad size: {n}"},
+    };
+
+    static_assert(sizeof(TriggerDefs) / sizeof(TriggerDefs[0]) == AlertTrigger_Count, "one row per trigger");
+}
+
+///----------------------------------------------------------------------------------------------------
+/// SplitWord - First space-separated word of text; the trimmed remainder goes to rest
+///----------------------------------------------------------------------------------------------------
+static std::string SplitWord(const std::string& text, std::string& rest)
+{
+    size_t space = text.find_first_of(" \t");
+    if (space == std::string::npos)
+    {
+        rest.clear();
+        return text;
+    }
+    rest = Trim(text.substr(space));
+    return text.substr(0, space);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// ParseValues - "5,10, 25" into the rule's sorted, de-duplicated values
+///----------------------------------------------------------------------------------------------------
+static bool ParseValues(const std::string& text, const TriggerDef& def, AlertRule& rule)
+{
+    size_t count = 0;
+    const char* p = text.c_str();
+    while (*p)
+    {
+        while (*p == ' ' || *p == ',')
+            p++;
+        if (!*p)
+            break;
+
+        char* end = nullptr;
+        unsigned long value = strtoul(p, &end, 10);
+        if (end == p || value == 0 || value > def.maxValue || count == def.maxValues)
+            return false;
+        rule.Values[count++] = static_cast<uint32_t>(value);
+        p = end;
+        if (*p && *p != ',' && *p != ' ')
+            return false;
+    }
+    if (count < def.minValues)
+        return false;
+
+    std::sort(rule.Values, rule.Values + count);
+    rule.ValueCount = static_cast<uint8_t>(std::unique(rule.Values, rule.Values + count) - rule.Values);
+    return true;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// ParseAction - "alert [text]", "file <path> [text]" or "event <name>"
+///----------------------------------------------------------------------------------------------------
+static bool ParseAction(const std::string& segment, const TriggerDef& def, AlertRule& rule)
+{
+    std::string rest;
+    std::string action = SplitWord(segment, rest);
+    if (action == "alert")
+    {
+        rule.Actions |= AlertAction_Alert;
+        rule.AlertMessage = rest.empty() ? def.defaultMessage : rest;
+        return true;
+    }
+    if (action == "file")
+    {
+        std::string text;
+        rule.FilePath = SplitWord(rest, text);
+        rule.FileMessage = text.empty() ? "{n}" : text;
+        rule.Actions |= AlertAction_File;
+        return !rule.FilePath.empty();
+    }
+    if (action == "event")
+    {
+        rule.Actions |= AlertAction_Event;
+        rule.EventName = rest;
+        return !rest.empty() && rest.find_first_of(" \t") == std::string::npos;
+    }
+    return false;
+}
+
+void AlertRuleState::Begin(uint32_t streak, uint32_t best)
+{
+    Compiled = nullptr;
+    NextEvery = 0;
+    LastStreak = streak;
+    LastBest = best;
+
+    // A streak that is the session best already broke the previous one (or there was none)
+    Baseline = streak < best ? best : 0;
+}
+
+bool AlertRules::Add(const std::string& definition)
+{
+    if (m_count >= MaxRules)
+        return false;
+
+    AlertRule rule;
+    rule.Source = definition;
+    const TriggerDef* def = nullptr;
+    size_t pos = 0;
+    while (pos <= definition.size())
+    {
+        size_t end = definition.find('|', pos);
+        if (end == std::string::npos)
+            end = definition.size();
+        std::string segment = Trim(definition.substr(pos, end - pos));
+        pos = end + 1;
+
+        if (def)
+        {
+            if (!ParseAction(segment, *def, rule))
+                return false;
+            continue;
+        }
+
+        // The first segment is the trigger and its values
+        std::string values;
+        std::string name = SplitWord(segment, values);
+        for (const TriggerDef& candidate : TriggerDefs)
+        {
+            if (name == candidate.name)
+                def = &candidate;
+        }
+        if (!def || !ParseValues(values, *def, rule))
+            return false;
+        rule.Trigger = def->trigger;
+    }
+    if (rule.Actions == 0)
+        return false;
+
+    m_rules[m_count++] = rule;
+    return true;
+}
+
+void AlertRules::Compile(const uint32_t* milestones, size_t milestoneCount)
+{
+    // Built-in rule: alert on the milestones= streaks
+    AlertRule& builtIn = m_rules[0];
+    builtIn = AlertRule();
+    builtIn.Trigger = AlertTrigger_Streak;
+    builtIn.AlertMessage = TriggerDefs[AlertTrigger_Streak].defaultMessage;
+    for (size_t i = 0; i < milestoneCount && builtIn.ValueCount < AlertRule::MaxValues; i++)
+    {
+        if (milestones[i] != 0 && milestones[i] <= MaxThreshold)
+            builtIn.Values[builtIn.ValueCount++] = milestones[i];
+    }
+    builtIn.Actions = builtIn.ValueCount != 0 ? AlertAction_Alert : 0;
+
+    memset(m_streakRules, 0, sizeof(m_streakRules));
+    memset(m_squadRank, 0, sizeof(m_squadRank));
+    m_squadThresholdCount = 0;
+    m_everyRules = 0;
+    m_bestRules = 0;
+    for (std::string& path : m_filePaths)
+        path.clear();
+
+    size_t fileCount = 0;
+    for (size_t i = 0; i < m_count; i++)
+    {
+        AlertRule& rule = m_rules[i];
+        if (rule.Actions & AlertAction_File)
+        {
+            // Rules writing the same file share its slot
+            size_t slot = 0;
+            while (slot < fileCount && m_filePaths[slot] != rule.FilePath)
+                slot++;
+            if (slot == fileCount && fileCount < MaxFiles)
+                m_filePaths[fileCount++] = rule.FilePath;
+            if (slot < fileCount)
+                rule.FileSlot = static_cast<uint8_t>(slot);
+            else
+                rule.Actions &= ~AlertAction_File;
+        }
+        if (rule.Actions == 0)
+            continue;
+
+        uint32_t bit = uint32_t(1) << i;
+        switch (rule.Trigger)
+        {
+            case AlertTrigger_Streak:
+                for (size_t v = 0; v < rule.ValueCount; v++)
+                    m_streakRules[rule.Values[v]] |= bit;
+                break;
+            case AlertTrigger_KillsEvery:
+                m_everyRules |= bit;
+                break;
+            case AlertTrigger_BestStreak:
+                m_bestRules |= bit;
+                break;
+            case AlertTrigger_SquadSize:
+                for (size_t v = 0; v < rule.ValueCount; v++)
+                    m_squadThresholds[m_squadThresholdCount++] = {rule.Values[v], bit};
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Squad thresholds: sorted, one entry per value, then rank[size] = entries at or below size
+    std::sort(m_squadThresholds, m_squadThresholds + m_squadThresholdCount,
+              [](const SquadThreshold& a, const SquadThreshold& b) { return a.value < b.value; });
+    size_t merged = 0;
+    for (size_t i = 0; i < m_squadThresholdCount; i++)
+    {
+        if (merged != 0 && m_squadThresholds[merged - 1].value == m_squadThresholds[i].value)
+            m_squadThresholds[merged - 1].rules |= m_squadThresholds[i].rules;
+        else
+            m_squadThresholds[merged++] = m_squadThresholds[i];
+    }
+    m_squadThresholdCount = merged;
+    size_t rank = 0;
+    for (uint32_t size = 0; size <= MaxThreshold; size++)
+    {
+        while (rank < m_squadThresholdCount && m_squadThresholds[rank].value <= size)
+            rank++;
+        m_squadRank[size] = static_cast<uint16_t>(rank);
+    }
+}
+
+uint32_t AlertRules::NextEvery(uint32_t kills) const
+{
+    uint64_t next = UINT32_MAX;
+    for (uint32_t bits = m_everyRules; bits != 0; bits &= bits - 1)
+    {
+        uint64_t every = m_rules[LowestBit(bits)].Values[0];
+        uint64_t candidate = (kills / every + 1) * every;
+        if (candidate < next)
+            next = candidate;
+    }
+    return static_cast<uint32_t>(next);
+}
+
+uint32_t AlertRules::OnKill(AlertRuleState& state, uint32_t streak, uint32_t best, uint32_t kills) const
+{
+    // The streak did not grow since the last kill, so it ended and this is a new one
+    if (streak <= state.LastStreak)
+        state.Baseline = state.LastBest;
+    state.LastStreak = streak;
+    if (best > state.LastBest)
+        state.LastBest = best;
+
+    uint32_t fired = streak <= MaxThreshold ? m_streakRules[streak] : 0;
+    if (m_bestRules != 0 && state.Baseline != 0 && streak == state.Baseline + 1)
+        fired |= m_bestRules;
+
+    if (m_everyRules != 0)
+    {
+        if (state.Compiled != this)
+        {
+            state.Compiled = this;
+            state.NextEvery = NextEvery(kills != 0 ? kills - 1 : 0);
+        }
+        if (kills >= state.NextEvery)
+        {
+            for (uint32_t bits = m_everyRules; bits != 0; bits &= bits - 1)
+            {
+                uint32_t rule = LowestBit(bits);
+                if (kills % m_rules[rule].Values[0] == 0)
+                    fired |= uint32_t(1) << rule;
+            }
+            state.NextEvery = NextEvery(kills);
+        }
+    }
+    return fired;
+}
+
+uint32_t AlertRules::OnSquadSize(uint32_t before, uint32_t after) const
+{
+    if (after <= before || m_squadThresholdCount == 0)
+        return 0;
+
+    // Every threshold in (before, after] was crossed
+    size_t from = m_squadRank[std::min(before, MaxThreshold)];
+    size_t to = m_squadRank[std::min(after, MaxThreshold)];
+    uint32_t fired = 0;
+    for (size_t i = from; i < to; i++)
+        fired |= m_squadThresholds[i].rules;
+    return fired;
+}
+
+bool AlertRules::SameRules(const AlertRules& other) const
+{
+    if (m_count != other.m_count)
+        return false;
+    for (size_t i = 1; i < m_count; i++)
+    {
+        if (m_rules[i].Source != other.m_rules[i].Source)
+            return false;
+    }
+    return true;
+}
+
+size_t AlertRules::Format(const std::string& message, uint32_t value, char* buffer, size_t size)
+{
+    if (size == 0)
+        return 0;
+
+    size_t pos = 0;
+    for (size_t i = 0; i < message.size() && pos + 1 < size; i++)
+    {
+        if (message.compare(i, 3, "{n}") == 0)
+        {
+            int len = snprintf(buffer + pos, size - pos, "%u", value);
+            if (len > 0)
+                pos = std::min(pos + static_cast<size_t>(len), size - 1);
+            i += 2;
+            continue;
+        }
+        buffer[pos++] = message[i];
+    }
+    buffer[pos] = '\0';
+    return pos;
+}
@@ -0,0 +1,124 @@
+///----------------------------------------------------------------------------------------------------
+/// Alert Rules - Settings-defined reactions to streaks, kill counts and squad size
+///
+/// Each rule="..." line in settings.txt is one trigger and one or more actions separated by '|':
+///   rule=streak 5,10,25 | alert Killstreak: {n}! | event EV_MY_OVERLAY_STREAK
+///   rule=kills_every 10 | file addons/streamlink/lastkill.txt {n} kills this session
+///   rule=best_streak | alert New best streak: {n}!
+///   rule=squad_size 10,25,50 | alert Squad size {n}
+/// {n} in a message is replaced by the value that fired the rule. The milestones= setting is the
+/// built-in streak alert rule.
+///
+/// Rules are compiled once per settings load into tables keyed by value: a rule mask per streak
+/// value, a rank table over the sorted squad size thresholds, the next kill count any kills_every
+/// rule fires at, and a single mask for best_streak. Checking a kill is a few array reads whatever
+/// the number of rules; rules are only walked once they have fired.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_ALERT_RULES_H
+#define STREAMLINK_ALERT_RULES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum EAlertTrigger : uint8_t
+{
+    AlertTrigger_Streak,        // the killstreak reaches one of the values
+    AlertTrigger_KillsEvery,    // every Nth session kill
+    AlertTrigger_BestStreak,    // the streak beats the session's previous best streak
+    AlertTrigger_SquadSize,     // the squad grows to or past one of the values
+    AlertTrigger_Count
+};
+
+enum EAlertAction : uint8_t
+{
+    AlertAction_Alert = 1 << 0,   // GUI_SendAlert with the message
+    AlertAction_File  = 1 << 1,   // write the message to a file
+    AlertAction_Event = 1 << 2    // Events_Raise for other addons
+};
+
+struct AlertRule
+{
+    static constexpr size_t MaxValues = 16;
+
+    EAlertTrigger Trigger = AlertTrigger_Streak;
+    uint8_t       Actions = 0;                 // EAlertAction bits
+    uint8_t       FileSlot = 0;                // AlertAction_File: index of FilePath
+    uint8_t       ValueCount = 0;
+    uint32_t      Values[MaxValues] = {};      // thresholds, or the N of kills_every
+    std::string   AlertMessage;                // {n} is the value
+    std::string   FilePath;                    // relative to the game directory
+    std::string   FileMessage;
+    std::string   EventName;
+    std::string   Source;                      // the settings line, to spot changes
+};
+
+class AlertRules;
+
+/// Per-thread memory of the kill triggers, kept by whoever calls OnKill
+struct AlertRuleState
+{
+    const AlertRules* Compiled = nullptr;   // rules NextEvery was computed for
+    uint32_t          NextEvery = 0;        // next session kill count a kills_every rule fires at
+    uint32_t          LastStreak = 0;
+    uint32_t          LastBest = 0;
+    uint32_t          Baseline = 0;         // best streak before the current streak began
+
+    /// Starts tracking from a (possibly restored) session.
+    void Begin(uint32_t streak, uint32_t best);
+};
+
+class AlertRules
+{
+public:
+    static constexpr size_t   MaxRules = 32;          // one bit each in a rule mask
+    static constexpr size_t   MaxFiles = 8;           // distinct file action paths
+    static constexpr uint32_t MaxThreshold = 1023;    // largest streak or squad size value
+
+    /// Parses one rule= line and adds it. False (and nothing added) if it is malformed or the table
+    /// is full.
+    bool Add(const std::string& definition);
+
+    /// Rebuilds the built-in milestone rule and every lookup table. Call after the last Add.
+    void Compile(const uint32_t* milestones, size_t milestoneCount);
+
+    /// Rules fired by a kill that left the streak, best streak and session kills at these values.
+    uint32_t OnKill(AlertRuleState& state, uint32_t streak, uint32_t best, uint32_t kills) const;
+
+    /// Rules fired by the squad growing from before to after members.
+    uint32_t OnSquadSize(uint32_t before, uint32_t after) const;
+
+    size_t           Count() const { return m_count; }
+    const AlertRule& Rule(size_t index) const { return m_rules[index]; }
+
+    /// Path of a file action slot (relative to the game directory), empty if unused.
+    const std::string& FilePath(size_t slot) const { return m_filePaths[slot]; }
+
+    /// Same rule lines (the built-in milestone rule is compared through the milestones setting).
+    bool SameRules(const AlertRules& other) const;
+
+    /// Writes message into buffer with {n} replaced by value. Returns the length.
+    static size_t Format(const std::string& message, uint32_t value, char* buffer, size_t size);
+
+private:
+    struct SquadThreshold
+    {
+        uint32_t value;
+        uint32_t rules;
+    };
+
+    uint32_t NextEvery(uint32_t kills) const;
+
+    AlertRule      m_rules[MaxRules];             // [0] is the built-in milestone rule
+    size_t         m_count = 1;
+    std::string    m_filePaths[MaxFiles];
+    uint32_t       m_streakRules[MaxThreshold + 1] = {};
+    SquadThreshold m_squadThresholds[MaxRules * AlertRule::MaxValues] = {};
+    size_t         m_squadThresholdCount = 0;
+    uint16_t       m_squadRank[MaxThreshold + 1] = {};   // thresholds <= size
+    uint32_t       m_everyRules = 0;
+    uint32_t       m_bestRules = 0;
+};
+
+#endif
@@ -0,0 +1,118 @@
+///----------------------------------------------------------------------------------------------------
+/// Combat Counters - Settings-defined counts of combat events matching a filter expression
+///----------------------------------------------------------------------------------------------------
+
+#include "combat_counters.h"
+
+#include <cctype>
+
+#include "helpers.h"
+
+///----------------------------------------------------------------------------------------------------
+/// ValidName - Letters, digits, '_' and '-', so the default file name is a plain file name
+///----------------------------------------------------------------------------------------------------
+static bool ValidName(const std::string& name)
+{
+    if (name.empty() || name.size() > 32)
+        return false;
+    for (char c : name)
+    {
+        if (!isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-')
+            return false;
+    }
+    return true;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// FindSeparator - Next single '|' from pos; "||" belongs to the expression
+///----------------------------------------------------------------------------------------------------
+static size_t FindSeparator(const std::string& text, size_t pos)
+{
+    while ((pos = text.find('|', pos)) != std::string::npos)
+    {
+        if (pos + 1 < text.size() && text[pos + 1] == '|')
+        {
+            pos += 2;
+            continue;
+        }
+        return pos;
+    }
+    return std::string::npos;
+}
+
+bool CombatCounters::Add(const std::string& definition)
+{
+    if (m_count >= MaxCounters)
+        return false;
+
+    // name | expression [| file path]
+    size_t first = FindSeparator(definition, 0);
+    if (first == std::string::npos)
+        return false;
+    size_t second = FindSeparator(definition, first + 1);
+
+    CombatCounter counter;
+    counter.Name = Trim(definition.substr(0, first));
+    counter.Expression = Trim(definition.substr(first + 1, second == std::string::npos ? std::string::npos
+                                                                                        : second - first - 1));
+    if (!ValidName(counter.Name) || !counter.Filter.Compile(counter.Expression))
+        return false;
+
+    counter.FilePath = "addons/streamlink/" + counter.Name + ".txt";
+    if (second != std::string::npos)
+    {
+        std::string action = Trim(definition.substr(second + 1));
+        if (action.compare(0, 5, "file ") != 0)
+            return false;
+        counter.FilePath = Trim(action.substr(5));
+        if (counter.FilePath.empty() || counter.FilePath.find('|') != std::string::npos)
+            return false;
+    }
+
+    for (size_t i = 0; i < m_count; i++)
+    {
+        if (m_counters[i].Name == counter.Name)
+            return false;
+    }
+
+    uint32_t bit = uint32_t(1) << m_count;
+    for (int value = 0; value < 256; value++)
+    {
+        if (counter.Filter.CanMatch(FilterField_Result, value))
+            m_byResult[value] |= bit;
+        if (counter.Filter.CanMatch(FilterField_Statechange, value))
+            m_byStatechange[value] |= bit;
+    }
+    m_counters[m_count++] = counter;
+    return true;
+}
+
+uint32_t CombatCounters::Match(const CombatRecord& record) const
+{
+    uint32_t candidates = m_byResult[record.Result] & m_byStatechange[record.IsStatechange];
+    if (candidates == 0 || !record.HasEvent())
+        return 0;
+
+    FilterFields fields = MakeFilterFields(record);
+    uint32_t matched = 0;
+    for (uint32_t bits = candidates; bits != 0; bits &= bits - 1)
+    {
+        uint32_t i = LowestBit(bits);
+        matched |= static_cast<uint32_t>(m_counters[i].Filter.Matches(fields)) << i;
+    }
+    return matched;
+}
+
+bool CombatCounters::SameCounters(const CombatCounters& other) const
+{
+    if (m_count != other.m_count)
+        return false;
+    for (size_t i = 0; i < m_count; i++)
+    {
+        const CombatCounter& a = m_counters[i];
+        const CombatCounter& b = other.m_counters[i];
+        if (a.Name != b.Name || a.Expression != b.Expression || a.FilePath != b.FilePath)
+            return false;
+    }
+    return true;
+}
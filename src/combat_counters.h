@@ -0,0 +1,60 @@
+///----------------------------------------------------------------------------------------------------
+/// Combat Counters - Settings-defined counts of combat events matching a filter expression
+///
+/// Each counter="..." line in settings.txt is a name, an event filter expression (see event_filter.h)
+/// and optionally the file the count is written to, separated by '|':
+///   counter=my_kills | result==KILLINGBLOW && src.self && dst.profession in 1..9
+///   counter=warbanner | skill==14419 && src.self | file overlay/warbanner.txt
+/// Without a file action the count goes to addons/streamlink/<name>.txt.
+///
+/// Most expressions require one result or state change, so each counter's bit is also filed in two
+/// 256-entry tables under every Result and IsStatechange value it can match. Match ANDs the two
+/// entries for the record and runs only those filters, over fields unpacked once, so a plain strike
+/// never reaches the kill and down counters. A new thing to count is a settings line rather than a
+/// change to the combat handlers.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_COMBAT_COUNTERS_H
+#define STREAMLINK_COMBAT_COUNTERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "combat_record.h"
+#include "event_filter.h"
+
+struct CombatCounter
+{
+    std::string Name;
+    std::string Expression;
+    std::string FilePath;     // relative to the game directory
+    EventFilter Filter;
+};
+
+class CombatCounters
+{
+public:
+    static constexpr size_t MaxCounters = 32;   // one bit each in a Match mask
+
+    /// Parses one counter= line and adds it. False (and nothing added) if it is malformed, the name is
+    /// taken or the table is full.
+    bool Add(const std::string& definition);
+
+    /// Counters the record counts towards, one bit per counter. Agent notifications count for none.
+    uint32_t Match(const CombatRecord& record) const;
+
+    size_t               Count() const { return m_count; }
+    const CombatCounter& Counter(size_t index) const { return m_counters[index]; }
+
+    /// Same counter lines in the same order.
+    bool SameCounters(const CombatCounters& other) const;
+
+private:
+    CombatCounter m_counters[MaxCounters];
+    size_t        m_count = 0;
+    uint32_t      m_byResult[256] = {};        // counters that can match each Result
+    uint32_t      m_byStatechange[256] = {};   // and each IsStatechange
+};
+
+#endif
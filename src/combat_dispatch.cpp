@@ -0,0 +1,89 @@
+///----------------------------------------------------------------------------------------------------
+/// Combat Dispatch - Single path from both ArcDPS combat feeds to the combat tracker
+///----------------------------------------------------------------------------------------------------
+
+#include "combat_dispatch.h"
+
+#include "combat_tracker.h"
+#include "event_dedup.h"
+
+typedef uint32_t (*COMBAT_HANDLER)(const CombatRecord& record);
+
+namespace
+{
+    struct HandlerTables
+    {
+        COMBAT_HANDLER StateChange[256] = {};   // by IsStatechange
+        COMBAT_HANDLER Result[256] = {};        // by Result, for events that are not state changes
+        bool           CriticalStateChange[256] = {};
+        bool           CriticalResult[256] = {};
+
+        HandlerTables()
+        {
+            // Critical handlers change counted state, so the event queue keeps room for their records.
+            // The percentage updates only replace a gauge value that the next update supersedes.
+            OnStateChange(ArcDPS::CBTS_CHANGEUP, CombatTracker::OnStatusChange, true);
+            OnStateChange(ArcDPS::CBTS_CHANGEDOWN, CombatTracker::OnStatusChange, true);
+            OnStateChange(ArcDPS::CBTS_CHANGEDEAD, CombatTracker::OnStatusChange, true);
+            OnStateChange(ArcDPS::CBTS_DESPAWN, CombatTracker::OnDespawn, true);
+            OnStateChange(ArcDPS::CBTS_HEALTHPCTUPDATE, CombatTracker::OnGaugeUpdate, false);
+            OnStateChange(ArcDPS::CBTS_BARRIERPCTUPDATE, CombatTracker::OnGaugeUpdate, false);
+
+            OnResult(ArcDPS::CBTR_KILLINGBLOW, CombatTracker::OnKillingBlow, true);
+            OnResult(ArcDPS::CBTR_DOWNED, CombatTracker::OnDowned, true);
+        }
+
+        void OnStateChange(uint8_t statechange, COMBAT_HANDLER handler, bool critical)
+        {
+            StateChange[statechange] = handler;
+            CriticalStateChange[statechange] = critical;
+        }
+
+        void OnResult(uint8_t result, COMBAT_HANDLER handler, bool critical)
+        {
+            Result[result] = handler;
+            CriticalResult[result] = critical;
+        }
+    };
+
+    const HandlerTables g_handlers;
+    EventDedup          g_dedup;
+}
+
+bool CombatDispatch::Accept(const CombatRecord& record)
+{
+    return g_dedup.Accept(record);
+}
+
+uint32_t CombatDispatch::Dispatch(const CombatRecord& record)
+{
+    if (!record.HasEvent())
+        return CombatTracker::OnAgentNotification(record);
+
+    COMBAT_HANDLER handler = nullptr;
+    if (record.IsStatechange)
+        handler = g_handlers.StateChange[record.IsStatechange];
+    else if (!record.IsActivation && !record.IsBuffRemove)   // Result means something else for those
+        handler = g_handlers.Result[record.Result];
+
+    return handler ? handler(record) : CombatChange_None;
+}
+
+bool CombatDispatch::IsCritical(const CombatRecord& record)
+{
+    if (!record.HasEvent())
+        return record.IsTrackingNotification();
+    if (record.IsStatechange)
+        return g_handlers.CriticalStateChange[record.IsStatechange];
+    return !record.IsActivation && !record.IsBuffRemove && g_handlers.CriticalResult[record.Result];
+}
+
+uint64_t CombatDispatch::Duplicates()
+{
+    return g_dedup.Duplicates();
+}
+
+void CombatDispatch::Reset()
+{
+    g_dedup.Clear();
+}
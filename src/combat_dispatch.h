@@ -0,0 +1,37 @@
+///----------------------------------------------------------------------------------------------------
+/// Combat Dispatch - Single path from both ArcDPS combat feeds to the combat tracker
+///
+/// Records from LOCAL_RAW and SQUAD_RAW go through one EventDedup, so the copy of an event the other
+/// feed already delivered is dropped, and the rest are routed through two 256-entry handler tables:
+/// one indexed by IsStatechange for state changes, one by Result for plain combat events. A record
+/// with no handler costs two loads and a compare. Agent notifications (no ev) go to
+/// CombatTracker::OnAgentNotification from either feed. Called from the event queue worker only.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_COMBAT_DISPATCH_H
+#define STREAMLINK_COMBAT_DISPATCH_H
+
+#include <cstdint>
+
+#include "combat_record.h"
+
+namespace CombatDispatch
+{
+    /// True the first time an event is seen, false for the other feed's copy. Every consumer of
+    /// combat records checks this first, so each logical event is handled exactly once.
+    bool Accept(const CombatRecord& record);
+
+    /// Runs the record's handler, returns its ECombatChange flags.
+    uint32_t Dispatch(const CombatRecord& record);
+
+    /// True for records whose handler changes counted state (agent notifications, status changes,
+    /// despawns, killing blows, downs). The event queue keeps a reserve for these. Any thread.
+    bool IsCritical(const CombatRecord& record);
+
+    /// Copies dropped by Accept since the last Reset.
+    uint64_t Duplicates();
+
+    void Reset();
+}
+
+#endif
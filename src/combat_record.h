@@ -0,0 +1,143 @@
+///----------------------------------------------------------------------------------------------------
+/// Combat Record - Compact copy of one ArcDPS combat callback
+///
+/// Everything the trackers use from EvCombatData, flattened into a fixed-size POD so it can be queued
+/// and processed after the callback returns. Agent names and the skill name are deliberately left
+/// out: ArcDPS only guarantees them for the duration of the callback.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_COMBAT_RECORD_H
+#define STREAMLINK_COMBAT_RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "ArcDPS.h"
+
+/// Which subscription delivered the event
+enum ECombatSource : uint8_t
+{
+    CombatSource_Local = 0,   // EV_ARCDPS_COMBATEVENT_LOCAL_RAW
+    CombatSource_Squad = 1    // EV_ARCDPS_COMBATEVENT_SQUAD_RAW
+};
+
+/// Bits in CombatRecord::Flags
+enum ECombatRecordFlags : uint8_t
+{
+    CombatRecord_HasEvent   = 1 << 0,   // ev was set; without it the callback is an agent notification
+    CombatRecord_HasSrc     = 1 << 1,
+    CombatRecord_HasDst     = 1 << 2,
+    CombatRecord_SrcIsSelf  = 1 << 3,
+    CombatRecord_DstIsSelf  = 1 << 4,
+    CombatRecord_SrcElite   = 1 << 5    // src->Specialization was non-zero (see IsTrackingNotification)
+};
+
+struct CombatRecord
+{
+    uint64_t Time;
+    uint64_t Id;                 // EvCombatData::id (ArcDPS event id)
+    uint64_t SrcId;              // AgentShort::ID, 0 without a source agent
+    uint64_t DstId;
+    uint64_t DstAgent;           // raw CombatEvent::DestinationAgent (state change payloads)
+    int32_t  Value;
+    int32_t  BuffDamage;
+    uint32_t SkillId;
+    uint32_t SrcProfession;      // 1-9 for players, species id for NPCs
+    uint32_t DstProfession;
+    uint16_t SrcTeam;
+    uint16_t DstTeam;
+    uint8_t  Source;             // ECombatSource
+    uint8_t  Flags;              // ECombatRecordFlags
+    uint8_t  IsStatechange;
+    uint8_t  Result;
+    uint8_t  Iff;
+    uint8_t  Buff;
+    uint8_t  IsActivation;
+    uint8_t  IsBuffRemove;
+
+    bool HasEvent() const  { return (Flags & CombatRecord_HasEvent) != 0; }
+    bool SrcIsSelf() const { return (Flags & CombatRecord_SrcIsSelf) != 0; }
+    bool DstIsSelf() const { return (Flags & CombatRecord_DstIsSelf) != 0; }
+
+    /// A null-ev callback with src->elite 0 announces an agent joining or leaving tracking; with
+    /// elite 1 it only reports a target change, src being the new target.
+    bool IsTrackingNotification() const { return !HasEvent() && !(Flags & CombatRecord_SrcElite); }
+};
+
+static_assert(sizeof(CombatRecord) <= 72, "CombatRecord should stay within a cache line and a bit");
+
+///----------------------------------------------------------------------------------------------------
+/// IsPlayer - In arcDPS, Profession is 1-9 for players, species ID (>9) for NPCs
+///----------------------------------------------------------------------------------------------------
+inline bool IsPlayer(uint32_t profession)
+{
+    return profession >= 1 && profession <= 9;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// MakeCombatRecord - Copy the fields we track out of a callback payload
+///----------------------------------------------------------------------------------------------------
+inline CombatRecord MakeCombatRecord(const EvCombatData& data, ECombatSource source)
+{
+    CombatRecord record = {};
+    record.Id = data.id;
+    record.Source = source;
+
+    if (const ArcDPS::CombatEvent* ev = data.ev)
+    {
+        record.Flags |= CombatRecord_HasEvent;
+        record.Time = ev->Time;
+        record.DstAgent = ev->DestinationAgent;
+        record.Value = ev->Value;
+        record.BuffDamage = ev->BuffDamage;
+        record.SkillId = ev->SkillID;
+        record.IsStatechange = ev->IsStatechange;
+        record.Result = ev->Result;
+        record.Iff = ev->IFF;
+        record.Buff = ev->Buff;
+        record.IsActivation = ev->IsActivation;
+        record.IsBuffRemove = ev->IsBuffRemove;
+    }
+    if (const ArcDPS::AgentShort* src = data.src)
+    {
+        record.Flags |= CombatRecord_HasSrc | (src->IsSelf ? CombatRecord_SrcIsSelf : 0) |
+                        (src->Specialization ? CombatRecord_SrcElite : 0);
+        record.SrcId = src->ID;
+        record.SrcProfession = src->Profession;
+        record.SrcTeam = src->Team;
+    }
+    if (const ArcDPS::AgentShort* dst = data.dst)
+    {
+        record.Flags |= CombatRecord_HasDst | (dst->IsSelf ? CombatRecord_DstIsSelf : 0);
+        record.DstId = dst->ID;
+        record.DstProfession = dst->Profession;
+        record.DstTeam = dst->Team;
+    }
+    return record;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// CopyName - Copy a callback-lifetime UTF-8 name (may be null) into a fixed buffer, cut at a
+///            character boundary if it does not fit
+///----------------------------------------------------------------------------------------------------
+inline void CopyName(char* out, size_t size, const char* name)
+{
+    if (!name)
+    {
+        out[0] = '\0';
+        return;
+    }
+
+    size_t length = strnlen(name, size);
+    if (length == size)
+    {
+        length = size - 1;
+        while (length > 0 && (static_cast<unsigned char>(name[length]) & 0xC0) == 0x80)
+            length--;
+    }
+    memcpy(out, name, length);
+    out[length] = '\0';
+}
+
+#endif
@@ -0,0 +1,510 @@
+///----------------------------------------------------------------------------------------------------
+/// Combat Recording - Compact binary format for the raw ArcDPS combat and squad update streams
+///----------------------------------------------------------------------------------------------------
+
+#include "combat_recording.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    enum ERecordType : uint8_t
+    {
+        Record_Combat = 1,
+        Record_Squad = 2,
+        Record_Name = 3,
+        Record_NameReset = 4
+    };
+
+    const char Magic[4] = {'S', 'L', 'R', 'C'};
+
+    // CombatEvent's one-byte fields, IFF through PAD64: a mask of the non-zero ones, then those bytes
+    constexpr size_t RawFlagsOffset = offsetof(ArcDPS::CombatEvent, IFF);
+    constexpr size_t RawFlagsSize = sizeof(ArcDPS::CombatEvent) - RawFlagsOffset;
+    static_assert(RawFlagsSize == 16, "CombatEvent layout changed");
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Writing - LEB128 varints, zigzag for signed values and deltas
+///----------------------------------------------------------------------------------------------------
+static void PutVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static void PutSigned(std::vector<uint8_t>& out, int64_t value)
+{
+    PutVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+static void PutDelta(std::vector<uint8_t>& out, uint64_t value, uint64_t& previous)
+{
+    PutSigned(out, static_cast<int64_t>(value - previous));
+    previous = value;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Reading - Each getter fails instead of reading past end
+///----------------------------------------------------------------------------------------------------
+static bool GetVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value)
+{
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        if (p == end)
+            return false;
+        uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+static bool GetSigned(const uint8_t*& p, const uint8_t* end, int64_t& value)
+{
+    uint64_t raw;
+    if (!GetVarint(p, end, raw))
+        return false;
+    value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+    return true;
+}
+
+static bool GetDelta(const uint8_t*& p, const uint8_t* end, uint64_t& previous)
+{
+    int64_t delta;
+    if (!GetSigned(p, end, delta))
+        return false;
+    previous += static_cast<uint64_t>(delta);
+    return true;
+}
+
+template <typename T>
+static bool GetNumber(const uint8_t*& p, const uint8_t* end, T& value)
+{
+    uint64_t raw;
+    if (!GetVarint(p, end, raw))
+        return false;
+    value = static_cast<T>(raw);
+    return true;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// HashName - FNV-1a
+///----------------------------------------------------------------------------------------------------
+static uint64_t HashName(const char* name, size_t length)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Capture
+///----------------------------------------------------------------------------------------------------
+static void CaptureAgent(const ArcDPS::AgentShort& agent, RecordedAgent& out)
+{
+    out.ID = agent.ID;
+    out.Profession = agent.Profession;
+    out.Specialization = agent.Specialization;
+    out.IsSelf = agent.IsSelf;
+    out.Team = agent.Team;
+    CopyName(out.Name, sizeof(out.Name), agent.Name);
+}
+
+void CaptureCombat(const EvCombatData& data, ECombatSource source, RecordedCombat& out)
+{
+    out.EventId = data.id;
+    out.Revision = data.revision;
+    out.Source = source;
+    out.Flags = data.ev ? Recorded_HasEvent : 0;
+    out.Ev = data.ev ? *data.ev : ArcDPS::CombatEvent();
+    if (data.src)
+    {
+        CaptureAgent(*data.src, out.Src);
+        out.Flags |= Recorded_HasSrc | (data.src->Name ? Recorded_SrcName : 0);
+    }
+    if (data.dst)
+    {
+        CaptureAgent(*data.dst, out.Dst);
+        out.Flags |= Recorded_HasDst | (data.dst->Name ? Recorded_DstName : 0);
+    }
+    CopyName(out.SkillName, sizeof(out.SkillName), data.skillname);
+    if (data.skillname)
+        out.Flags |= Recorded_SkillName;
+}
+
+void CaptureUser(const UnofficialExtras::UserInfo& user, RecordedUser& out)
+{
+    CopyName(out.AccountName, sizeof(out.AccountName), user.AccountName);
+    out.HasName = user.AccountName != nullptr;
+    out.JoinTime = user.JoinTime;
+    out.Role = static_cast<uint8_t>(user.Role);
+    out.Subgroup = user.Subgroup;
+    out.ReadyStatus = user.ReadyStatus ? 1 : 0;
+    out.GroupType = static_cast<uint8_t>(user.GroupType);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RecordingEncoder
+///----------------------------------------------------------------------------------------------------
+RecordingEncoder::RecordingEncoder()
+    : m_names(MaxNames * 2), m_arena(NameArenaSize)
+{
+    m_payload.reserve(512);
+}
+
+void RecordingEncoder::Begin(uint64_t wallClockMs, std::vector<uint8_t>& out)
+{
+    ResetNames(nullptr);
+    m_eventId = m_time = m_srcAgent = m_dstAgent = m_srcId = m_dstId = 0;
+    m_joinTime = 0;
+
+    out.insert(out.end(), Magic, Magic + sizeof(Magic));
+    out.push_back(CombatRecording::Version);
+    out.insert(out.end(), 3, 0);
+    for (int i = 0; i < 8; i++)
+        out.push_back(static_cast<uint8_t>(wallClockMs >> (i * 8)));
+}
+
+///----------------------------------------------------------------------------------------------------
+/// ResetNames - Empty the table; with out, also tell the reader to forget its ids
+///----------------------------------------------------------------------------------------------------
+void RecordingEncoder::ResetNames(std::vector<uint8_t>* out)
+{
+    std::fill(m_names.begin(), m_names.end(), NameSlot{0, 0, 0});
+    m_arenaUsed = 0;
+    m_nameCount = 0;
+    if (out)
+    {
+        PutVarint(*out, 1);
+        out->push_back(Record_NameReset);
+    }
+}
+
+///----------------------------------------------------------------------------------------------------
+/// MakeRoom - Start the name table over unless that many new names are sure to fit. Runs before a
+///            record rather than in Intern, so no record refers to ids from both tables.
+///----------------------------------------------------------------------------------------------------
+void RecordingEncoder::MakeRoom(size_t names, std::vector<uint8_t>& out)
+{
+    if (m_nameCount + names > MaxNames || m_arenaUsed + names * CombatRecording::MaxNameLength > m_arena.size())
+        ResetNames(&out);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Intern - Id of a name, defining it in out first if it is new. 0 for a null name.
+///----------------------------------------------------------------------------------------------------
+uint32_t RecordingEncoder::Intern(const char* name, bool present, std::vector<uint8_t>& out)
+{
+    if (!present)
+        return 0;
+
+    size_t length = strlen(name);
+    uint64_t hash = HashName(name, length);
+    size_t mask = m_names.size() - 1;
+    size_t index = static_cast<size_t>(hash) & mask;
+    for (; m_names[index].Id != 0; index = (index + 1) & mask)
+    {
+        const NameSlot& slot = m_names[index];
+        if (slot.Hash == hash && strcmp(&m_arena[slot.Offset], name) == 0)
+            return slot.Id;
+    }
+
+    if (m_nameCount == MaxNames || m_arenaUsed + length + 1 > m_arena.size())
+        return 0;   // MakeRoom was not asked for enough
+
+    memcpy(&m_arena[m_arenaUsed], name, length + 1);
+    m_names[index] = NameSlot{hash, static_cast<uint32_t>(m_arenaUsed), static_cast<uint32_t>(++m_nameCount)};
+    m_arenaUsed += length + 1;
+
+    PutVarint(out, length + 1);
+    out.push_back(Record_Name);
+    out.insert(out.end(), name, name + length);
+    return m_names[index].Id;
+}
+
+void RecordingEncoder::Combat(const RecordedCombat& combat, std::vector<uint8_t>& out)
+{
+    MakeRoom(3, out);
+
+    std::vector<uint8_t>& payload = m_payload;
+    payload.clear();
+    payload.push_back(Record_Combat);
+    payload.push_back(combat.Source);
+    payload.push_back(combat.Flags);
+    PutDelta(payload, combat.EventId, m_eventId);
+    PutVarint(payload, combat.Revision);
+
+    const ArcDPS::CombatEvent& ev = combat.Ev;
+    bool hasEvent = (combat.Flags & Recorded_HasEvent) != 0;
+    if (hasEvent)
+    {
+        PutDelta(payload, ev.Time, m_time);
+        PutDelta(payload, ev.SourceAgent, m_srcAgent);
+        PutDelta(payload, ev.DestinationAgent, m_dstAgent);
+        PutSigned(payload, ev.Value);
+        PutSigned(payload, ev.BuffDamage);
+        PutVarint(payload, ev.OverstackValue);
+        PutVarint(payload, ev.SkillID);
+        PutVarint(payload, ev.SourceInstanceID);
+        PutVarint(payload, ev.DestinationInstanceID);
+        PutVarint(payload, ev.SrcMasterInstanceID);
+        PutVarint(payload, ev.DestinationMasterInstanceID);
+        const uint8_t* raw = reinterpret_cast<const uint8_t*>(&ev) + RawFlagsOffset;
+        uint32_t mask = 0;
+        for (size_t i = 0; i < RawFlagsSize; i++)
+            mask |= raw[i] ? 1u << i : 0;
+        PutVarint(payload, mask);
+        for (size_t i = 0; i < RawFlagsSize; i++)
+        {
+            if (raw[i])
+                payload.push_back(raw[i]);
+        }
+    }
+
+    // Agent ids relative to the event's agent fields (equal for nearly every event), else to the last
+    const RecordedAgent* agents[2] = {&combat.Src, &combat.Dst};
+    const uint8_t present[2] = {Recorded_HasSrc, Recorded_HasDst};
+    const uint8_t named[2] = {Recorded_SrcName, Recorded_DstName};
+    uint64_t* previous[2] = {&m_srcId, &m_dstId};
+    const uint64_t eventAgent[2] = {ev.SourceAgent, ev.DestinationAgent};
+    for (int i = 0; i < 2; i++)
+    {
+        if (!(combat.Flags & present[i]))
+            continue;
+        const RecordedAgent& agent = *agents[i];
+        uint64_t base = hasEvent ? eventAgent[i] : *previous[i];
+        PutSigned(payload, static_cast<int64_t>(agent.ID - base));
+        *previous[i] = agent.ID;
+        PutVarint(payload, agent.Profession);
+        PutVarint(payload, agent.Specialization);
+        PutVarint(payload, agent.IsSelf);
+        PutVarint(payload, agent.Team);
+        PutVarint(payload, Intern(agent.Name, (combat.Flags & named[i]) != 0, out));
+    }
+    PutVarint(payload, Intern(combat.SkillName, (combat.Flags & Recorded_SkillName) != 0, out));
+
+    PutVarint(out, payload.size());
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+void RecordingEncoder::SquadUpdate(const RecordedUser* users, size_t count, std::vector<uint8_t>& out)
+{
+    MakeRoom(count, out);
+
+    std::vector<uint8_t>& payload = m_payload;
+    payload.clear();
+    payload.push_back(Record_Squad);
+    PutVarint(payload, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const RecordedUser& user = users[i];
+        PutVarint(payload, Intern(user.AccountName, user.HasName, out));
+        PutSigned(payload, user.JoinTime - m_joinTime);
+        m_joinTime = user.JoinTime;
+        payload.push_back(user.Role);
+        payload.push_back(user.Subgroup);
+        payload.push_back(user.ReadyStatus);
+        payload.push_back(user.GroupType);
+    }
+
+    PutVarint(out, payload.size());
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RecordingReader
+///----------------------------------------------------------------------------------------------------
+bool RecordingReader::Open(const std::string& path)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f)
+        return false;
+
+    std::vector<uint8_t> data;
+    uint8_t buffer[64 * 1024];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), f)) > 0)
+        data.insert(data.end(), buffer, buffer + read);
+    fclose(f);
+    return Open(data.data(), data.size());
+}
+
+bool RecordingReader::Open(const uint8_t* data, size_t size)
+{
+    *this = RecordingReader();
+    if (size < CombatRecording::HeaderSize || memcmp(data, Magic, sizeof(Magic)) != 0 ||
+        data[4] != CombatRecording::Version)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < 8; i++)
+        m_startedAtMs |= static_cast<uint64_t>(data[8 + i]) << (i * 8);
+    m_data.assign(data, data + size);
+    m_pos = CombatRecording::HeaderSize;
+    return true;
+}
+
+bool RecordingReader::LookupName(uint64_t id, char* out, bool& present) const
+{
+    present = id != 0;
+    if (id > m_names.size())
+        return false;
+    CopyName(out, CombatRecording::MaxNameLength, present ? m_names[id - 1].c_str() : nullptr);
+    return true;
+}
+
+bool RecordingReader::DecodeCombat(const uint8_t*& p, const uint8_t* end, RecordedCombat& out)
+{
+    out = RecordedCombat();
+    if (end - p < 2)
+        return false;
+    out.Source = *p++;
+    out.Flags = *p++;
+    if (!GetDelta(p, end, m_eventId) || !GetVarint(p, end, out.Revision))
+        return false;
+    out.EventId = m_eventId;
+
+    ArcDPS::CombatEvent& ev = out.Ev;
+    bool hasEvent = (out.Flags & Recorded_HasEvent) != 0;
+    if (hasEvent)
+    {
+        int64_t value, buffDamage;
+        uint64_t mask;
+        if (!GetDelta(p, end, m_time) || !GetDelta(p, end, m_srcAgent) || !GetDelta(p, end, m_dstAgent) ||
+            !GetSigned(p, end, value) || !GetSigned(p, end, buffDamage) ||
+            !GetNumber(p, end, ev.OverstackValue) || !GetNumber(p, end, ev.SkillID) ||
+            !GetNumber(p, end, ev.SourceInstanceID) || !GetNumber(p, end, ev.DestinationInstanceID) ||
+            !GetNumber(p, end, ev.SrcMasterInstanceID) || !GetNumber(p, end, ev.DestinationMasterInstanceID) ||
+            !GetVarint(p, end, mask) || mask >> RawFlagsSize)
+        {
+            return false;
+        }
+        ev.Time = m_time;
+        ev.SourceAgent = m_srcAgent;
+        ev.DestinationAgent = m_dstAgent;
+        ev.Value = static_cast<int32_t>(value);
+        ev.BuffDamage = static_cast<int32_t>(buffDamage);
+        uint8_t* raw = reinterpret_cast<uint8_t*>(&ev) + RawFlagsOffset;
+        for (size_t i = 0; i < RawFlagsSize; i++)
+        {
+            if (!(mask & (1u << i)))
+                continue;
+            if (p == end)
+                return false;
+            raw[i] = *p++;
+        }
+    }
+
+    RecordedAgent* agents[2] = {&out.Src, &out.Dst};
+    const uint8_t present[2] = {Recorded_HasSrc, Recorded_HasDst};
+    uint64_t* previous[2] = {&m_srcId, &m_dstId};
+    const uint64_t eventAgent[2] = {ev.SourceAgent, ev.DestinationAgent};
+    for (int i = 0; i < 2; i++)
+    {
+        if (!(out.Flags & present[i]))
+            continue;
+        RecordedAgent& agent = *agents[i];
+        int64_t delta;
+        uint64_t nameId;
+        bool named;
+        if (!GetSigned(p, end, delta) || !GetNumber(p, end, agent.Profession) ||
+            !GetNumber(p, end, agent.Specialization) || !GetNumber(p, end, agent.IsSelf) ||
+            !GetNumber(p, end, agent.Team) || !GetVarint(p, end, nameId) || !LookupName(nameId, agent.Name, named))
+        {
+            return false;
+        }
+        agent.ID = (hasEvent ? eventAgent[i] : *previous[i]) + static_cast<uint64_t>(delta);
+        *previous[i] = agent.ID;
+    }
+
+    uint64_t skillNameId;
+    bool named;
+    return GetVarint(p, end, skillNameId) && LookupName(skillNameId, out.SkillName, named);
+}
+
+bool RecordingReader::DecodeSquad(const uint8_t*& p, const uint8_t* end, std::vector<RecordedUser>& out)
+{
+    uint64_t count;
+    if (!GetVarint(p, end, count) || count > static_cast<uint64_t>(end - p))
+        return false;
+
+    out.assign(static_cast<size_t>(count), RecordedUser());
+    for (RecordedUser& user : out)
+    {
+        uint64_t nameId;
+        int64_t delta;
+        if (!GetVarint(p, end, nameId) || !LookupName(nameId, user.AccountName, user.HasName) ||
+            !GetSigned(p, end, delta) || end - p < 4)
+        {
+            return false;
+        }
+        m_joinTime += delta;
+        user.JoinTime = m_joinTime;
+        user.Role = *p++;
+        user.Subgroup = *p++;
+        user.ReadyStatus = *p++;
+        user.GroupType = *p++;
+    }
+    return true;
+}
+
+bool RecordingReader::Next(RecordingEntry& out)
+{
+    while (m_pos < m_data.size())
+    {
+        const uint8_t* p = m_data.data() + m_pos;
+        const uint8_t* dataEnd = m_data.data() + m_data.size();
+        uint64_t length;
+        if (!GetVarint(p, dataEnd, length) || length == 0 || length > static_cast<uint64_t>(dataEnd - p))
+        {
+            m_damaged = true;
+            return false;
+        }
+
+        const uint8_t* end = p + length;
+        m_pos = static_cast<size_t>(end - m_data.data());
+        uint8_t type = *p++;
+        switch (type)
+        {
+            case Record_Name:
+                m_names.emplace_back(reinterpret_cast<const char*>(p), static_cast<size_t>(end - p));
+                break;
+            case Record_NameReset:
+                m_names.clear();
+                break;
+            case Record_Combat:
+                out.Kind = RecordingEntry::Combat;
+                if (!DecodeCombat(p, end, out.CombatData) || p != end)
+                {
+                    m_damaged = true;
+                    return false;
+                }
+                return true;
+            case Record_Squad:
+                out.Kind = RecordingEntry::SquadUpdate;
+                if (!DecodeSquad(p, end, out.Users) || p != end)
+                {
+                    m_damaged = true;
+                    return false;
+                }
+                return true;
+            default:
+                break;   // a newer record type: skip it
+        }
+    }
+    return false;
+}
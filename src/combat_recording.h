@@ -0,0 +1,191 @@
+///----------------------------------------------------------------------------------------------------
+/// Combat Recording - Compact binary format for the raw ArcDPS combat and squad update streams
+///
+/// A recording is a 16-byte header (magic, version, wall-clock start time) followed by records, each
+/// a LEB128 length and that many payload bytes, so a reader can step over a record it does not know
+/// and a file cut off mid-record loses only that record. The first payload byte is the record type:
+///   Combat     one EvCombatData: source feed, which pointers were set, the event id and revision,
+///              every CombatEvent field, both AgentShorts and the skill name
+///   Squad      one EvSquadUpdate batch: every UserInfo
+///   Name       defines the next name id (ids count up from 1; 0 stands for a null name)
+///   NameReset  forgets every name id (the writer's table was full)
+/// Integers are LEB128, signed values zigzag-encoded. The event time, event id and the event's agent
+/// fields are stored as the difference to the previous record's, and an AgentShort::ID relative to
+/// the event field it nearly always equals, so each is usually one byte. The sixteen one-byte flag
+/// fields are a mask plus the non-zero bytes. Agent, skill and account names are written once and
+/// referred to by id afterwards.
+///
+/// The Recorded* structs are what a callback copies out of its payload (names included, since they
+/// die with the callback); RecordingEncoder turns them into bytes and RecordingReader back. Neither
+/// class is thread-safe.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_COMBAT_RECORDING_H
+#define STREAMLINK_COMBAT_RECORDING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ArcDPS.h"
+#include "UnofficialExtras.h"
+#include "combat_record.h"
+
+namespace CombatRecording
+{
+    constexpr uint8_t Version = 1;
+    constexpr size_t  HeaderSize = 16;
+    constexpr size_t  MaxNameLength = 64;   // bytes kept per name, terminator included
+}
+
+/// Bits in RecordedCombat::Flags: which payload pointers were set
+enum ERecordedFlags : uint8_t
+{
+    Recorded_HasEvent     = 1 << 0,
+    Recorded_HasSrc       = 1 << 1,
+    Recorded_HasDst       = 1 << 2,
+    Recorded_SrcName      = 1 << 3,
+    Recorded_DstName      = 1 << 4,
+    Recorded_SkillName    = 1 << 5
+};
+
+struct RecordedAgent
+{
+    uint64_t ID;
+    uint32_t Profession;
+    uint32_t Specialization;
+    uint32_t IsSelf;
+    uint16_t Team;
+    char     Name[CombatRecording::MaxNameLength];
+};
+
+struct RecordedCombat
+{
+    uint64_t            EventId;
+    uint64_t            Revision;
+    ArcDPS::CombatEvent Ev;
+    RecordedAgent       Src;
+    RecordedAgent       Dst;
+    char                SkillName[CombatRecording::MaxNameLength];
+    uint8_t             Source;   // ECombatSource
+    uint8_t             Flags;    // ERecordedFlags
+};
+
+struct RecordedUser
+{
+    char    AccountName[CombatRecording::MaxNameLength];
+    int64_t JoinTime;
+    uint8_t Role;          // UnofficialExtras::UserRole
+    uint8_t Subgroup;
+    uint8_t ReadyStatus;
+    uint8_t GroupType;     // UnofficialExtras::ChannelType
+    bool    HasName;
+};
+
+/// Copies a combat callback payload. Safe from the callback thread.
+void CaptureCombat(const EvCombatData& data, ECombatSource source, RecordedCombat& out);
+
+/// Copies one user of a squad update batch.
+void CaptureUser(const UnofficialExtras::UserInfo& user, RecordedUser& out);
+
+class RecordingEncoder
+{
+public:
+    static constexpr size_t MaxNames = 8192;              // interned before the table starts over
+    static constexpr size_t NameArenaSize = 256 * 1024;
+
+    RecordingEncoder();
+
+    /// Appends the file header and forgets every previous value and name: a new recording.
+    void Begin(uint64_t wallClockMs, std::vector<uint8_t>& out);
+
+    /// Appends one combat record, preceded by the definition of any name it uses for the first time.
+    void Combat(const RecordedCombat& combat, std::vector<uint8_t>& out);
+
+    /// Appends one squad update batch the same way.
+    void SquadUpdate(const RecordedUser* users, size_t count, std::vector<uint8_t>& out);
+
+    /// Distinct names interned since Begin (or the last reset of the table).
+    size_t NameCount() const { return m_nameCount; }
+
+private:
+    struct NameSlot
+    {
+        uint64_t Hash;
+        uint32_t Offset;   // into m_arena
+        uint32_t Id;       // 0: empty slot
+    };
+
+    void     MakeRoom(size_t names, std::vector<uint8_t>& out);
+    uint32_t Intern(const char* name, bool present, std::vector<uint8_t>& out);
+    void     ResetNames(std::vector<uint8_t>* out);
+
+    std::vector<NameSlot> m_names;   // open addressing, MaxNames * 2 slots
+    std::vector<char>     m_arena;
+    size_t                m_arenaUsed = 0;
+    size_t                m_nameCount = 0;
+    std::vector<uint8_t>  m_payload;   // record being built; keeps its capacity
+
+    uint64_t m_eventId = 0;          // previous record's values, for the deltas
+    uint64_t m_time = 0;
+    uint64_t m_srcAgent = 0;
+    uint64_t m_dstAgent = 0;
+    uint64_t m_srcId = 0;
+    uint64_t m_dstId = 0;
+    int64_t  m_joinTime = 0;
+};
+
+/// One decoded record: a combat callback or a squad update batch
+struct RecordingEntry
+{
+    enum EKind : uint8_t
+    {
+        Combat,
+        SquadUpdate
+    };
+
+    EKind                     Kind;
+    RecordedCombat            CombatData;   // Combat
+    std::vector<RecordedUser> Users;        // SquadUpdate
+};
+
+class RecordingReader
+{
+public:
+    /// Reads a whole recording file. False if it cannot be read or is not a recording.
+    bool Open(const std::string& path);
+
+    /// Same, from bytes already in memory (copied).
+    bool Open(const uint8_t* data, size_t size);
+
+    /// Next combat or squad record. False at the end of the data, or at a record that does not decode
+    /// (see Damaged); everything before it has been returned.
+    bool Next(RecordingEntry& out);
+
+    uint64_t StartedAtMs() const { return m_startedAtMs; }
+
+    /// True if reading stopped at a damaged or truncated record rather than the clean end.
+    bool Damaged() const { return m_damaged; }
+
+private:
+    bool DecodeCombat(const uint8_t*& p, const uint8_t* end, RecordedCombat& out);
+    bool DecodeSquad(const uint8_t*& p, const uint8_t* end, std::vector<RecordedUser>& out);
+    bool LookupName(uint64_t id, char* out, bool& present) const;
+
+    std::vector<uint8_t>     m_data;
+    size_t                   m_pos = 0;
+    uint64_t                 m_startedAtMs = 0;
+    bool                     m_damaged = false;
+    std::vector<std::string> m_names;   // index id - 1
+
+    uint64_t m_eventId = 0;
+    uint64_t m_time = 0;
+    uint64_t m_srcAgent = 0;
+    uint64_t m_dstAgent = 0;
+    uint64_t m_srcId = 0;
+    uint64_t m_dstId = 0;
+    int64_t  m_joinTime = 0;
+};
+
+#endif
@@ -0,0 +1,295 @@
+///----------------------------------------------------------------------------------------------------
+/// Combat Tracker - Killstreak, session stats, self identification, and player and squad alive state
+///                  from ArcDPS events
+///----------------------------------------------------------------------------------------------------
+
+#include "combat_tracker.h"
+
+#include "agent_table.h"
+#include "game_state.h"
+#include "state_block.h"
+#include "tracing.h"
+
+namespace
+{
+    // Squad agents seen through SQUAD_RAW; only touched by the thread running the handlers
+    AgentTable     g_agents;
+    uint64_t       g_selfId = 0;   // handler thread's copy; TrackedState::SelfId is published for readers
+    ThrottledGauge g_gauges[SelfGauge_Count];
+}
+
+///----------------------------------------------------------------------------------------------------
+/// IsSelf - True if the agent is us, either flagged by ArcDPS or matching the tracked self ID
+///----------------------------------------------------------------------------------------------------
+static bool IsSelf(bool present, bool flaggedSelf, uint64_t id)
+{
+    if (!present)
+        return false;
+    if (flaggedSelf)
+        return true;
+    return g_selfId != 0 && id == g_selfId;
+}
+
+static bool SrcIsSelf(const CombatRecord& record)
+{
+    return IsSelf((record.Flags & CombatRecord_HasSrc) != 0, record.SrcIsSelf(), record.SrcId);
+}
+
+static bool DstIsSelf(const CombatRecord& record)
+{
+    return IsSelf((record.Flags & CombatRecord_HasDst) != 0, record.DstIsSelf(), record.DstId);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// PublishVitals - Copy the agent table counts into the state block
+///----------------------------------------------------------------------------------------------------
+static uint32_t PublishVitals()
+{
+    SquadVitals vitals;
+    vitals.Alive = g_agents.Count(PlayerStatus::Alive);
+    vitals.Downed = g_agents.Count(PlayerStatus::Downed);
+    vitals.Dead = g_agents.Count(PlayerStatus::Dead);
+    StateBlock::Update([vitals](TrackedState& state) { state.Vitals = vitals; });
+    return CombatChange_SquadVitals;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// UpdateSquadAgent - Record an alive state change for a squad member
+///
+/// Only agents announced by the squad feed are members. Sharing our team proves nothing (WvW puts
+/// every allied player on it), so the one agent added here without an announcement is ourselves.
+///----------------------------------------------------------------------------------------------------
+static uint32_t UpdateSquadAgent(const CombatRecord& record, PlayerStatus status, bool self)
+{
+    if (g_agents.SetStatus(record.SrcId, status))
+        return PublishVitals();
+    if (!self || g_agents.Find(record.SrcId) || !IsPlayer(record.SrcProfession))
+        return CombatChange_None;
+
+    return g_agents.Set(record.SrcId, status, record.SrcProfession, record.SrcTeam)
+        ? PublishVitals() : CombatChange_None;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// CountsInWvW - Kills and downs only count in WvW (from the cached MumbleLink snapshot)
+///----------------------------------------------------------------------------------------------------
+static bool CountsInWvW(const char* what)
+{
+    bool inWvW = GameState::IsInWvW();
+    STREAMLINK_TRACE(ELogLevel_DEBUG, "%s: mapType=%u, mapId=%u, isWvW=%s", what,
+                     GameState::MapType(), GameState::MapId(), inWvW ? "true" : "false");
+    return inWvW;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// ByUsOnPlayer - We are the source and the target is an enemy player, not an NPC
+///----------------------------------------------------------------------------------------------------
+static bool ByUsOnPlayer(const CombatRecord& record)
+{
+    bool dstIsPlayer = (record.Flags & CombatRecord_HasDst) && IsPlayer(record.DstProfession);
+    return dstIsPlayer && SrcIsSelf(record);
+}
+
+uint32_t CombatTracker::OnAgentNotification(const CombatRecord& record)
+{
+    // Target changes arrive the same way; they neither add nor remove anyone
+    if (!(record.Flags & CombatRecord_HasSrc) || !record.IsTrackingNotification())
+        return CombatChange_None;
+
+    if (record.SrcIsSelf())
+    {
+        uint64_t selfId = record.SrcId;
+        g_selfId = selfId;
+        StateBlock::Update([selfId](TrackedState& state) { state.SelfId = selfId; });
+    }
+
+    // Only the squad feed announces squad members: one with a profession joined ArcDPS tracking,
+    // one with profession 0 left it
+    if (record.Source != CombatSource_Squad)
+        return CombatChange_None;
+
+    if (record.SrcProfession == 0)
+        return g_agents.Remove(record.SrcId) ? PublishVitals() : CombatChange_None;
+    if (!IsPlayer(record.SrcProfession) || g_agents.Find(record.SrcId))
+        return CombatChange_None;
+
+    return g_agents.Set(record.SrcId, PlayerStatus::Alive, record.SrcProfession, record.SrcTeam)
+        ? PublishVitals() : CombatChange_None;
+}
+
+uint32_t CombatTracker::OnStatusChange(const CombatRecord& record)
+{
+    PlayerStatus status = PlayerStatus::Alive;
+    if (record.IsStatechange == ArcDPS::CBTS_CHANGEDOWN)
+        status = PlayerStatus::Downed;
+    else if (record.IsStatechange == ArcDPS::CBTS_CHANGEDEAD)
+        status = PlayerStatus::Dead;
+
+    bool self = SrcIsSelf(record);
+    uint32_t changes = UpdateSquadAgent(record, status, self);
+    if (!self)
+        return changes;
+
+    bool death = false;
+    if (status == PlayerStatus::Dead && GameState::IsInWvW())
+    {
+        death = true;
+        changes |= CombatChange_Killstreak | CombatChange_Session;
+    }
+
+    // Status and stats change in the same update, so no reader sees dead with the old streak
+    StateBlock::Update([status, death](TrackedState& state)
+    {
+        state.Status = status;
+        if (death)
+            SessionStats::Apply(state.Session, SessionEvent_Death);
+    });
+
+    STREAMLINK_TRACE(ELogLevel_INFO, "Player status changed to: %s", StatusName(status));
+    return changes | CombatChange_PlayerStatus;
+}
+
+uint32_t CombatTracker::OnDespawn(const CombatRecord& record)
+{
+    return g_agents.Remove(record.SrcId) ? PublishVitals() : CombatChange_None;
+}
+
+uint32_t CombatTracker::OnKillingBlow(const CombatRecord& record)
+{
+    if (!CountsInWvW("KILLINGBLOW"))
+        return CombatChange_None;
+
+    uint32_t changes = CombatChange_None;
+
+    // Check if WE dealt the killing blow
+    bool byUs = ByUsOnPlayer(record);
+    if (byUs)
+        changes |= CombatChange_Killstreak | CombatChange_Kill | CombatChange_Session;
+
+    // Check if WE were killed (we are the target of a killing blow). The death itself is counted on
+    // CBTS_CHANGEDEAD; this only ends the streak right away.
+    // Note: Stomp deaths don't trigger KILLINGBLOW, only direct deaths do
+    bool killed = DstIsSelf(record);
+    if (killed)
+        changes |= CombatChange_Killstreak;
+
+    if (changes != CombatChange_None)
+    {
+        StateBlock::Update([byUs, killed](TrackedState& state)
+        {
+            if (byUs)
+                SessionStats::Apply(state.Session, SessionEvent_Kill);
+            if (killed)
+                SessionStats::Apply(state.Session, SessionEvent_StreakEnd);
+        });
+    }
+    return changes;
+}
+
+uint32_t CombatTracker::OnDowned(const CombatRecord& record)
+{
+    if (!CountsInWvW("DOWNED") || !ByUsOnPlayer(record))
+        return CombatChange_None;
+
+    StateBlock::Update([](TrackedState& state) { SessionStats::Apply(state.Session, SessionEvent_EnemyDowned); });
+    return CombatChange_Session | CombatChange_EnemyDowned;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// OnGaugeUpdate - Our health or barrier percentage (x100, in dst_agent) changed. SQUAD_RAW sends these
+///                 for every squad member; only ours is kept.
+///----------------------------------------------------------------------------------------------------
+uint32_t CombatTracker::OnGaugeUpdate(const CombatRecord& record)
+{
+    if (!SrcIsSelf(record))
+        return CombatChange_None;
+
+    ESelfGauge gauge = record.IsStatechange == ArcDPS::CBTS_BARRIERPCTUPDATE ? SelfGauge_Barrier : SelfGauge_Health;
+    g_gauges[gauge].Set(static_cast<uint32_t>(record.DstAgent < ThrottledGauge::Full ? record.DstAgent
+                                                                                     : ThrottledGauge::Full));
+    return CombatChange_None;
+}
+
+uint32_t CombatTracker::OutgoingDamage(const CombatRecord& record)
+{
+    if (!record.HasEvent() || record.IsStatechange || record.IsActivation || record.IsBuffRemove)
+        return 0;
+    if (record.DstIsSelf() || !SrcIsSelf(record))
+        return 0;
+
+    // Condition ticks carry their damage in buff_dmg (result 0 means it landed); strikes in value
+    int32_t damage = record.Buff ? (record.Result == 0 ? record.BuffDamage : 0) : record.Value;
+    return damage > 0 ? static_cast<uint32_t>(damage) : 0;
+}
+
+uint32_t CombatTracker::KillCount()
+{
+    return StateBlock::Read().Session.Get(SessionStat_CurrentStreak);
+}
+
+SessionCounters CombatTracker::Session()
+{
+    return StateBlock::Read().Session;
+}
+
+PlayerStatus CombatTracker::Status()
+{
+    return StateBlock::Read().Status;
+}
+
+SquadVitals CombatTracker::Vitals()
+{
+    return StateBlock::Read().Vitals;
+}
+
+uintptr_t CombatTracker::SelfId()
+{
+    return static_cast<uintptr_t>(StateBlock::Read().SelfId);
+}
+
+ThrottledGauge& CombatTracker::Gauge(ESelfGauge gauge)
+{
+    return g_gauges[gauge];
+}
+
+const char* CombatTracker::StatusName(PlayerStatus status)
+{
+    switch (status)
+    {
+        case PlayerStatus::Downed: return "downed";
+        case PlayerStatus::Dead:   return "dead";
+        default:                   return "alive";
+    }
+}
+
+uint32_t CombatTracker::ResetKillstreak()
+{
+    uint32_t previous = 0;
+    StateBlock::Update([&previous](TrackedState& state)
+    {
+        previous = state.Session.Get(SessionStat_CurrentStreak);
+        SessionStats::Apply(state.Session, SessionEvent_StreakEnd);
+    });
+    return previous != 0 ? CombatChange_Killstreak : CombatChange_None;
+}
+
+uint32_t CombatTracker::RestoreSession(const SessionCounters& session)
+{
+    StateBlock::Update([&session](TrackedState& state) { state.Session = session; });
+    return CombatChange_Killstreak | CombatChange_Session;
+}
+
+void CombatTracker::Reset()
+{
+    StateBlock::Update([](TrackedState& state)
+    {
+        state.Session = SessionCounters();
+        state.Status = PlayerStatus::Alive;
+        state.SelfId = 0;
+        state.Vitals = SquadVitals();
+    });
+    g_agents.Clear();
+    g_selfId = 0;
+    for (ThrottledGauge& gauge : g_gauges)
+        gauge.Reset();
+}
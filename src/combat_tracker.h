@@ -0,0 +1,93 @@
+///----------------------------------------------------------------------------------------------------
+/// Combat Tracker - Killstreak, session stats, self identification, and player and squad alive state
+///                  from ArcDPS events
+///
+/// Pure state machine: handlers update the tracked state and report what changed, the caller decides
+/// which outputs to refresh. The state itself lives in the state block (state_block.h), so the
+/// queries below are lock-free snapshots. Per-agent squad state is kept in an AgentTable owned by the
+/// thread calling the handlers; only its counts are published.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_COMBAT_TRACKER_H
+#define STREAMLINK_COMBAT_TRACKER_H
+
+#include <cstdint>
+
+#include "combat_record.h"
+#include "session_stats.h"
+#include "throttled_gauge.h"
+
+enum class PlayerStatus : uint8_t
+{
+    Alive,
+    Downed,
+    Dead
+};
+
+/// Squad members (self included) in each alive state
+struct SquadVitals
+{
+    uint32_t Alive = 0;
+    uint32_t Downed = 0;
+    uint32_t Dead = 0;
+};
+
+/// Our own percentages, stored as they arrive and flushed on a timer (see throttled_gauge.h)
+enum ESelfGauge : uint32_t
+{
+    SelfGauge_Health,    // CBTS_HEALTHPCTUPDATE
+    SelfGauge_Barrier,   // CBTS_BARRIERPCTUPDATE
+    SelfGauge_Count
+};
+
+/// Bit flags returned by the handlers
+enum ECombatChange : uint32_t
+{
+    CombatChange_None         = 0,
+    CombatChange_Killstreak   = 1 << 0,   // killstreak count changed (kill or reset)
+    CombatChange_Kill         = 1 << 1,   // a kill was added to the streak
+    CombatChange_PlayerStatus = 1 << 2,   // alive/downed/dead changed
+    CombatChange_Session      = 1 << 3,   // a session stat (kills, deaths, downs, best streak) changed
+    CombatChange_EnemyDowned  = 1 << 4,   // we downed an enemy player
+    CombatChange_SquadVitals  = 1 << 5    // squad alive/downed/dead counts changed
+};
+
+namespace CombatTracker
+{
+    /// Handlers for the combat dispatcher (combat_dispatch.h). Each gets every record of its kind
+    /// once, whichever feed delivered it.
+    uint32_t OnAgentNotification(const CombatRecord& record);   // null ev: self id, squad agent tracking
+    uint32_t OnStatusChange(const CombatRecord& record);        // CBTS_CHANGEUP / CHANGEDOWN / CHANGEDEAD
+    uint32_t OnDespawn(const CombatRecord& record);             // CBTS_DESPAWN
+    uint32_t OnKillingBlow(const CombatRecord& record);         // CBTR_KILLINGBLOW: kills, killed
+    uint32_t OnDowned(const CombatRecord& record);              // CBTR_DOWNED: enemies we downed
+    uint32_t OnGaugeUpdate(const CombatRecord& record);         // CBTS_HEALTHPCTUPDATE / BARRIERPCTUPDATE
+
+    /// Strike or condition damage the record says we dealt, 0 for anything else.
+    uint32_t OutgoingDamage(const CombatRecord& record);
+
+    uint32_t     KillCount();   // current streak
+    SessionCounters Session();
+    PlayerStatus Status();
+    SquadVitals  Vitals();
+    uintptr_t    SelfId();
+
+    /// Our health or barrier percentage. The handlers only Set it; the output side polls it.
+    ThrottledGauge& Gauge(ESelfGauge gauge);
+
+    /// Text written to the player status output.
+    const char*  StatusName(PlayerStatus status);
+
+    /// Ends the current streak (e.g. on leaving WvW). Returns CombatChange_Killstreak if it was not
+    /// already zero.
+    uint32_t ResetKillstreak();
+
+    /// Carries on a session restored from the journal. Returns CombatChange_Killstreak and
+    /// CombatChange_Session.
+    uint32_t RestoreSession(const SessionCounters& session);
+
+    /// Back to an empty session, alive, unknown self and gauges, no squad agents.
+    void Reset();
+}
+
+#endif
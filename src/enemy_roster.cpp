@@ -0,0 +1,267 @@
+///----------------------------------------------------------------------------------------------------
+/// Enemy Roster - Enemy players in range, counted per team, with lost despawns aged out
+///----------------------------------------------------------------------------------------------------
+
+#include "enemy_roster.h"
+
+#include "open_addressing.h"
+
+static_assert(EnemyRoster::MaxAgents < 0xFFFF, "pool indices are stored in a uint16_t");
+static_assert(EnemyRoster::WheelSlots <= 256, "wheel slots are stored in a uint8_t");
+
+static constexpr size_t NotFound = EnemyRoster::TableSize;
+
+EnemyRoster::EnemyRoster(uint32_t timeoutMs)
+{
+    constexpr uint32_t MaxTimeoutMs = (WheelSlots - 2) * TickMs;
+    m_timeoutMs = timeoutMs < MaxTimeoutMs ? timeoutMs : MaxTimeoutMs;
+    Clear();
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Home - Preferred table slot of an agent id, spread with a Fibonacci multiply (top bits)
+///----------------------------------------------------------------------------------------------------
+size_t EnemyRoster::Home(uint64_t id)
+{
+    constexpr unsigned Shift = 64 - 10;
+    static_assert((size_t(1) << (64 - Shift)) == TableSize, "shift must match the table size");
+    return static_cast<size_t>((id * 0x9E3779B97F4A7C15ull) >> Shift);
+}
+
+bool EnemyRoster::IsUsed(uint16_t slot)
+{
+    return slot != None;
+}
+
+size_t EnemyRoster::FindSlot(uint64_t id) const
+{
+    return OpenAddressing::Find(m_slots, Home(id), IsUsed,
+                                [this, id](uint16_t index) { return m_agents[index].id == id; });
+}
+
+void EnemyRoster::RemoveSlot(size_t slot)
+{
+    OpenAddressing::Erase(m_slots, slot, IsUsed,
+                          [this](uint16_t index) { return Home(m_agents[index].id); },
+                          [](uint16_t& emptied) { emptied = None; });
+}
+
+///----------------------------------------------------------------------------------------------------
+/// TeamSlot - Index of the team's count slot, optionally claiming an empty one; -1 if none
+///----------------------------------------------------------------------------------------------------
+int EnemyRoster::TeamSlot(uint16_t team, bool create)
+{
+    int empty = -1;
+    for (size_t t = 0; t < MaxTeams; t++)
+    {
+        if (m_teams[t].Count == 0)
+        {
+            if (empty < 0)
+                empty = static_cast<int>(t);
+            continue;
+        }
+        if (m_teams[t].Team == team)
+            return static_cast<int>(t);
+    }
+    if (!create || empty < 0)
+        return -1;
+
+    m_teams[empty].Team = team;
+    return empty;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// DueTick - First wheel tick at which the agent has gone a whole timeout without being seen
+///----------------------------------------------------------------------------------------------------
+uint64_t EnemyRoster::DueTick(const Agent& agent) const
+{
+    return (agent.lastSeen + m_timeoutMs) / TickMs + 1;
+}
+
+void EnemyRoster::Link(uint16_t index, uint64_t tick)
+{
+    // Anything due at or before the current tick is looked at on the next one
+    if (tick <= m_tick)
+        tick = m_tick + 1;
+
+    Agent& agent = m_agents[index];
+    agent.wheelSlot = static_cast<uint8_t>(tick % WheelSlots);
+    agent.prev = None;
+    agent.next = m_wheel[agent.wheelSlot];
+    if (agent.next != None)
+        m_agents[agent.next].prev = index;
+    m_wheel[agent.wheelSlot] = index;
+}
+
+void EnemyRoster::Unlink(uint16_t index)
+{
+    Agent& agent = m_agents[index];
+    if (agent.prev != None)
+        m_agents[agent.prev].next = agent.next;
+    else
+        m_wheel[agent.wheelSlot] = agent.next;
+    if (agent.next != None)
+        m_agents[agent.next].prev = agent.prev;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Release - Return an agent already removed from the table to the pool
+///----------------------------------------------------------------------------------------------------
+void EnemyRoster::Release(uint16_t index)
+{
+    Unlink(index);
+    m_teams[m_agents[index].teamSlot].Count--;
+    m_freeAgents[m_freeCount++] = index;
+    m_size--;
+}
+
+bool EnemyRoster::Seen(uint64_t id, uint16_t team, uint64_t timeMs)
+{
+    if (!m_started)
+    {
+        m_tick = timeMs / TickMs;
+        m_started = true;
+    }
+
+    size_t found = FindSlot(id);
+    if (found != NotFound)
+    {
+        // Only the last-seen time moves; the wheel re-files the agent when its old slot comes round
+        Agent& agent = m_agents[m_slots[found]];
+        if (timeMs > agent.lastSeen)
+            agent.lastSeen = timeMs;
+        if (m_teams[agent.teamSlot].Team == team)
+            return false;
+
+        int slot = TeamSlot(team, true);
+        if (slot < 0)
+            return false;
+        m_teams[agent.teamSlot].Count--;
+        m_teams[slot].Count++;
+        agent.teamSlot = static_cast<uint8_t>(slot);
+        return true;
+    }
+
+    if (m_freeCount == 0)
+        return false;
+    int teamSlot = TeamSlot(team, true);
+    if (teamSlot < 0)
+        return false;
+
+    uint16_t index = m_freeAgents[--m_freeCount];
+    Agent& agent = m_agents[index];
+    agent.id = id;
+    agent.lastSeen = timeMs;
+    agent.teamSlot = static_cast<uint8_t>(teamSlot);
+    m_teams[teamSlot].Count++;
+
+    m_slots[OpenAddressing::FreeSlot(m_slots, Home(id), IsUsed)] = index;
+
+    Link(index, DueTick(agent));
+    m_size++;
+    return true;
+}
+
+bool EnemyRoster::Remove(uint64_t id)
+{
+    size_t found = FindSlot(id);
+    if (found == NotFound)
+        return false;
+
+    uint16_t index = m_slots[found];
+    RemoveSlot(found);
+    Release(index);
+    return true;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// ProcessTick - Evict the agents in this tick's slot that are due, re-file the ones seen since
+///----------------------------------------------------------------------------------------------------
+void EnemyRoster::ProcessTick(uint64_t tick, size_t& evicted)
+{
+    uint32_t slot = static_cast<uint32_t>(tick % WheelSlots);
+    uint16_t index = m_wheel[slot];
+    while (index != None)
+    {
+        Agent& agent = m_agents[index];
+        uint16_t next = agent.next;
+        uint64_t due = DueTick(agent);
+        if (due <= tick)
+        {
+            RemoveSlot(FindSlot(agent.id));
+            Release(index);
+            evicted++;
+        }
+        else if (due % WheelSlots != slot)
+        {
+            Unlink(index);
+            Link(index, due);
+        }
+        index = next;
+    }
+}
+
+size_t EnemyRoster::Expire(uint64_t nowMs)
+{
+    uint64_t nowTick = nowMs / TickMs;
+    if (!m_started)
+    {
+        m_tick = nowTick;
+        m_started = true;
+        return 0;
+    }
+
+    // After a long gap each slot only needs looking at once
+    if (nowTick > m_tick + WheelSlots)
+        m_tick = nowTick - WheelSlots;
+
+    size_t evicted = 0;
+    while (m_tick < nowTick)
+    {
+        m_tick++;
+        ProcessTick(m_tick, evicted);
+    }
+    return evicted;
+}
+
+bool EnemyRoster::Contains(uint64_t id) const
+{
+    return FindSlot(id) != NotFound;
+}
+
+uint32_t EnemyRoster::TeamCount(uint16_t team) const
+{
+    for (const EnemyTeamCount& count : m_teams)
+    {
+        if (count.Count != 0 && count.Team == team)
+            return count.Count;
+    }
+    return 0;
+}
+
+size_t EnemyRoster::Teams(EnemyTeamCount* out, size_t capacity) const
+{
+    size_t written = 0;
+    for (const EnemyTeamCount& count : m_teams)
+    {
+        if (count.Count != 0 && written < capacity)
+            out[written++] = count;
+    }
+    return written;
+}
+
+void EnemyRoster::Clear()
+{
+    for (size_t i = 0; i < TableSize; i++)
+        m_slots[i] = None;
+    for (uint32_t s = 0; s < WheelSlots; s++)
+        m_wheel[s] = None;
+    for (size_t i = 0; i < MaxAgents; i++)
+        m_freeAgents[i] = static_cast<uint16_t>(MaxAgents - 1 - i);
+    for (EnemyTeamCount& count : m_teams)
+        count = EnemyTeamCount();
+    m_freeCount = MaxAgents;
+    m_tick = 0;
+    m_started = false;
+    m_size = 0;
+}
@@ -0,0 +1,98 @@
+///----------------------------------------------------------------------------------------------------
+/// Enemy Roster - Enemy players in range, counted per team, with lost despawns aged out
+///
+/// Agents live in a fixed pool; an open-addressing table (linear probing, backward-shift deletion)
+/// maps AgentShort::ID to a pool index, and a handful of team slots hold the per-team counts, which
+/// are adjusted on every insert, team change and removal. Every agent also sits on one list of a
+/// timer wheel, in the slot of the tick it is due to expire. Seeing an agent again only moves its
+/// last-seen time; when its slot comes round, the wheel either evicts it or re-files it under its new
+/// due tick. So every operation is O(1) amortised and nothing ever scans the whole roster.
+/// Not thread-safe; the owner serialises access.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_ENEMY_ROSTER_H
+#define STREAMLINK_ENEMY_ROSTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct EnemyTeamCount
+{
+    uint16_t Team = 0;
+    uint32_t Count = 0;
+};
+
+class EnemyRoster
+{
+public:
+    static constexpr size_t   MaxAgents = 512;          // zerg fights reach a few hundred players
+    static constexpr size_t   TableSize = MaxAgents * 2;
+    static constexpr size_t   MaxTeams = 8;              // WvW has three; spare slots for stale team ids
+    static constexpr uint32_t WheelSlots = 64;
+    static constexpr uint32_t TickMs = 1000;
+
+    /// Agents not seen for timeoutMs are dropped. The timeout must fit on the wheel (WheelSlots - 2
+    /// ticks at most) and is clamped to it.
+    explicit EnemyRoster(uint32_t timeoutMs = 30000);
+
+    /// An enemy player was seen at timeMs: added, or its team and last-seen time refreshed. Returns
+    /// true if a count changed. New agents are ignored when the pool or the team slots are full.
+    bool Seen(uint64_t id, uint16_t team, uint64_t timeMs);
+
+    /// Forgets the agent (despawn, moved to our team). Returns true if it was in the roster.
+    bool Remove(uint64_t id);
+
+    /// Moves the wheel to nowMs and drops every agent not seen within the timeout. Returns the number
+    /// dropped.
+    size_t Expire(uint64_t nowMs);
+
+    bool Contains(uint64_t id) const;
+
+    size_t Size() const { return m_size; }
+
+    /// Agents on one team.
+    uint32_t TeamCount(uint16_t team) const;
+
+    /// Copies the non-empty team counts into out, returns how many were written.
+    size_t Teams(EnemyTeamCount* out, size_t capacity) const;
+
+    void Clear();
+
+private:
+    static constexpr uint16_t None = 0xFFFF;
+
+    struct Agent
+    {
+        uint64_t id;
+        uint64_t lastSeen;
+        uint16_t prev;       // timer wheel list links (pool indices)
+        uint16_t next;
+        uint8_t  wheelSlot;
+        uint8_t  teamSlot;
+    };
+
+    static size_t Home(uint64_t id);
+    static bool   IsUsed(uint16_t slot);
+
+    size_t   FindSlot(uint64_t id) const;
+    void     RemoveSlot(size_t slot);
+    int      TeamSlot(uint16_t team, bool create);
+    uint64_t DueTick(const Agent& agent) const;
+    void     Link(uint16_t index, uint64_t tick);
+    void     Unlink(uint16_t index);
+    void     Release(uint16_t index);
+    void     ProcessTick(uint64_t tick, size_t& evicted);
+
+    Agent          m_agents[MaxAgents];
+    uint16_t       m_freeAgents[MaxAgents];
+    size_t         m_freeCount;
+    uint16_t       m_slots[TableSize];     // pool index, or None
+    uint16_t       m_wheel[WheelSlots];    // head of each wheel list, or None
+    EnemyTeamCount m_teams[MaxTeams];
+    uint64_t       m_tick;                 // last tick the wheel has processed
+    bool           m_started;
+    uint32_t       m_timeoutMs;
+    size_t         m_size;
+};
+
+#endif
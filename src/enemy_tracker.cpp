@@ -0,0 +1,152 @@
+///----------------------------------------------------------------------------------------------------
+/// Enemy Tracker - Enemy players in range in WvW, per team, from ArcDPS spawn, despawn, team and IFF
+///                 information
+///----------------------------------------------------------------------------------------------------
+
+#include "enemy_tracker.h"
+
+#include <mutex>
+
+#include "game_state.h"
+
+namespace
+{
+    std::mutex  g_mutex;
+    EnemyRoster g_roster(EnemyTracker::TimeoutMs);
+    uint16_t    g_selfTeam = 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// SetSelfTeam - Our team changed: enemies were judged against the old one, so start over
+///----------------------------------------------------------------------------------------------------
+static bool SetSelfTeam(uint16_t team)
+{
+    if (team == 0 || team == g_selfTeam)
+        return false;
+
+    g_selfTeam = team;
+    bool hadEnemies = g_roster.Size() != 0;
+    g_roster.Clear();
+    return hadEnemies;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// SeeAgent - Add or refresh one side of a record if it is an enemy player
+///
+/// foeOfSelf is set when the record is a foe event whose other side is us, which identifies an enemy
+/// even before our own team is known.
+///----------------------------------------------------------------------------------------------------
+static bool SeeAgent(uint64_t id, uint32_t profession, uint16_t team, bool foeOfSelf, uint64_t time)
+{
+    if (id == 0 || team == 0 || !IsPlayer(profession))
+        return false;
+
+    bool enemy = g_selfTeam != 0 ? team != g_selfTeam : foeOfSelf;
+    if (!enemy)
+        return g_roster.Remove(id);
+    return g_roster.Seen(id, team, time);
+}
+
+bool EnemyTracker::OnRecord(const CombatRecord& record)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    if (!GameState::IsInWvW())
+    {
+        bool hadEnemies = g_roster.Size() != 0;
+        g_roster.Clear();
+        return hadEnemies;
+    }
+
+    bool hasSrc = (record.Flags & CombatRecord_HasSrc) != 0;
+    bool hasDst = (record.Flags & CombatRecord_HasDst) != 0;
+    bool changed = false;
+    if (hasSrc && record.SrcIsSelf())
+        changed |= SetSelfTeam(record.SrcTeam);
+    if (hasDst && record.DstIsSelf())
+        changed |= SetSelfTeam(record.DstTeam);
+
+    // Agent notifications carry no event time; spawns and events below cover the same agents
+    if (!record.HasEvent() || !hasSrc)
+        return changed;
+
+    switch (record.IsStatechange)
+    {
+        case ArcDPS::CBTS_NONE:
+        {
+            bool foe = record.Iff == ArcDPS::IFF_FOE;
+            changed |= SeeAgent(record.SrcId, record.SrcProfession, record.SrcTeam, foe && record.DstIsSelf(),
+                                record.Time);
+            if (hasDst)
+            {
+                changed |= SeeAgent(record.DstId, record.DstProfession, record.DstTeam, foe && record.SrcIsSelf(),
+                                    record.Time);
+            }
+            break;
+        }
+        case ArcDPS::CBTS_DESPAWN:
+            changed |= g_roster.Remove(record.SrcId);
+            break;
+        case ArcDPS::CBTS_TEAMCHANGE:
+        {
+            // The new team id is carried in dst_agent
+            uint16_t team = static_cast<uint16_t>(record.DstAgent);
+            if (record.SrcIsSelf())
+                changed |= SetSelfTeam(team);
+            else
+                changed |= SeeAgent(record.SrcId, record.SrcProfession, team, false, record.Time);
+            break;
+        }
+        default:
+            // Spawns, state changes, position updates: all say the agent is still around
+            changed |= SeeAgent(record.SrcId, record.SrcProfession, record.SrcTeam, false, record.Time);
+            break;
+    }
+    return changed;
+}
+
+bool EnemyTracker::Tick(uint64_t nowMs)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    if (!GameState::IsInWvW())
+    {
+        bool hadEnemies = g_roster.Size() != 0;
+        g_roster.Clear();
+        return hadEnemies;
+    }
+    return nowMs != 0 && g_roster.Expire(nowMs) != 0;
+}
+
+uint32_t EnemyTracker::Total()
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return static_cast<uint32_t>(g_roster.Size());
+}
+
+size_t EnemyTracker::Teams(EnemyTeamCount* out, size_t capacity)
+{
+    size_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        count = g_roster.Teams(out, capacity);
+    }
+
+    // At most MaxTeams entries, so a plain insertion sort
+    for (size_t i = 1; i < count; i++)
+    {
+        EnemyTeamCount entry = out[i];
+        size_t j = i;
+        for (; j > 0 && out[j - 1].Count < entry.Count; j--)
+            out[j] = out[j - 1];
+        out[j] = entry;
+    }
+    return count;
+}
+
+void EnemyTracker::Reset()
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_roster.Clear();
+    g_selfTeam = 0;
+}
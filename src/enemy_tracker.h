@@ -0,0 +1,43 @@
+///----------------------------------------------------------------------------------------------------
+/// Enemy Tracker - Enemy players in range in WvW, per team, from ArcDPS spawn, despawn, team and IFF
+///                 information
+///
+/// Feeds an EnemyRoster from every combat record: CBTS_SPAWN and any event involving an enemy player
+/// add or refresh it, CBTS_DESPAWN removes it, CBTS_TEAMCHANGE moves it between teams (or out of the
+/// roster when it joins ours). A player is an enemy when its team differs from ours, or when a foe
+/// event links it to us before our team is known. Agents whose despawn was lost age out on the
+/// roster's timer wheel. The event queue worker feeds it; renderers and the writer tick read it, under
+/// a small mutex.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_ENEMY_TRACKER_H
+#define STREAMLINK_ENEMY_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "combat_record.h"
+#include "enemy_roster.h"
+
+namespace EnemyTracker
+{
+    /// Seconds without any event from an enemy before it is assumed gone.
+    constexpr uint32_t TimeoutMs = 30000;
+
+    /// Handles one record from either subscription. Returns true if any count changed.
+    bool OnRecord(const CombatRecord& record);
+
+    /// Ages out enemies not seen since nowMs - TimeoutMs (event time), and empties the roster outside
+    /// WvW. Returns true if any count changed.
+    bool Tick(uint64_t nowMs);
+
+    /// Enemy players currently tracked.
+    uint32_t Total();
+
+    /// Non-empty per-team counts, largest first. Returns how many were written.
+    size_t Teams(EnemyTeamCount* out, size_t capacity);
+
+    void Reset();
+}
+
+#endif
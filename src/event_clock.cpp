@@ -0,0 +1,53 @@
+///----------------------------------------------------------------------------------------------------
+/// Event Clock - The ArcDPS event time (ev->Time, milliseconds) as of now
+///----------------------------------------------------------------------------------------------------
+
+#include "event_clock.h"
+
+#include <chrono>
+
+#include "seqlock.h"
+
+namespace
+{
+    struct ClockSample
+    {
+        uint64_t EventTimeMs = 0;
+        int64_t  SeenAtMs = 0;   // steady clock when that event time was observed
+    };
+
+    Seqlock<ClockSample> g_sample;
+
+    int64_t SteadyMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+void EventClock::Observe(uint64_t eventTimeMs)
+{
+    int64_t seenAt = SteadyMs();
+    g_sample.Update([eventTimeMs, seenAt](ClockSample& sample)
+    {
+        if (eventTimeMs < sample.EventTimeMs)
+            return;
+        sample.EventTimeMs = eventTimeMs;
+        sample.SeenAtMs = seenAt;
+    });
+}
+
+uint64_t EventClock::Now()
+{
+    ClockSample sample = g_sample.Load();
+    if (sample.EventTimeMs == 0)
+        return 0;
+
+    int64_t elapsed = SteadyMs() - sample.SeenAtMs;
+    return sample.EventTimeMs + static_cast<uint64_t>(elapsed > 0 ? elapsed : 0);
+}
+
+void EventClock::Reset()
+{
+    g_sample.Store(ClockSample());
+}
@@ -0,0 +1,26 @@
+///----------------------------------------------------------------------------------------------------
+/// Event Clock - The ArcDPS event time (ev->Time, milliseconds) as of now
+///
+/// ArcDPS stamps every event, but nothing arrives between fights. The event queue worker observes the
+/// newest event time of each batch together with the local steady clock; Now() extrapolates from that
+/// sample, so time-windowed state (rates, roster aging) keeps moving while the game is quiet. The
+/// sample sits in a seqlock, so any thread can read it without a lock.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_EVENT_CLOCK_H
+#define STREAMLINK_EVENT_CLOCK_H
+
+#include <cstdint>
+
+namespace EventClock
+{
+    /// An event with this time was just processed. Older times are ignored.
+    void Observe(uint64_t eventTimeMs);
+
+    /// Newest event time seen plus the wall time elapsed since it arrived. 0 before the first event.
+    uint64_t Now();
+
+    void Reset();
+}
+
+#endif
@@ -0,0 +1,104 @@
+///----------------------------------------------------------------------------------------------------
+/// Event Dedup - Drops the second copy of a combat event delivered through both ArcDPS feeds
+///----------------------------------------------------------------------------------------------------
+
+#include "event_dedup.h"
+
+#include <cstring>
+
+static_assert((EventDedup::Sets & (EventDedup::Sets - 1)) == 0, "set count must be a power of two");
+
+EventDedup::EventDedup()
+{
+    Clear();
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Mix - Fold one field into the fingerprint (multiply-xorshift, as in splitmix64)
+///----------------------------------------------------------------------------------------------------
+static uint64_t Mix(uint64_t hash, uint64_t value)
+{
+    hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    hash ^= hash >> 31;
+    hash *= 0xBF58476D1CE4E5B9ull;
+    return hash ^ (hash >> 29);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Fingerprint - Identity of an event, the same for both feeds' copies. The ArcDPS event id and the
+///               self flags are left out: they are per-feed.
+///----------------------------------------------------------------------------------------------------
+uint64_t EventDedup::Fingerprint(const CombatRecord& record)
+{
+    uint64_t kind = static_cast<uint64_t>(record.IsStatechange)
+        | static_cast<uint64_t>(record.Result) << 8
+        | static_cast<uint64_t>(record.Buff) << 16
+        | static_cast<uint64_t>(record.IsActivation) << 24
+        | static_cast<uint64_t>(record.IsBuffRemove) << 32;
+
+    uint64_t hash = Mix(0, record.Time);
+    hash = Mix(hash, record.SrcId);
+    hash = Mix(hash, record.DstId);
+    hash = Mix(hash, kind);
+    hash = Mix(hash, record.SkillId);
+    hash = Mix(hash, static_cast<uint32_t>(record.Value));
+    hash = Mix(hash, static_cast<uint32_t>(record.BuffDamage));
+    return Mix(hash, record.DstAgent);
+}
+
+bool EventDedup::Accept(const CombatRecord& record)
+{
+    if (!record.HasEvent())
+        return true;
+
+    uint64_t fingerprint = Fingerprint(record);
+    Set& set = m_sets[(fingerprint >> 32) & (Sets - 1)];
+    size_t self = record.Source == CombatSource_Squad ? 1 : 0;
+    size_t other = 1 - self;
+
+    Way* way = nullptr;
+    Way* free = nullptr;
+    for (Way& candidate : set.ways)
+    {
+        if (candidate.pending[0] == 0 && candidate.pending[1] == 0)
+        {
+            if (!free)
+                free = &candidate;
+            continue;
+        }
+        if (candidate.fingerprint == fingerprint)
+        {
+            way = &candidate;
+            break;
+        }
+    }
+
+    if (way && way->pending[other] > 0)
+    {
+        way->pending[other]--;
+        m_duplicates++;
+        return false;
+    }
+
+    if (!way)
+    {
+        way = free;
+        if (!way)
+        {
+            way = &set.ways[set.next];
+            set.next = static_cast<uint8_t>((set.next + 1) % Ways);
+        }
+        way->fingerprint = fingerprint;
+        way->pending[0] = 0;
+        way->pending[1] = 0;
+    }
+    if (way->pending[self] != UINT16_MAX)
+        way->pending[self]++;
+    return true;
+}
+
+void EventDedup::Clear()
+{
+    memset(m_sets, 0, sizeof(m_sets));
+    m_duplicates = 0;
+}
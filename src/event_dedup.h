@@ -0,0 +1,61 @@
+///----------------------------------------------------------------------------------------------------
+/// Event Dedup - Drops the second copy of a combat event delivered through both ArcDPS feeds
+///
+/// LOCAL_RAW and SQUAD_RAW overlap: anything involving us (our kills, our downs, our damage, our own
+/// state changes) arrives on both, in no fixed order. Each event is fingerprinted from the fields that
+/// identify it (time, agents, skill, result or state change, amounts) into a small 4-way
+/// set-associative table that remembers, per feed, how many copies of that fingerprint are still
+/// waiting for their twin. A copy whose twin from the other feed is waiting is a duplicate and consumes
+/// it; anything else is accepted and waits in turn. So an event is accepted once however the feeds interleave, while the
+/// same event repeated on a single feed (multi-hit skills in the same millisecond) is still counted
+/// each time. A full set reuses its oldest way, forgetting that fingerprint; the table only has to
+/// outlast the gap between the two deliveries, which is a few events.
+/// Not thread-safe; the owner serialises access.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_EVENT_DEDUP_H
+#define STREAMLINK_EVENT_DEDUP_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "combat_record.h"
+
+class EventDedup
+{
+public:
+    static constexpr size_t Ways = 4;
+    static constexpr size_t Sets = 512;
+
+    EventDedup();
+
+    /// True if the record should be handled, false if it is the other feed's copy of an event already
+    /// accepted. Agent notifications (no ev) carry different meanings on each feed and are always
+    /// accepted.
+    bool Accept(const CombatRecord& record);
+
+    /// Copies dropped since the last Clear.
+    uint64_t Duplicates() const { return m_duplicates; }
+
+    void Clear();
+
+    static uint64_t Fingerprint(const CombatRecord& record);
+
+private:
+    struct Way
+    {
+        uint64_t fingerprint;
+        uint16_t pending[2];    // per ECombatSource: copies accepted and not yet matched
+    };
+
+    struct Set
+    {
+        Way     ways[Ways];
+        uint8_t next;           // way to reuse when none is free (round robin, so the oldest)
+    };
+
+    Set      m_sets[Sets];
+    uint64_t m_duplicates;
+};
+
+#endif
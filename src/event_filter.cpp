@@ -0,0 +1,427 @@
+///----------------------------------------------------------------------------------------------------
+/// Event Filter - Boolean expressions over combat record fields, compiled to a flat test table
+///----------------------------------------------------------------------------------------------------
+
+#include "event_filter.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    // Flipping the sign bit maps signed order onto unsigned order, so one compare covers both
+    constexpr uint64_t SignBias = uint64_t(1) << 63;
+
+    // Literals are limited to what the record fields can hold, so low - 1 and high + 1 never overflow
+    constexpr int64_t MinLiteral = INT32_MIN;
+    constexpr int64_t MaxLiteral = UINT32_MAX;
+
+    struct NamedValue
+    {
+        const char* name;
+        int64_t     value;
+    };
+
+    const NamedValue Results[] = {
+        {"NORMAL", ArcDPS::CBTR_NORMAL},           {"CRIT", ArcDPS::CBTR_CRIT},
+        {"GLANCE", ArcDPS::CBTR_GLANCE},           {"BLOCK", ArcDPS::CBTR_BLOCK},
+        {"EVADE", ArcDPS::CBTR_EVADE},             {"INTERRUPT", ArcDPS::CBTR_INTERRUPT},
+        {"ABSORB", ArcDPS::CBTR_ABSORB},           {"BLIND", ArcDPS::CBTR_BLIND},
+        {"KILLINGBLOW", ArcDPS::CBTR_KILLINGBLOW}, {"DOWNED", ArcDPS::CBTR_DOWNED},
+        {"BREAKBAR", ArcDPS::CBTR_BREAKBAR},       {"ACTIVATION", ArcDPS::CBTR_ACTIVATION},
+        {"CROWDCONTROL", ArcDPS::CBTR_CROWDCONTROL},
+        {nullptr, 0},
+    };
+
+    const NamedValue Statechanges[] = {
+        {"NONE", ArcDPS::CBTS_NONE},
+        {"ENTERCOMBAT", ArcDPS::CBTS_ENTERCOMBAT},           {"EXITCOMBAT", ArcDPS::CBTS_EXITCOMBAT},
+        {"CHANGEUP", ArcDPS::CBTS_CHANGEUP},                 {"CHANGEDEAD", ArcDPS::CBTS_CHANGEDEAD},
+        {"CHANGEDOWN", ArcDPS::CBTS_CHANGEDOWN},             {"SPAWN", ArcDPS::CBTS_SPAWN},
+        {"DESPAWN", ArcDPS::CBTS_DESPAWN},                   {"HEALTHPCTUPDATE", ArcDPS::CBTS_HEALTHPCTUPDATE},
+        {"WEAPSWAP", ArcDPS::CBTS_WEAPSWAP},                 {"MAXHEALTHUPDATE", ArcDPS::CBTS_MAXHEALTHUPDATE},
+        {"TEAMCHANGE", ArcDPS::CBTS_TEAMCHANGE},             {"BARRIERPCTUPDATE", ArcDPS::CBTS_BARRIERPCTUPDATE},
+        {"STUNBREAK", ArcDPS::CBTS_STUNBREAK},
+        {nullptr, 0},
+    };
+
+    const NamedValue Iffs[] = {
+        {"FRIEND", ArcDPS::IFF_FRIEND}, {"FOE", ArcDPS::IFF_FOE}, {"UNKNOWN", ArcDPS::IFF_UNKNOWN},
+        {nullptr, 0},
+    };
+
+    const NamedValue Professions[] = {
+        {"GUARDIAN", 1}, {"WARRIOR", 2}, {"ENGINEER", 3}, {"RANGER", 4}, {"THIEF", 5},
+        {"ELEMENTALIST", 6}, {"MESMER", 7}, {"NECROMANCER", 8}, {"REVENANT", 9},
+        {nullptr, 0},
+    };
+
+    struct FieldDef
+    {
+        const char*       name;
+        EFilterField      field;
+        const NamedValue* constants;   // names usable on the right-hand side, or null
+    };
+
+    const FieldDef FieldDefs[] = {
+        {"result",         FilterField_Result,        Results},
+        {"statechange",    FilterField_Statechange,   Statechanges},
+        {"skill",          FilterField_Skill,         nullptr},
+        {"value",          FilterField_Value,         nullptr},
+        {"buff_damage",    FilterField_BuffDamage,    nullptr},
+        {"iff",            FilterField_Iff,           Iffs},
+        {"buff",           FilterField_Buff,          nullptr},
+        {"activation",     FilterField_Activation,    nullptr},
+        {"buff_remove",    FilterField_BuffRemove,    nullptr},
+        {"src.self",       FilterField_SrcSelf,       nullptr},
+        {"src.profession", FilterField_SrcProfession, Professions},
+        {"src.team",       FilterField_SrcTeam,       nullptr},
+        {"dst.self",       FilterField_DstSelf,       nullptr},
+        {"dst.profession", FilterField_DstProfession, Professions},
+        {"dst.team",       FilterField_DstTeam,       nullptr},
+    };
+
+    static_assert(sizeof(FieldDefs) / sizeof(FieldDefs[0]) == FilterField_Count, "one row per field");
+
+    enum ENodeKind : uint8_t
+    {
+        Node_Test,
+        Node_And,
+        Node_Or,
+        Node_Not
+    };
+
+    struct Node
+    {
+        ENodeKind kind;
+        uint8_t   left;     // And, Or, Not
+        uint8_t   right;    // And, Or
+        uint8_t   leaves;   // tests under this node, which is also the table entries it takes
+        uint8_t   field;    // Test
+        int64_t   low;      // Test, inclusive
+        int64_t   high;
+    };
+
+    enum EOperator : uint8_t
+    {
+        Op_Equal,
+        Op_NotEqual,
+        Op_LessEqual,
+        Op_GreaterEqual,
+        Op_Less,
+        Op_Greater
+    };
+
+    struct Operator
+    {
+        const char* token;
+        EOperator   op;
+    };
+
+    // Two-character operators first, so "<=" is not read as "<"
+    const Operator Operators[] = {
+        {"==", Op_Equal}, {"!=", Op_NotEqual}, {"<=", Op_LessEqual}, {">=", Op_GreaterEqual},
+        {"<", Op_Less},   {">", Op_Greater},
+    };
+
+    constexpr size_t MaxNodes = EventFilter::MaxTests * 3;   // tests, the operators joining them, and !s
+    constexpr size_t MaxDepth = 32;                          // nested parentheses and !s
+
+    ///------------------------------------------------------------------------------------------------
+    /// Parser - Recursive descent over the expression text into a node array
+    ///
+    ///   or    := and ('||' and)*
+    ///   and   := unary ('&&' unary)*
+    ///   unary := '!' unary | '(' or ')' | field [op value | 'in' value '..' value]
+    ///------------------------------------------------------------------------------------------------
+    class Parser
+    {
+    public:
+        explicit Parser(const char* text) : m_p(text) {}
+
+        bool Parse(uint8_t& root)
+        {
+            if (!ParseOr(root))
+                return false;
+            SkipSpace();
+            return *m_p == '\0';
+        }
+
+        const Node* Nodes() const { return m_nodes; }
+
+    private:
+        void SkipSpace()
+        {
+            while (*m_p == ' ' || *m_p == '\t')
+                m_p++;
+        }
+
+        bool Accept(const char* token)
+        {
+            SkipSpace();
+            size_t len = strlen(token);
+            if (strncmp(m_p, token, len) != 0)
+                return false;
+            m_p += len;
+            return true;
+        }
+
+        /// Identifier, dots allowed inside (src.self)
+        size_t Word(char* out, size_t size)
+        {
+            SkipSpace();
+            size_t len = 0;
+            while (isalnum(static_cast<unsigned char>(m_p[len])) || m_p[len] == '_' || (len > 0 && m_p[len] == '.'))
+                len++;
+            if (len == 0 || len >= size || isdigit(static_cast<unsigned char>(m_p[0])))
+                return 0;
+            memcpy(out, m_p, len);
+            out[len] = '\0';
+            m_p += len;
+            return len;
+        }
+
+        bool NewNode(const Node& node, uint8_t& index)
+        {
+            if (m_count >= MaxNodes || m_leaves + (node.kind == Node_Test) > EventFilter::MaxTests)
+                return false;
+            m_leaves += node.kind == Node_Test;
+            m_nodes[m_count] = node;
+            index = static_cast<uint8_t>(m_count++);
+            return true;
+        }
+
+        bool Join(ENodeKind kind, uint8_t left, uint8_t right, uint8_t& index)
+        {
+            uint8_t leaves = static_cast<uint8_t>(m_nodes[left].leaves + m_nodes[right].leaves);
+            return NewNode({kind, left, right, leaves, 0, 0, 0}, index);
+        }
+
+        bool ParseOr(uint8_t& index)
+        {
+            if (!ParseAnd(index))
+                return false;
+            while (Accept("||"))
+            {
+                uint8_t right;
+                if (!ParseAnd(right) || !Join(Node_Or, index, right, index))
+                    return false;
+            }
+            return true;
+        }
+
+        bool ParseAnd(uint8_t& index)
+        {
+            if (!ParseUnary(index))
+                return false;
+            while (Accept("&&"))
+            {
+                uint8_t right;
+                if (!ParseUnary(right) || !Join(Node_And, index, right, index))
+                    return false;
+            }
+            return true;
+        }
+
+        bool ParseUnary(uint8_t& index)
+        {
+            if (++m_depth > MaxDepth)
+                return false;
+
+            bool ok;
+            if (Accept("!="))
+                ok = false;   // "!=" is only an operator
+            else if (Accept("!"))
+            {
+                uint8_t child;
+                ok = ParseUnary(child) && NewNode({Node_Not, child, 0, m_nodes[child].leaves, 0, 0, 0}, index);
+            }
+            else if (Accept("("))
+                ok = ParseOr(index) && Accept(")");
+            else
+                ok = ParseComparison(index);
+
+            m_depth--;
+            return ok;
+        }
+
+        bool ParseValue(const FieldDef& def, int64_t& value)
+        {
+            SkipSpace();
+            char name[32];
+            if (def.constants && Word(name, sizeof(name)))
+            {
+                for (const NamedValue* constant = def.constants; constant->name; constant++)
+                {
+                    if (strcmp(constant->name, name) == 0)
+                    {
+                        value = constant->value;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            // Decimal, or hex behind an explicit 0x; a leading zero is not octal
+            const char* digits = m_p + (*m_p == '-' || *m_p == '+');
+            int base = digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X') ? 16 : 10;
+            char* end = nullptr;
+            long long parsed = strtoll(m_p, &end, base);
+            if (end == m_p || parsed < MinLiteral || parsed > MaxLiteral || (*end == '.' && end[1] != '.'))
+                return false;
+            m_p = end;
+            value = parsed;
+            return true;
+        }
+
+        bool ParseComparison(uint8_t& index)
+        {
+            char name[32];
+            if (!Word(name, sizeof(name)))
+                return false;
+
+            const FieldDef* def = nullptr;
+            for (const FieldDef& candidate : FieldDefs)
+            {
+                if (strcmp(candidate.name, name) == 0)
+                    def = &candidate;
+            }
+            if (!def)
+                return false;
+
+            // The test is low <= field <= high, optionally negated
+            int64_t value = 0;
+            int64_t low = 0;
+            int64_t high = 0;
+            bool negate = false;
+            const Operator* op = nullptr;
+            for (const Operator& candidate : Operators)
+            {
+                if (!op && Accept(candidate.token))
+                    op = &candidate;
+            }
+            if (op)
+            {
+                if (!ParseValue(*def, value))
+                    return false;
+                switch (op->op)
+                {
+                    case Op_Equal:        low = value;     high = value;     break;
+                    case Op_NotEqual:     low = value;     high = value;     negate = true; break;
+                    case Op_LessEqual:    low = INT64_MIN; high = value;     break;
+                    case Op_GreaterEqual: low = value;     high = INT64_MAX; break;
+                    case Op_Less:         low = INT64_MIN; high = value - 1; break;
+                    case Op_Greater:      low = value + 1; high = INT64_MAX; break;
+                }
+            }
+            else if (Accept("in "))
+            {
+                if (!ParseValue(*def, low) || !Accept("..") || !ParseValue(*def, high) || low > high)
+                    return false;
+            }
+            else
+            {
+                // A bare field: non-zero
+                negate = true;
+            }
+
+            if (!NewNode({Node_Test, 0, 0, 1, def->field, low, high}, index))
+                return false;
+            return !negate || NewNode({Node_Not, index, 0, 1, 0, 0, 0}, index);
+        }
+
+        const char* m_p;
+        Node        m_nodes[MaxNodes] = {};
+        size_t      m_count = 0;
+        size_t      m_leaves = 0;
+        size_t      m_depth = 0;
+    };
+}
+
+FilterFields MakeFilterFields(const CombatRecord& record)
+{
+    FilterFields fields;
+    uint64_t* v = fields.Values;
+    v[FilterField_Result] = SignBias + record.Result;
+    v[FilterField_Statechange] = SignBias + record.IsStatechange;
+    v[FilterField_Skill] = SignBias + record.SkillId;
+    v[FilterField_Value] = SignBias + static_cast<uint64_t>(static_cast<int64_t>(record.Value));
+    v[FilterField_BuffDamage] = SignBias + static_cast<uint64_t>(static_cast<int64_t>(record.BuffDamage));
+    v[FilterField_Iff] = SignBias + record.Iff;
+    v[FilterField_Buff] = SignBias + record.Buff;
+    v[FilterField_Activation] = SignBias + record.IsActivation;
+    v[FilterField_BuffRemove] = SignBias + record.IsBuffRemove;
+    v[FilterField_SrcSelf] = SignBias + (record.SrcIsSelf() ? 1 : 0);
+    v[FilterField_SrcProfession] = SignBias + record.SrcProfession;
+    v[FilterField_SrcTeam] = SignBias + record.SrcTeam;
+    v[FilterField_DstSelf] = SignBias + (record.DstIsSelf() ? 1 : 0);
+    v[FilterField_DstProfession] = SignBias + record.DstProfession;
+    v[FilterField_DstTeam] = SignBias + record.DstTeam;
+    return fields;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Emit - Lay out the tests under a node from table entry start, wiring both outcomes
+///
+/// Tests are placed in source order, so a node's first test is at start and the one after its last is
+/// start + leaves: && continues into its right side on true, || on false, and ! swaps the targets.
+///----------------------------------------------------------------------------------------------------
+template <typename TestT>
+static void Emit(const Node* nodes, uint8_t index, uint8_t start, uint8_t ifTrue, uint8_t ifFalse, TestT* out)
+{
+    const Node& node = nodes[index];
+    uint8_t next = static_cast<uint8_t>(start + (node.kind == Node_Test ? 0 : nodes[node.left].leaves));
+    switch (node.kind)
+    {
+        case Node_Test:
+            out[start].Low = SignBias + static_cast<uint64_t>(node.low);
+            out[start].Span = static_cast<uint64_t>(node.high) - static_cast<uint64_t>(node.low);
+            out[start].Field = node.field;
+            out[start].IfTrue = ifTrue;
+            out[start].IfFalse = ifFalse;
+            break;
+        case Node_And:
+            Emit(nodes, node.left, start, next, ifFalse, out);
+            Emit(nodes, node.right, next, ifTrue, ifFalse, out);
+            break;
+        case Node_Or:
+            Emit(nodes, node.left, start, ifTrue, next, out);
+            Emit(nodes, node.right, next, ifTrue, ifFalse, out);
+            break;
+        case Node_Not:
+            Emit(nodes, node.left, start, ifFalse, ifTrue, out);
+            break;
+    }
+}
+
+bool EventFilter::Compile(const std::string& expression)
+{
+    Parser parser(expression.c_str());
+    uint8_t root = 0;
+    if (!parser.Parse(root))
+        return false;
+
+    Emit(parser.Nodes(), root, 0, Accept, Reject, m_tests);
+    m_testCount = parser.Nodes()[root].leaves;
+    m_conjunction = true;
+    for (size_t i = 0; i < m_testCount; i++)
+    {
+        uint8_t next = i + 1 < m_testCount ? static_cast<uint8_t>(i + 1) : Accept;
+        m_conjunction &= m_tests[i].IfTrue == next && m_tests[i].IfFalse == Reject;
+    }
+    return true;
+}
+
+bool EventFilter::CanMatch(EFilterField field, int64_t value) const
+{
+    // Follow the tests whose failure rejects outright: every match passes each of them
+    uint64_t biased = SignBias + static_cast<uint64_t>(value);
+    for (uint8_t pc = 0; pc < MaxTests && m_tests[pc].IfFalse == Reject; pc = m_tests[pc].IfTrue)
+    {
+        const Test& test = m_tests[pc];
+        if (test.Field == field && biased - test.Low > test.Span)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,110 @@
+///----------------------------------------------------------------------------------------------------
+/// Event Filter - Boolean expressions over combat record fields, compiled to a flat test table
+///
+/// An expression is comparisons of record fields joined with &&, || and !, with parentheses:
+///   result==KILLINGBLOW && src.self && dst.profession in 1..9 && skill==12345
+///   statechange==CHANGEDOWN && (src.self || dst.team!=0)
+/// A comparison is field==, !=, <, <=, >, >= a number (decimal, or hex with 0x) or one of the field's
+/// named constants, or "field in low..high" (inclusive); a field on its own means field!=0.
+///
+/// Every comparison compiles to one range test "low <= field <= high" with a jump target for each
+/// outcome, so && and || short-circuit by jumping and ! swaps the targets. Targets only ever point
+/// forward and the table holds no other instruction, so evaluating is a loop of one load, one
+/// compare and one select per test actually reached. The record's fields are unpacked once per event
+/// into an array indexed by field (FilterFields) and shared by every filter.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_EVENT_FILTER_H
+#define STREAMLINK_EVENT_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "combat_record.h"
+
+/// Fields an expression can test, in FilterFields order
+enum EFilterField : uint8_t
+{
+    FilterField_Result,
+    FilterField_Statechange,
+    FilterField_Skill,
+    FilterField_Value,
+    FilterField_BuffDamage,
+    FilterField_Iff,
+    FilterField_Buff,
+    FilterField_Activation,
+    FilterField_BuffRemove,
+    FilterField_SrcSelf,
+    FilterField_SrcProfession,
+    FilterField_SrcTeam,
+    FilterField_DstSelf,
+    FilterField_DstProfession,
+    FilterField_DstTeam,
+    FilterField_Count
+};
+
+/// A record's fields, widened so that every range test is one unsigned compare
+struct FilterFields
+{
+    uint64_t Values[FilterField_Count];
+};
+
+/// Unpacks a record for evaluation; signed fields keep their order through the unsigned compare.
+FilterFields MakeFilterFields(const CombatRecord& record);
+
+class EventFilter
+{
+public:
+    static constexpr size_t MaxTests = 32;   // comparisons per expression
+
+    /// Compiles expression, replacing any previous one. False (filter unchanged) if it does not parse
+    /// or has more than MaxTests comparisons.
+    bool Compile(const std::string& expression);
+
+    bool Matches(const FilterFields& fields) const
+    {
+        if (m_conjunction)
+        {
+            // Plain && chain: every test, no early exit, so the only branch is the fixed-length loop
+            bool matched = m_testCount != 0;
+            for (size_t i = 0; i < m_testCount; i++)
+                matched &= fields.Values[m_tests[i].Field] - m_tests[i].Low <= m_tests[i].Span;
+            return matched;
+        }
+
+        uint8_t pc = 0;
+        while (pc < MaxTests)
+        {
+            const Test& test = m_tests[pc];
+            pc = fields.Values[test.Field] - test.Low <= test.Span ? test.IfTrue : test.IfFalse;
+        }
+        return pc == Accept;
+    }
+
+    /// False if no record with this field value can match: some test every match has to pass rejects
+    /// it. Lets a caller index filters by a field and skip the ones that cannot apply.
+    bool CanMatch(EFilterField field, int64_t value) const;
+
+    /// Comparisons in the compiled expression (0 before the first successful Compile).
+    size_t TestCount() const { return m_testCount; }
+
+private:
+    static constexpr uint8_t Accept = 0xFE;
+    static constexpr uint8_t Reject = 0xFF;
+
+    struct Test
+    {
+        uint64_t Low;     // biased field value
+        uint64_t Span;    // high - low
+        uint8_t  Field;   // EFilterField
+        uint8_t  IfTrue;  // next test, or Accept / Reject
+        uint8_t  IfFalse;
+    };
+
+    Test   m_tests[MaxTests] = {{0, 0, 0, Reject, Reject}};
+    size_t m_testCount = 0;
+    bool   m_conjunction = false;   // tests only ever continue to the next or reject
+};
+
+#endif
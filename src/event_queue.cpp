@@ -0,0 +1,196 @@
+///----------------------------------------------------------------------------------------------------
+/// Event Queue - Hands combat records from the ArcDPS callbacks to a single processing thread
+///----------------------------------------------------------------------------------------------------
+
+#include "event_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "combat_dispatch.h"
+#include "mpsc_ring.h"
+#include "tracing.h"
+
+namespace
+{
+    // The worker drains on this period; producers only wake it early once the ring is filling up, so
+    // an ordinary callback never makes a system call. Outputs are flushed every 100 ms anyway.
+    constexpr std::chrono::milliseconds DrainInterval{2};
+    constexpr size_t WakeThreshold = EventQueue::Capacity / 4;
+
+    MpscRing<CombatRecord, EventQueue::Capacity> g_ring;
+    CombatRecord                      g_batch[EventQueue::MaxBatch];
+    EVENT_BATCH_HANDLER               g_handler = nullptr;
+
+    std::atomic<uint64_t>             g_dropped{0};
+    std::atomic<uint64_t>             g_droppedCritical{0};
+    alignas(64) std::atomic<size_t>   g_consumed{0};   // total records handled, compared against Claimed()
+    alignas(64) std::atomic<bool>     g_wakePending{false};
+
+    std::thread                       g_thread;
+    std::mutex                        g_wakeMutex;
+    std::condition_variable           g_wakeCv;
+    std::atomic<bool>                 g_running{false};
+    bool                              g_stopRequested = false;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// ProcessBatch - Pop up to MaxBatch records and hand them to the handler. Returns the count.
+///----------------------------------------------------------------------------------------------------
+static size_t ProcessBatch()
+{
+    size_t count = g_ring.PopBatch(g_batch, EventQueue::MaxBatch);
+    if (count == 0)
+        return 0;
+
+    if (g_handler)
+        g_handler(g_batch, count);
+    g_consumed.fetch_add(count, std::memory_order_release);
+    return count;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// WorkerThread - Drain the ring in batches every drain interval, or sooner when woken
+///----------------------------------------------------------------------------------------------------
+static void WorkerThread()
+{
+    uint64_t reportedDrops = 0;
+    for (;;)
+    {
+        while (ProcessBatch() != 0)
+        {
+        }
+
+        uint64_t dropped = g_dropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDrops)
+        {
+            STREAMLINK_TRACE(ELogLevel_WARNING, "Event queue full: %llu records dropped (%llu critical)",
+                             (unsigned long long)dropped,
+                             (unsigned long long)g_droppedCritical.load(std::memory_order_relaxed));
+            reportedDrops = dropped;
+        }
+
+        std::unique_lock<std::mutex> lock(g_wakeMutex);
+        if (g_stopRequested)
+        {
+            // Anything pushed before Stop() still gets processed
+            lock.unlock();
+            while (ProcessBatch() != 0)
+            {
+            }
+            break;
+        }
+        g_wakeCv.wait_for(lock, DrainInterval, []
+        {
+            return g_stopRequested || g_wakePending.load(std::memory_order_relaxed);
+        });
+        g_wakePending.store(false, std::memory_order_relaxed);
+    }
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Wake - Cut the current drain interval short (first caller only until the worker runs again)
+///----------------------------------------------------------------------------------------------------
+static void Wake()
+{
+    if (g_wakePending.load(std::memory_order_relaxed) || g_wakePending.exchange(true, std::memory_order_relaxed))
+        return;
+
+    // Without the mutex a wakeup can be missed; the drain interval bounds that case
+    g_wakeCv.notify_one();
+}
+
+bool EventQueue::IsCritical(const CombatRecord& record)
+{
+    return CombatDispatch::IsCritical(record);
+}
+
+bool EventQueue::Push(const CombatRecord& record)
+{
+    bool critical = IsCritical(record);
+
+    // Keep the tail of the ring for records that change tracked state
+    if (!critical && g_ring.SizeApprox() >= Capacity - CriticalReserve)
+    {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (!g_ring.TryPush(record))
+    {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        if (critical)
+            g_droppedCritical.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (g_ring.SizeApprox() >= WakeThreshold)
+        Wake();
+    return true;
+}
+
+void EventQueue::Start(EVENT_BATCH_HANDLER handler)
+{
+    if (g_thread.joinable())
+        return;
+
+    g_handler = handler;
+    {
+        std::lock_guard<std::mutex> lock(g_wakeMutex);
+        g_stopRequested = false;
+    }
+    g_running.store(true, std::memory_order_release);
+    g_thread = std::thread(WorkerThread);
+}
+
+void EventQueue::Stop()
+{
+    if (!g_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(g_wakeMutex);
+        g_stopRequested = true;
+    }
+    g_wakeCv.notify_one();
+    g_thread.join();
+    g_running.store(false, std::memory_order_release);
+}
+
+void EventQueue::WaitProcessed()
+{
+    size_t target = g_ring.Claimed();
+    Wake();
+    while (g_running.load(std::memory_order_acquire) &&
+           static_cast<intptr_t>(g_consumed.load(std::memory_order_acquire) - target) < 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+uint64_t EventQueue::Processed()
+{
+    return g_consumed.load(std::memory_order_acquire);
+}
+
+uint64_t EventQueue::Dropped()
+{
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t EventQueue::DroppedCritical()
+{
+    return g_droppedCritical.load(std::memory_order_relaxed);
+}
+
+void EventQueue::Reset()
+{
+    if (g_thread.joinable())
+        return;
+
+    g_dropped.store(0, std::memory_order_relaxed);
+    g_droppedCritical.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,55 @@
+///----------------------------------------------------------------------------------------------------
+/// Event Queue - Hands combat records from the ArcDPS callbacks to a single processing thread
+///
+/// Callbacks copy a CombatRecord into a bounded lock-free ring and return; a worker thread drains the
+/// ring in batches every couple of milliseconds and runs all tracking logic. Producers only wake it
+/// early when the ring is filling up, so the callback cost is one fixed-size copy and a CAS, however
+/// much tracking is added behind it.
+///
+/// Drop policy: the ring never blocks a callback. Once it is nearly full, ordinary records (strikes,
+/// buffs, position and percentage updates) are dropped while the last CriticalReserve slots are kept
+/// for records whose handler changes tracked state (see CombatDispatch::IsCritical). Both kinds of drop
+/// are counted.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_EVENT_QUEUE_H
+#define STREAMLINK_EVENT_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "combat_record.h"
+
+/// Processes a batch of records on the worker thread.
+typedef void (*EVENT_BATCH_HANDLER)(const CombatRecord* records, size_t count);
+
+namespace EventQueue
+{
+    constexpr size_t Capacity = 8192;
+    constexpr size_t CriticalReserve = 512;
+    constexpr size_t MaxBatch = 256;
+
+    /// True for records the drop policy protects.
+    bool IsCritical(const CombatRecord& record);
+
+    /// Queues a record. Returns false if it was dropped. Lock-free, safe from any thread.
+    bool Push(const CombatRecord& record);
+
+    /// Starts the worker thread.
+    void Start(EVENT_BATCH_HANDLER handler);
+
+    /// Processes everything still queued, then joins the worker thread.
+    void Stop();
+
+    /// Blocks until every record pushed before the call has been processed (tests and benchmarks).
+    void WaitProcessed();
+
+    uint64_t Processed();          // records handled since the process started
+    uint64_t Dropped();            // all drops, critical included
+    uint64_t DroppedCritical();
+
+    /// Clears the drop counters. Only valid while stopped.
+    void Reset();
+}
+
+#endif
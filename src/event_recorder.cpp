@@ -0,0 +1,282 @@
+///----------------------------------------------------------------------------------------------------
+/// Event Recorder - Opt-in capture of the raw combat and squad update streams to a recording file
+///----------------------------------------------------------------------------------------------------
+
+#include "event_recorder.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "combat_recording.h"
+#include "mpsc_ring.h"
+#include "platform.h"
+
+namespace
+{
+    enum ECellKind : uint8_t
+    {
+        Cell_Combat,
+        Cell_User     // one user of a squad update batch
+    };
+
+    struct RecorderCell
+    {
+        ECellKind Kind;
+        uint32_t  Index;   // Cell_User: position in the batch
+        uint32_t  Count;   // Cell_User: users in the batch
+        union
+        {
+            RecordedCombat Combat;
+            RecordedUser   User;
+        };
+    };
+
+    using Ring = MpscRing<RecorderCell, EventRecorder::Capacity>;
+    using Clock = std::chrono::steady_clock;
+
+    // Same drain policy as the event queue: a short period, woken early only once the ring fills up
+    constexpr std::chrono::milliseconds DrainInterval{5};
+    constexpr std::chrono::seconds      MaxWriteDelay{1};
+    constexpr size_t                    WakeThreshold = EventRecorder::Capacity / 4;
+    constexpr size_t                    DrainBatch = 64;
+    constexpr size_t                    MaxBatchUsers = 256;
+
+    std::atomic<Ring*>                g_ring{nullptr};
+    std::atomic<uint64_t>             g_dropped{0};
+    std::atomic<uint64_t>             g_bytesWritten{0};
+    alignas(64) std::atomic<bool>     g_wakePending{false};
+
+    // Recorder thread only (and Start/Stop while it is not running)
+    std::unique_ptr<RecordingEncoder> g_encoder;
+    std::vector<uint8_t>              g_buffer;
+    FILE*                             g_file = nullptr;
+    RecorderCell                      g_cells[DrainBatch];
+    RecordedUser                      g_batchUsers[MaxBatchUsers];
+    size_t                            g_batchUserCount = 0;
+
+    std::thread                       g_thread;
+    std::mutex                        g_wakeMutex;
+    std::condition_variable           g_wakeCv;
+    bool                              g_stopRequested = false;
+}
+
+std::atomic<bool> EventRecorder::g_recording{false};
+
+///----------------------------------------------------------------------------------------------------
+/// Push - Hand one cell to the recorder thread, or count it as dropped (callback side)
+///----------------------------------------------------------------------------------------------------
+static void Push(const RecorderCell& cell)
+{
+    Ring* ring = g_ring.load(std::memory_order_acquire);
+    if (!ring || !ring->TryPush(cell))
+    {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (ring->SizeApprox() >= WakeThreshold && !g_wakePending.load(std::memory_order_relaxed) &&
+        !g_wakePending.exchange(true, std::memory_order_relaxed))
+    {
+        g_wakeCv.notify_one();
+    }
+}
+
+///----------------------------------------------------------------------------------------------------
+/// EncodeCell - Append one cell to the buffer; squad users are held until their batch is complete
+///----------------------------------------------------------------------------------------------------
+static void EncodeCell(const RecorderCell& cell)
+{
+    if (cell.Kind == Cell_Combat)
+    {
+        g_encoder->Combat(cell.Combat, g_buffer);
+        return;
+    }
+
+    if (cell.Index == 0)
+        g_batchUserCount = 0;
+    if (cell.Count != 0)
+        g_batchUsers[g_batchUserCount++] = cell.User;
+
+    // A batch larger than MaxBatchUsers is written in parts
+    if (cell.Index + 1 >= cell.Count || g_batchUserCount == MaxBatchUsers)
+    {
+        g_encoder->SquadUpdate(g_batchUsers, g_batchUserCount, g_buffer);
+        g_batchUserCount = 0;
+    }
+}
+
+static void WriteBuffer()
+{
+    if (g_buffer.empty())
+        return;
+    size_t written = fwrite(g_buffer.data(), 1, g_buffer.size(), g_file);
+    fflush(g_file);
+    g_bytesWritten.fetch_add(written, std::memory_order_relaxed);
+    g_buffer.clear();
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Drain - Encode everything in the ring. Returns the number of cells.
+///----------------------------------------------------------------------------------------------------
+static size_t Drain()
+{
+    Ring* ring = g_ring.load(std::memory_order_relaxed);
+    size_t total = 0;
+    size_t count;
+    while ((count = ring->PopBatch(g_cells, DrainBatch)) != 0)
+    {
+        for (size_t i = 0; i < count; i++)
+            EncodeCell(g_cells[i]);
+        total += count;
+        if (g_buffer.size() >= EventRecorder::WriteChunk)
+            WriteBuffer();
+    }
+    return total;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RecorderThread - Drain every interval (or sooner when woken); write when a chunk has built up or
+///                  MaxWriteDelay has passed, so a crash loses at most about a second
+///----------------------------------------------------------------------------------------------------
+static void RecorderThread()
+{
+    Clock::time_point lastWrite = Clock::now();
+    for (;;)
+    {
+        Drain();
+        Clock::time_point now = Clock::now();
+        if (now - lastWrite >= MaxWriteDelay)
+        {
+            WriteBuffer();
+            lastWrite = now;
+        }
+
+        std::unique_lock<std::mutex> lock(g_wakeMutex);
+        if (g_stopRequested)
+        {
+            lock.unlock();
+            Drain();
+            WriteBuffer();
+            break;
+        }
+        g_wakeCv.wait_for(lock, DrainInterval, []
+        {
+            return g_stopRequested || g_wakePending.load(std::memory_order_relaxed);
+        });
+        g_wakePending.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool EventRecorder::Start(const std::string& path, uint64_t wallClockMs)
+{
+    Stop();
+
+    size_t slash = path.find_last_of("\\/");
+    if (slash != std::string::npos)
+        Platform::CreateDirectories(path.substr(0, slash).c_str());
+    g_file = fopen(path.c_str(), "wb");
+    if (!g_file)
+        return false;
+
+    if (!g_ring.load(std::memory_order_relaxed))
+        g_ring.store(new Ring(), std::memory_order_release);
+    if (!g_encoder)
+        g_encoder.reset(new RecordingEncoder());
+
+    // Cells pushed while the last recording was stopping belong to neither file
+    Ring* ring = g_ring.load(std::memory_order_relaxed);
+    while (ring->PopBatch(g_cells, DrainBatch) != 0)
+    {
+    }
+
+    g_buffer.clear();
+    g_buffer.reserve(WriteChunk * 2);
+    g_encoder->Begin(wallClockMs, g_buffer);
+    g_batchUserCount = 0;
+    g_dropped.store(0, std::memory_order_relaxed);
+    g_bytesWritten.store(0, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(g_wakeMutex);
+        g_stopRequested = false;
+    }
+    g_thread = std::thread(RecorderThread);
+    g_recording.store(true, std::memory_order_release);
+    return true;
+}
+
+void EventRecorder::Stop()
+{
+    g_recording.store(false, std::memory_order_relaxed);
+    if (g_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_wakeMutex);
+            g_stopRequested = true;
+        }
+        g_wakeCv.notify_one();
+        g_thread.join();
+    }
+    if (g_file)
+    {
+        fclose(g_file);
+        g_file = nullptr;
+    }
+}
+
+void EventRecorder::RecordCombat(const EvCombatData& data, ECombatSource source)
+{
+    if (!IsRecording())
+        return;
+
+    RecorderCell cell;
+    cell.Kind = Cell_Combat;
+    cell.Index = 0;
+    cell.Count = 1;
+    CaptureCombat(data, source, cell.Combat);
+    Push(cell);
+}
+
+void EventRecorder::RecordSquadUpdate(const EvSquadUpdate& update)
+{
+    if (!IsRecording())
+        return;
+
+    RecorderCell cell;
+    cell.Kind = Cell_User;
+    cell.Count = static_cast<uint32_t>(update.UpdatedUsersCount);
+    cell.Index = 0;
+    if (cell.Count == 0 || !update.UpdatedUsers)
+    {
+        cell.Count = 0;
+        Push(cell);   // an empty batch is still a batch
+        return;
+    }
+    for (; cell.Index < cell.Count; cell.Index++)
+    {
+        CaptureUser(update.UpdatedUsers[cell.Index], cell.User);
+        Push(cell);
+    }
+}
+
+uint64_t EventRecorder::Dropped()
+{
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t EventRecorder::BytesWritten()
+{
+    return g_bytesWritten.load(std::memory_order_relaxed);
+}
+
+void EventRecorder::Shutdown()
+{
+    Stop();
+    delete g_ring.exchange(nullptr, std::memory_order_acq_rel);
+    g_encoder.reset();
+    g_buffer = std::vector<uint8_t>();
+}
@@ -0,0 +1,59 @@
+///----------------------------------------------------------------------------------------------------
+/// Event Recorder - Opt-in capture of the raw combat and squad update streams to a recording file
+///
+/// While recording, each callback copies its payload (names included) into one fixed-size cell of a
+/// bounded lock-free ring and returns: no encoding, locking or I/O on the game thread. A recorder
+/// thread drains the ring every few milliseconds, encodes the cells (see combat_recording.h) into a
+/// memory buffer and writes the buffer in large sequential chunks, at least every second while events
+/// come in. If the ring fills, cells are dropped and counted rather than blocking the callback. When
+/// recording is off the callbacks pay one relaxed load.
+///
+/// Start and Stop are called from one thread at a time (load, unload, settings reload).
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_EVENT_RECORDER_H
+#define STREAMLINK_EVENT_RECORDER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Nexus.h"
+#include "UnofficialExtras.h"
+#include "combat_record.h"
+
+namespace EventRecorder
+{
+    constexpr size_t Capacity = 8192;            // cells in the ring, allocated on the first Start
+    constexpr size_t WriteChunk = 256 * 1024;   // buffered bytes that trigger a write
+
+    extern std::atomic<bool> g_recording;
+
+    inline bool IsRecording()
+    {
+        return g_recording.load(std::memory_order_relaxed);
+    }
+
+    /// Creates path (and its directory) and starts recording into it, stopping any current recording
+    /// first. False if the file cannot be created.
+    bool Start(const std::string& path, uint64_t wallClockMs);
+
+    /// Writes everything captured so far, closes the file and stops the recorder thread.
+    void Stop();
+
+    /// Callback side: capture one payload. No-ops unless recording.
+    void RecordCombat(const EvCombatData& data, ECombatSource source);
+    void RecordSquadUpdate(const EvSquadUpdate& update);
+
+    /// Cells dropped because the ring was full, since the last Start.
+    uint64_t Dropped();
+
+    /// Bytes written to the current (or last) recording.
+    uint64_t BytesWritten();
+
+    /// Frees the ring. Only once nothing can call the Record functions any more.
+    void Shutdown();
+}
+
+#endif
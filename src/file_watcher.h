@@ -0,0 +1,42 @@
+///----------------------------------------------------------------------------------------------------
+/// File Watcher - Change notification for one file, polled without blocking
+///
+/// Watches the file's directory rather than the file itself, so editors that save by writing a
+/// temporary file and renaming it over the original are still seen. Uses ReadDirectoryChangesW on
+/// Windows and inotify on Linux; other POSIX systems fall back to comparing the modification time and
+/// size on every poll. Poll() is meant to be called from a periodic hook (the writer thread) and
+/// only reports that something happened; callers debounce and re-read the file themselves.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_FILE_WATCHER_H
+#define STREAMLINK_FILE_WATCHER_H
+
+#include <string>
+
+class FileWatcher
+{
+public:
+    FileWatcher() = default;
+    ~FileWatcher() { Close(); }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /// Starts watching path. Its directory must exist; the file itself need not. Returns false if
+    /// notifications could not be set up.
+    bool Watch(const std::string& path);
+
+    /// True if the file was written, created, replaced or deleted since the last poll. Never blocks.
+    bool Poll();
+
+    void Close();
+
+    bool IsOpen() const { return m_state != nullptr; }
+
+private:
+    std::string m_path;
+    std::string m_name;           // file name within the watched directory
+    void*       m_state = nullptr;  // platform notification state, owned
+};
+
+#endif
@@ -0,0 +1,134 @@
+///----------------------------------------------------------------------------------------------------
+/// File Watcher - POSIX implementation (inotify on Linux, stat polling elsewhere)
+///----------------------------------------------------------------------------------------------------
+
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+#include "file_watcher.h"
+
+namespace
+{
+    struct WatchState
+    {
+        int   fd = -1;             // inotify instance (Linux)
+        int   wd = -1;             // watch on the directory
+        bool  exists = false;      // last stat (fallback)
+        off_t size = 0;
+        struct timespec modified = {};
+    };
+}
+
+#if !defined(__linux__)
+///----------------------------------------------------------------------------------------------------
+/// Snapshot - Store the file's current size and modification time; true if they changed
+///----------------------------------------------------------------------------------------------------
+static bool Snapshot(const std::string& path, WatchState& state)
+{
+    struct stat st;
+    bool exists = stat(path.c_str(), &st) == 0;
+    struct timespec modified = {};
+    off_t size = 0;
+    if (exists)
+    {
+#if defined(__APPLE__)
+        modified = st.st_mtimespec;
+#else
+        modified = st.st_mtim;
+#endif
+        size = st.st_size;
+    }
+
+    bool changed = exists != state.exists || size != state.size || modified.tv_sec != state.modified.tv_sec ||
+                   modified.tv_nsec != state.modified.tv_nsec;
+    state.exists = exists;
+    state.size = size;
+    state.modified = modified;
+    return changed;
+}
+#endif
+
+bool FileWatcher::Watch(const std::string& path)
+{
+    Close();
+    size_t separator = path.find_last_of('/');
+    std::string directory = separator == std::string::npos ? "." : path.substr(0, separator ? separator : 1);
+    m_name = separator == std::string::npos ? path : path.substr(separator + 1);
+    if (m_name.empty())
+        return false;
+
+    struct stat st;
+    if (stat(directory.c_str(), &st) != 0 || !S_ISDIR(st.st_mode))
+        return false;
+
+    WatchState* state = new WatchState();
+#if defined(__linux__)
+    state->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (state->fd >= 0)
+    {
+        state->wd = inotify_add_watch(state->fd, directory.c_str(),
+                                      IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE);
+    }
+    if (state->wd < 0)
+    {
+        if (state->fd >= 0)
+            close(state->fd);
+        delete state;
+        return false;
+    }
+#else
+    Snapshot(path, *state);
+#endif
+    m_path = path;
+    m_state = state;
+    return true;
+}
+
+bool FileWatcher::Poll()
+{
+    if (!m_state)
+        return false;
+    WatchState* state = static_cast<WatchState*>(m_state);
+
+#if defined(__linux__)
+    // Drain everything queued; only events naming our file count
+    alignas(struct inotify_event) char buffer[4096];
+    bool changed = false;
+    for (;;)
+    {
+        ssize_t length = read(state->fd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break;
+
+        for (ssize_t pos = 0; pos < length;)
+        {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + pos);
+            if (event->len != 0 && strcmp(event->name, m_name.c_str()) == 0)
+                changed = true;
+            pos += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+        }
+    }
+    return changed;
+#else
+    return Snapshot(m_path, *state);
+#endif
+}
+
+void FileWatcher::Close()
+{
+    if (!m_state)
+        return;
+
+    WatchState* state = static_cast<WatchState*>(m_state);
+    if (state->fd >= 0)
+        close(state->fd);   // drops the watch with it
+    delete state;
+    m_state = nullptr;
+    m_path.clear();
+    m_name.clear();
+}
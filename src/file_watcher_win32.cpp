@@ -0,0 +1,127 @@
+///----------------------------------------------------------------------------------------------------
+/// File Watcher - Win32 implementation (ReadDirectoryChangesW, overlapped)
+///----------------------------------------------------------------------------------------------------
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+
+#include "file_watcher.h"
+
+namespace
+{
+    constexpr DWORD NotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE |
+                                   FILE_NOTIFY_CHANGE_SIZE;
+
+    struct WatchState
+    {
+        HANDLE     directory = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        bool       pending = false;          // a read is outstanding
+        WCHAR      name[MAX_PATH] = {};      // file name, compared case-insensitively
+        int        nameLength = 0;
+        DWORD      buffer[4096 / sizeof(DWORD)];   // FILE_NOTIFY_INFORMATION records, DWORD-aligned
+    };
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Issue - Queue the next asynchronous read of directory changes
+///----------------------------------------------------------------------------------------------------
+static bool Issue(WatchState& state)
+{
+    ResetEvent(state.overlapped.hEvent);
+    state.pending = ReadDirectoryChangesW(state.directory, state.buffer, sizeof(state.buffer), FALSE,
+                                          NotifyFilter, nullptr, &state.overlapped, nullptr) != FALSE;
+    return state.pending;
+}
+
+bool FileWatcher::Watch(const std::string& path)
+{
+    Close();
+    size_t separator = path.find_last_of("\\/");
+    std::string directory = separator == std::string::npos ? "." : path.substr(0, separator);
+    m_name = separator == std::string::npos ? path : path.substr(separator + 1);
+    if (m_name.empty())
+        return false;
+
+    WatchState* state = new WatchState();
+    state->nameLength = MultiByteToWideChar(CP_ACP, 0, m_name.c_str(), -1, state->name, MAX_PATH) - 1;
+    state->directory = CreateFileA(directory.c_str(), FILE_LIST_DIRECTORY,
+                                   FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                   FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    state->overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    if (state->nameLength <= 0 || state->directory == INVALID_HANDLE_VALUE || !state->overlapped.hEvent ||
+        !Issue(*state))
+    {
+        if (state->overlapped.hEvent)
+            CloseHandle(state->overlapped.hEvent);
+        if (state->directory != INVALID_HANDLE_VALUE)
+            CloseHandle(state->directory);
+        delete state;
+        return false;
+    }
+
+    m_path = path;
+    m_state = state;
+    return true;
+}
+
+bool FileWatcher::Poll()
+{
+    if (!m_state)
+        return false;
+    WatchState* state = static_cast<WatchState*>(m_state);
+
+    bool changed = false;
+    DWORD bytes = 0;
+    if (state->pending && GetOverlappedResult(state->directory, &state->overlapped, &bytes, FALSE))
+    {
+        state->pending = false;
+
+        // Zero bytes means the buffer overflowed and the details were lost: assume our file changed
+        if (bytes == 0)
+            changed = true;
+
+        const char* record = reinterpret_cast<const char*>(state->buffer);
+        while (bytes != 0)
+        {
+            const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(record);
+            int length = static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+            if (CompareStringOrdinal(info->FileName, length, state->name, state->nameLength, TRUE) == CSTR_EQUAL)
+                changed = true;
+            if (info->NextEntryOffset == 0)
+                break;
+            record += info->NextEntryOffset;
+        }
+    }
+    else if (state->pending && GetLastError() != ERROR_IO_INCOMPLETE)
+    {
+        state->pending = false;   // the read failed; re-issue below
+    }
+
+    if (!state->pending)
+        Issue(*state);
+    return changed;
+}
+
+void FileWatcher::Close()
+{
+    if (!m_state)
+        return;
+
+    WatchState* state = static_cast<WatchState*>(m_state);
+    if (state->pending)
+    {
+        // The buffer must outlive the read, so wait for the cancellation to land
+        CancelIoEx(state->directory, &state->overlapped);
+        DWORD bytes = 0;
+        GetOverlappedResult(state->directory, &state->overlapped, &bytes, TRUE);
+    }
+    CloseHandle(state->overlapped.hEvent);
+    CloseHandle(state->directory);
+    delete state;
+    m_state = nullptr;
+    m_path.clear();
+    m_name.clear();
+}
@@ -0,0 +1,179 @@
+///----------------------------------------------------------------------------------------------------
+/// Game State - Cached map snapshot from MumbleLink, refreshed only when the game advances uiTick
+///----------------------------------------------------------------------------------------------------
+
+#include "game_state.h"
+
+#include <atomic>
+
+#include "mumble_link.h"
+
+namespace
+{
+    struct MapTypeInfo
+    {
+        uint32_t    flags;
+        const char* name;
+    };
+
+    // Indexed by MumbleContext::mapType
+    constexpr MapTypeInfo MapTypes[] = {
+        {MapFlag_None, "Redirect"},              //  0
+        {MapFlag_None, "Character Creation"},    //  1
+        {MapFlag_PvP,  "PvP"},                   //  2
+        {MapFlag_None, "GvG"},                   //  3
+        {MapFlag_None, "Instance"},              //  4
+        {MapFlag_None, "Open World"},            //  5
+        {MapFlag_PvP,  "Tournament"},            //  6
+        {MapFlag_None, "Tutorial"},              //  7
+        {MapFlag_PvP,  "User Tournament"},       //  8
+        {MapFlag_WvW,  "Eternal Battlegrounds"}, //  9
+        {MapFlag_WvW,  "Blue Borderlands"},      // 10
+        {MapFlag_WvW,  "Green Borderlands"},     // 11
+        {MapFlag_WvW,  "Red Borderlands"},       // 12
+        {MapFlag_None, "Fortune's Vale"},        // 13
+        {MapFlag_WvW,  "Obsidian Sanctum"},      // 14
+        {MapFlag_WvW,  "Edge of the Mists"},     // 15
+        {MapFlag_None, "Open World"},            // 16
+        {MapFlag_None, "Big Battle"},            // 17
+        {MapFlag_None, "WvW Lounge"},            // 18
+    };
+    constexpr uint32_t MapTypeCount = sizeof(MapTypes) / sizeof(MapTypes[0]);
+
+    struct MapIdInfo
+    {
+        uint32_t    mapId;
+        uint32_t    flags;
+        const char* name;
+    };
+
+    // Maps whose id says more than their type; flags here replace the type's flags
+    constexpr MapIdInfo MapIds[] = {
+        {38,   MapFlag_WvW,  "Eternal Battlegrounds"},
+        {50,   MapFlag_None, "Lion's Arch"},
+        {95,   MapFlag_WvW,  "Alpine Borderlands (Green)"},
+        {96,   MapFlag_WvW,  "Alpine Borderlands (Blue)"},
+        {350,  MapFlag_PvP,  "Heart of the Mists"},
+        {899,  MapFlag_WvW,  "Obsidian Sanctum"},
+        {968,  MapFlag_WvW,  "Edge of the Mists"},
+        {1099, MapFlag_WvW,  "Desert Borderlands (Red)"},
+        {1315, MapFlag_WvW,  "Armistice Bastion"},
+    };
+
+    constexpr const MapIdInfo* FindMapId(uint32_t mapId)
+    {
+        for (const MapIdInfo& info : MapIds)
+        {
+            if (info.mapId == mapId)
+                return &info;
+        }
+        return nullptr;
+    }
+
+    constexpr uint32_t Classify(uint32_t mapType, uint32_t mapId)
+    {
+        const MapIdInfo* info = FindMapId(mapId);
+        if (info)
+            return info->flags;
+        return mapType < MapTypeCount ? MapTypes[mapType].flags : MapFlag_None;
+    }
+
+    static_assert(Classify(9, 0) == MapFlag_WvW, "Eternal Battlegrounds map type is WvW");
+    static_assert(Classify(5, 1315) == MapFlag_WvW, "Armistice Bastion is WvW regardless of map type");
+    static_assert(Classify(5, 50) == MapFlag_None, "open world is neither WvW nor PvP");
+    static_assert(Classify(200, 0) == MapFlag_None, "unknown map types are unclassified");
+
+    // Snapshot word: mapId in the low 32 bits, mapType in bits 32-47, flags in bits 48-63
+    constexpr uint64_t Pack(uint32_t mapId, uint32_t mapType, uint32_t flags)
+    {
+        return uint64_t(mapId) | (uint64_t(mapType & 0xFFFF) << 32) | (uint64_t(flags & 0xFFFF) << 48);
+    }
+
+    std::atomic<uint64_t> g_snapshot{0};
+    std::atomic<uint32_t> g_lastTick{0};
+    std::atomic_flag      g_polling = ATOMIC_FLAG_INIT;
+}
+
+uint32_t GameState::Poll()
+{
+    // Not connected: keep the last known map rather than reporting a change
+    const LinkedMem* link = MumbleLink::Get();
+    if (!link)
+        return GameChange_None;
+
+    uint32_t tick = link->uiTick;
+    if (tick == g_lastTick.load(std::memory_order_relaxed))
+        return GameChange_None;
+
+    // Another thread is already refreshing this tick
+    if (g_polling.test_and_set(std::memory_order_acquire))
+        return GameChange_None;
+
+    g_lastTick.store(tick, std::memory_order_relaxed);
+
+    const MumbleContext* ctx = MumbleLink::Context();
+    uint32_t mapId = ctx->mapId;
+    uint32_t mapType = ctx->mapType;
+    uint64_t snapshot = Pack(mapId, mapType, Classify(mapType, mapId));
+
+    uint32_t changes = GameChange_None;
+    uint64_t previous = g_snapshot.load(std::memory_order_relaxed);
+    if (snapshot != previous)
+    {
+        g_snapshot.store(snapshot, std::memory_order_relaxed);
+        changes |= GameChange_Map;
+
+        bool wasWvW = ((previous >> 48) & MapFlag_WvW) != 0;
+        bool isWvW = ((snapshot >> 48) & MapFlag_WvW) != 0;
+        if (isWvW && !wasWvW)
+            changes |= GameChange_EnteredWvW;
+        else if (wasWvW && !isWvW)
+            changes |= GameChange_LeftWvW;
+    }
+
+    g_polling.clear(std::memory_order_release);
+    return changes;
+}
+
+uint32_t GameState::MapId()
+{
+    return static_cast<uint32_t>(g_snapshot.load(std::memory_order_relaxed));
+}
+
+uint32_t GameState::MapType()
+{
+    return static_cast<uint32_t>((g_snapshot.load(std::memory_order_relaxed) >> 32) & 0xFFFF);
+}
+
+uint32_t GameState::MapFlags()
+{
+    return static_cast<uint32_t>(g_snapshot.load(std::memory_order_relaxed) >> 48);
+}
+
+bool GameState::IsInWvW()
+{
+    return (MapFlags() & MapFlag_WvW) != 0;
+}
+
+bool GameState::IsInPvP()
+{
+    return (MapFlags() & MapFlag_PvP) != 0;
+}
+
+uint32_t GameState::ClassifyMap(uint32_t mapType, uint32_t mapId)
+{
+    return Classify(mapType, mapId);
+}
+
+const char* GameState::MapName(uint32_t mapType, uint32_t mapId)
+{
+    if (const MapIdInfo* info = FindMapId(mapId))
+        return info->name;
+    return mapType < MapTypeCount ? MapTypes[mapType].name : "Unknown";
+}
+
+void GameState::Reset()
+{
+    g_snapshot.store(0, std::memory_order_relaxed);
+    g_lastTick.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,53 @@
+///----------------------------------------------------------------------------------------------------
+/// Game State - Cached map snapshot from MumbleLink, refreshed only when the game advances uiTick
+///
+/// The map is classified once per change and packed into a single atomic word, so IsInWvW() and the
+/// other queries are one relaxed load on any thread. Poll() is cheap enough to call at the top of
+/// every event handler: while uiTick is unchanged it compares one value and returns.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_GAME_STATE_H
+#define STREAMLINK_GAME_STATE_H
+
+#include <cstdint>
+
+/// Map classification bits
+enum EMapFlags : uint32_t
+{
+    MapFlag_None = 0,
+    MapFlag_WvW  = 1 << 0,    // WvW maps and the Armistice Bastion lounge
+    MapFlag_PvP  = 1 << 1     // structured PvP, tournaments and the Heart of the Mists lobby
+};
+
+/// Bit flags returned by Poll
+enum EGameChange : uint32_t
+{
+    GameChange_None       = 0,
+    GameChange_Map        = 1 << 0,   // map id or type changed
+    GameChange_EnteredWvW = 1 << 1,
+    GameChange_LeftWvW    = 1 << 2
+};
+
+namespace GameState
+{
+    /// Refreshes the snapshot if MumbleLink ticked since the last poll. Safe from any thread; when
+    /// two threads poll at once, one refreshes and the other returns GameChange_None.
+    uint32_t Poll();
+
+    uint32_t MapId();
+    uint32_t MapType();
+    uint32_t MapFlags();
+    bool     IsInWvW();
+    bool     IsInPvP();
+
+    /// Classification of a map, independent of any live MumbleLink.
+    uint32_t ClassifyMap(uint32_t mapType, uint32_t mapId);
+
+    /// Display name of a map: known map ids first, then a name for its map type.
+    const char* MapName(uint32_t mapType, uint32_t mapId);
+
+    /// Forgets the snapshot; the next Poll reads the map again.
+    void Reset();
+}
+
+#endif
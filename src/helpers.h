@@ -0,0 +1,41 @@
+///----------------------------------------------------------------------------------------------------
+/// Helpers - Small bit and text routines shared by the settings-defined rule and counter parsers
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_HELPERS_H
+#define STREAMLINK_HELPERS_H
+
+#include <cstdint>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+///----------------------------------------------------------------------------------------------------
+/// LowestBit - Index of the least significant set bit (value must be non-zero)
+///----------------------------------------------------------------------------------------------------
+inline uint32_t LowestBit(uint32_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Trim - Copy of text without leading and trailing spaces and tabs
+///----------------------------------------------------------------------------------------------------
+inline std::string Trim(const std::string& text)
+{
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string::npos)
+        return std::string();
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+
+#endif
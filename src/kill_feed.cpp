@@ -0,0 +1,144 @@
+///----------------------------------------------------------------------------------------------------
+/// Kill Feed - Our last few kills with the victim's name and profession and the killing-blow skill
+///----------------------------------------------------------------------------------------------------
+
+#include "kill_feed.h"
+
+#include <cstdio>
+#include <cstring>
+
+static const char* const ProfessionNames[] = {
+    "", "Guardian", "Warrior", "Engineer", "Ranger", "Thief", "Elementalist", "Mesmer", "Necromancer", "Revenant",
+};
+
+///----------------------------------------------------------------------------------------------------
+/// SkillHash - Fibonacci hash of a skill id, top bits, so nearby ids spread over the table
+///----------------------------------------------------------------------------------------------------
+static size_t SkillHash(uint32_t skillId)
+{
+    static_assert(KillFeed::MaxSkills * 2 == 512, "the shift below assumes a 512-slot table");
+    return (skillId * 2654435761u) >> 23;
+}
+
+bool CaptureKillNames(const EvCombatData& data, KillNames& out)
+{
+    const ArcDPS::CombatEvent* ev = data.ev;
+    if (!ev || ev->IsStatechange != ArcDPS::CBTS_NONE || ev->Result != ArcDPS::CBTR_KILLINGBLOW)
+        return false;
+    if (!data.src || !data.src->IsSelf || !data.dst || !IsPlayer(data.dst->Profession))
+        return false;
+
+    out.Time = ev->Time;
+    out.DstId = data.dst->ID;
+    out.SkillId = ev->SkillID;
+    CopyName(out.Victim, sizeof(out.Victim), data.dst->Name);
+    CopyName(out.Skill, sizeof(out.Skill), data.skillname);
+    return true;
+}
+
+void KillFeed::Stage(const KillNames& names)
+{
+    // Our kills arrive on both feeds; the second capture of one adds nothing
+    for (size_t i = 1; i <= m_pendingCount; i++)
+    {
+        const KillNames& pending = m_pending[(m_pendingHead + MaxPending - i) % MaxPending];
+        if (pending.Time == names.Time && pending.DstId == names.DstId && pending.SkillId == names.SkillId)
+            return;
+    }
+
+    m_pending[m_pendingHead] = names;
+    m_pendingHead = (m_pendingHead + 1) % MaxPending;
+    if (m_pendingCount < MaxPending)
+        m_pendingCount++;
+}
+
+void KillFeed::Add(const CombatRecord& record)
+{
+    size_t slot = m_head;
+    m_entries[slot].SkillId = record.SkillId;
+    m_entries[slot].Profession = record.DstProfession;
+    m_victimNames[slot][0] = '\0';
+
+    // Newest first
+    for (size_t i = 1; i <= m_pendingCount; i++)
+    {
+        const KillNames& names = m_pending[(m_pendingHead + MaxPending - i) % MaxPending];
+        if (names.Time == record.Time && names.DstId == record.DstId && names.SkillId == record.SkillId)
+        {
+            memcpy(m_victimNames[slot], names.Victim, sizeof(names.Victim));
+            InternSkill(names.SkillId, names.Skill);
+            break;
+        }
+    }
+
+    m_head = (m_head + 1) % MaxKills;
+    if (m_count < MaxKills)
+        m_count++;
+}
+
+size_t KillFeed::Render(char* buffer, size_t size) const
+{
+    size_t length = 0;
+    buffer[0] = '\0';
+    for (size_t i = 1; i <= m_count && length < size; i++)
+    {
+        size_t slot = (m_head + MaxKills - i) % MaxKills;
+        const Entry& entry = m_entries[slot];
+        const char* victim = m_victimNames[slot][0] != '\0' ? m_victimNames[slot] : "Unknown";
+        const char* profession = entry.Profession < sizeof(ProfessionNames) / sizeof(ProfessionNames[0])
+                                     ? ProfessionNames[entry.Profession] : "";
+        const char* skill = SkillName(entry.SkillId);
+
+        int written = skill ? snprintf(buffer + length, size - length, "%s%s (%s) - %s", i > 1 ? "\n" : "",
+                                       victim, profession, skill)
+                            : snprintf(buffer + length, size - length, "%s%s (%s) - Skill #%u", i > 1 ? "\n" : "",
+                                       victim, profession, entry.SkillId);
+        if (written < 0)
+            break;
+        length += static_cast<size_t>(written);
+    }
+    return length < size ? length : size - 1;
+}
+
+const char* KillFeed::SkillName(uint32_t skillId) const
+{
+    size_t index = SkillHash(skillId);
+    while (m_skills[index].Used)
+    {
+        if (m_skills[index].SkillId == skillId)
+            return m_skillArena + m_skills[index].Offset;
+        index = (index + 1) % SkillTableSize;
+    }
+    return nullptr;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// InternSkill - Cache a skill's name the first time it is seen; later captures of it are ignored
+///----------------------------------------------------------------------------------------------------
+void KillFeed::InternSkill(uint32_t skillId, const char* name)
+{
+    size_t length = strlen(name);
+    if (length == 0 || m_skillCount >= MaxSkills || m_skillArenaUsed + length + 1 > SkillArenaSize)
+        return;
+
+    size_t index = SkillHash(skillId);
+    while (m_skills[index].Used)
+    {
+        if (m_skills[index].SkillId == skillId)
+            return;
+        index = (index + 1) % SkillTableSize;
+    }
+
+    memcpy(m_skillArena + m_skillArenaUsed, name, length + 1);
+    m_skills[index] = {skillId, static_cast<uint16_t>(m_skillArenaUsed), true};
+    m_skillArenaUsed += length + 1;
+    m_skillCount++;
+}
+
+void KillFeed::Clear()
+{
+    m_head = 0;
+    m_count = 0;
+    m_pendingHead = 0;
+    m_pendingCount = 0;
+}
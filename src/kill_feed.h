@@ -0,0 +1,101 @@
+///----------------------------------------------------------------------------------------------------
+/// Kill Feed - Our last few kills with the victim's name and profession and the killing-blow skill
+///
+/// ArcDPS only guarantees AgentShort::Name and EvCombatData::skillname for the duration of the
+/// callback, so the callback copies them into a KillNames for the events that can be one of our kills
+/// (CaptureKillNames), and the worker pairs that copy with the record once the tracker credits the
+/// kill. Nothing here allocates after construction: the feed is a ring of MaxKills entries whose victim
+/// names live in a preallocated arena of one MaxNameLength slot per entry, reused when the entry is
+/// overwritten, and skill names are interned once per skill id in an append-only arena indexed by an
+/// open-addressing map. Not thread-safe; the owner serialises access.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_KILL_FEED_H
+#define STREAMLINK_KILL_FEED_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ArcDPS.h"
+#include "combat_record.h"
+
+/// Names from one killing blow, copied out of the callback payload
+struct KillNames
+{
+    static constexpr size_t MaxNameLength = 64;   // bytes kept per name, terminator included
+
+    uint64_t Time;
+    uint64_t DstId;
+    uint32_t SkillId;
+    char     Victim[MaxNameLength];
+    char     Skill[MaxNameLength];
+};
+
+/// Copies the names if data is our killing blow on a player; false (out untouched) for anything else,
+/// squadmates' kills included, which is almost every event and costs a few compares. Safe from the
+/// callback thread.
+bool CaptureKillNames(const EvCombatData& data, KillNames& out);
+
+class KillFeed
+{
+public:
+    static constexpr size_t MaxKills = 5;
+    static constexpr size_t MaxPending = 16;       // captured names waiting for their record
+    static constexpr size_t MaxSkills = 256;       // distinct skill names cached
+    static constexpr size_t SkillArenaSize = 8192;
+    static constexpr size_t MaxTextSize = MaxKills * 160;   // Render output, newlines included
+
+    /// Holds captured names until Add sees the record they belong to. A kill already staged (the same
+    /// kill from the other feed) is ignored; the oldest is dropped when full.
+    void Stage(const KillNames& names);
+
+    /// A kill credited to us (CombatChange_Kill): becomes the newest entry, evicting the oldest once
+    /// MaxKills are held. Names come from the staged capture with the same time, target and skill.
+    void Add(const CombatRecord& record);
+
+    /// One line per kill, newest first: "Victim (Profession) - Skill". Returns the length written
+    /// (always less than size, which must be at least 1).
+    size_t Render(char* buffer, size_t size) const;
+
+    /// Cached name of a skill, nullptr if it was never captured (or the cache is full).
+    const char* SkillName(uint32_t skillId) const;
+
+    size_t Count() const { return m_count; }
+
+    /// Empty feed and staging; cached skill names are kept, they do not change.
+    void Clear();
+
+private:
+    struct Entry
+    {
+        uint32_t SkillId;
+        uint32_t Profession;
+    };
+
+    struct SkillSlot
+    {
+        uint32_t SkillId;
+        uint16_t Offset;   // into m_skillArena
+        bool     Used;
+    };
+
+    static constexpr size_t SkillTableSize = MaxSkills * 2;
+
+    void InternSkill(uint32_t skillId, const char* name);
+
+    Entry     m_entries[MaxKills] = {};
+    char      m_victimNames[MaxKills][KillNames::MaxNameLength] = {};   // arena: one slot per entry
+    size_t    m_head = 0;    // slot the next kill goes to
+    size_t    m_count = 0;
+
+    KillNames m_pending[MaxPending] = {};
+    size_t    m_pendingHead = 0;
+    size_t    m_pendingCount = 0;
+
+    SkillSlot m_skills[SkillTableSize] = {};
+    char      m_skillArena[SkillArenaSize] = {};
+    size_t    m_skillArenaUsed = 0;
+    size_t    m_skillCount = 0;
+};
+
+#endif
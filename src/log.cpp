@@ -0,0 +1,38 @@
+///----------------------------------------------------------------------------------------------------
+/// Log - Logging shim over the Nexus logger
+///----------------------------------------------------------------------------------------------------
+
+#include "log.h"
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+
+static std::atomic<AddonAPI*> g_logApi{nullptr};
+
+void Log::SetApi(AddonAPI* api)
+{
+    g_logApi.store(api, std::memory_order_release);
+}
+
+void Log::Write(ELogLevel level, const char* message)
+{
+    AddonAPI* api = g_logApi.load(std::memory_order_acquire);
+    if (api && api->Log)
+        api->Log(level, ADDON_NAME, message);
+}
+
+void Log::Writef(ELogLevel level, const char* format, ...)
+{
+    AddonAPI* api = g_logApi.load(std::memory_order_acquire);
+    if (!api || !api->Log)
+        return;
+
+    char message[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    api->Log(level, ADDON_NAME, message);
+}
@@ -0,0 +1,28 @@
+///----------------------------------------------------------------------------------------------------
+/// Log - Logging shim over the Nexus logger
+///
+/// Routes messages to AddonAPI::Log while an API is attached and drops them otherwise, so the tracking
+/// code can log without caring whether it runs inside the game, a test or a benchmark.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_LOG_H
+#define STREAMLINK_LOG_H
+
+#include "Nexus.h"
+
+#define ADDON_NAME "Nexus Streamlink"
+
+namespace Log
+{
+    /// Attaches (or with nullptr detaches) the API used for logging.
+    void SetApi(AddonAPI* api);
+
+    void Write(ELogLevel level, const char* message);
+
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    void Writef(ELogLevel level, const char* format, ...);
+}
+
+#endif
@@ -0,0 +1,38 @@
+///----------------------------------------------------------------------------------------------------
+/// Mapped File - Read-only memory mapping of a whole file
+///
+/// Wraps CreateFileMapping/MapViewOfFile on Windows and mmap on POSIX, so files written by the addon
+/// (the session journal) can be read back without copying them through a buffer.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_MAPPED_FILE_H
+#define STREAMLINK_MAPPED_FILE_H
+
+#include <cstddef>
+
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Maps the file read-only. Fails if it does not exist or is empty.
+    bool Open(const char* path);
+
+    /// Unmaps the file; it can then be replaced or deleted.
+    void Close();
+
+    bool        IsOpen() const { return m_data != nullptr; }
+    const void* Data() const { return m_data; }
+    size_t      Size() const { return m_size; }
+
+private:
+    void*  m_data = nullptr;
+    size_t m_size = 0;
+    void*  m_handle = nullptr;     // HANDLE of the file mapping (Windows only)
+};
+
+#endif
@@ -0,0 +1,299 @@
+///----------------------------------------------------------------------------------------------------
+/// Metrics - Latency histograms for the event callbacks and write paths
+///----------------------------------------------------------------------------------------------------
+
+#include "metrics.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace
+{
+    // Log-linear buckets: values below 16 ticks are exact, above that every power of two is split into
+    // 16 linear sub-buckets (at most ~6% error). Samples of 2^40 ticks and more share the last bucket.
+    constexpr uint32_t SubBucketBits = 4;
+    constexpr uint64_t SubBuckets = uint64_t(1) << SubBucketBits;
+    constexpr uint32_t MaxValueBits = 40;
+    constexpr size_t   BucketCount = (MaxValueBits - SubBucketBits + 1) * SubBuckets;
+
+    const char* const ProbeNames[Metrics::Probe_Count] = {
+        "local_event",
+        "squad_event",
+        "squad_update",
+        "event_batch",
+        "file_write",
+        "state_publish",
+        "overlay_refresh",
+    };
+
+    // Written only by the owning thread (relaxed load + store, no read-modify-write); read by Render*
+    struct Histogram
+    {
+        std::atomic<uint32_t> buckets[BucketCount];
+        std::atomic<uint64_t> max;
+    };
+
+    struct alignas(64) ThreadSlot
+    {
+        std::atomic<bool> owned;
+        Histogram         probes[Metrics::Probe_Count];
+    };
+
+    /// Gives the slot back when its thread exits; the counts stay and the next owner adds to them
+    struct SlotOwner
+    {
+        ThreadSlot* slot = nullptr;
+        ~SlotOwner()
+        {
+            if (slot)
+                slot->owned.store(false, std::memory_order_release);
+        }
+    };
+
+    ThreadSlot                        g_slots[Metrics::MaxThreads];
+    std::atomic<uint64_t>             g_lost{0};
+    thread_local SlotOwner            t_owner;
+
+    // Tick rate reference, taken when recording is first enabled
+    std::atomic<uint64_t>             g_referenceTicks{0};
+    std::atomic<int64_t>              g_referenceNs{0};
+}
+
+std::atomic<bool> Metrics::g_enabled{false};
+
+///----------------------------------------------------------------------------------------------------
+/// HighestBit - Index of the most significant set bit (value must be non-zero)
+///----------------------------------------------------------------------------------------------------
+static uint32_t HighestBit(uint64_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<uint32_t>(index);
+#else
+    return 63u - static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+}
+
+static size_t BucketOf(uint64_t ticks)
+{
+    if (ticks < SubBuckets)
+        return static_cast<size_t>(ticks);
+
+    uint32_t msb = HighestBit(ticks);
+    if (msb >= MaxValueBits)
+        return BucketCount - 1;
+
+    uint32_t shift = msb - SubBucketBits;
+    return static_cast<size_t>((shift + 1) * SubBuckets + (ticks >> shift) - SubBuckets);
+}
+
+/// Largest value that lands in the bucket
+static uint64_t BucketUpperBound(size_t bucket)
+{
+    if (bucket < SubBuckets)
+        return bucket;
+
+    uint64_t shift = bucket / SubBuckets - 1;
+    uint64_t sub = bucket % SubBuckets + SubBuckets;
+    return ((sub + 1) << shift) - 1;
+}
+
+static int64_t SteadyNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+///----------------------------------------------------------------------------------------------------
+/// NsPerTick - Counter rate measured since the reference point, or 0 while less than 1 ms of it has
+///             passed (the caller reports no durations yet rather than waiting for it)
+///----------------------------------------------------------------------------------------------------
+static double NsPerTick()
+{
+    if (g_referenceNs.load(std::memory_order_acquire) == 0)
+    {
+        g_referenceTicks.store(Metrics::ReadTicks(), std::memory_order_relaxed);
+        g_referenceNs.store(SteadyNs(), std::memory_order_release);
+    }
+
+    uint64_t elapsedTicks = Metrics::ReadTicks() - g_referenceTicks.load(std::memory_order_relaxed);
+    int64_t elapsedNs = SteadyNs() - g_referenceNs.load(std::memory_order_acquire);
+    if (elapsedNs < 1000000 || elapsedTicks == 0)
+        return 0.0;
+    return static_cast<double>(elapsedNs) / static_cast<double>(elapsedTicks);
+}
+
+static ThreadSlot* ClaimSlot()
+{
+    for (ThreadSlot& slot : g_slots)
+    {
+        bool expected = false;
+        if (!slot.owned.load(std::memory_order_relaxed) &&
+            slot.owned.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void Metrics::SetEnabled(bool enabled)
+{
+    if (enabled && g_referenceNs.load(std::memory_order_acquire) == 0)
+    {
+        g_referenceTicks.store(ReadTicks(), std::memory_order_relaxed);
+        g_referenceNs.store(SteadyNs(), std::memory_order_release);
+    }
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Metrics::Record(EProbe probe, uint64_t ticks)
+{
+    ThreadSlot* slot = t_owner.slot;
+    if (!slot)
+    {
+        slot = ClaimSlot();
+        if (!slot)
+        {
+            g_lost.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        t_owner.slot = slot;
+    }
+
+    Histogram& histogram = slot->probes[probe];
+    std::atomic<uint32_t>& bucket = histogram.buckets[BucketOf(ticks)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (ticks > histogram.max.load(std::memory_order_relaxed))
+        histogram.max.store(ticks, std::memory_order_relaxed);
+}
+
+Metrics::Summary Metrics::Summarize(EProbe probe)
+{
+    uint64_t merged[BucketCount] = {};
+    uint64_t count = 0;
+    uint64_t maxTicks = 0;
+    for (const ThreadSlot& slot : g_slots)
+    {
+        const Histogram& histogram = slot.probes[probe];
+        for (size_t b = 0; b < BucketCount; b++)
+        {
+            uint32_t n = histogram.buckets[b].load(std::memory_order_relaxed);
+            merged[b] += n;
+            count += n;
+        }
+        uint64_t slotMax = histogram.max.load(std::memory_order_relaxed);
+        if (slotMax > maxTicks)
+            maxTicks = slotMax;
+    }
+
+    Summary summary = {count, 0, 0, 0};
+    if (count == 0)
+        return summary;
+
+    // Bucket upper bounds, capped at the true maximum so p99 never exceeds max. Within 1 ms of the
+    // first enable the tick rate is not known yet and the durations stay 0.
+    double nsPerTick = NsPerTick();
+    uint64_t p50Rank = (count + 1) / 2;
+    uint64_t p99Rank = count - count / 100;
+    uint64_t seen = 0;
+    uint64_t p50 = maxTicks;
+    uint64_t p99 = maxTicks;
+    bool haveP50 = false;
+    for (size_t b = 0; b < BucketCount; b++)
+    {
+        seen += merged[b];
+        uint64_t upper = BucketUpperBound(b) < maxTicks ? BucketUpperBound(b) : maxTicks;
+        if (!haveP50 && seen >= p50Rank)
+        {
+            p50 = upper;
+            haveP50 = true;
+        }
+        if (seen >= p99Rank)
+        {
+            p99 = upper;
+            break;
+        }
+    }
+
+    summary.P50 = static_cast<uint64_t>(static_cast<double>(p50) * nsPerTick);
+    summary.P99 = static_cast<uint64_t>(static_cast<double>(p99) * nsPerTick);
+    summary.Max = static_cast<uint64_t>(static_cast<double>(maxTicks) * nsPerTick);
+    return summary;
+}
+
+const char* Metrics::ProbeName(EProbe probe)
+{
+    return probe < Probe_Count ? ProbeNames[probe] : "unknown";
+}
+
+uint64_t Metrics::Lost()
+{
+    return g_lost.load(std::memory_order_relaxed);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Appendf - snprintf at pos; stops appending once the buffer is full
+///----------------------------------------------------------------------------------------------------
+#if defined(__GNUC__)
+__attribute__((format(printf, 4, 5)))
+#endif
+static void Appendf(char* buffer, size_t size, size_t& pos, const char* format, ...)
+{
+    if (pos >= size)
+        return;
+
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buffer + pos, size - pos, format, args);
+    va_end(args);
+    if (len > 0)
+        pos += static_cast<size_t>(len) < size - pos ? static_cast<size_t>(len) : size - pos;
+}
+
+size_t Metrics::RenderText(char* buffer, size_t size)
+{
+    size_t pos = 0;
+    Appendf(buffer, size, pos, "%-16s %12s %10s %10s %12s\n", "probe", "count", "p50 ns", "p99 ns", "max ns");
+    for (uint32_t p = 0; p < Probe_Count; p++)
+    {
+        Summary s = Summarize(static_cast<EProbe>(p));
+        Appendf(buffer, size, pos, "%-16s %12llu %10llu %10llu %12llu\n", ProbeNames[p],
+                (unsigned long long)s.Count, (unsigned long long)s.P50, (unsigned long long)s.P99,
+                (unsigned long long)s.Max);
+    }
+    Appendf(buffer, size, pos, "recording %s, %llu samples lost\n", IsEnabled() ? "on" : "off",
+            (unsigned long long)Lost());
+    return pos;
+}
+
+size_t Metrics::RenderJson(char* buffer, size_t size)
+{
+    size_t pos = 0;
+    Appendf(buffer, size, pos, "{\"enabled\":%s,\"lost\":%llu,\"probes\":{", IsEnabled() ? "true" : "false",
+            (unsigned long long)Lost());
+    for (uint32_t p = 0; p < Probe_Count; p++)
+    {
+        Summary s = Summarize(static_cast<EProbe>(p));
+        Appendf(buffer, size, pos, "%s\"%s\":{\"count\":%llu,\"p50_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu}",
+                p ? "," : "", ProbeNames[p], (unsigned long long)s.Count, (unsigned long long)s.P50,
+                (unsigned long long)s.P99, (unsigned long long)s.Max);
+    }
+    Appendf(buffer, size, pos, "}}\n");
+    return pos;
+}
+
+void Metrics::Reset()
+{
+    for (ThreadSlot& slot : g_slots)
+    {
+        for (Histogram& histogram : slot.probes)
+        {
+            for (std::atomic<uint32_t>& bucket : histogram.buckets)
+                bucket.store(0, std::memory_order_relaxed);
+            histogram.max.store(0, std::memory_order_relaxed);
+        }
+    }
+    g_lost.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,118 @@
+///----------------------------------------------------------------------------------------------------
+/// Metrics - Latency histograms for the event callbacks and write paths
+///
+/// STREAMLINK_METRICS_SCOPE(probe) times the rest of the enclosing block with the CPU timestamp
+/// counter (__rdtsc on x86 and x64, MSVC included; steady_clock on other targets). Ticks are turned
+/// into nanoseconds against steady_clock from the moment recording is first enabled. Samples go
+/// into log-linear histograms owned by the recording thread: recording is a handful of relaxed
+/// loads and stores to memory no other thread writes, with no locks and no shared cache lines.
+/// Render*() merges every thread's histograms on demand (the writer thread, a few times a minute).
+///
+/// When disabled, a scope costs one relaxed load and a branch on entry and exit.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_METRICS_H
+#define STREAMLINK_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace Metrics
+{
+    enum EProbe : uint32_t
+    {
+        Probe_LocalEvent,       // EV_ARCDPS_COMBATEVENT_LOCAL_RAW callback
+        Probe_SquadEvent,       // EV_ARCDPS_COMBATEVENT_SQUAD_RAW callback
+        Probe_SquadUpdate,      // EV_UNOFFICIAL_EXTRAS_SQUAD_UPDATE callback
+        Probe_EventBatch,       // one batch on the event queue worker
+        Probe_FileWrite,        // render and write of one output file
+        Probe_StatePublish,     // shared memory publish
+        Probe_OverlayRefresh,   // overlay server re-render and delta broadcast
+        Probe_Count
+    };
+
+    constexpr size_t MaxThreads = 32;   // threads that can record; later ones are counted as lost
+
+    /// Cached switch for the hot path.
+    extern std::atomic<bool> g_enabled;
+
+    inline bool IsEnabled()
+    {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Turns recording on or off at runtime. Histograms are kept across switches.
+    void SetEnabled(bool enabled);
+
+    /// Raw timestamp in counter ticks.
+    inline uint64_t ReadTicks()
+    {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /// Adds one sample to the calling thread's histogram for the probe.
+    void Record(EProbe probe, uint64_t ticks);
+
+    /// Merged view of one probe across threads, in nanoseconds. The durations are 0 until 1 ms after
+    /// recording was first enabled, when the tick rate becomes known; Count is always exact.
+    struct Summary
+    {
+        uint64_t Count;
+        uint64_t P50;
+        uint64_t P99;
+        uint64_t Max;
+    };
+    Summary Summarize(EProbe probe);
+
+    const char* ProbeName(EProbe probe);
+
+    /// Samples dropped because MaxThreads threads already own histograms.
+    uint64_t Lost();
+
+    /// Plain text table and JSON object over every probe (OUTPUT_RENDER signatures).
+    size_t RenderText(char* buffer, size_t size);
+    size_t RenderJson(char* buffer, size_t size);
+
+    /// Clears every histogram. Only while nothing is recording.
+    void Reset();
+
+    ///------------------------------------------------------------------------------------------------
+    /// Scope - Records the time from construction to destruction, if enabled at construction
+    ///------------------------------------------------------------------------------------------------
+    class Scope
+    {
+    public:
+        explicit Scope(EProbe probe) : m_probe(probe), m_start(IsEnabled() ? ReadTicks() : 0) {}
+        ~Scope()
+        {
+            if (m_start != 0)
+                Record(m_probe, ReadTicks() - m_start);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        EProbe   m_probe;
+        uint64_t m_start;
+    };
+}
+
+#define STREAMLINK_METRICS_CONCAT_INNER(a, b) a##b
+#define STREAMLINK_METRICS_CONCAT(a, b) STREAMLINK_METRICS_CONCAT_INNER(a, b)
+#define STREAMLINK_METRICS_SCOPE(probe) \
+    Metrics::Scope STREAMLINK_METRICS_CONCAT(metricsScope_, __LINE__)(probe)
+
+#endif
@@ -0,0 +1,117 @@
+///----------------------------------------------------------------------------------------------------
+/// MPSC Ring - Bounded lock-free multi-producer / single-consumer queue
+///
+/// Fixed capacity (power of two), no allocation after construction. Each cell carries a sequence
+/// number, so producers claim a slot with one CAS on the head and publish it with one store; the
+/// consumer never writes shared counters that producers spin on. TryPush fails instead of blocking
+/// when the ring is full.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_MPSC_RING_H
+#define STREAMLINK_MPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+template <typename T, size_t Capacity>
+class MpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    MpscRing()
+    {
+        for (size_t i = 0; i < Capacity; i++)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /// Copies value into the ring. Returns false if the ring is full. Safe from any thread.
+    bool TryPush(const T& value)
+    {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;)
+        {
+            cell = &m_cells[pos & Mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Removes the oldest element. Consumer thread only.
+    bool TryPop(T& out)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[tail & Mask];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq != tail + 1)
+            return false;
+
+        out = cell.value;
+        cell.sequence.store(tail + Capacity, std::memory_order_release);
+        m_tail.store(tail + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Removes up to max elements into out. Consumer thread only.
+    size_t PopBatch(T* out, size_t max)
+    {
+        size_t count = 0;
+        while (count < max && TryPop(out[count]))
+            count++;
+        return count;
+    }
+
+    /// Approximate number of queued elements.
+    size_t SizeApprox() const
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        return head >= tail ? head - tail : 0;
+    }
+
+    /// Number of pushes that have claimed a slot so far (monotonic). Once the consumer has popped this
+    /// many elements in total, everything pushed before the call has been consumed.
+    size_t Claimed() const
+    {
+        return m_head.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t Mask = Capacity - 1;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T                   value;
+    };
+
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};   // written by the consumer only
+    alignas(64) Cell                m_cells[Capacity];
+};
+
+#endif
@@ -0,0 +1,38 @@
+///----------------------------------------------------------------------------------------------------
+/// MumbleLink - Read-only view of the game's MumbleLink shared memory
+///----------------------------------------------------------------------------------------------------
+
+#include "mumble_link.h"
+
+#include "shared_memory.h"
+
+static SharedMemory g_mumbleMemory;
+static const LinkedMem* g_mumbleLink = nullptr;
+
+bool MumbleLink::Open(const char* name)
+{
+    Close();
+    if (!g_mumbleMemory.OpenReadOnly(name, sizeof(LinkedMem)))
+        return false;
+
+    g_mumbleLink = static_cast<const LinkedMem*>(g_mumbleMemory.Data());
+    return true;
+}
+
+void MumbleLink::Close()
+{
+    g_mumbleLink = nullptr;
+    g_mumbleMemory.Close();
+}
+
+const LinkedMem* MumbleLink::Get()
+{
+    return g_mumbleLink;
+}
+
+const MumbleContext* MumbleLink::Context()
+{
+    if (!g_mumbleLink)
+        return nullptr;
+    return reinterpret_cast<const MumbleContext*>(g_mumbleLink->context);
+}
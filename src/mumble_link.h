@@ -0,0 +1,56 @@
+///----------------------------------------------------------------------------------------------------
+/// MumbleLink - Read-only view of the game's MumbleLink shared memory
+///
+/// The region is opened once at load; every query reads the live memory. Map classification and
+/// change detection live in GameState, which snapshots this view.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_MUMBLE_LINK_H
+#define STREAMLINK_MUMBLE_LINK_H
+
+#include <cstdint>
+
+// MumbleLink structures for reading GW2 game state
+struct MumbleContext
+{
+    unsigned char serverAddress[28];
+    uint32_t      mapId;
+    uint32_t      mapType;
+    uint32_t      shardId;
+    uint32_t      instance;
+    uint32_t      buildId;
+};
+
+struct LinkedMem
+{
+    uint32_t uiVersion;
+    uint32_t uiTick;
+    float    fAvatarPosition[3];
+    float    fAvatarFront[3];
+    float    fAvatarTop[3];
+    wchar_t  name[256];
+    float    fCameraPosition[3];
+    float    fCameraFront[3];
+    float    fCameraTop[3];
+    wchar_t  identity[256];
+    uint32_t context_len;
+    unsigned char context[256];
+};
+
+namespace MumbleLink
+{
+    /// Default region name; the game uses another one when started with -mumble <name>.
+    constexpr const char* DefaultName = "MumbleLink";
+
+    /// Maps the named region read-only. Returns false if the game has not created it.
+    bool Open(const char* name);
+    void Close();
+
+    /// Live view of the region, or nullptr when not connected.
+    const LinkedMem* Get();
+
+    /// Context block of the live view, or nullptr when not connected.
+    const MumbleContext* Context();
+}
+
+#endif
@@ -0,0 +1,62 @@
+///----------------------------------------------------------------------------------------------------
+/// Net - Minimal non-blocking loopback sockets
+///
+/// Wraps Winsock on Windows and BSD sockets on POSIX. Everything listens on or connects to 127.0.0.1
+/// only; the overlay server never accepts connections from other machines.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_NET_H
+#define STREAMLINK_NET_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Net
+{
+    typedef intptr_t Socket;
+    constexpr Socket InvalidSocket = -1;
+
+    /// Per-process socket library setup (WSAStartup on Windows). Calls nest.
+    bool Startup();
+    void Cleanup();
+
+    /// Non-blocking TCP listener on 127.0.0.1. Port 0 picks a free port; boundPort receives it.
+    Socket ListenLoopback(uint16_t port, uint16_t& boundPort);
+
+    /// Accepts one pending connection as a non-blocking socket, or returns InvalidSocket.
+    Socket Accept(Socket listener);
+
+    /// Non-blocking TCP connection to 127.0.0.1 (completes in the background; poll for writable).
+    Socket ConnectLoopback(uint16_t port);
+
+    /// Non-blocking UDP socket bound to 127.0.0.1 that other threads can poke with Wake().
+    Socket OpenWakeSocket(uint16_t& boundPort);
+
+    /// Sends one byte to the wake socket. Never blocks; a full queue already means "wake up".
+    void Wake(Socket wakeSocket, uint16_t port);
+
+    /// Discards everything queued on the wake socket.
+    void DrainWake(Socket wakeSocket);
+
+    /// Bytes sent, 0 if the socket buffer is full, -1 on error.
+    long Send(Socket socket, const void* data, size_t length);
+
+    /// Bytes received, 0 if nothing is available, -1 when the peer closed or on error.
+    long Recv(Socket socket, void* buffer, size_t size);
+
+    void Close(Socket socket);
+
+    struct PollEntry
+    {
+        Socket socket;
+        bool   wantWrite;
+        bool   readable;   // set by Poll; also set on hang-up or error so the next Recv sees it
+        bool   writable;   // set by Poll
+    };
+
+    /// Waits until an entry is readable (or writable, if asked) or the timeout expires.
+    /// Returns the number of ready entries, 0 on timeout, -1 on error.
+    int Poll(PollEntry* entries, size_t count, int timeoutMs);
+}
+
+#endif
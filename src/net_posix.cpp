@@ -0,0 +1,183 @@
+///----------------------------------------------------------------------------------------------------
+/// Net - POSIX implementation (host builds for tests and benchmarks)
+///----------------------------------------------------------------------------------------------------
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include "net.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static sockaddr_in LoopbackAddress(uint16_t port)
+{
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    return addr;
+}
+
+static bool SetNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static uint16_t BoundPort(int fd)
+{
+    sockaddr_in addr = {};
+    socklen_t len = sizeof(addr);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0)
+        return 0;
+    return ntohs(addr.sin_port);
+}
+
+bool Net::Startup()
+{
+    return true;
+}
+
+void Net::Cleanup()
+{
+}
+
+Net::Socket Net::ListenLoopback(uint16_t port, uint16_t& boundPort)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return InvalidSocket;
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr = LoopbackAddress(port);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 8) != 0 ||
+        !SetNonBlocking(fd))
+    {
+        close(fd);
+        return InvalidSocket;
+    }
+
+    boundPort = BoundPort(fd);
+    return fd;
+}
+
+Net::Socket Net::Accept(Socket listener)
+{
+    int fd = accept(static_cast<int>(listener), nullptr, nullptr);
+    if (fd < 0)
+        return InvalidSocket;
+
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    if (!SetNonBlocking(fd))
+    {
+        close(fd);
+        return InvalidSocket;
+    }
+    return fd;
+}
+
+Net::Socket Net::ConnectLoopback(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return InvalidSocket;
+
+    sockaddr_in addr = LoopbackAddress(port);
+    if (!SetNonBlocking(fd) ||
+        (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 && errno != EINPROGRESS))
+    {
+        close(fd);
+        return InvalidSocket;
+    }
+    return fd;
+}
+
+Net::Socket Net::OpenWakeSocket(uint16_t& boundPort)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+        return InvalidSocket;
+
+    sockaddr_in addr = LoopbackAddress(0);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || !SetNonBlocking(fd))
+    {
+        close(fd);
+        return InvalidSocket;
+    }
+
+    boundPort = BoundPort(fd);
+    return fd;
+}
+
+void Net::Wake(Socket wakeSocket, uint16_t port)
+{
+    sockaddr_in addr = LoopbackAddress(port);
+    char byte = 1;
+    sendto(static_cast<int>(wakeSocket), &byte, 1, MSG_DONTWAIT, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+}
+
+void Net::DrainWake(Socket wakeSocket)
+{
+    char buffer[64];
+    while (recv(static_cast<int>(wakeSocket), buffer, sizeof(buffer), MSG_DONTWAIT) > 0)
+    {
+    }
+}
+
+long Net::Send(Socket socket, const void* data, size_t length)
+{
+    ssize_t sent = send(static_cast<int>(socket), data, length, MSG_NOSIGNAL);
+    if (sent >= 0)
+        return static_cast<long>(sent);
+    return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+}
+
+long Net::Recv(Socket socket, void* buffer, size_t size)
+{
+    ssize_t received = recv(static_cast<int>(socket), buffer, size, 0);
+    if (received > 0)
+        return static_cast<long>(received);
+    if (received == 0)
+        return -1;
+    return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+}
+
+void Net::Close(Socket socket)
+{
+    if (socket != InvalidSocket)
+        close(static_cast<int>(socket));
+}
+
+int Net::Poll(PollEntry* entries, size_t count, int timeoutMs)
+{
+    std::vector<pollfd> fds(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        fds[i].fd = static_cast<int>(entries[i].socket);
+        fds[i].events = static_cast<short>(POLLIN | (entries[i].wantWrite ? POLLOUT : 0));
+        fds[i].revents = 0;
+    }
+
+    int ready = poll(fds.data(), static_cast<nfds_t>(count), timeoutMs);
+    if (ready < 0)
+        return errno == EINTR ? 0 : -1;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        entries[i].readable = (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+        entries[i].writable = (fds[i].revents & POLLOUT) != 0;
+    }
+    return ready;
+}
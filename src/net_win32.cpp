@@ -0,0 +1,190 @@
+///----------------------------------------------------------------------------------------------------
+/// Net - Win32 implementation (Winsock 2)
+///----------------------------------------------------------------------------------------------------
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#include <vector>
+
+#include "net.h"
+
+static sockaddr_in LoopbackAddress(uint16_t port)
+{
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    return addr;
+}
+
+static bool SetNonBlocking(SOCKET s)
+{
+    u_long mode = 1;
+    return ioctlsocket(s, FIONBIO, &mode) == 0;
+}
+
+static uint16_t BoundPort(SOCKET s)
+{
+    sockaddr_in addr = {};
+    int len = sizeof(addr);
+    if (getsockname(s, reinterpret_cast<sockaddr*>(&addr), &len) != 0)
+        return 0;
+    return ntohs(addr.sin_port);
+}
+
+static SOCKET ToSocket(Net::Socket socket)
+{
+    return static_cast<SOCKET>(socket);
+}
+
+static bool WouldBlock()
+{
+    int error = WSAGetLastError();
+    return error == WSAEWOULDBLOCK || error == WSAEINTR;
+}
+
+bool Net::Startup()
+{
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+}
+
+void Net::Cleanup()
+{
+    WSACleanup();
+}
+
+Net::Socket Net::ListenLoopback(uint16_t port, uint16_t& boundPort)
+{
+    SOCKET s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == INVALID_SOCKET)
+        return InvalidSocket;
+
+    // Refuse to share the port with another process (the Windows default allows hijacking it)
+    BOOL exclusive = TRUE;
+    setsockopt(s, SOL_SOCKET, SO_EXCLUSIVEADDRUSE, reinterpret_cast<const char*>(&exclusive), sizeof(exclusive));
+
+    sockaddr_in addr = LoopbackAddress(port);
+    if (bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(s, 8) != 0 ||
+        !SetNonBlocking(s))
+    {
+        closesocket(s);
+        return InvalidSocket;
+    }
+
+    boundPort = BoundPort(s);
+    return static_cast<Socket>(s);
+}
+
+Net::Socket Net::Accept(Socket listener)
+{
+    SOCKET s = accept(ToSocket(listener), nullptr, nullptr);
+    if (s == INVALID_SOCKET)
+        return InvalidSocket;
+
+    BOOL noDelay = TRUE;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+    if (!SetNonBlocking(s))
+    {
+        closesocket(s);
+        return InvalidSocket;
+    }
+    return static_cast<Socket>(s);
+}
+
+Net::Socket Net::ConnectLoopback(uint16_t port)
+{
+    SOCKET s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == INVALID_SOCKET)
+        return InvalidSocket;
+
+    sockaddr_in addr = LoopbackAddress(port);
+    if (!SetNonBlocking(s) ||
+        (connect(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 && !WouldBlock()))
+    {
+        closesocket(s);
+        return InvalidSocket;
+    }
+    return static_cast<Socket>(s);
+}
+
+Net::Socket Net::OpenWakeSocket(uint16_t& boundPort)
+{
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == INVALID_SOCKET)
+        return InvalidSocket;
+
+    sockaddr_in addr = LoopbackAddress(0);
+    if (bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || !SetNonBlocking(s))
+    {
+        closesocket(s);
+        return InvalidSocket;
+    }
+
+    boundPort = BoundPort(s);
+    return static_cast<Socket>(s);
+}
+
+void Net::Wake(Socket wakeSocket, uint16_t port)
+{
+    sockaddr_in addr = LoopbackAddress(port);
+    char byte = 1;
+    sendto(ToSocket(wakeSocket), &byte, 1, 0, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+}
+
+void Net::DrainWake(Socket wakeSocket)
+{
+    char buffer[64];
+    while (recv(ToSocket(wakeSocket), buffer, sizeof(buffer), 0) > 0)
+    {
+    }
+}
+
+long Net::Send(Socket socket, const void* data, size_t length)
+{
+    int sent = send(ToSocket(socket), static_cast<const char*>(data), static_cast<int>(length), 0);
+    if (sent != SOCKET_ERROR)
+        return sent;
+    return WouldBlock() ? 0 : -1;
+}
+
+long Net::Recv(Socket socket, void* buffer, size_t size)
+{
+    int received = recv(ToSocket(socket), static_cast<char*>(buffer), static_cast<int>(size), 0);
+    if (received > 0)
+        return received;
+    if (received == 0)
+        return -1;
+    return WouldBlock() ? 0 : -1;
+}
+
+void Net::Close(Socket socket)
+{
+    if (socket != InvalidSocket)
+        closesocket(ToSocket(socket));
+}
+
+int Net::Poll(PollEntry* entries, size_t count, int timeoutMs)
+{
+    std::vector<WSAPOLLFD> fds(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        fds[i].fd = ToSocket(entries[i].socket);
+        fds[i].events = static_cast<SHORT>(POLLRDNORM | (entries[i].wantWrite ? POLLWRNORM : 0));
+        fds[i].revents = 0;
+    }
+
+    int ready = WSAPoll(fds.data(), static_cast<ULONG>(count), timeoutMs);
+    if (ready == SOCKET_ERROR)
+        return -1;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        entries[i].readable = (fds[i].revents & (POLLRDNORM | POLLHUP | POLLERR)) != 0;
+        entries[i].writable = (fds[i].revents & POLLWRNORM) != 0;
+    }
+    return ready;
+}
@@ -0,0 +1,70 @@
+///----------------------------------------------------------------------------------------------------
+/// Open Addressing - Linear probing and backward-shift deletion over a fixed power-of-two slot array
+///
+/// Shared by the fixed-capacity tables (agents, enemies, squad members). Each table keeps its own slot
+/// layout and hash; it passes small function objects that say whether a slot is used, empty a slot,
+/// match a key and give an entry's home slot. Deleting shifts later entries of the probe run back
+/// into the hole, so lookups never meet tombstones and the table never needs rebuilding.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_OPEN_ADDRESSING_H
+#define STREAMLINK_OPEN_ADDRESSING_H
+
+#include <cstddef>
+
+namespace OpenAddressing
+{
+    ///----------------------------------------------------------------------------------------------------
+    /// Find - Slot of the entry for which matches() holds, probing from home; Size if there is none
+    ///----------------------------------------------------------------------------------------------------
+    template <typename Slot, size_t Size, typename IsUsed, typename Matches>
+    size_t Find(const Slot (&slots)[Size], size_t home, IsUsed isUsed, Matches matches)
+    {
+        static_assert((Size & (Size - 1)) == 0, "table size must be a power of two");
+        for (size_t i = home;; i = (i + 1) & (Size - 1))
+        {
+            if (!isUsed(slots[i]))
+                return Size;
+            if (matches(slots[i]))
+                return i;
+        }
+    }
+
+    ///----------------------------------------------------------------------------------------------------
+    /// FreeSlot - First empty slot of the probe run from home (the table must not be full)
+    ///----------------------------------------------------------------------------------------------------
+    template <typename Slot, size_t Size, typename IsUsed>
+    size_t FreeSlot(const Slot (&slots)[Size], size_t home, IsUsed isUsed)
+    {
+        size_t i = home;
+        while (isUsed(slots[i]))
+            i = (i + 1) & (Size - 1);
+        return i;
+    }
+
+    ///----------------------------------------------------------------------------------------------------
+    /// Erase - Empty a slot and shift later entries of the probe run back, so no tombstones are needed
+    ///----------------------------------------------------------------------------------------------------
+    template <typename Slot, size_t Size, typename IsUsed, typename HomeOf, typename MakeEmpty>
+    void Erase(Slot (&slots)[Size], size_t slot, IsUsed isUsed, HomeOf homeOf, MakeEmpty makeEmpty)
+    {
+        constexpr size_t mask = Size - 1;
+        makeEmpty(slots[slot]);
+
+        size_t hole = slot;
+        for (size_t i = (hole + 1) & mask; isUsed(slots[i]); i = (i + 1) & mask)
+        {
+            // An entry may move into the hole only if the hole lies between its home slot and i
+            size_t home = homeOf(slots[i]);
+            bool movable = (hole <= i) ? (home <= hole || home > i) : (home <= hole && home > i);
+            if (!movable)
+                continue;
+
+            slots[hole] = slots[i];
+            makeEmpty(slots[i]);
+            hole = i;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,52 @@
+///----------------------------------------------------------------------------------------------------
+/// Output File - One text output with a pre-resolved path and change detection
+///----------------------------------------------------------------------------------------------------
+
+#include "output_file.h"
+
+#include <cstring>
+
+#include "platform.h"
+
+bool OutputFile::Open(const std::string& fullPath)
+{
+    Close();
+    if (fullPath.empty())
+        return false;
+
+    m_path = fullPath;
+    m_tempPath = fullPath + ".tmp";
+
+    size_t sep = fullPath.find_last_of("\\/");
+    if (sep != std::string::npos && sep > 0)
+        Platform::CreateDirectories(fullPath.substr(0, sep).c_str());
+
+    return true;
+}
+
+bool OutputFile::Write(const char* data, size_t length)
+{
+    if (m_path.empty())
+        return false;
+
+    if (m_hasLastContent && m_lastContent.size() == length &&
+        (length == 0 || memcmp(m_lastContent.data(), data, length) == 0))
+    {
+        return true;
+    }
+
+    if (!Platform::ReplaceFileContents(m_path.c_str(), m_tempPath.c_str(), data, length))
+        return false;
+
+    m_lastContent.assign(data, length);
+    m_hasLastContent = true;
+    return true;
+}
+
+void OutputFile::Close()
+{
+    m_path.clear();
+    m_tempPath.clear();
+    m_lastContent.clear();
+    m_hasLastContent = false;
+}
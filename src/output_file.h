@@ -0,0 +1,39 @@
+///----------------------------------------------------------------------------------------------------
+/// Output File - One text output with a pre-resolved path and change detection
+///
+/// The path, its temp sibling and the parent directory are all set up once in Open(). Write() then
+/// compares against the last content written and only touches the disk when the bytes differ,
+/// replacing the file atomically so OBS never reads a half-written value.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_OUTPUT_FILE_H
+#define STREAMLINK_OUTPUT_FILE_H
+
+#include <cstddef>
+#include <string>
+
+class OutputFile
+{
+public:
+    /// Resolves the temp path and creates the parent directory. Returns false for an empty path.
+    bool Open(const std::string& fullPath);
+
+    /// Writes data if it differs from the last successful write. Returns true if the file now holds
+    /// data (including when the write was skipped); false leaves the previous content in place, and
+    /// the next Write with any data tries again.
+    bool Write(const char* data, size_t length);
+
+    /// Forgets the path and the cached content.
+    void Close();
+
+    bool IsOpen() const { return !m_path.empty(); }
+    const std::string& Path() const { return m_path; }
+
+private:
+    std::string m_path;
+    std::string m_tempPath;
+    std::string m_lastContent;
+    bool        m_hasLastContent = false;
+};
+
+#endif
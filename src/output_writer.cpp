@@ -0,0 +1,236 @@
+///----------------------------------------------------------------------------------------------------
+/// Output Writer - Background thread that coalesces output file updates
+///----------------------------------------------------------------------------------------------------
+
+#include "output_writer.h"
+#include "metrics.h"
+#include "output_file.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    constexpr size_t DirtyWordBits = 64;
+    constexpr size_t DirtyWordCount = OutputWriter::MaxOutputs / DirtyWordBits;
+
+    struct Output
+    {
+        OUTPUT_RENDER render = nullptr;
+        OutputFile    file;
+    };
+
+    Output                            g_outputs[OutputWriter::MaxOutputs];
+    size_t                            g_outputCount = 0;
+    char                              g_renderBuffer[OutputWriter::MaxRenderSize];
+    OUTPUT_TICK                       g_tickHooks[OutputWriter::MaxTickHooks] = {};
+    size_t                            g_tickHookCount = 0;
+    std::atomic<uint64_t>             g_dirty[DirtyWordCount] = {};
+
+    std::thread                       g_thread;
+    std::mutex                        g_wakeMutex;
+    std::condition_variable           g_wakeCv;
+    bool                              g_stopRequested = false;
+    std::chrono::milliseconds         g_flushInterval{100};
+}
+
+///----------------------------------------------------------------------------------------------------
+/// AnyDirty - True if at least one output is waiting to be written
+///----------------------------------------------------------------------------------------------------
+static bool AnyDirty()
+{
+    for (size_t w = 0; w < DirtyWordCount; w++)
+    {
+        if (g_dirty[w].load(std::memory_order_relaxed) != 0)
+            return true;
+    }
+    return false;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// FlushDirty - Render and write every output flagged since the last flush, once each
+///----------------------------------------------------------------------------------------------------
+static void FlushDirty()
+{
+    for (size_t w = 0; w < DirtyWordCount; w++)
+    {
+        // Claim the whole word at once; anything flagged after this point lands in the next flush
+        uint64_t bits = g_dirty[w].exchange(0, std::memory_order_acquire);
+        while (bits != 0)
+        {
+            size_t bit = 0;
+            while (((bits >> bit) & 1) == 0)
+                bit++;
+            bits &= bits - 1;
+
+            size_t id = w * DirtyWordBits + bit;
+            if (id >= g_outputCount || !g_outputs[id].file.IsOpen())
+                continue;
+
+            STREAMLINK_METRICS_SCOPE(Metrics::Probe_FileWrite);
+            Output& output = g_outputs[id];
+            size_t length = output.render(g_renderBuffer, sizeof(g_renderBuffer));
+            if (length > sizeof(g_renderBuffer))
+                length = sizeof(g_renderBuffer);
+
+            // Unchanged content is dropped inside OutputFile::Write without touching the disk. A refused
+            // replace left the old content; flag the output again so the next flush retries it.
+            if (!output.file.Write(g_renderBuffer, length))
+                g_dirty[w].fetch_or(uint64_t(1) << bit, std::memory_order_relaxed);
+        }
+    }
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RunTickHooks - Periodic work registered by other subsystems
+///----------------------------------------------------------------------------------------------------
+static void RunTickHooks()
+{
+    for (size_t i = 0; i < g_tickHookCount; i++)
+        g_tickHooks[i]();
+}
+
+///----------------------------------------------------------------------------------------------------
+/// WriterThread - Wait for dirty outputs, write them, then hold off for one flush interval
+///----------------------------------------------------------------------------------------------------
+static void WriterThread()
+{
+    for (;;)
+    {
+        {
+            // MarkDirty notifies without taking the mutex, so a wakeup can be missed; the timeout bounds
+            // that case to one flush interval.
+            std::unique_lock<std::mutex> lock(g_wakeMutex);
+            g_wakeCv.wait_for(lock, g_flushInterval, [] { return g_stopRequested || AnyDirty(); });
+            if (g_stopRequested)
+                break;
+        }
+
+        // Hooks first, so anything they flag goes out in the same pass
+        RunTickHooks();
+        FlushDirty();
+
+        {
+            // Coalescing window: further changes during this interval are written together afterwards
+            std::unique_lock<std::mutex> lock(g_wakeMutex);
+            g_wakeCv.wait_for(lock, g_flushInterval, [] { return g_stopRequested; });
+            if (g_stopRequested)
+                break;
+        }
+    }
+}
+
+bool OutputWriter::AddTickHook(OUTPUT_TICK tick)
+{
+    if (!tick || g_tickHookCount >= MaxTickHooks)
+        return false;
+
+    g_tickHooks[g_tickHookCount++] = tick;
+    return true;
+}
+
+int OutputWriter::Register(const std::string& fullPath, OUTPUT_RENDER render)
+{
+    if (!render || g_outputCount >= MaxOutputs)
+        return InvalidOutput;
+
+    // An empty path leaves the file closed: the output exists but is never written
+    Output& output = g_outputs[g_outputCount];
+    if (!fullPath.empty() && !output.file.Open(fullPath))
+        return InvalidOutput;
+
+    output.render = render;
+    return static_cast<int>(g_outputCount++);
+}
+
+void OutputWriter::Retarget(int id, const std::string& fullPath)
+{
+    if (id < 0 || static_cast<size_t>(id) >= g_outputCount)
+        return;
+
+    OutputFile& file = g_outputs[id].file;
+    if (file.Path() == fullPath)
+        return;
+
+    // Reopening also forgets the cached content, so the new file is written on the next pass
+    if (fullPath.empty())
+        file.Close();
+    else
+        file.Open(fullPath);
+    MarkDirty(id);
+}
+
+void OutputWriter::SetFlushInterval(uint32_t flushIntervalMs)
+{
+    g_flushInterval = std::chrono::milliseconds(flushIntervalMs > 0 ? flushIntervalMs : 1);
+}
+
+void OutputWriter::MarkDirty(int id)
+{
+    if (id < 0 || static_cast<size_t>(id) >= g_outputCount)
+        return;
+
+    uint64_t bit = uint64_t(1) << (static_cast<size_t>(id) % DirtyWordBits);
+    uint64_t prev = g_dirty[static_cast<size_t>(id) / DirtyWordBits].fetch_or(bit, std::memory_order_release);
+
+    // Only the first change after a flush needs to wake the writer
+    if ((prev & bit) == 0)
+        g_wakeCv.notify_one();
+}
+
+void OutputWriter::MarkAllDirty()
+{
+    for (size_t id = 0; id < g_outputCount; id++)
+        MarkDirty(static_cast<int>(id));
+}
+
+void OutputWriter::Start(uint32_t flushIntervalMs)
+{
+    if (g_thread.joinable())
+        return;
+
+    g_flushInterval = std::chrono::milliseconds(flushIntervalMs > 0 ? flushIntervalMs : 1);
+    {
+        std::lock_guard<std::mutex> lock(g_wakeMutex);
+        g_stopRequested = false;
+    }
+    g_thread = std::thread(WriterThread);
+}
+
+void OutputWriter::Stop()
+{
+    if (g_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_wakeMutex);
+            g_stopRequested = true;
+        }
+        g_wakeCv.notify_one();
+        g_thread.join();
+    }
+
+    // Final state must reach disk even if it changed inside the last coalescing window
+    RunTickHooks();
+    FlushDirty();
+}
+
+void OutputWriter::Reset()
+{
+    if (g_thread.joinable())
+        return;
+
+    for (size_t w = 0; w < DirtyWordCount; w++)
+        g_dirty[w].store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < MaxOutputs; i++)
+    {
+        g_outputs[i].render = nullptr;
+        g_outputs[i].file.Close();
+    }
+    g_outputCount = 0;
+    for (size_t i = 0; i < MaxTickHooks; i++)
+        g_tickHooks[i] = nullptr;
+    g_tickHookCount = 0;
+}
@@ -0,0 +1,65 @@
+///----------------------------------------------------------------------------------------------------
+/// Output Writer - Background thread that coalesces output file updates
+///
+/// Event callbacks only flag an output as dirty. A dedicated writer thread picks up the dirty outputs,
+/// renders them and writes each of them at most once per flush interval, so bursts of state changes
+/// collapse into a single write and the game's threads never wait on the filesystem.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_OUTPUT_WRITER_H
+#define STREAMLINK_OUTPUT_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// Formats the current value of one output into buffer and returns its length. Called from the writer
+/// thread (or from Stop()), and from the overlay server thread for outputs it also serves, so it must
+/// only read thread-safe state.
+typedef size_t (*OUTPUT_RENDER)(char* buffer, size_t size);
+
+/// Periodic work piggybacking on the writer thread (draining queues, timed refreshes). Runs before
+/// every flush pass and at least once every two flush intervals while idle.
+typedef void (*OUTPUT_TICK)();
+
+namespace OutputWriter
+{
+    constexpr size_t MaxOutputs = 128;
+    constexpr size_t MaxTickHooks = 16;
+    constexpr size_t MaxRenderSize = 8192;
+    constexpr int    InvalidOutput = -1;
+
+    /// Registers a file output and returns its id. The path is resolved and its directory created
+    /// here, once. An empty path registers the output disabled, so Retarget can enable it later.
+    /// Returns InvalidOutput for a missing renderer or a full table. Must be called before Start().
+    int  Register(const std::string& fullPath, OUTPUT_RENDER render);
+
+    /// Points an output at a new file (empty disables it) and flags it dirty. Writer thread only (a
+    /// tick hook), or while the writer is stopped.
+    void Retarget(int id, const std::string& fullPath);
+
+    /// Changes the flush interval. Writer thread only (a tick hook), or while the writer is stopped.
+    void SetFlushInterval(uint32_t flushIntervalMs);
+
+    /// Adds periodic work to the writer thread. Must be called before Start(). Hooks also run once
+    /// more from Stop(), before the final flush.
+    bool AddTickHook(OUTPUT_TICK tick);
+
+    /// Flags an output for the next flush. Lock-free and safe to call from any thread.
+    void MarkDirty(int id);
+
+    /// Flags every registered output for the next flush.
+    void MarkAllDirty();
+
+    /// Starts the writer thread. Each output is written at most once per flushIntervalMs.
+    void Start(uint32_t flushIntervalMs);
+
+    /// Stops the writer thread and synchronously writes anything still pending.
+    void Stop();
+
+    /// Clears the output table, the tick hooks and the cached file contents. Only valid while the writer thread is
+    /// stopped.
+    void Reset();
+}
+
+#endif
@@ -0,0 +1,595 @@
+///----------------------------------------------------------------------------------------------------
+/// Overlay Server - Optional loopback HTTP/WebSocket endpoint for browser-source overlays
+///----------------------------------------------------------------------------------------------------
+
+#include "overlay_server.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics.h"
+#include "net.h"
+#include "tracing.h"
+#include "websocket.h"
+
+namespace
+{
+    constexpr size_t RequestBufferSize = 4096;
+    constexpr int    PollTimeoutMs = 250;
+
+    struct Field
+    {
+        const char*               name = nullptr;
+        OUTPUT_RENDER             render = nullptr;
+        OverlayServer::EFieldKind kind = OverlayServer::Field_Number;
+        std::string               value;   // JSON text last pushed
+    };
+
+    enum class ClientPhase : uint8_t
+    {
+        Http,
+        WebSocket
+    };
+
+    struct Client
+    {
+        Net::Socket socket = Net::InvalidSocket;
+        ClientPhase phase = ClientPhase::Http;
+        uint8_t     received[RequestBufferSize];
+        size_t      receivedLength = 0;
+        std::string pending;
+        size_t      pendingOffset = 0;
+        bool        closeAfterSend = false;
+        bool        needsSnapshot = false;
+        bool        closed = false;
+    };
+
+    Field                     g_fields[OverlayServer::MaxFields];
+    size_t                    g_fieldCount = 0;
+    char                      g_renderBuffer[OutputWriter::MaxRenderSize];
+
+    std::vector<Client*>      g_clients;
+    Net::Socket               g_listener = Net::InvalidSocket;
+    Net::Socket               g_wake = Net::InvalidSocket;
+    uint16_t                  g_wakePort = 0;
+    std::atomic<uint16_t>     g_port{0};
+    std::atomic<bool>         g_running{false};
+    std::atomic<bool>         g_stopRequested{false};
+    std::atomic<bool>         g_notifyPending{false};
+    std::thread               g_thread;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// AppendJsonString - Append text as a quoted, escaped JSON string
+///----------------------------------------------------------------------------------------------------
+static void AppendJsonString(std::string& out, const char* text, size_t length)
+{
+    out += '"';
+    for (size_t i = 0; i < length; i++)
+    {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        switch (c)
+        {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20)
+                {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                }
+                else
+                {
+                    out += static_cast<char>(c);
+                }
+                break;
+        }
+    }
+    out += '"';
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderField - Current value of a field as JSON text
+///----------------------------------------------------------------------------------------------------
+static std::string RenderField(const Field& field)
+{
+    size_t length = field.render(g_renderBuffer, sizeof(g_renderBuffer));
+    if (length > sizeof(g_renderBuffer))
+        length = sizeof(g_renderBuffer);
+
+    std::string value;
+    if (field.kind == OverlayServer::Field_String)
+        AppendJsonString(value, g_renderBuffer, length);
+    else if (length == 0)
+        value = "null";
+    else
+        value.assign(g_renderBuffer, length);
+    return value;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// StateObject - {"field":value,...} from the last rendered values
+///----------------------------------------------------------------------------------------------------
+static std::string StateObject()
+{
+    std::string json = "{";
+    for (size_t i = 0; i < g_fieldCount; i++)
+    {
+        if (i > 0)
+            json += ',';
+        json += '"';
+        json += g_fields[i].name;
+        json += "\":";
+        json += g_fields[i].value;
+    }
+    json += '}';
+    return json;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Queue - Append bytes to a client's send buffer unless it is already too far behind
+///----------------------------------------------------------------------------------------------------
+static bool Queue(Client& client, const std::string& data)
+{
+    if (client.pending.size() - client.pendingOffset + data.size() > OverlayServer::MaxPendingBytes)
+        return false;
+
+    client.pending += data;
+    return true;
+}
+
+static std::string TextFrame(const std::string& payload)
+{
+    uint8_t header[WebSocket::MaxHeaderSize];
+    size_t headerSize = WebSocket::EncodeHeader(WebSocket::Opcode_Text, payload.size(), header);
+
+    std::string frame(reinterpret_cast<const char*>(header), headerSize);
+    frame += payload;
+    return frame;
+}
+
+static void QueueSnapshot(Client& client)
+{
+    if (!Queue(client, TextFrame("{\"type\":\"snapshot\",\"state\":" + StateObject() + "}")))
+        client.needsSnapshot = true;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Refresh - Re-render every field and push the ones that changed to WebSocket clients
+///----------------------------------------------------------------------------------------------------
+static void Refresh()
+{
+    STREAMLINK_METRICS_SCOPE(Metrics::Probe_OverlayRefresh);
+
+    // Cleared before rendering: a change that lands during the render wakes us again. The exchange
+    // pairs with the one in Notify(), so state written before it is visible to the renders below.
+    g_notifyPending.exchange(false, std::memory_order_acq_rel);
+
+    std::string delta;
+    for (size_t i = 0; i < g_fieldCount; i++)
+    {
+        std::string value = RenderField(g_fields[i]);
+        if (value == g_fields[i].value)
+            continue;
+
+        delta += delta.empty() ? "{\"type\":\"delta\",\"state\":{\"" : ",\"";
+        delta += g_fields[i].name;
+        delta += "\":";
+        delta += value;
+        g_fields[i].value.swap(value);
+    }
+    if (delta.empty())
+        return;
+
+    delta += "}}";
+    std::string frame = TextFrame(delta);
+    for (Client* client : g_clients)
+    {
+        if (client->phase != ClientPhase::WebSocket || client->needsSnapshot)
+            continue;
+
+        // A client that is this far behind gets a snapshot instead, once it has caught up
+        if (!Queue(*client, frame))
+            client->needsSnapshot = true;
+    }
+}
+
+///----------------------------------------------------------------------------------------------------
+/// FindHeader - Case-insensitive header lookup in a complete request; value is trimmed
+///----------------------------------------------------------------------------------------------------
+static bool FindHeader(const char* request, const char* name, const char*& value, size_t& valueLength)
+{
+    size_t nameLength = strlen(name);
+    for (const char* line = strstr(request, "\r\n"); line && line[2] != '\r'; line = strstr(line + 2, "\r\n"))
+    {
+        const char* start = line + 2;
+        bool match = true;
+        for (size_t i = 0; i < nameLength && match; i++)
+        {
+            char c = start[i];
+            if (c >= 'A' && c <= 'Z')
+                c = static_cast<char>(c - 'A' + 'a');
+            match = (c == name[i]);
+        }
+        if (!match || start[nameLength] != ':')
+            continue;
+
+        const char* v = start + nameLength + 1;
+        while (*v == ' ' || *v == '\t')
+            v++;
+        const char* end = strstr(v, "\r\n");
+        while (end > v && (end[-1] == ' ' || end[-1] == '\t'))
+            end--;
+        value = v;
+        valueLength = static_cast<size_t>(end - v);
+        return true;
+    }
+    return false;
+}
+
+static bool ContainsToken(const char* value, size_t length, const char* token)
+{
+    size_t tokenLength = strlen(token);
+    for (size_t i = 0; i + tokenLength <= length; i++)
+    {
+        bool match = true;
+        for (size_t j = 0; j < tokenLength && match; j++)
+        {
+            char c = value[i + j];
+            if (c >= 'A' && c <= 'Z')
+                c = static_cast<char>(c - 'A' + 'a');
+            match = (c == token[j]);
+        }
+        if (match)
+            return true;
+    }
+    return false;
+}
+
+static void QueueHttpResponse(Client& client, const char* status, const char* contentType, const std::string& body)
+{
+    char header[256];
+    snprintf(header, sizeof(header),
+             "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nCache-Control: no-store\r\n"
+             "Access-Control-Allow-Origin: *\r\nConnection: close\r\n\r\n",
+             status, contentType, body.size());
+    Queue(client, std::string(header) + body);
+    client.closeAfterSend = true;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// HandleRequest - Serve GET /state or upgrade to a WebSocket
+///----------------------------------------------------------------------------------------------------
+static void HandleRequest(Client& client, const char* request)
+{
+    char method[8] = {};
+    char path[128] = {};
+    if (sscanf(request, "%7s %127s", method, path) != 2)
+    {
+        QueueHttpResponse(client, "400 Bad Request", "text/plain", "bad request");
+        return;
+    }
+    if (strcmp(method, "GET") != 0)
+    {
+        QueueHttpResponse(client, "405 Method Not Allowed", "text/plain", "GET only");
+        return;
+    }
+    if (strcmp(path, "/") != 0 && strcmp(path, "/state") != 0)
+    {
+        QueueHttpResponse(client, "404 Not Found", "text/plain", "not found");
+        return;
+    }
+
+    const char* upgrade = nullptr;
+    size_t upgradeLength = 0;
+    const char* key = nullptr;
+    size_t keyLength = 0;
+    if (FindHeader(request, "upgrade", upgrade, upgradeLength) && ContainsToken(upgrade, upgradeLength, "websocket") &&
+        FindHeader(request, "sec-websocket-key", key, keyLength))
+    {
+        char accept[WebSocket::AcceptKeyLength + 1];
+        WebSocket::AcceptKey(key, keyLength, accept);
+
+        std::string response = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                               "Sec-WebSocket-Accept: ";
+        response += accept;
+        response += "\r\n\r\n";
+        Queue(client, response);
+
+        client.phase = ClientPhase::WebSocket;
+        Refresh();
+        QueueSnapshot(client);
+        STREAMLINK_TRACE(ELogLevel_DEBUG, "Overlay server: WebSocket client connected");
+        return;
+    }
+
+    Refresh();
+    QueueHttpResponse(client, "200 OK", "application/json", StateObject());
+}
+
+///----------------------------------------------------------------------------------------------------
+/// HandleFrames - Process complete client frames: answer pings and close requests, ignore data
+///----------------------------------------------------------------------------------------------------
+static void HandleFrames(Client& client)
+{
+    size_t offset = 0;
+    WebSocket::Frame frame;
+    while (WebSocket::ParseFrame(client.received + offset, client.receivedLength - offset, frame))
+    {
+        uint8_t* payload = client.received + offset + frame.headerSize;
+        WebSocket::Unmask(frame, payload);
+
+        if (frame.opcode == WebSocket::Opcode_Close || frame.opcode == WebSocket::Opcode_Ping)
+        {
+            uint8_t reply = frame.opcode == WebSocket::Opcode_Close ? WebSocket::Opcode_Close : WebSocket::Opcode_Pong;
+            uint8_t header[WebSocket::MaxHeaderSize];
+            size_t headerSize = WebSocket::EncodeHeader(reply, frame.payloadLength, header);
+            std::string data(reinterpret_cast<const char*>(header), headerSize);
+            data.append(reinterpret_cast<const char*>(payload), frame.payloadLength);
+            Queue(client, data);
+            if (frame.opcode == WebSocket::Opcode_Close)
+                client.closeAfterSend = true;
+        }
+
+        offset += frame.headerSize + frame.payloadLength;
+    }
+
+    memmove(client.received, client.received + offset, client.receivedLength - offset);
+    client.receivedLength -= offset;
+}
+
+static void HandleRead(Client& client)
+{
+    for (;;)
+    {
+        size_t space = sizeof(client.received) - client.receivedLength - 1;
+        if (space == 0)
+        {
+            // Request headers too large, or a frame bigger than any overlay would send
+            client.closed = true;
+            return;
+        }
+
+        long received = Net::Recv(client.socket, client.received + client.receivedLength, space);
+        if (received < 0)
+        {
+            client.closed = true;
+            return;
+        }
+        if (received == 0)
+            return;
+        client.receivedLength += static_cast<size_t>(received);
+
+        if (client.phase == ClientPhase::Http)
+        {
+            client.received[client.receivedLength] = '\0';
+            const char* request = reinterpret_cast<const char*>(client.received);
+            if (!strstr(request, "\r\n\r\n"))
+                continue;
+
+            HandleRequest(client, request);
+            client.receivedLength = 0;
+            if (client.phase == ClientPhase::Http)
+                return;
+        }
+        else if (!client.closeAfterSend)
+        {
+            HandleFrames(client);
+        }
+    }
+}
+
+static void HandleWrite(Client& client)
+{
+    while (client.pendingOffset < client.pending.size())
+    {
+        long sent = Net::Send(client.socket, client.pending.data() + client.pendingOffset,
+                              client.pending.size() - client.pendingOffset);
+        if (sent < 0)
+        {
+            client.closed = true;
+            return;
+        }
+        if (sent == 0)
+            return;
+        client.pendingOffset += static_cast<size_t>(sent);
+    }
+
+    client.pending.clear();
+    client.pendingOffset = 0;
+    if (client.closeAfterSend)
+    {
+        client.closed = true;
+        return;
+    }
+
+    if (client.needsSnapshot)
+    {
+        client.needsSnapshot = false;
+        QueueSnapshot(client);
+    }
+}
+
+static void AcceptClients()
+{
+    for (;;)
+    {
+        Net::Socket socket = Net::Accept(g_listener);
+        if (socket == Net::InvalidSocket)
+            return;
+
+        if (g_clients.size() >= OverlayServer::MaxClients)
+        {
+            Net::Close(socket);
+            continue;
+        }
+
+        Client* client = new Client();
+        client->socket = socket;
+        g_clients.push_back(client);
+    }
+}
+
+static void CloseClient(Client* client)
+{
+    Net::Close(client->socket);
+    delete client;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// ServerThread - Poll the listener, the wake socket and every client until stopped
+///----------------------------------------------------------------------------------------------------
+static void ServerThread()
+{
+    std::vector<Net::PollEntry> entries;
+    while (!g_stopRequested.load())
+    {
+        entries.clear();
+        entries.push_back({g_listener, false, false, false});
+        entries.push_back({g_wake, false, false, false});
+        for (Client* client : g_clients)
+            entries.push_back({client->socket, client->pendingOffset < client->pending.size(), false, false});
+
+        if (Net::Poll(entries.data(), entries.size(), PollTimeoutMs) < 0)
+            break;
+        if (g_stopRequested.load())
+            break;
+
+        if (entries[1].readable)
+        {
+            Net::DrainWake(g_wake);
+            Refresh();
+        }
+
+        // Clients accepted now are not in entries yet; they are polled from the next pass
+        size_t polledClients = entries.size() - 2;
+        if (entries[0].readable)
+            AcceptClients();
+
+        for (size_t i = 0; i < polledClients; i++)
+        {
+            Client& client = *g_clients[i];
+            if (entries[i + 2].readable && !client.closed)
+                HandleRead(client);
+        }
+
+        // Try every client with pending data: queued deltas go out in this same pass
+        for (Client* client : g_clients)
+        {
+            if (!client->closed && client->pendingOffset < client->pending.size())
+                HandleWrite(*client);
+        }
+
+        for (size_t i = 0; i < g_clients.size();)
+        {
+            if (g_clients[i]->closed)
+            {
+                CloseClient(g_clients[i]);
+                g_clients.erase(g_clients.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+}
+
+bool OverlayServer::AddField(const char* name, OUTPUT_RENDER render, EFieldKind kind)
+{
+    if (!name || !render || g_fieldCount >= MaxFields || g_thread.joinable())
+        return false;
+
+    Field& field = g_fields[g_fieldCount++];
+    field.name = name;
+    field.render = render;
+    field.kind = kind;
+    field.value = "null";
+    return true;
+}
+
+bool OverlayServer::Start(uint16_t port)
+{
+    if (g_thread.joinable() || !Net::Startup())
+        return false;
+
+    uint16_t boundPort = 0;
+    g_listener = Net::ListenLoopback(port, boundPort);
+    g_wake = Net::OpenWakeSocket(g_wakePort);
+    if (g_listener == Net::InvalidSocket || g_wake == Net::InvalidSocket)
+    {
+        Net::Close(g_listener);
+        Net::Close(g_wake);
+        g_listener = Net::InvalidSocket;
+        g_wake = Net::InvalidSocket;
+        Net::Cleanup();
+        return false;
+    }
+
+    // Initial values, so the first snapshot is complete
+    for (size_t i = 0; i < g_fieldCount; i++)
+        g_fields[i].value = RenderField(g_fields[i]);
+
+    g_port.store(boundPort);
+    g_stopRequested.store(false);
+    g_notifyPending.store(false);
+    g_running.store(true);
+    g_thread = std::thread(ServerThread);
+    return true;
+}
+
+uint16_t OverlayServer::Port()
+{
+    return g_port.load(std::memory_order_relaxed);
+}
+
+void OverlayServer::Notify()
+{
+    if (!g_running.load(std::memory_order_acquire))
+        return;
+
+    // Only the first change since the last refresh needs to wake the I/O thread
+    if (!g_notifyPending.exchange(true, std::memory_order_acq_rel))
+        Net::Wake(g_wake, g_wakePort);
+}
+
+void OverlayServer::Stop()
+{
+    if (!g_thread.joinable())
+        return;
+
+    g_running.store(false);
+    g_stopRequested.store(true);
+    Net::Wake(g_wake, g_wakePort);
+    g_thread.join();
+
+    for (Client* client : g_clients)
+        CloseClient(client);
+    g_clients.clear();
+
+    Net::Close(g_listener);
+    Net::Close(g_wake);
+    g_listener = Net::InvalidSocket;
+    g_wake = Net::InvalidSocket;
+    g_port.store(0);
+    Net::Cleanup();
+}
+
+void OverlayServer::Reset()
+{
+    if (g_thread.joinable())
+        return;
+
+    for (size_t i = 0; i < MaxFields; i++)
+        g_fields[i] = Field();
+    g_fieldCount = 0;
+}
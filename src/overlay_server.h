@@ -0,0 +1,52 @@
+///----------------------------------------------------------------------------------------------------
+/// Overlay Server - Optional loopback HTTP/WebSocket endpoint for browser-source overlays
+///
+/// Runs on its own I/O thread. GET /state returns a JSON object with every registered field; a
+/// WebSocket connection to the same port receives a full snapshot on connect and a delta with just
+/// the changed fields whenever Notify() is called. Event callbacks only ever call Notify(), which is
+/// an atomic exchange plus, for the first change since the last push, one non-blocking loopback
+/// datagram to wake the I/O thread. Clients that stop reading are skipped rather than waited on and
+/// get a fresh snapshot once they catch up.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_OVERLAY_SERVER_H
+#define STREAMLINK_OVERLAY_SERVER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "output_writer.h"
+
+namespace OverlayServer
+{
+    enum EFieldKind : uint8_t
+    {
+        Field_Number,   // rendered text is a JSON number
+        Field_String    // rendered text is escaped and quoted
+    };
+
+    constexpr uint16_t DefaultPort = 27135;
+    constexpr size_t   MaxFields = 48;
+    constexpr size_t   MaxClients = 16;
+    constexpr size_t   MaxPendingBytes = 64 * 1024;   // per client, before deltas are skipped
+
+    /// Adds a JSON field rendered with an output renderer. Must be called before Start().
+    bool AddField(const char* name, OUTPUT_RENDER render, EFieldKind kind);
+
+    /// Listens on 127.0.0.1:port (0 picks a free port) and starts the I/O thread.
+    bool Start(uint16_t port);
+
+    /// Port actually listened on, or 0 while stopped.
+    uint16_t Port();
+
+    /// State changed: push deltas to WebSocket clients. Lock-free, never blocks, safe from any thread.
+    void Notify();
+
+    /// Closes every connection and joins the I/O thread.
+    void Stop();
+
+    /// Forgets the registered fields. Only valid while stopped.
+    void Reset();
+}
+
+#endif
@@ -0,0 +1,29 @@
+///----------------------------------------------------------------------------------------------------
+/// Platform - Thin OS shims used by the rest of the addon
+///
+/// Everything that needs the Windows API (or its POSIX counterpart) goes through here so the
+/// tracking logic itself stays platform-neutral.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_PLATFORM_H
+#define STREAMLINK_PLATFORM_H
+
+#include <cstddef>
+
+namespace Platform
+{
+    /// Preferred path separator for paths we build ourselves.
+    extern const char PathSeparator;
+
+    /// Creates every missing directory along the given path. Returns true if the directory exists
+    /// afterwards.
+    bool CreateDirectories(const char* path);
+
+    /// Writes data to tempPath and renames it over path, so readers see either the old or the new
+    /// content but never a partially written file. If the rename is refused (e.g. another process
+    /// holds the target open without delete sharing) the temp file is removed, path keeps its old
+    /// content and the result is false; the caller retries later. path is never rewritten in place.
+    bool ReplaceFileContents(const char* path, const char* tempPath, const void* data, size_t length);
+}
+
+#endif
@@ -0,0 +1,75 @@
+///----------------------------------------------------------------------------------------------------
+/// Platform - POSIX implementation (host builds for tests and benchmarks)
+///----------------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+
+#include "platform.h"
+
+const char Platform::PathSeparator = '/';
+
+bool Platform::CreateDirectories(const char* path)
+{
+    if (!path || !path[0])
+        return false;
+
+    char buffer[4096];
+    size_t len = strlen(path);
+    if (len >= sizeof(buffer))
+        return false;
+    memcpy(buffer, path, len + 1);
+
+    for (size_t i = 1; i <= len; i++)
+    {
+        if (buffer[i] != '/' && buffer[i] != '\\' && buffer[i] != '\0')
+            continue;
+
+        char saved = buffer[i];
+        buffer[i] = '\0';
+        if (mkdir(buffer, 0755) != 0 && errno != EEXIST && saved == '\0')
+            return false;
+        buffer[i] = saved;
+    }
+    return true;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// WriteWholeFile - Create or truncate a file and write the buffer
+///----------------------------------------------------------------------------------------------------
+static bool WriteWholeFile(const char* path, const void* data, size_t length)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+
+    const char* bytes = static_cast<const char*>(data);
+    size_t remaining = length;
+    while (remaining > 0)
+    {
+        ssize_t written = write(fd, bytes, remaining);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            close(fd);
+            return false;
+        }
+        bytes += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    return close(fd) == 0;
+}
+
+bool Platform::ReplaceFileContents(const char* path, const char* tempPath, const void* data, size_t length)
+{
+    if (WriteWholeFile(tempPath, data, length) && rename(tempPath, path) == 0)
+        return true;
+
+    unlink(tempPath);
+    return false;
+}
@@ -0,0 +1,74 @@
+///----------------------------------------------------------------------------------------------------
+/// Platform - Win32 implementation
+///----------------------------------------------------------------------------------------------------
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#include <cstring>
+
+#include "platform.h"
+
+const char Platform::PathSeparator = '\\';
+
+bool Platform::CreateDirectories(const char* path)
+{
+    if (!path || !path[0])
+        return false;
+
+    char buffer[MAX_PATH * 2];
+    size_t len = strlen(path);
+    if (len >= sizeof(buffer))
+        return false;
+    memcpy(buffer, path, len + 1);
+
+    // Create each prefix in turn; existing components simply fail with ERROR_ALREADY_EXISTS
+    for (size_t i = 1; i <= len; i++)
+    {
+        if (buffer[i] != '\\' && buffer[i] != '/' && buffer[i] != '\0')
+            continue;
+        if (buffer[i - 1] == ':')
+            continue;  // drive root, e.g. "C:\"
+
+        char saved = buffer[i];
+        buffer[i] = '\0';
+        if (!CreateDirectoryA(buffer, nullptr) && GetLastError() != ERROR_ALREADY_EXISTS)
+        {
+            buffer[i] = saved;
+            if (saved == '\0')
+                return false;
+            continue;  // e.g. access denied on a parent that already exists
+        }
+        buffer[i] = saved;
+    }
+    return true;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// WriteWholeFile - Create or truncate a file and write the buffer in a single WriteFile call
+///----------------------------------------------------------------------------------------------------
+static bool WriteWholeFile(const char* path, const void* data, size_t length)
+{
+    HANDLE file = CreateFileA(path, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    DWORD written = 0;
+    BOOL ok = WriteFile(file, data, static_cast<DWORD>(length), &written, nullptr);
+    CloseHandle(file);
+    return ok && written == length;
+}
+
+bool Platform::ReplaceFileContents(const char* path, const char* tempPath, const void* data, size_t length)
+{
+    if (WriteWholeFile(tempPath, data, length) &&
+        MoveFileExA(tempPath, path, MOVEFILE_REPLACE_EXISTING))
+    {
+        return true;
+    }
+
+    DeleteFileA(tempPath);
+    return false;
+}
@@ -0,0 +1,62 @@
+///----------------------------------------------------------------------------------------------------
+/// Rate Tracker - Rolling kills per minute, downs per minute and damage per second
+///----------------------------------------------------------------------------------------------------
+
+#include "rate_tracker.h"
+
+#include <mutex>
+
+#include "sliding_window.h"
+
+namespace
+{
+    constexpr uint32_t WindowLengths[RateWindow_Count] = {10 * 1000, 60 * 1000, 5 * 60 * 1000};
+
+    // Milliseconds per unit of each rate: per minute for counts, per second for damage
+    constexpr double RateUnitMs[Rate_Count] = {60000.0, 60000.0, 1000.0};
+
+    struct RateWindows
+    {
+        SlidingWindow Windows[RateWindow_Count] = {
+            SlidingWindow(WindowLengths[RateWindow_10s]),
+            SlidingWindow(WindowLengths[RateWindow_60s]),
+            SlidingWindow(WindowLengths[RateWindow_5min]),
+        };
+    };
+
+    std::mutex  g_mutex;
+    RateWindows g_rates[Rate_Count];
+}
+
+uint32_t RateTracker::WindowMs(ERateWindow window)
+{
+    return WindowLengths[window];
+}
+
+void RateTracker::Add(ERate rate, uint64_t eventTimeMs, uint64_t amount)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    for (SlidingWindow& window : g_rates[rate].Windows)
+        window.Add(eventTimeMs, amount);
+}
+
+uint64_t RateTracker::Total(ERate rate, ERateWindow window, uint64_t nowMs)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_rates[rate].Windows[window].Sum(nowMs);
+}
+
+double RateTracker::Rate(ERate rate, ERateWindow window, uint64_t nowMs)
+{
+    return static_cast<double>(Total(rate, window, nowMs)) * RateUnitMs[rate] / WindowLengths[window];
+}
+
+void RateTracker::Reset()
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    for (RateWindows& rate : g_rates)
+    {
+        for (SlidingWindow& window : rate.Windows)
+            window.Clear();
+    }
+}
@@ -0,0 +1,50 @@
+///----------------------------------------------------------------------------------------------------
+/// Rate Tracker - Rolling kills per minute, downs per minute and damage per second
+///
+/// Each rate is kept over 10 second, 60 second and 5 minute windows, one SlidingWindow each, keyed by
+/// the ArcDPS event time (ev->Time, milliseconds). The event queue worker adds to them as records are
+/// processed; output renderers query them on a timer against EventClock::Now(), so a damage tick never
+/// costs more than a bucket increment and rates keep decaying while no events come in. A small mutex
+/// guards the windows: the worker takes it once per counted record and the renderers a few times per
+/// refresh, so it is never contended for long.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_RATE_TRACKER_H
+#define STREAMLINK_RATE_TRACKER_H
+
+#include <cstdint>
+
+enum ERate : uint32_t
+{
+    Rate_Kills,    // our killing blows on players (WvW), per minute
+    Rate_Downs,    // enemy players we downed (WvW), per minute
+    Rate_Damage,   // outgoing strike and condition damage, per second
+    Rate_Count
+};
+
+enum ERateWindow : uint32_t
+{
+    RateWindow_10s,
+    RateWindow_60s,
+    RateWindow_5min,
+    RateWindow_Count
+};
+
+namespace RateTracker
+{
+    uint32_t WindowMs(ERateWindow window);
+
+    /// Counts amount at an ArcDPS event time.
+    void Add(ERate rate, uint64_t eventTimeMs, uint64_t amount);
+
+    /// Total added within the window ending at nowMs (event time).
+    uint64_t Total(ERate rate, ERateWindow window, uint64_t nowMs);
+
+    /// Total scaled to the rate's unit: per minute for kills and downs, per second for damage. The
+    /// whole window length is the divisor, so rates ramp up over the first window of a session.
+    double Rate(ERate rate, ERateWindow window, uint64_t nowMs);
+
+    void Reset();
+}
+
+#endif
@@ -0,0 +1,130 @@
+///----------------------------------------------------------------------------------------------------
+/// Seqlock - Lock-free consistent snapshots of a small trivially copyable value
+///
+/// The value is stored as an array of relaxed 64-bit atomics guarded by a sequence counter that is odd
+/// while a write is in progress. Writers serialise by moving the counter from even to odd with a CAS,
+/// so any thread may write; write sections are a few dozen stores, so contention is short-lived.
+/// Readers never write shared memory: they copy the words and retry if the counter moved, so a
+/// reader can never slow a writer down and always gets a value some writer actually stored.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_SEQLOCK_H
+#define STREAMLINK_SEQLOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+template <typename T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock values are copied word by word");
+
+public:
+    Seqlock()
+    {
+        T value = T();
+        StoreWords(value);
+    }
+
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    /// Consistent copy of the value. Retries while a write overlaps the copy.
+    T Load() const
+    {
+        uint64_t words[WordCount];
+        for (uint32_t spins = 0;; spins++)
+        {
+            uint64_t before = m_sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0)
+            {
+                for (size_t i = 0; i < WordCount; i++)
+                    words[i] = m_words[i].load(std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_sequence.load(std::memory_order_relaxed) == before)
+                    break;
+            }
+            if (spins >= SpinsBeforeYield)
+                std::this_thread::yield();
+        }
+
+        T value;
+        memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    /// Runs fn(T&) on the current value inside a write section and publishes the result. fn must be
+    /// short and must not touch this Seqlock.
+    template <typename Fn>
+    void Update(Fn&& fn)
+    {
+        uint64_t seq = BeginWrite();
+
+        // The write section is exclusive, so the words can be read without validation
+        uint64_t words[WordCount];
+        for (size_t i = 0; i < WordCount; i++)
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        T value;
+        memcpy(&value, words, sizeof(T));
+
+        fn(value);
+
+        StoreWords(value);
+        m_sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Replaces the whole value.
+    void Store(const T& value)
+    {
+        uint64_t seq = BeginWrite();
+        StoreWords(value);
+        m_sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Number of completed writes times two (even while idle). Cheap change detection for readers.
+    uint64_t Sequence() const
+    {
+        return m_sequence.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t   WordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    static constexpr uint32_t SpinsBeforeYield = 64;
+
+    uint64_t BeginWrite()
+    {
+        uint64_t seq = m_sequence.load(std::memory_order_relaxed);
+        for (uint32_t spins = 0;; spins++)
+        {
+            if ((seq & 1) == 0 &&
+                m_sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                                 std::memory_order_relaxed))
+            {
+                // Keep the payload stores below from becoming visible before the odd sequence
+                std::atomic_thread_fence(std::memory_order_release);
+                return seq;
+            }
+            if (spins >= SpinsBeforeYield)
+                std::this_thread::yield();
+            seq = m_sequence.load(std::memory_order_relaxed);
+        }
+    }
+
+    void StoreWords(const T& value)
+    {
+        uint64_t words[WordCount] = {};
+        memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < WordCount; i++)
+            m_words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    alignas(64) std::atomic<uint64_t> m_sequence{0};
+    std::atomic<uint64_t>             m_words[WordCount];
+};
+
+#endif
@@ -0,0 +1,330 @@
+///----------------------------------------------------------------------------------------------------
+/// Session Journal - Crash-safe record of the session stats, restored on the next load
+///----------------------------------------------------------------------------------------------------
+
+#include "session_journal.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#include "mpsc_ring.h"
+#include "platform.h"
+
+namespace
+{
+    constexpr size_t QueueSize = 256;
+
+    // CRC-32 (IEEE 802.3, reflected), table built once at startup
+    struct Crc32Table
+    {
+        uint32_t Values[256];
+
+        Crc32Table()
+        {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; bit++)
+                    crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+                Values[i] = crc;
+            }
+        }
+    };
+
+    const Crc32Table g_crc;
+
+    MpscRing<JournalRecord, QueueSize> g_queue;
+    std::atomic<bool>                  g_open{false};
+    std::atomic<uint32_t>              g_session{0};
+
+    // Newest snapshot that found the queue full. While one is pending every later snapshot replaces
+    // it instead of entering the queue, so it always follows the queued ones in the file.
+    std::mutex                         g_latestMutex;
+    std::atomic<bool>                  g_latestPending{false};
+    JournalRecord                      g_latest = {};
+
+    // Writer thread only (and Open/Close, which run while it is stopped)
+    std::string g_path;
+    FILE*       g_file = nullptr;
+    size_t      g_records = 0;      // valid records in the file
+    bool        g_compact = false;  // rewrite before the next append
+    bool        g_unusable = false; // damaged or not a journal: appends would be lost until rewritten
+}
+
+static uint32_t Crc32(const void* data, size_t length)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++)
+        crc = g_crc.Values[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static uint32_t Checksum(const JournalRecord& record)
+{
+    const char* bytes = reinterpret_cast<const char*>(&record);
+    return Crc32(bytes + sizeof(record.Checksum), sizeof(record) - sizeof(record.Checksum));
+}
+
+static JournalHeader MakeHeader()
+{
+    JournalHeader header = {};
+    header.Magic = JournalHeader::MagicValue;
+    header.Version = JournalHeader::CurrentVersion;
+    header.RecordSize = sizeof(JournalRecord);
+    return header;
+}
+
+bool JournalReader::Open(const char* path)
+{
+    Close();
+    if (!m_file.Open(path))
+        return false;
+
+    const JournalHeader* header = static_cast<const JournalHeader*>(m_file.Data());
+    if (m_file.Size() < sizeof(JournalHeader) || header->Magic != JournalHeader::MagicValue ||
+        header->Version != JournalHeader::CurrentVersion || header->RecordSize != sizeof(JournalRecord))
+    {
+        m_file.Close();
+        return false;
+    }
+
+    // Records are checked in place; the first one that fails ends the journal
+    m_records = reinterpret_cast<const JournalRecord*>(header + 1);
+    size_t available = (m_file.Size() - sizeof(JournalHeader)) / sizeof(JournalRecord);
+    while (m_count < available && m_records[m_count].Checksum == Checksum(m_records[m_count]))
+        m_count++;
+    m_damaged = sizeof(JournalHeader) + m_count * sizeof(JournalRecord) != m_file.Size();
+    return true;
+}
+
+void JournalReader::Close()
+{
+    m_file.Close();
+    m_records = nullptr;
+    m_count = 0;
+    m_damaged = false;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// CreateParentDirectory - Make sure the directory the journal lives in exists
+///----------------------------------------------------------------------------------------------------
+static void CreateParentDirectory(const std::string& path)
+{
+    size_t separator = path.find_last_of("\\/");
+    if (separator != std::string::npos && separator != 0)
+        Platform::CreateDirectories(path.substr(0, separator).c_str());
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Compact - Rewrite the journal as its header plus the last record of each of the last MaxHistory
+///           sessions (writer thread)
+///
+/// The new file only takes the journal's place through an atomic rename. If that is refused the old
+/// journal is left as it was and the next flush tries again.
+///----------------------------------------------------------------------------------------------------
+static void Compact()
+{
+    if (g_file)
+    {
+        fclose(g_file);
+        g_file = nullptr;
+    }
+
+    static unsigned char buffer[sizeof(JournalHeader) + SessionJournal::MaxHistory * sizeof(JournalRecord)];
+    JournalHeader header = MakeHeader();
+    memcpy(buffer, &header, sizeof(header));
+    JournalRecord* kept = reinterpret_cast<JournalRecord*>(buffer + sizeof(header));
+    size_t keptCount = 0;
+
+    // Newest first: a record is kept when it is the last one of its session
+    JournalReader reader;
+    if (reader.Open(g_path.c_str()))
+    {
+        for (size_t i = reader.Count(); i-- > 0 && keptCount < SessionJournal::MaxHistory;)
+        {
+            const JournalRecord& record = reader.Records()[i];
+            if (keptCount == 0 || record.Session != kept[keptCount - 1].Session)
+                kept[keptCount++] = record;
+        }
+        reader.Close();   // Windows cannot replace a file that is still mapped
+    }
+    for (size_t i = 0; i < keptCount / 2; i++)
+    {
+        JournalRecord swap = kept[i];
+        kept[i] = kept[keptCount - 1 - i];
+        kept[keptCount - 1 - i] = swap;
+    }
+
+    std::string tempPath = g_path + ".tmp";
+    if (!Platform::ReplaceFileContents(g_path.c_str(), tempPath.c_str(), buffer,
+                                       sizeof(header) + keptCount * sizeof(JournalRecord)))
+        return;
+
+    g_records = keptCount;
+    g_compact = false;
+    g_unusable = false;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Push - Stamp and queue one snapshot
+///----------------------------------------------------------------------------------------------------
+static void Push(EJournalRecord type, const SessionCounters& session, uint64_t nowMs)
+{
+    if (!g_open.load(std::memory_order_acquire))
+        return;
+
+    JournalRecord record = {};
+    record.Type = type;
+    record.StatCount = SessionStat_Count;
+    record.Session = g_session.load(std::memory_order_relaxed);
+    record.WallTimeMs = nowMs;
+    memcpy(record.Stats, session.Values, SessionStat_Count * sizeof(uint32_t));
+    record.Checksum = Checksum(record);
+
+    // A full queue keeps the newest snapshot aside rather than losing it; each one supersedes the last
+    if (!g_latestPending.load(std::memory_order_acquire) && g_queue.TryPush(record))
+        return;
+    std::lock_guard<std::mutex> lock(g_latestMutex);
+    g_latest = record;
+    g_latestPending.store(true, std::memory_order_release);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// TakeQueued - Pop the queued snapshots, followed by the pending newest one if there is one
+///----------------------------------------------------------------------------------------------------
+static size_t TakeQueued(JournalRecord* out, size_t max)
+{
+    if (!g_latestPending.load(std::memory_order_acquire))
+        return g_queue.PopBatch(out, max);
+
+    // Under the lock no producer can slip a snapshot into the queue ahead of the pending one
+    std::lock_guard<std::mutex> lock(g_latestMutex);
+    size_t count = g_queue.PopBatch(out, max - 1);
+    out[count++] = g_latest;
+    g_latestPending.store(false, std::memory_order_release);
+    return count;
+}
+
+bool SessionJournal::Open(const std::string& path, uint64_t nowMs, uint64_t maxAgeMs, SessionCounters& restored)
+{
+    // Anything queued by a previous session was flushed by its Close; drop leftovers
+    JournalRecord discard;
+    while (g_queue.TryPop(discard)) {}
+    g_latestPending.store(false, std::memory_order_relaxed);
+    if (g_file)
+    {
+        fclose(g_file);
+        g_file = nullptr;
+    }
+
+    g_path = path;
+    CreateParentDirectory(path);
+
+    bool restore = false;
+    uint32_t session = 0;
+    JournalReader reader;
+    if (reader.Open(path.c_str()))
+    {
+        g_records = reader.Count();
+        g_unusable = reader.Damaged();
+        g_compact = g_unusable || g_records >= CompactThreshold;
+        if (g_records != 0)
+        {
+            const JournalRecord& last = reader.Records()[g_records - 1];
+            uint64_t age = nowMs >= last.WallTimeMs ? nowMs - last.WallTimeMs : last.WallTimeMs - nowMs;
+            restore = maxAgeMs != 0 && age <= maxAgeMs;
+            session = last.Session;
+            if (restore)
+            {
+                restored = SessionCounters();
+                size_t stats = last.StatCount < SessionStat_Count ? last.StatCount : SessionStat_Count;
+                memcpy(restored.Values, last.Stats, stats * sizeof(uint32_t));
+            }
+        }
+    }
+    else
+    {
+        // Missing or unreadable: the first flush writes a fresh header
+        g_records = 0;
+        g_compact = true;
+        g_unusable = true;
+    }
+
+    g_session.store(restore ? session : session + 1, std::memory_order_relaxed);
+    g_open.store(true, std::memory_order_release);
+    return restore;
+}
+
+void SessionJournal::Record(const SessionCounters& session, uint64_t nowMs)
+{
+    Push(JournalRecord_Streak, session, nowMs);
+}
+
+void SessionJournal::Flush()
+{
+    if (!g_open.load(std::memory_order_acquire))
+        return;
+
+    // Until a damaged journal has been rewritten the snapshots wait in the queue
+    if (g_compact)
+        Compact();
+    if (g_unusable)
+        return;
+
+    JournalRecord batch[QueueSize + 1];
+    size_t count = TakeQueued(batch, QueueSize + 1);
+    if (count == 0)
+        return;
+
+    if (!g_file)
+    {
+        g_file = fopen(g_path.c_str(), "ab");
+        if (!g_file)
+            return;
+
+        // Compaction normally leaves a header behind; write one if the file came up empty anyway
+        fseek(g_file, 0, SEEK_END);
+        if (ftell(g_file) == 0)
+        {
+            JournalHeader header = MakeHeader();
+            fwrite(&header, sizeof(header), 1, g_file);
+        }
+    }
+
+    // One sequential write per pass; a crash mid-write leaves a tail that fails its checksum
+    fwrite(batch, sizeof(JournalRecord), count, g_file);
+    fflush(g_file);
+    g_records += count;
+    if (g_records >= CompactThreshold)
+        g_compact = true;
+}
+
+void SessionJournal::Close(const SessionCounters& session, uint64_t nowMs)
+{
+    if (!g_open.load(std::memory_order_acquire))
+        return;
+
+    Push(JournalRecord_Summary, session, nowMs);
+    Flush();
+    g_open.store(false, std::memory_order_release);
+    if (g_file)
+    {
+        fclose(g_file);
+        g_file = nullptr;
+    }
+}
+
+uint32_t SessionJournal::Session()
+{
+    return g_session.load(std::memory_order_relaxed);
+}
+
+uint64_t SessionJournal::WallClockMs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,111 @@
+///----------------------------------------------------------------------------------------------------
+/// Session Journal - Crash-safe record of the session stats, restored on the next load
+///
+/// An append-only binary file under the addon directory: a header, then fixed-size 64-byte records,
+/// each a full snapshot of the session counters with a session number, a wall-clock time and a CRC-32.
+/// Every streak or stat change queues a snapshot on a lock-free ring; the writer thread appends the
+/// queue in one write per flush pass, so nothing on the event path waits on the disk. Unload appends a
+/// session summary. Because every record is a snapshot, replay is just finding the newest valid record:
+/// the file is mapped, checked record by record, and anything after the first bad checksum (a write
+/// torn by a crash) is ignored. If that record is recent enough, the session carries on where it left
+/// off. When the file grows past CompactThreshold records or a damaged tail was found, the writer
+/// thread rewrites it, keeping the last record of each of the last MaxHistory sessions; the rewrite
+/// replaces the journal only through an atomic rename, and a refused one leaves it untouched.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_SESSION_JOURNAL_H
+#define STREAMLINK_SESSION_JOURNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "mapped_file.h"
+#include "session_stats.h"
+
+enum EJournalRecord : uint16_t
+{
+    JournalRecord_Streak = 1,    // a streak or stat changed
+    JournalRecord_Summary = 2    // the session ended (unload)
+};
+
+/// File header, padded to one record so records stay 64-byte aligned in a mapping
+struct JournalHeader
+{
+    static constexpr uint32_t MagicValue = 0x4A4C5453;   // "STLJ"
+    static constexpr uint32_t CurrentVersion = 1;
+
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t RecordSize;
+    uint32_t Reserved[13];
+};
+
+struct JournalRecord
+{
+    static constexpr uint32_t MaxStats = 10;
+
+    uint32_t Checksum;           // CRC-32 of every byte after this field
+    uint16_t Type;               // EJournalRecord
+    uint16_t StatCount;          // SessionStat_Count when written
+    uint32_t Session;            // session number; a restored session keeps its number
+    uint32_t Reserved;
+    uint64_t WallTimeMs;         // milliseconds since the Unix epoch, for the restore window
+    uint32_t Stats[MaxStats];    // SessionCounters::Values, by ESessionStat
+};
+
+static_assert(sizeof(JournalHeader) == 64, "journal header is one record long");
+static_assert(sizeof(JournalRecord) == 64, "journal records are 64 bytes");
+static_assert(SessionStat_Count <= JournalRecord::MaxStats, "journal record has no room for the new stat");
+
+///----------------------------------------------------------------------------------------------------
+/// JournalReader - Maps a journal file and exposes its valid records in place
+///----------------------------------------------------------------------------------------------------
+class JournalReader
+{
+public:
+    /// Maps the file and checks the header and every record. False if it is missing or not a journal.
+    bool Open(const char* path);
+    void Close();
+
+    size_t               Count() const { return m_count; }
+    const JournalRecord* Records() const { return m_records; }
+
+    /// Bytes after the valid records: a torn or corrupted tail.
+    bool Damaged() const { return m_damaged; }
+
+private:
+    MappedFile           m_file;
+    const JournalRecord* m_records = nullptr;
+    size_t               m_count = 0;
+    bool                 m_damaged = false;
+};
+
+namespace SessionJournal
+{
+    constexpr size_t CompactThreshold = 4096;   // records before the file is rewritten (256 KB)
+    constexpr size_t MaxHistory = 64;           // sessions kept by compaction
+
+    /// Opens the journal at path (created on the first flush) and replays it. If its newest record is
+    /// at most maxAgeMs older than nowMs, copies that snapshot into restored, continues that session
+    /// and returns true; otherwise a new session starts.
+    bool Open(const std::string& path, uint64_t nowMs, uint64_t maxAgeMs, SessionCounters& restored);
+
+    /// Queues a snapshot, any thread. Lock-free until the queue is full; then the newest snapshot is
+    /// kept aside under a lock and written after the queued ones, so the last one always reaches the file.
+    void Record(const SessionCounters& session, uint64_t nowMs);
+
+    /// Appends the queued snapshots, compacting first if needed. Writer thread only.
+    void Flush();
+
+    /// Appends a session summary, flushes and closes the file. Only after the writer thread stopped.
+    void Close(const SessionCounters& session, uint64_t nowMs);
+
+    /// Current session number (1 for the first session in a new journal).
+    uint32_t Session();
+
+    /// Milliseconds since the Unix epoch, the clock the records are stamped with.
+    uint64_t WallClockMs();
+}
+
+#endif
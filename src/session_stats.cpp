@@ -0,0 +1,48 @@
+///----------------------------------------------------------------------------------------------------
+/// Session Stats - Kills, deaths, downs and streaks since the addon was loaded
+///----------------------------------------------------------------------------------------------------
+
+#include "session_stats.h"
+
+namespace
+{
+    struct EventRow
+    {
+        uint32_t add[SessionCounters::Capacity];   // added to the counters
+        uint32_t keepStreak;                       // 1 keeps the current streak, 0 ends it
+    };
+
+    // Rows follow ESessionEvent, columns follow ESessionStat
+    //                        kills deaths downs streak best
+    constexpr EventRow Rows[SessionEvent_Count] = {
+        /* Kill */        {{1,    0,     0,    1,     0}, 1},
+        /* Death */       {{0,    1,     0,    0,     0}, 0},
+        /* EnemyDowned */ {{0,    0,     1,    0,     0}, 1},
+        /* StreakEnd */   {{0,    0,     0,    0,     0}, 0},
+    };
+
+    static_assert(SessionStat_Kills == 0 && SessionStat_Deaths == 1 && SessionStat_Downs == 2 &&
+                  SessionStat_CurrentStreak == 3 && SessionStat_BestStreak == 4,
+                  "table columns follow ESessionStat");
+}
+
+void SessionStats::Apply(SessionCounters& counters, ESessionEvent event)
+{
+    const EventRow& row = Rows[event < SessionEvent_Count ? event : SessionEvent_StreakEnd];
+
+    uint32_t* values = counters.Values;
+    values[SessionStat_CurrentStreak] *= row.keepStreak;
+    for (uint32_t i = 0; i < SessionCounters::Capacity; i++)
+        values[i] += row.add[i];
+
+    uint32_t streak = values[SessionStat_CurrentStreak];
+    uint32_t best = values[SessionStat_BestStreak];
+    values[SessionStat_BestStreak] = best > streak ? best : streak;
+}
+
+double SessionStats::KillDeathRatio(const SessionCounters& counters)
+{
+    uint32_t deaths = counters.Get(SessionStat_Deaths);
+    double kills = static_cast<double>(counters.Get(SessionStat_Kills));
+    return deaths != 0 ? kills / static_cast<double>(deaths) : kills;
+}
@@ -0,0 +1,55 @@
+///----------------------------------------------------------------------------------------------------
+/// Session Stats - Kills, deaths, downs and streaks since the addon was loaded
+///
+/// All counters sit in one 64-byte SessionCounters. Every tracked outcome is an ESessionEvent, and
+/// Apply() adds that event's row from a constant table to the counters and updates the streaks
+/// without branching, so a new stat is a new column in the table rather than new per-event code.
+/// K/D is derived when rendering.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_SESSION_STATS_H
+#define STREAMLINK_SESSION_STATS_H
+
+#include <cstdint>
+
+enum ESessionStat : uint32_t
+{
+    SessionStat_Kills,           // enemy players we killed (killing blow, WvW)
+    SessionStat_Deaths,          // times we died in WvW
+    SessionStat_Downs,           // enemy players we downed (WvW)
+    SessionStat_CurrentStreak,   // kills since the last death (the killstreak)
+    SessionStat_BestStreak,      // longest streak this session
+    SessionStat_Count
+};
+
+enum ESessionEvent : uint32_t
+{
+    SessionEvent_Kill,
+    SessionEvent_Death,
+    SessionEvent_EnemyDowned,
+    SessionEvent_StreakEnd,      // streak ends without a death (killing blow on us, leaving WvW)
+    SessionEvent_Count
+};
+
+struct alignas(64) SessionCounters
+{
+    static constexpr uint32_t Capacity = 16;   // room for new stats without changing the layout
+
+    uint32_t Values[Capacity] = {};
+
+    uint32_t Get(ESessionStat stat) const { return Values[stat]; }
+};
+
+static_assert(sizeof(SessionCounters) == 64, "SessionCounters is one cache line");
+static_assert(SessionStat_Count <= SessionCounters::Capacity, "too many session stats");
+
+namespace SessionStats
+{
+    /// Applies one event. O(1), no data-dependent branches.
+    void Apply(SessionCounters& counters, ESessionEvent event);
+
+    /// Kills per death; with no deaths, the kill count.
+    double KillDeathRatio(const SessionCounters& counters);
+}
+
+#endif
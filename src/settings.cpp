@@ -0,0 +1,435 @@
+///----------------------------------------------------------------------------------------------------
+/// Settings - Parsed settings.txt as an immutable Config, swapped in whole on reload
+///----------------------------------------------------------------------------------------------------
+
+#include "settings.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "mumble_link.h"
+#include "overlay_server.h"
+#include "tracing.h"
+
+namespace
+{
+    struct PathDefault
+    {
+        EOutputPath path;
+        const char* key;
+        const char* defaultPath;
+    };
+
+    const PathDefault PathDefaults[] = {
+        {OutputPath_Killstreak,      "killstreak_file",    "addons/streamlink/killstreak.txt"},
+        {OutputPath_Squad,           "squad_file",         "addons/streamlink/squad.txt"},
+        {OutputPath_PlayerStatus,    "player_status_file", "addons/streamlink/playerstatus.txt"},
+        {OutputPath_SquadSize,       "squad_size_file",    "addons/streamlink/squadsize.txt"},
+        {OutputPath_Subgroups,       "subgroups_file",     "addons/streamlink/subgroups.txt"},
+        {OutputPath_Commanders,      "commanders_file",    "addons/streamlink/commanders.txt"},
+        {OutputPath_Lieutenants,     "lieutenants_file",   "addons/streamlink/lieutenants.txt"},
+        {OutputPath_GroupType,       "group_type_file",    "addons/streamlink/grouptype.txt"},
+        {OutputPath_Ready,           "ready_file",         "addons/streamlink/ready.txt"},
+        {OutputPath_SquadAlive,      "squad_alive_file",   "addons/streamlink/squadalive.txt"},
+        {OutputPath_SquadDowned,     "squad_downed_file",  "addons/streamlink/squaddowned.txt"},
+        {OutputPath_SquadDead,       "squad_dead_file",    "addons/streamlink/squaddead.txt"},
+        {OutputPath_Enemies,         "enemies_file",       "addons/streamlink/enemies.txt"},
+        {OutputPath_EnemyTeams,      "enemy_teams_file",   "addons/streamlink/enemyteams.txt"},
+        {OutputPath_MapName,         "map_file",           "addons/streamlink/map.txt"},
+        {OutputPath_MapId,           "map_id_file",        "addons/streamlink/mapid.txt"},
+        {OutputPath_Kills,           "kills_file",         "addons/streamlink/kills.txt"},
+        {OutputPath_Deaths,          "deaths_file",        "addons/streamlink/deaths.txt"},
+        {OutputPath_Downs,           "downs_file",         "addons/streamlink/downs.txt"},
+        {OutputPath_BestStreak,      "best_streak_file",   "addons/streamlink/beststreak.txt"},
+        {OutputPath_KillDeathRatio,  "kd_file",            "addons/streamlink/kd.txt"},
+        {OutputPath_KillsPerMinute,  "kpm_file",           "addons/streamlink/kpm.txt"},
+        {OutputPath_DownsPerMinute,  "downs_pm_file",      "addons/streamlink/downspm.txt"},
+        {OutputPath_DamagePerSecond, "dps_file",           "addons/streamlink/dps.txt"},
+        {OutputPath_KillFeed,        "kill_feed_file",     "addons/streamlink/killfeed.txt"},
+        {OutputPath_Health,          "health_file",        "addons/streamlink/health.txt"},
+        {OutputPath_Barrier,         "barrier_file",       "addons/streamlink/barrier.txt"},
+        {OutputPath_MetricsText,     "metrics_file",       "addons/streamlink/metrics.txt"},
+        {OutputPath_MetricsJson,     "metrics_json_file",  "addons/streamlink/metrics.json"},
+    };
+
+    static_assert(sizeof(PathDefaults) / sizeof(PathDefaults[0]) == OutputPath_Count, "one row per output path");
+
+    const uint32_t DefaultMilestones[] = {5, 10, 25, 50, 100};
+
+    std::atomic<const Config*>           g_current{nullptr};
+    std::mutex                           g_publishMutex;
+    std::vector<std::unique_ptr<Config>> g_published;      // every Config handed out, freed by Reset
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Value parsers - One per kind of setting, instantiated per Config field
+///----------------------------------------------------------------------------------------------------
+static bool ParseFlag(const char* value, bool& out)
+{
+    static const char* const on[] = {"1", "true", "yes", "on"};
+    static const char* const off[] = {"0", "false", "no", "off"};
+    for (size_t i = 0; i < 4; i++)
+    {
+        if (strcmp(value, on[i]) == 0) { out = true; return true; }
+        if (strcmp(value, off[i]) == 0) { out = false; return true; }
+    }
+    return false;
+}
+
+static bool ParseUnsigned(const char* value, uint32_t min, uint32_t max, uint32_t& out)
+{
+    if (!value[0])
+        return false;
+    char* end = nullptr;
+    unsigned long parsed = strtoul(value, &end, 10);
+    if (*end != '\0' || parsed < min || parsed > max)
+        return false;
+    out = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+template <bool Config::*Field>
+static bool SetFlag(const char* value, Config& config)
+{
+    return ParseFlag(value, config.*Field);
+}
+
+template <uint32_t Config::*Field, uint32_t Min, uint32_t Max>
+static bool SetNumber(const char* value, Config& config)
+{
+    return ParseUnsigned(value, Min, Max, config.*Field);
+}
+
+template <std::string Config::*Field>
+static bool SetText(const char* value, Config& config)
+{
+    config.*Field = value;
+    return true;
+}
+
+template <EOutputPath Path>
+static bool SetPath(const char* value, Config& config)
+{
+    config.OutputPaths[Path] = value;
+    return true;
+}
+
+static bool SetMumbleLink(const char* value, Config& config)
+{
+    if (!value[0])
+        return false;
+    config.MumbleLink = value;
+    return true;
+}
+
+static bool SetServerPort(const char* value, Config& config)
+{
+    uint32_t port = 0;
+    if (!ParseUnsigned(value, 0, 65535, port))
+        return false;
+    config.ServerPort = static_cast<uint16_t>(port);
+    return true;
+}
+
+static bool SetLogLevel(const char* value, Config& config)
+{
+    return Tracing::ParseLevel(value, config.LogLevel);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// SetMilestones - Comma-separated killstreak counts, e.g. "5, 10, 25"; empty turns alerts off
+///----------------------------------------------------------------------------------------------------
+static bool SetMilestones(const char* value, Config& config)
+{
+    uint32_t milestones[Config::MaxMilestones];
+    size_t count = 0;
+    const char* p = value;
+    while (*p)
+    {
+        while (*p == ' ' || *p == ',')
+            p++;
+        if (!*p)
+            break;
+
+        char* end = nullptr;
+        unsigned long parsed = strtoul(p, &end, 10);
+        if (end == p || parsed == 0 || parsed > AlertRules::MaxThreshold || count == Config::MaxMilestones)
+            return false;
+        milestones[count++] = static_cast<uint32_t>(parsed);
+        p = end;
+        if (*p && *p != ',' && *p != ' ')
+            return false;
+    }
+
+    std::sort(milestones, milestones + count);
+    count = static_cast<size_t>(std::unique(milestones, milestones + count) - milestones);
+    std::copy(milestones, milestones + count, config.Milestones);
+    config.MilestoneCount = count;
+    return true;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Comparers - Whether a setting differs between two configs
+///----------------------------------------------------------------------------------------------------
+template <typename T, T Config::*Field>
+static bool Same(const Config& a, const Config& b)
+{
+    return a.*Field == b.*Field;
+}
+
+template <EOutputPath Path>
+static bool SamePath(const Config& a, const Config& b)
+{
+    return a.OutputPaths[Path] == b.OutputPaths[Path];
+}
+
+static bool SetRule(const char* value, Config& config)
+{
+    return config.Rules.Add(value);
+}
+
+static bool SameRules(const Config& a, const Config& b)
+{
+    return a.Rules.SameRules(b.Rules);
+}
+
+static bool SetCounter(const char* value, Config& config)
+{
+    return config.Counters.Add(value);
+}
+
+static bool SameCounters(const Config& a, const Config& b)
+{
+    return a.Counters.SameCounters(b.Counters);
+}
+
+static bool SameMilestones(const Config& a, const Config& b)
+{
+    return a.MilestoneCount == b.MilestoneCount &&
+           std::equal(a.Milestones, a.Milestones + a.MilestoneCount, b.Milestones);
+}
+
+namespace
+{
+    struct SettingDef
+    {
+        const char* key;
+        bool (*parse)(const char* value, Config& config);
+        bool (*same)(const Config& a, const Config& b);
+        bool restart;   // read once at load
+    };
+
+#define STREAMLINK_PATH_SETTING(path) \
+    {PathDefaults[path].key, SetPath<path>, SamePath<path>, false}
+
+    const SettingDef SettingDefs[] = {
+        STREAMLINK_PATH_SETTING(OutputPath_Killstreak),
+        STREAMLINK_PATH_SETTING(OutputPath_Squad),
+        STREAMLINK_PATH_SETTING(OutputPath_PlayerStatus),
+        STREAMLINK_PATH_SETTING(OutputPath_SquadSize),
+        STREAMLINK_PATH_SETTING(OutputPath_Subgroups),
+        STREAMLINK_PATH_SETTING(OutputPath_Commanders),
+        STREAMLINK_PATH_SETTING(OutputPath_Lieutenants),
+        STREAMLINK_PATH_SETTING(OutputPath_GroupType),
+        STREAMLINK_PATH_SETTING(OutputPath_Ready),
+        STREAMLINK_PATH_SETTING(OutputPath_SquadAlive),
+        STREAMLINK_PATH_SETTING(OutputPath_SquadDowned),
+        STREAMLINK_PATH_SETTING(OutputPath_SquadDead),
+        STREAMLINK_PATH_SETTING(OutputPath_Enemies),
+        STREAMLINK_PATH_SETTING(OutputPath_EnemyTeams),
+        STREAMLINK_PATH_SETTING(OutputPath_MapName),
+        STREAMLINK_PATH_SETTING(OutputPath_MapId),
+        STREAMLINK_PATH_SETTING(OutputPath_Kills),
+        STREAMLINK_PATH_SETTING(OutputPath_Deaths),
+        STREAMLINK_PATH_SETTING(OutputPath_Downs),
+        STREAMLINK_PATH_SETTING(OutputPath_BestStreak),
+        STREAMLINK_PATH_SETTING(OutputPath_KillDeathRatio),
+        STREAMLINK_PATH_SETTING(OutputPath_KillsPerMinute),
+        STREAMLINK_PATH_SETTING(OutputPath_DownsPerMinute),
+        STREAMLINK_PATH_SETTING(OutputPath_DamagePerSecond),
+        STREAMLINK_PATH_SETTING(OutputPath_KillFeed),
+        STREAMLINK_PATH_SETTING(OutputPath_Health),
+        STREAMLINK_PATH_SETTING(OutputPath_Barrier),
+        STREAMLINK_PATH_SETTING(OutputPath_MetricsText),
+        STREAMLINK_PATH_SETTING(OutputPath_MetricsJson),
+        {"trace_file",         SetText<&Config::TraceFile>,                         Same<std::string, &Config::TraceFile>,        false},
+        {"flush_interval_ms",  SetNumber<&Config::FlushIntervalMs, 10, 10000>,      Same<uint32_t, &Config::FlushIntervalMs>,     false},
+        {"gauge_interval_ms",  SetNumber<&Config::GaugeIntervalMs, 0, 60000>,       Same<uint32_t, &Config::GaugeIntervalMs>,     false},
+        {"gauge_threshold",    SetNumber<&Config::GaugeThreshold, 0, 100>,          Same<uint32_t, &Config::GaugeThreshold>,      false},
+        {"milestones",         SetMilestones,                                       SameMilestones,                               false},
+        {"rule",               SetRule,                                             SameRules,                                    false},
+        {"counter",            SetCounter,                                          SameCounters,                                 false},
+        {"log_level",          SetLogLevel,                                         Same<int, &Config::LogLevel>,                 false},
+        {"reset_on_leave_wvw", SetFlag<&Config::ResetOnLeaveWvW>,                   Same<bool, &Config::ResetOnLeaveWvW>,         false},
+        {"metrics",            SetFlag<&Config::Metrics>,                           Same<bool, &Config::Metrics>,                 false},
+        {"record",             SetFlag<&Config::Record>,                            Same<bool, &Config::Record>,                  false},
+        {"record_file",        SetText<&Config::RecordFile>,                        Same<std::string, &Config::RecordFile>,       false},
+        {"mumble_link",        SetMumbleLink,                                       Same<std::string, &Config::MumbleLink>,       true},
+        {"shared_memory",      SetFlag<&Config::SharedMemory>,                      Same<bool, &Config::SharedMemory>,            true},
+        {"server",             SetFlag<&Config::Server>,                            Same<bool, &Config::Server>,                  true},
+        {"server_port",        SetServerPort,                                       Same<uint16_t, &Config::ServerPort>,          true},
+        {"journal",            SetFlag<&Config::Journal>,                           Same<bool, &Config::Journal>,                 true},
+        {"journal_max_age",    SetNumber<&Config::JournalMaxAgeSec, 0, 86400 * 7>,  Same<uint32_t, &Config::JournalMaxAgeSec>,    true},
+    };
+
+#undef STREAMLINK_PATH_SETTING
+}
+
+Config Settings::Defaults()
+{
+    Config config;
+    for (const PathDefault& row : PathDefaults)
+        config.OutputPaths[row.path] = row.defaultPath;
+    config.MumbleLink = MumbleLink::DefaultName;
+    config.RecordFile = "addons/streamlink/recordings/%Y%m%d-%H%M%S.slrec";
+    config.ServerPort = OverlayServer::DefaultPort;
+    config.LogLevel = ELogLevel_INFO;
+    std::copy(std::begin(DefaultMilestones), std::end(DefaultMilestones), config.Milestones);
+    config.MilestoneCount = sizeof(DefaultMilestones) / sizeof(DefaultMilestones[0]);
+    config.Rules.Compile(config.Milestones, config.MilestoneCount);
+    return config;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Trim - Strip spaces, tabs and line endings from both ends, in place
+///----------------------------------------------------------------------------------------------------
+static char* Trim(char* text)
+{
+    while (*text == ' ' || *text == '\t')
+        text++;
+    size_t len = strlen(text);
+    while (len > 0 && strchr(" \t\r\n", text[len - 1]))
+        text[--len] = '\0';
+    return text;
+}
+
+size_t Settings::Parse(const std::string& text, Config& config)
+{
+    size_t rejected = 0;
+    bool firstLine = true;
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos)
+            end = text.size();
+
+        // Copied whole: a long counter filter or path is never cut short
+        std::string line(text, pos, end - pos);
+        pos = end + 1;
+
+        char* key = Trim(&line[0]);
+        if (!key[0] || key[0] == '#' || key[0] == ';')
+            continue;
+
+        char* value = strchr(key, '=');
+        if (!value)
+        {
+            // The original format: a bare first line is the killstreak output path
+            if (firstLine)
+                config.OutputPaths[OutputPath_Killstreak] = key;
+            else
+                rejected++;
+            firstLine = false;
+            continue;
+        }
+        firstLine = false;
+
+        *value++ = '\0';
+        key = Trim(key);
+        value = Trim(value);
+
+        const SettingDef* def = nullptr;
+        for (const SettingDef& candidate : SettingDefs)
+        {
+            if (strcmp(candidate.key, key) == 0)
+            {
+                def = &candidate;
+                break;
+            }
+        }
+        if (!def || !def->parse(value, config))
+            rejected++;
+    }
+    config.Rules.Compile(config.Milestones, config.MilestoneCount);
+    return rejected;
+}
+
+bool Settings::Load(const std::string& path, Config& config, size_t* rejectedLines)
+{
+    config = Defaults();
+    if (rejectedLines)
+        *rejectedLines = 0;
+    if (path.empty())
+        return false;
+
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f)
+        return false;
+
+    std::string text;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), f)) > 0)
+        text.append(buffer, read);
+    fclose(f);
+
+    size_t rejected = Parse(text, config);
+    if (rejectedLines)
+        *rejectedLines = rejected;
+    return true;
+}
+
+std::string Settings::ChangedKeys(const Config& before, const Config& after)
+{
+    std::string keys;
+    for (const SettingDef& def : SettingDefs)
+    {
+        if (def.same(before, after))
+            continue;
+        if (!keys.empty())
+            keys += ", ";
+        keys += def.key;
+    }
+    return keys;
+}
+
+bool Settings::NeedsRestart(const Config& before, const Config& after)
+{
+    for (const SettingDef& def : SettingDefs)
+    {
+        if (def.restart && !def.same(before, after))
+            return true;
+    }
+    return false;
+}
+
+const Config* Settings::Current()
+{
+    const Config* config = g_current.load(std::memory_order_acquire);
+    if (config)
+        return config;
+
+    static const Config defaults = Defaults();
+    return &defaults;
+}
+
+void Settings::Publish(const Config& config)
+{
+    std::lock_guard<std::mutex> lock(g_publishMutex);
+    g_published.push_back(std::unique_ptr<Config>(new Config(config)));
+    g_current.store(g_published.back().get(), std::memory_order_release);
+}
+
+void Settings::Reset()
+{
+    std::lock_guard<std::mutex> lock(g_publishMutex);
+    g_current.store(nullptr, std::memory_order_release);
+    g_published.clear();
+}
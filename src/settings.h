@@ -0,0 +1,116 @@
+///----------------------------------------------------------------------------------------------------
+/// Settings - Parsed settings.txt as an immutable Config, swapped in whole on reload
+///
+/// The file is key=value lines; blank lines and lines starting with # or ; are ignored, whitespace
+/// around keys and values is trimmed. For compatibility with the original one-line format, a first line
+/// without '=' is the killstreak output path. Every key lives in one table, so a new setting is a new
+/// Config field and a new row. rule= and counter= may repeat; each line is one alert rule (see
+/// alert_rules.h) or one event counter (see combat_counters.h).
+///
+/// Readers get the current Config through a single atomic pointer load and may keep using it for as
+/// long as they run: a reload builds a new Config and publishes it with one store, and replaced Configs
+/// stay allocated until Reset(), which only runs once every reader has stopped. Reloads are
+/// user-driven, so the few kilobytes each retired Config holds do not add up to anything.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_SETTINGS_H
+#define STREAMLINK_SETTINGS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "alert_rules.h"
+#include "combat_counters.h"
+
+/// Every file the addon writes, each with a <name>_file key
+enum EOutputPath : uint32_t
+{
+    OutputPath_Killstreak,
+    OutputPath_Squad,
+    OutputPath_PlayerStatus,
+    OutputPath_SquadSize,
+    OutputPath_Subgroups,
+    OutputPath_Commanders,
+    OutputPath_Lieutenants,
+    OutputPath_GroupType,
+    OutputPath_Ready,
+    OutputPath_SquadAlive,
+    OutputPath_SquadDowned,
+    OutputPath_SquadDead,
+    OutputPath_Enemies,
+    OutputPath_EnemyTeams,
+    OutputPath_MapName,
+    OutputPath_MapId,
+    OutputPath_Kills,
+    OutputPath_Deaths,
+    OutputPath_Downs,
+    OutputPath_BestStreak,
+    OutputPath_KillDeathRatio,
+    OutputPath_KillsPerMinute,
+    OutputPath_DownsPerMinute,
+    OutputPath_DamagePerSecond,
+    OutputPath_KillFeed,
+    OutputPath_Health,
+    OutputPath_Barrier,
+    OutputPath_MetricsText,
+    OutputPath_MetricsJson,
+    OutputPath_Count
+};
+
+struct Config
+{
+    static constexpr size_t MaxMilestones = 16;
+
+    std::string    OutputPaths[OutputPath_Count];   // relative to the game directory; empty disables
+    std::string    TraceFile;                        // empty: diagnostics go to the Nexus log
+    std::string    RecordFile;                       // strftime pattern, relative to the game directory
+    std::string    MumbleLink;
+    uint32_t       FlushIntervalMs = 100;
+    uint32_t       GaugeIntervalMs = 250;            // health/barrier outputs: minimum time between writes
+    uint32_t       GaugeThreshold = 1;               // and minimum change, in whole percent
+    uint32_t       JournalMaxAgeSec = 600;
+    uint32_t       Milestones[MaxMilestones] = {};   // killstreak alerts, ascending, no duplicates
+    size_t         MilestoneCount = 0;
+    AlertRules     Rules;                            // rule= lines plus the milestones, compiled
+    CombatCounters Counters;                         // counter= lines, compiled
+    int            LogLevel = 0;
+    uint16_t       ServerPort = 0;
+    bool           SharedMemory = false;
+    bool           ResetOnLeaveWvW = false;
+    bool           Server = false;
+    bool           Metrics = false;
+    bool           Journal = true;
+    bool           Record = false;
+};
+
+namespace Settings
+{
+    /// The built-in defaults (every output enabled at its usual path).
+    Config Defaults();
+
+    /// Applies every line of text on top of config. Returns the number of lines that were not
+    /// understood (unknown key, bad value); those leave config unchanged.
+    size_t Parse(const std::string& text, Config& config);
+
+    /// Defaults plus the file at path. Returns false if the file could not be read (config then
+    /// holds the defaults).
+    bool Load(const std::string& path, Config& config, size_t* rejectedLines = nullptr);
+
+    /// Keys whose value differs between two configs, comma-separated, for the reload log line.
+    std::string ChangedKeys(const Config& before, const Config& after);
+
+    /// Keys that only take effect at load (server, shared memory, MumbleLink, journal).
+    bool NeedsRestart(const Config& before, const Config& after);
+
+    /// The published Config: one acquire load. Defaults until the first Publish.
+    const Config* Current();
+
+    /// Makes config current. Keeps the previous one alive until Reset. Any thread.
+    void Publish(const Config& config);
+
+    /// Frees every published Config. Only while nothing can call Current().
+    void Reset();
+}
+
+#endif
@@ -0,0 +1,43 @@
+///----------------------------------------------------------------------------------------------------
+/// Shared Memory - Named shared memory regions
+///
+/// Wraps CreateFileMapping/OpenFileMapping/MapViewOfFile on Windows and shm_open/mmap on POSIX, so the
+/// same code can consume MumbleLink, publish our own state and be tested on Linux.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_SHARED_MEMORY_H
+#define STREAMLINK_SHARED_MEMORY_H
+
+#include <cstddef>
+
+class SharedMemory
+{
+public:
+    SharedMemory() = default;
+    ~SharedMemory() { Close(); }
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    /// Creates the region (or opens it if it already exists) and maps it read/write.
+    bool Create(const char* name, size_t size);
+
+    /// Maps an existing region read-only. Fails if nobody has created it.
+    bool OpenReadOnly(const char* name, size_t size);
+
+    /// Unmaps the region. On POSIX the creator also removes the name.
+    void Close();
+
+    bool   IsOpen() const { return m_data != nullptr; }
+    void*  Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+private:
+    void*  m_data = nullptr;
+    size_t m_size = 0;
+    void*  m_handle = nullptr;     // HANDLE of the file mapping (Windows only)
+    bool   m_created = false;
+    char   m_name[128] = {};
+};
+
+#endif
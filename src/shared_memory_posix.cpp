@@ -0,0 +1,99 @@
+///----------------------------------------------------------------------------------------------------
+/// Shared Memory - POSIX implementation (shm_open/mmap)
+///----------------------------------------------------------------------------------------------------
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+
+#include "shared_memory.h"
+
+///----------------------------------------------------------------------------------------------------
+/// MakePosixName - shm_open names must start with a single slash
+///----------------------------------------------------------------------------------------------------
+static void MakePosixName(const char* name, char* out, size_t outSize)
+{
+    snprintf(out, outSize, "%s%s", name[0] == '/' ? "" : "/", name);
+}
+
+bool SharedMemory::Create(const char* name, size_t size)
+{
+    Close();
+    if (!name || size == 0)
+        return false;
+
+    char posixName[sizeof(m_name)];
+    MakePosixName(name, posixName, sizeof(posixName));
+
+    int fd = shm_open(posixName, O_CREAT | O_RDWR, 0600);
+    if (fd < 0)
+        return false;
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping keeps the object alive
+    if (view == MAP_FAILED)
+        return false;
+
+    m_data = view;
+    m_size = size;
+    m_created = true;
+    memcpy(m_name, posixName, sizeof(m_name));
+    return true;
+}
+
+bool SharedMemory::OpenReadOnly(const char* name, size_t size)
+{
+    Close();
+    if (!name || size == 0)
+        return false;
+
+    char posixName[sizeof(m_name)];
+    MakePosixName(name, posixName, sizeof(posixName));
+
+    int fd = shm_open(posixName, O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < size)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
+        return false;
+
+    m_data = view;
+    m_size = size;
+    m_created = false;
+    memcpy(m_name, posixName, sizeof(m_name));
+    return true;
+}
+
+void SharedMemory::Close()
+{
+    if (m_data)
+    {
+        munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+    // Unlike Windows, a POSIX name outlives its mappings until it is explicitly removed
+    if (m_created && m_name[0])
+        shm_unlink(m_name);
+
+    m_size = 0;
+    m_created = false;
+    m_name[0] = '\0';
+}
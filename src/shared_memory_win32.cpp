@@ -0,0 +1,80 @@
+///----------------------------------------------------------------------------------------------------
+/// Shared Memory - Win32 implementation
+///----------------------------------------------------------------------------------------------------
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#include <cstring>
+
+#include "shared_memory.h"
+
+bool SharedMemory::Create(const char* name, size_t size)
+{
+    Close();
+    if (!name || size == 0)
+        return false;
+
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        0, static_cast<DWORD>(size), name);
+    if (!mapping)
+        return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_handle = mapping;
+    m_data = view;
+    m_size = size;
+    m_created = true;
+    strncpy_s(m_name, name, sizeof(m_name) - 1);
+    return true;
+}
+
+bool SharedMemory::OpenReadOnly(const char* name, size_t size)
+{
+    Close();
+    if (!name || size == 0)
+        return false;
+
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name);
+    if (!mapping)
+        return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_handle = mapping;
+    m_data = view;
+    m_size = size;
+    m_created = false;
+    strncpy_s(m_name, name, sizeof(m_name) - 1);
+    return true;
+}
+
+void SharedMemory::Close()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if (m_handle)
+    {
+        // The mapping itself disappears once the last handle to it is closed
+        CloseHandle(static_cast<HANDLE>(m_handle));
+        m_handle = nullptr;
+    }
+    m_size = 0;
+    m_created = false;
+    m_name[0] = '\0';
+}
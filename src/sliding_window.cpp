@@ -0,0 +1,62 @@
+///----------------------------------------------------------------------------------------------------
+/// Sliding Window - Event total over the last N milliseconds, in a fixed ring of time buckets
+///----------------------------------------------------------------------------------------------------
+
+#include "sliding_window.h"
+
+SlidingWindow::SlidingWindow(uint32_t windowMs)
+    : m_bucketMs(windowMs / Buckets > 0 ? windowMs / Buckets : 1)
+{
+    Clear();
+}
+
+void SlidingWindow::Advance(uint64_t bucket)
+{
+    if (bucket <= m_head)
+        return;
+
+    // A gap of a whole window or more empties everything at once
+    if (bucket - m_head >= Buckets)
+    {
+        for (uint64_t& count : m_counts)
+            count = 0;
+        m_total = 0;
+        m_head = bucket;
+        return;
+    }
+
+    while (m_head < bucket)
+    {
+        m_head++;
+        uint64_t& count = m_counts[m_head % Buckets];
+        m_total -= count;
+        count = 0;
+    }
+}
+
+void SlidingWindow::Add(uint64_t timeMs, uint64_t amount)
+{
+    uint64_t bucket = timeMs / m_bucketMs;
+    Advance(bucket);
+
+    // Late arrivals still count if their bucket has not left the window yet
+    if (bucket + Buckets <= m_head)
+        return;
+
+    m_counts[bucket % Buckets] += amount;
+    m_total += amount;
+}
+
+uint64_t SlidingWindow::Sum(uint64_t nowMs)
+{
+    Advance(nowMs / m_bucketMs);
+    return m_total;
+}
+
+void SlidingWindow::Clear()
+{
+    for (uint64_t& count : m_counts)
+        count = 0;
+    m_total = 0;
+    m_head = 0;
+}
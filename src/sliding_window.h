@@ -0,0 +1,46 @@
+///----------------------------------------------------------------------------------------------------
+/// Sliding Window - Event total over the last N milliseconds, in a fixed ring of time buckets
+///
+/// The window is split into Buckets equal slices. Add() drops an amount into the slice its timestamp
+/// falls in; Sum() returns the total of the slices still inside the window. Moving the window forward
+/// clears the slices that fall out of it and subtracts them from a running total, so both calls are
+/// O(1) amortised (at most Buckets slices are ever cleared at once) and memory does not grow with
+/// fight length. The window edge moves one slice at a time, so totals are exact to one slice width.
+/// Not thread-safe; the owner serialises access.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_SLIDING_WINDOW_H
+#define STREAMLINK_SLIDING_WINDOW_H
+
+#include <cstdint>
+
+class SlidingWindow
+{
+public:
+    static constexpr uint32_t Buckets = 50;
+
+    /// windowMs is rounded down to a whole number of buckets (at least one millisecond each).
+    explicit SlidingWindow(uint32_t windowMs = 60000);
+
+    /// Adds amount at timeMs. Timestamps may arrive slightly out of order; anything older than the
+    /// window is ignored.
+    void Add(uint64_t timeMs, uint64_t amount);
+
+    /// Total of everything added in the window ending at nowMs. Moves the window forward if nowMs is
+    /// past its end; an earlier nowMs leaves it where it is.
+    uint64_t Sum(uint64_t nowMs);
+
+    uint32_t WindowMs() const { return m_bucketMs * Buckets; }
+
+    void Clear();
+
+private:
+    void Advance(uint64_t bucket);
+
+    uint64_t m_counts[Buckets];
+    uint64_t m_total;
+    uint64_t m_head;       // absolute index (timeMs / m_bucketMs) of the newest bucket
+    uint32_t m_bucketMs;
+};
+
+#endif
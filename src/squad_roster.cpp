@@ -0,0 +1,129 @@
+///----------------------------------------------------------------------------------------------------
+/// Squad Roster - Fixed-capacity table of squad and party members, keyed by account name
+///----------------------------------------------------------------------------------------------------
+
+#include "squad_roster.h"
+
+#include <cstring>
+
+#include "open_addressing.h"
+
+static_assert(SquadRoster::MaxMembers <= 256, "name indices are stored in a uint8_t");
+
+static constexpr size_t NotFound = SquadRoster::TableSize;
+
+///----------------------------------------------------------------------------------------------------
+/// SameName - Compare an account name against its arena copy, which may be truncated
+///----------------------------------------------------------------------------------------------------
+static bool SameName(const char* stored, const char* accountName)
+{
+    return strncmp(stored, accountName, SquadRoster::MaxNameLength) == 0;
+}
+
+SquadRoster::SquadRoster()
+{
+    Clear();
+}
+
+uint64_t SquadRoster::HashName(const char* accountName)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const unsigned char* p = reinterpret_cast<const unsigned char*>(accountName); *p; p++)
+    {
+        hash ^= *p;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+size_t SquadRoster::Home(uint64_t hash)
+{
+    return static_cast<size_t>(hash) & (TableSize - 1);
+}
+
+bool SquadRoster::IsUsed(const Slot& slot)
+{
+    return slot.used;
+}
+
+size_t SquadRoster::FindSlot(uint64_t hash, const char* accountName) const
+{
+    return OpenAddressing::Find(m_slots, Home(hash), IsUsed, [this, hash, accountName](const Slot& slot)
+    {
+        return slot.hash == hash && SameName(m_names[slot.nameIndex], accountName);
+    });
+}
+
+void SquadRoster::RemoveAt(size_t slot)
+{
+    m_freeNames[m_freeNameCount++] = m_slots[slot].nameIndex;
+    m_size--;
+    OpenAddressing::Erase(m_slots, slot, IsUsed,
+                          [](const Slot& moved) { return Home(moved.hash); },
+                          [](Slot& emptied) { emptied.used = false; });
+}
+
+SquadRosterChange SquadRoster::Apply(const UnofficialExtras::UserInfo& user)
+{
+    SquadRosterChange change;
+    if (!user.AccountName)
+        return change;
+
+    change.After.Role = user.Role;
+    change.After.Subgroup = user.Subgroup;
+    change.After.ReadyStatus = user.ReadyStatus;
+    change.After.GroupType = user.GroupType;
+    bool member = user.Role != UnofficialExtras::UserRole::None && user.Role != UnofficialExtras::UserRole::Invalid;
+
+    uint64_t hash = HashName(user.AccountName);
+    size_t found = FindSlot(hash, user.AccountName);
+    if (found != NotFound)
+    {
+        change.WasMember = true;
+        change.Before = m_slots[found].state;
+        if (member)
+        {
+            m_slots[found].state = change.After;
+            change.IsMember = true;
+        }
+        else
+        {
+            RemoveAt(found);
+        }
+        return change;
+    }
+
+    if (!member || m_freeNameCount == 0)
+        return change;
+
+    Slot& slot = m_slots[OpenAddressing::FreeSlot(m_slots, Home(hash), IsUsed)];
+    slot.hash = hash;
+    slot.state = change.After;
+    slot.nameIndex = m_freeNames[--m_freeNameCount];
+    slot.used = true;
+    strncpy(m_names[slot.nameIndex], user.AccountName, MaxNameLength);
+    m_names[slot.nameIndex][MaxNameLength] = '\0';
+    m_size++;
+
+    change.IsMember = true;
+    return change;
+}
+
+const SquadMemberState* SquadRoster::Find(const char* accountName) const
+{
+    if (!accountName)
+        return nullptr;
+
+    size_t found = FindSlot(HashName(accountName), accountName);
+    return found != NotFound ? &m_slots[found].state : nullptr;
+}
+
+void SquadRoster::Clear()
+{
+    for (size_t i = 0; i < TableSize; i++)
+        m_slots[i].used = false;
+    for (size_t i = 0; i < MaxMembers; i++)
+        m_freeNames[i] = static_cast<uint8_t>(MaxMembers - 1 - i);
+    m_freeNameCount = MaxMembers;
+    m_size = 0;
+}
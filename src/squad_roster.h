@@ -0,0 +1,81 @@
+///----------------------------------------------------------------------------------------------------
+/// Squad Roster - Fixed-capacity table of squad and party members, keyed by account name
+///
+/// An open-addressing table with linear probing and backward-shift deletion, indexed by a 64-bit
+/// hash of the account name. Names are copied into a fixed arena, so applying an update never
+/// allocates. Each member keeps the role, subgroup, ready state and group type from its last update.
+/// Not thread-safe; the owner serialises access.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_SQUAD_ROSTER_H
+#define STREAMLINK_SQUAD_ROSTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "UnofficialExtras.h"
+
+/// Per-member state carried by a UserInfo
+struct SquadMemberState
+{
+    UnofficialExtras::UserRole    Role = UnofficialExtras::UserRole::None;
+    uint8_t                       Subgroup = 0;
+    bool                          ReadyStatus = false;
+    UnofficialExtras::ChannelType GroupType = UnofficialExtras::ChannelType::Invalid;
+};
+
+/// Outcome of applying one UserInfo: membership and state before and after
+struct SquadRosterChange
+{
+    bool             WasMember = false;
+    bool             IsMember = false;
+    SquadMemberState Before;
+    SquadMemberState After;
+};
+
+class SquadRoster
+{
+public:
+    static constexpr size_t MaxMembers = 128;          // squads cap at 50, plus invites and applicants
+    static constexpr size_t TableSize = MaxMembers * 2;
+    static constexpr size_t MaxNameLength = 63;        // longer names are stored truncated
+
+    SquadRoster();
+
+    /// FNV-1a hash of an account name; computed once per user per update.
+    static uint64_t HashName(const char* accountName);
+
+    /// Adds, updates or removes the user. Roles None and Invalid remove; any other role is a member.
+    /// A new member is ignored (IsMember stays false) when the roster is full.
+    SquadRosterChange Apply(const UnofficialExtras::UserInfo& user);
+
+    /// State of a member, or nullptr if the account is not in the roster.
+    const SquadMemberState* Find(const char* accountName) const;
+
+    size_t Size() const { return m_size; }
+
+    void Clear();
+
+private:
+    struct Slot
+    {
+        uint64_t         hash;
+        SquadMemberState state;
+        uint8_t          nameIndex;
+        bool             used;
+    };
+
+    static size_t Home(uint64_t hash);
+    static bool   IsUsed(const Slot& slot);
+
+    size_t FindSlot(uint64_t hash, const char* accountName) const;
+    void   RemoveAt(size_t slot);
+
+    Slot     m_slots[TableSize];
+    char     m_names[MaxMembers][MaxNameLength + 1];
+    uint8_t  m_freeNames[MaxMembers];
+    size_t   m_freeNameCount;
+    size_t   m_size;
+};
+
+#endif
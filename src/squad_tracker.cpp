@@ -0,0 +1,125 @@
+///----------------------------------------------------------------------------------------------------
+/// Squad Tracker - Squad membership and composition from Unofficial Extras squad updates
+///----------------------------------------------------------------------------------------------------
+
+#include "squad_tracker.h"
+
+#include "squad_roster.h"
+#include "state_block.h"
+
+// Owned by the squad update thread; readers go through the state block
+static SquadRoster g_roster;
+static SquadComposition g_composition;
+
+///----------------------------------------------------------------------------------------------------
+/// IsJoined - Leader, lieutenants and members count towards the composition; invites do not
+///----------------------------------------------------------------------------------------------------
+static bool IsJoined(const SquadMemberState& state)
+{
+    return state.Role == UnofficialExtras::UserRole::SquadLeader ||
+           state.Role == UnofficialExtras::UserRole::Lieutenant ||
+           state.Role == UnofficialExtras::UserRole::Member;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Adjust - Add (delta = 1) or remove (delta = -1) one member's contribution to the counters
+///----------------------------------------------------------------------------------------------------
+static void Adjust(SquadComposition& c, const SquadMemberState& state, uint32_t delta)
+{
+    if (!IsJoined(state))
+        return;
+
+    c.Size += delta;
+    c.Subgroups[state.Subgroup < SquadComposition::MaxSubgroups ? state.Subgroup : 0] += delta;
+
+    if (state.Role == UnofficialExtras::UserRole::SquadLeader)
+        c.Commanders += delta;
+    else if (state.Role == UnofficialExtras::UserRole::Lieutenant)
+        c.Lieutenants += delta;
+
+    if (state.ReadyStatus)
+        c.Ready += delta;
+
+    if (state.GroupType == UnofficialExtras::ChannelType::Party)
+        c.InParty += delta;
+    else if (state.GroupType == UnofficialExtras::ChannelType::Squad)
+        c.InSquad += delta;
+}
+
+uint32_t SquadTracker::Apply(const EvSquadUpdate& update)
+{
+    if (!update.UpdatedUsers || update.UpdatedUsersCount == 0) return SquadChange_None;
+
+    // Each changed user moves its old contribution out and its new one in; comparing against the
+    // counters from before the batch reports only what actually moved
+    SquadComposition before = g_composition;
+    for (uint64_t i = 0; i < update.UpdatedUsersCount; i++)
+    {
+        SquadRosterChange change = g_roster.Apply(update.UpdatedUsers[i]);
+        if (change.WasMember)
+            Adjust(g_composition, change.Before, static_cast<uint32_t>(-1));
+        if (change.IsMember)
+            Adjust(g_composition, change.After, 1);
+    }
+
+    const SquadComposition& after = g_composition;
+    uint32_t changes = SquadChange_None;
+    if (after.Size != before.Size)
+        changes |= SquadChange_Size;
+    for (uint32_t g = 0; g < SquadComposition::MaxSubgroups; g++)
+    {
+        if (after.Subgroups[g] != before.Subgroups[g])
+        {
+            changes |= SquadChange_Subgroups;
+            break;
+        }
+    }
+    if (after.Commanders != before.Commanders || after.Lieutenants != before.Lieutenants)
+        changes |= SquadChange_Roles;
+    if (after.Ready != before.Ready)
+        changes |= SquadChange_Ready;
+    if (GroupTypeName(after) != GroupTypeName(before))
+        changes |= SquadChange_GroupType;
+
+    bool nowInSquad = g_roster.Size() != 0;
+    bool wasInSquad = nowInSquad;
+    StateBlock::Update([&wasInSquad, nowInSquad](TrackedState& state)
+    {
+        wasInSquad = state.InSquad;
+        state.InSquad = nowInSquad;
+        state.Squad = g_composition;
+    });
+    if (wasInSquad != nowInSquad)
+        changes |= SquadChange_InSquad;
+    return changes;
+}
+
+bool SquadTracker::InSquad()
+{
+    return StateBlock::Read().InSquad;
+}
+
+SquadComposition SquadTracker::Composition()
+{
+    return StateBlock::Read().Squad;
+}
+
+const char* SquadTracker::GroupTypeName(const SquadComposition& composition)
+{
+    if (composition.InSquad != 0)
+        return "squad";
+    if (composition.InParty != 0)
+        return "party";
+    return "none";
+}
+
+void SquadTracker::Reset()
+{
+    g_roster.Clear();
+    g_composition = SquadComposition();
+    StateBlock::Update([](TrackedState& state)
+    {
+        state.InSquad = false;
+        state.Squad = SquadComposition();
+    });
+}
@@ -0,0 +1,62 @@
+///----------------------------------------------------------------------------------------------------
+/// Squad Tracker - Squad membership and composition from Unofficial Extras squad updates
+///
+/// Composition counters are adjusted per changed user from the roster's before/after state, never
+/// recomputed by scanning the roster, and published to the state block once per batch. Apply() and
+/// Reset() own the roster and must not run concurrently (squad updates arrive on one thread); the
+/// queries are lock-free snapshots and safe from any thread.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_SQUAD_TRACKER_H
+#define STREAMLINK_SQUAD_TRACKER_H
+
+#include <cstdint>
+
+#include "UnofficialExtras.h"
+
+/// Bit flags returned by Apply
+enum ESquadChange : uint32_t
+{
+    SquadChange_None      = 0,
+    SquadChange_InSquad   = 1 << 0,   // in-squad flag flipped
+    SquadChange_Size      = 1 << 1,   // number of joined members changed
+    SquadChange_Subgroups = 1 << 2,   // a subgroup count changed
+    SquadChange_Roles     = 1 << 3,   // commander or lieutenant count changed
+    SquadChange_GroupType = 1 << 4,   // party vs squad changed
+    SquadChange_Ready     = 1 << 5    // ready-check count changed
+};
+
+/// Counters over joined members (leader, lieutenants, members; not invites or applicants)
+struct SquadComposition
+{
+    static constexpr uint32_t MaxSubgroups = 16;   // Subgroup 0 means no subgroup assigned
+
+    uint32_t Size = 0;
+    uint32_t Subgroups[MaxSubgroups] = {};
+    uint32_t Commanders = 0;
+    uint32_t Lieutenants = 0;
+    uint32_t Ready = 0;
+    uint32_t InParty = 0;   // members reported with ChannelType::Party
+    uint32_t InSquad = 0;   // members reported with ChannelType::Squad
+};
+
+namespace SquadTracker
+{
+    /// Applies one EvSquadUpdate batch. Returns the ESquadChange flags for what changed. Squad update
+    /// thread only.
+    uint32_t Apply(const EvSquadUpdate& update);
+
+    /// True while at least one other member is in our squad or party.
+    bool InSquad();
+
+    /// Consistent copy of the composition counters.
+    SquadComposition Composition();
+
+    /// "squad", "party" or "none", from a composition.
+    const char* GroupTypeName(const SquadComposition& composition);
+
+    /// Forgets all members. Only while no squad updates are being delivered.
+    void Reset();
+}
+
+#endif
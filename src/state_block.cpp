@@ -0,0 +1,12 @@
+///----------------------------------------------------------------------------------------------------
+/// State Block - All tracked addon state in one seqlock-protected value
+///----------------------------------------------------------------------------------------------------
+
+#include "state_block.h"
+
+Seqlock<TrackedState> StateBlock::g_state;
+
+void StateBlock::Reset()
+{
+    g_state.Store(TrackedState());
+}
@@ -0,0 +1,58 @@
+///----------------------------------------------------------------------------------------------------
+/// State Block - All tracked addon state in one seqlock-protected value
+///
+/// The trackers write through Update() (any thread, writers serialise on the sequence counter); every
+/// reader (output renderers, the overlay server, the shared memory publisher) takes a Read() snapshot
+/// and so sees session stats, player status, squad alive counts, self id and squad composition as of
+/// one single update, without taking a lock. The map snapshot stays in GameState, which already
+/// publishes it as one atomic word.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_STATE_BLOCK_H
+#define STREAMLINK_STATE_BLOCK_H
+
+#include <cstdint>
+
+#include "combat_tracker.h"
+#include "seqlock.h"
+#include "session_stats.h"
+#include "squad_tracker.h"
+
+struct TrackedState
+{
+    SessionCounters  Session;            // kills, deaths, downs and streaks (the killstreak included)
+    uint64_t         SelfId = 0;         // AgentShort::ID of the local player, 0 until seen
+    PlayerStatus     Status = PlayerStatus::Alive;
+    SquadVitals      Vitals;             // squad members alive, downed and dead
+    bool             InSquad = false;    // at least one other member in our squad or party
+    SquadComposition Squad;
+};
+
+namespace StateBlock
+{
+    extern Seqlock<TrackedState> g_state;
+
+    /// Consistent copy of every tracked field.
+    inline TrackedState Read()
+    {
+        return g_state.Load();
+    }
+
+    /// Runs fn(TrackedState&) inside a write section. Keep fn to a few assignments.
+    template <typename Fn>
+    inline void Update(Fn&& fn)
+    {
+        g_state.Update(static_cast<Fn&&>(fn));
+    }
+
+    /// Advances on every update; readers can skip work while it is unchanged.
+    inline uint64_t Sequence()
+    {
+        return g_state.Sequence();
+    }
+
+    /// Back to the default state.
+    void Reset();
+}
+
+#endif
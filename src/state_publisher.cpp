@@ -0,0 +1,58 @@
+///----------------------------------------------------------------------------------------------------
+/// State Publisher - Writes StreamlinkSharedState into a named shared memory region
+///----------------------------------------------------------------------------------------------------
+
+#include "state_publisher.h"
+
+#include <thread>
+
+bool StatePublisher::Open(const char* name)
+{
+    Close();
+    if (!m_memory.Create(name, sizeof(StreamlinkSharedState)))
+        return false;
+
+    StreamlinkSharedState* state = static_cast<StreamlinkSharedState*>(m_memory.Data());
+
+    // Readers check Magic first, so it is written last
+    state->Magic.store(0, std::memory_order_relaxed);
+    state->Version.store(STREAMLINK_SHARED_STATE_VERSION, std::memory_order_relaxed);
+    state->Size.store(sizeof(StreamlinkSharedState), std::memory_order_relaxed);
+    state->Sequence.store(0, std::memory_order_relaxed);
+    state->KillCount.store(0, std::memory_order_relaxed);
+    state->InSquad.store(0, std::memory_order_relaxed);
+    state->PlayerStatus.store(StreamlinkPlayerStatus_Alive, std::memory_order_relaxed);
+    for (auto& reserved : state->Reserved)
+        reserved.store(0, std::memory_order_relaxed);
+    state->Magic.store(STREAMLINK_SHARED_STATE_MAGIC, std::memory_order_release);
+
+    m_state.store(state, std::memory_order_release);
+    return true;
+}
+
+void StatePublisher::Close()
+{
+    StreamlinkSharedState* state = m_state.exchange(nullptr, std::memory_order_acq_rel);
+    if (state)
+        state->Magic.store(0, std::memory_order_release);
+    m_memory.Close();
+}
+
+uint32_t StatePublisher::BeginWrite(StreamlinkSharedState* state)
+{
+    // Another writer holds the section while Sequence is odd; the section is a handful of stores,
+    // so yielding is only ever needed under heavy contention
+    uint32_t seq = state->Sequence.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        if ((seq & 1) == 0 &&
+            state->Sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                                  std::memory_order_relaxed))
+        {
+            std::atomic_thread_fence(std::memory_order_release);
+            return seq;
+        }
+        std::this_thread::yield();
+        seq = state->Sequence.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,49 @@
+///----------------------------------------------------------------------------------------------------
+/// State Publisher - Writes StreamlinkSharedState into a named shared memory region
+///
+/// Publish() may be called from any thread. Writers serialise by moving Sequence from even to odd
+/// with a CAS, fill the payload, then release it to the next even value, so a concurrent reader
+/// either sees a complete update or retries. No syscalls are involved after Open().
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_STATE_PUBLISHER_H
+#define STREAMLINK_STATE_PUBLISHER_H
+
+#include <atomic>
+
+#include "shared_memory.h"
+#include "streamlink_shared_state.h"
+
+class StatePublisher
+{
+public:
+    /// Creates and initialises the region. Returns false if shared memory is unavailable.
+    bool Open(const char* name = STREAMLINK_SHARED_STATE_NAME);
+
+    /// Clears the magic so readers stop trusting the region, then unmaps it.
+    void Close();
+
+    bool IsOpen() const { return m_state.load(std::memory_order_acquire) != nullptr; }
+
+    /// Runs fill(StreamlinkSharedState&) inside a write section. fill should read the live values
+    /// itself so the last writer to enter always publishes the newest state. No-op while closed.
+    template <typename Fill>
+    void Publish(Fill&& fill)
+    {
+        StreamlinkSharedState* state = m_state.load(std::memory_order_acquire);
+        if (!state)
+            return;
+
+        uint32_t seq = BeginWrite(state);
+        fill(*state);
+        state->Sequence.store(seq + 2, std::memory_order_release);
+    }
+
+private:
+    static uint32_t BeginWrite(StreamlinkSharedState* state);
+
+    SharedMemory                        m_memory;
+    std::atomic<StreamlinkSharedState*> m_state{nullptr};
+};
+
+#endif
@@ -0,0 +1,1290 @@
+///----------------------------------------------------------------------------------------------------
+/// Streamlink - Addon lifecycle and event wiring
+///----------------------------------------------------------------------------------------------------
+
+#include "streamlink.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+#include "ArcDPS.h"
+#include "UnofficialExtras.h"
+#include "alert_rules.h"
+#include "combat_counters.h"
+#include "combat_dispatch.h"
+#include "combat_record.h"
+#include "combat_tracker.h"
+#include "enemy_tracker.h"
+#include "event_clock.h"
+#include "event_queue.h"
+#include "event_recorder.h"
+#include "file_watcher.h"
+#include "game_state.h"
+#include "helpers.h"
+#include "kill_feed.h"
+#include "log.h"
+#include "metrics.h"
+#include "mpsc_ring.h"
+#include "mumble_link.h"
+#include "output_writer.h"
+#include "overlay_server.h"
+#include "platform.h"
+#include "rate_tracker.h"
+#include "seqlock.h"
+#include "session_journal.h"
+#include "session_stats.h"
+#include "settings.h"
+#include "squad_tracker.h"
+#include "state_block.h"
+#include "state_publisher.h"
+#include "tracing.h"
+
+// Note: ImGui UI disabled - configure via settings file at:
+// <GW2>/addons/streamlink/settings.txt
+
+// Nexus API
+static AddonAPI* g_api = nullptr;
+
+// Shared memory state publication (optional, for OBS plugins and overlays)
+static StatePublisher g_statePublisher;
+
+// Settings file watch: reloads wait until the file has been quiet for SettingsDebounce, since editors
+// save in several steps (truncate and write, or write a temp file and rename it over)
+static FileWatcher g_settingsWatcher;
+static const std::chrono::milliseconds SettingsDebounce{250};
+static bool g_settingsPending = false;
+static std::chrono::steady_clock::time_point g_settingsChangedAt;
+
+// Output ids handed out by the writer thread, one per configurable file
+static int g_outputIds[OutputPath_Count];
+
+// Alert rule actions. File actions store their text for the writer thread; events are raised from the
+// writer thread too, so other addons' handlers never run on the event queue worker.
+struct RuleText
+{
+    char Text[128];
+};
+
+struct RuleEvent
+{
+    const char*         Name;      // owned by a published Config, which outlives the writer thread
+    StreamlinkRuleEvent Payload;
+};
+
+static AlertRuleState g_ruleState;    // event queue worker only
+static Seqlock<RuleText> g_ruleTexts[AlertRules::MaxFiles];
+static int g_ruleFileOutputs[AlertRules::MaxFiles];
+static MpscRing<RuleEvent, 64> g_ruleEvents;
+
+// Counter values by counter= slot, counted on the event queue worker and rendered by the writer thread
+static std::atomic<uint32_t> g_counterValues[CombatCounters::MaxCounters];
+static int g_counterOutputs[CombatCounters::MaxCounters];
+
+// Kill feed: names of our kills captured in the combat callbacks (one per feed, staged once), paired
+// with the credited kills on the worker, which hands the rendered text to the writer thread
+struct KillFeedText
+{
+    char Text[KillFeed::MaxTextSize];
+};
+
+static MpscRing<KillNames, 64> g_killNames;
+static KillFeed g_killFeed;    // event queue worker only
+static Seqlock<KillFeedText> g_killFeedText;
+
+// Session stat outputs, also served by the overlay server
+struct SessionOutput
+{
+    const char*   fieldName;     // overlay server field
+    EOutputPath   path;
+    OUTPUT_RENDER render;
+};
+
+template <ESessionStat Stat>
+static size_t RenderSessionStat(char* buffer, size_t size);
+static size_t RenderKillDeathRatio(char* buffer, size_t size);
+
+static const SessionOutput g_sessionOutputs[] = {
+    {"kills", OutputPath_Kills, RenderSessionStat<SessionStat_Kills>},
+    {"deaths", OutputPath_Deaths, RenderSessionStat<SessionStat_Deaths>},
+    {"downs", OutputPath_Downs, RenderSessionStat<SessionStat_Downs>},
+    {"bestStreak", OutputPath_BestStreak, RenderSessionStat<SessionStat_BestStreak>},
+    {"kd", OutputPath_KillDeathRatio, RenderKillDeathRatio},
+};
+
+// Rolling rate outputs, refreshed on a timer rather than per event
+static const EOutputPath g_rateOutputs[] = {
+    OutputPath_KillsPerMinute,
+    OutputPath_DownsPerMinute,
+    OutputPath_DamagePerSecond,
+};
+
+// Overlay server field for one rate over one window
+struct RateField
+{
+    const char*   name;
+    OUTPUT_RENDER render;
+};
+
+template <ERate Rate, ERateWindow Window>
+static size_t RenderRate(char* buffer, size_t size);
+
+static const RateField g_rateFields[] = {
+    {"kpm10s", RenderRate<Rate_Kills, RateWindow_10s>},
+    {"kpm60s", RenderRate<Rate_Kills, RateWindow_60s>},
+    {"kpm5m", RenderRate<Rate_Kills, RateWindow_5min>},
+    {"downsPm10s", RenderRate<Rate_Downs, RateWindow_10s>},
+    {"downsPm60s", RenderRate<Rate_Downs, RateWindow_60s>},
+    {"downsPm5m", RenderRate<Rate_Downs, RateWindow_5min>},
+    {"dps10s", RenderRate<Rate_Damage, RateWindow_10s>},
+    {"dps60s", RenderRate<Rate_Damage, RateWindow_60s>},
+    {"dps5m", RenderRate<Rate_Damage, RateWindow_5min>},
+};
+
+// Rates move with time as well as with events, so their outputs are refreshed on this interval
+static const std::chrono::seconds RateRefreshInterval{1};
+static std::chrono::steady_clock::time_point g_lastRateRefresh;
+
+// Latency metrics are rewritten this often while recording
+static const std::chrono::seconds MetricsDumpInterval{10};
+static std::chrono::steady_clock::time_point g_lastMetricsDump;
+
+///----------------------------------------------------------------------------------------------------
+/// JoinPath - Append a relative path to a directory
+///----------------------------------------------------------------------------------------------------
+static std::string JoinPath(const char* directory, const char* relativePath)
+{
+    std::string fullPath = directory;
+    if (!fullPath.empty() && fullPath.back() != '\\' && fullPath.back() != '/')
+    {
+        fullPath += Platform::PathSeparator;
+    }
+    fullPath += relativePath;
+    return fullPath;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// ResolveGamePath - Returns the full path of a file relative to the game directory, empty for an
+///                   empty (disabled) path. Called at load and on reload; the writer keeps the result.
+///----------------------------------------------------------------------------------------------------
+static std::string ResolveGamePath(const std::string& relativePath)
+{
+    if (relativePath.empty() || !g_api) return relativePath;
+
+    const char* gameDir = g_api->Paths_GetGameDirectory();
+    if (!gameDir) return relativePath;
+
+    return JoinPath(gameDir, relativePath.c_str());
+}
+
+///----------------------------------------------------------------------------------------------------
+/// StartRecording - Start a recording at record_file, its date and time placeholders (strftime)
+///                  filled in with the current local time, if record=1
+///----------------------------------------------------------------------------------------------------
+static void StartRecording(const Config& config)
+{
+    if (!config.Record || config.RecordFile.empty())
+        return;
+
+    char relativePath[512];
+    time_t now = time(nullptr);
+    if (strftime(relativePath, sizeof(relativePath), config.RecordFile.c_str(), localtime(&now)) == 0)
+    {
+        Log::Write(ELogLevel_WARNING, "Recorder: record_file does not expand to a path.");
+        return;
+    }
+
+    std::string path = ResolveGamePath(relativePath);
+    if (EventRecorder::Start(path, SessionJournal::WallClockMs()))
+        Log::Writef(ELogLevel_INFO, "Recording combat events to %s.", path.c_str());
+    else
+        Log::Writef(ELogLevel_WARNING, "Recorder: could not create %s.", path.c_str());
+}
+
+///----------------------------------------------------------------------------------------------------
+/// StopRecording - Finish the current recording, if any
+///----------------------------------------------------------------------------------------------------
+static void StopRecording()
+{
+    if (!EventRecorder::IsRecording())
+        return;
+
+    EventRecorder::Stop();
+    Log::Writef(ELogLevel_INFO, "Recording stopped: %llu bytes, %llu events dropped.",
+                (unsigned long long)EventRecorder::BytesWritten(), (unsigned long long)EventRecorder::Dropped());
+}
+
+///----------------------------------------------------------------------------------------------------
+/// GetAddonFilePath - Returns the path of a file in the addon directory, empty without one
+///----------------------------------------------------------------------------------------------------
+static std::string GetAddonFilePath(const char* fileName)
+{
+    if (!g_api) return "";
+
+    const char* addonDir = g_api->Paths_GetAddonDirectory("streamlink");
+    if (!addonDir) return "";
+
+    return JoinPath(addonDir, fileName);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// GetSettingsPath - Returns the path to the settings file
+///----------------------------------------------------------------------------------------------------
+static std::string GetSettingsPath()
+{
+    return GetAddonFilePath("settings.txt");
+}
+
+///----------------------------------------------------------------------------------------------------
+/// MarkOutput - Flag one configurable output for the writer thread
+///----------------------------------------------------------------------------------------------------
+static void MarkOutput(EOutputPath path)
+{
+    OutputWriter::MarkDirty(g_outputIds[path]);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderKillcount - Format current killstreak for the output file (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderKillcount(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%u", CombatTracker::KillCount());
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderSquadStatus - Format current squad status (0 or 1) for the output file (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderSquadStatus(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%u", SquadTracker::InSquad() ? 1 : 0);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderSquadSize - Format the number of joined squad or party members (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderSquadSize(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%u", SquadTracker::Composition().Size);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderSubgroups - One "subgroup: members" line per non-empty subgroup (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderSubgroups(char* buffer, size_t size)
+{
+    SquadComposition composition = SquadTracker::Composition();
+    size_t pos = 0;
+    for (uint32_t g = 1; g < SquadComposition::MaxSubgroups; g++)
+    {
+        if (composition.Subgroups[g] == 0)
+            continue;
+
+        int len = snprintf(buffer + pos, size - pos, "%s%u: %u", pos ? "\n" : "", g, composition.Subgroups[g]);
+        if (len <= 0 || static_cast<size_t>(len) >= size - pos)
+            break;
+        pos += static_cast<size_t>(len);
+    }
+    return pos;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderCommanders - Format the number of commanders (squad leaders) (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderCommanders(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%u", SquadTracker::Composition().Commanders);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderLieutenants - Format the number of lieutenants (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderLieutenants(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%u", SquadTracker::Composition().Lieutenants);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderGroupType - Format squad, party or none (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderGroupType(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%s", SquadTracker::GroupTypeName(SquadTracker::Composition()));
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderReady - Format ready-check progress as ready/members (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderReady(char* buffer, size_t size)
+{
+    SquadComposition composition = SquadTracker::Composition();
+    int len = snprintf(buffer, size, "%u/%u", composition.Ready, composition.Size);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderPlayerStatus - Format current player status (alive/downed/dead) for the output file
+///                      (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderPlayerStatus(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%s", CombatTracker::StatusName(CombatTracker::Status()));
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderSquadAlive - Format the number of squad members up (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderSquadAlive(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%u", CombatTracker::Vitals().Alive);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderSquadDowned - Format the number of squad members downed (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderSquadDowned(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%u", CombatTracker::Vitals().Downed);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderSquadDead - Format the number of squad members dead (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderSquadDead(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%u", CombatTracker::Vitals().Dead);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderSessionStat - Format one session counter (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+template <ESessionStat Stat>
+static size_t RenderSessionStat(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%u", CombatTracker::Session().Get(Stat));
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderKillDeathRatio - Format session kills per death with two decimals (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderKillDeathRatio(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%.2f", SessionStats::KillDeathRatio(CombatTracker::Session()));
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderRate - Format one rolling rate as of now: counts per minute with one decimal, damage per
+///              second as a whole number (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+template <ERate Rate, ERateWindow Window>
+static size_t RenderRate(char* buffer, size_t size)
+{
+    double rate = RateTracker::Rate(Rate, Window, EventClock::Now());
+    int len = snprintf(buffer, size, Rate == Rate_Damage ? "%.0f" : "%.1f", rate);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderEnemies - Format the number of enemy players in range (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderEnemies(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%u", EnemyTracker::Total());
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderEnemyTeams - One "team: players" line per enemy team in range, largest first (writer and
+///                    server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderEnemyTeams(char* buffer, size_t size)
+{
+    EnemyTeamCount teams[EnemyRoster::MaxTeams];
+    size_t count = EnemyTracker::Teams(teams, EnemyRoster::MaxTeams);
+    size_t pos = 0;
+    for (size_t t = 0; t < count; t++)
+    {
+        int len = snprintf(buffer + pos, size - pos, "%s%u: %u", pos ? "\n" : "", teams[t].Team, teams[t].Count);
+        if (len <= 0 || static_cast<size_t>(len) >= size - pos)
+            break;
+        pos += static_cast<size_t>(len);
+    }
+    return pos;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderMapName - Format the current map name for the output file (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderMapName(char* buffer, size_t size)
+{
+    uint32_t mapId = GameState::MapId();
+    const char* name = mapId != 0 ? GameState::MapName(GameState::MapType(), mapId) : "";
+    int len = snprintf(buffer, size, "%s", name);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderMapId - Format the current map id for the output file (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderMapId(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%u", GameState::MapId());
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderKillFeed - The kill feed text last rendered by the worker (writer thread)
+///----------------------------------------------------------------------------------------------------
+static size_t RenderKillFeed(char* buffer, size_t size)
+{
+    KillFeedText text = g_killFeedText.Load();
+    int len = snprintf(buffer, size, "%.*s", static_cast<int>(sizeof(text.Text)), text.Text);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderGauge - Our last published health or barrier percentage as a whole number, empty until the
+///               first update (writer and server threads)
+///----------------------------------------------------------------------------------------------------
+template <ESelfGauge Gauge>
+static size_t RenderGauge(char* buffer, size_t size)
+{
+    uint32_t value = CombatTracker::Gauge(Gauge).Published();
+    if (value == ThrottledGauge::Unknown)
+        return 0;
+    int len = snprintf(buffer, size, "%u", value / 100);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RenderRuleText - The last text an alert rule wrote to this file slot (writer thread)
+///----------------------------------------------------------------------------------------------------
+template <size_t Slot>
+static size_t RenderRuleText(char* buffer, size_t size)
+{
+    RuleText text = g_ruleTexts[Slot].Load();
+    int len = snprintf(buffer, size, "%.*s", static_cast<int>(sizeof(text.Text)), text.Text);
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+static const OUTPUT_RENDER g_ruleRenders[AlertRules::MaxFiles] = {
+    RenderRuleText<0>, RenderRuleText<1>, RenderRuleText<2>, RenderRuleText<3>,
+    RenderRuleText<4>, RenderRuleText<5>, RenderRuleText<6>, RenderRuleText<7>,
+};
+
+///----------------------------------------------------------------------------------------------------
+/// RenderCounter - Format one counter= count (writer thread)
+///----------------------------------------------------------------------------------------------------
+template <size_t Slot>
+static size_t RenderCounter(char* buffer, size_t size)
+{
+    int len = snprintf(buffer, size, "%u", g_counterValues[Slot].load(std::memory_order_relaxed));
+    return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+static const OUTPUT_RENDER g_counterRenders[CombatCounters::MaxCounters] = {
+    RenderCounter<0>,  RenderCounter<1>,  RenderCounter<2>,  RenderCounter<3>,
+    RenderCounter<4>,  RenderCounter<5>,  RenderCounter<6>,  RenderCounter<7>,
+    RenderCounter<8>,  RenderCounter<9>,  RenderCounter<10>, RenderCounter<11>,
+    RenderCounter<12>, RenderCounter<13>, RenderCounter<14>, RenderCounter<15>,
+    RenderCounter<16>, RenderCounter<17>, RenderCounter<18>, RenderCounter<19>,
+    RenderCounter<20>, RenderCounter<21>, RenderCounter<22>, RenderCounter<23>,
+    RenderCounter<24>, RenderCounter<25>, RenderCounter<26>, RenderCounter<27>,
+    RenderCounter<28>, RenderCounter<29>, RenderCounter<30>, RenderCounter<31>,
+};
+
+///----------------------------------------------------------------------------------------------------
+/// PublishState - Copy current state into the shared memory region (no-op unless enabled)
+///----------------------------------------------------------------------------------------------------
+static void PublishState()
+{
+    if (!g_statePublisher.IsOpen())
+        return;
+
+    STREAMLINK_METRICS_SCOPE(Metrics::Probe_StatePublish);
+    g_statePublisher.Publish([](StreamlinkSharedState& state)
+    {
+        // One snapshot, so the region never mixes fields from different updates
+        TrackedState tracked = StateBlock::Read();
+
+        uint32_t status = StreamlinkPlayerStatus_Alive;
+        switch (tracked.Status)
+        {
+            case PlayerStatus::Downed: status = StreamlinkPlayerStatus_Downed; break;
+            case PlayerStatus::Dead:   status = StreamlinkPlayerStatus_Dead; break;
+            default: break;
+        }
+
+        state.KillCount.store(tracked.Session.Get(SessionStat_CurrentStreak), std::memory_order_relaxed);
+        state.InSquad.store(tracked.InSquad ? 1 : 0, std::memory_order_relaxed);
+        state.PlayerStatus.store(status, std::memory_order_relaxed);
+    });
+}
+
+///----------------------------------------------------------------------------------------------------
+/// ApplyCombatChanges - Flag outputs for the writer thread and publish
+///----------------------------------------------------------------------------------------------------
+static void ApplyCombatChanges(uint32_t changes)
+{
+    if (changes == CombatChange_None)
+        return;
+
+    if (changes & CombatChange_Killstreak)
+        MarkOutput(OutputPath_Killstreak);
+    if (changes & CombatChange_PlayerStatus)
+        MarkOutput(OutputPath_PlayerStatus);
+    if (changes & CombatChange_SquadVitals)
+    {
+        MarkOutput(OutputPath_SquadAlive);
+        MarkOutput(OutputPath_SquadDowned);
+        MarkOutput(OutputPath_SquadDead);
+    }
+    if (changes & CombatChange_Session)
+    {
+        for (const SessionOutput& stat : g_sessionOutputs)
+            MarkOutput(stat.path);
+    }
+    if (changes & (CombatChange_Killstreak | CombatChange_Session))
+        SessionJournal::Record(CombatTracker::Session(), SessionJournal::WallClockMs());
+    PublishState();
+    OverlayServer::Notify();
+}
+
+///----------------------------------------------------------------------------------------------------
+/// ApplyEnemyChanges - Flag the enemy roster outputs for the writer thread
+///----------------------------------------------------------------------------------------------------
+static void ApplyEnemyChanges()
+{
+    MarkOutput(OutputPath_Enemies);
+    MarkOutput(OutputPath_EnemyTeams);
+    OverlayServer::Notify();
+}
+
+///----------------------------------------------------------------------------------------------------
+/// RunRule - Carry out the actions of one fired alert rule
+///----------------------------------------------------------------------------------------------------
+static void RunRule(const AlertRule& rule, uint32_t value)
+{
+    if ((rule.Actions & AlertAction_Alert) && g_api)
+    {
+        char message[128];
+        AlertRules::Format(rule.AlertMessage, value, message, sizeof(message));
+        g_api->GUI_SendAlert(message);
+    }
+    if (rule.Actions & AlertAction_File)
+    {
+        RuleText text;
+        AlertRules::Format(rule.FileMessage, value, text.Text, sizeof(text.Text));
+        g_ruleTexts[rule.FileSlot].Store(text);
+        OutputWriter::MarkDirty(g_ruleFileOutputs[rule.FileSlot]);
+    }
+    if (rule.Actions & AlertAction_Event)
+    {
+        RuleEvent event = {rule.EventName.c_str(), {rule.Trigger, value}};
+        g_ruleEvents.TryPush(event);
+    }
+}
+
+///----------------------------------------------------------------------------------------------------
+/// CheckKillRules - Run the alert rules a kill fired (event queue worker thread)
+///----------------------------------------------------------------------------------------------------
+static void CheckKillRules()
+{
+    const AlertRules& rules = Settings::Current()->Rules;
+    SessionCounters session = CombatTracker::Session();
+    uint32_t streak = session.Get(SessionStat_CurrentStreak);
+    uint32_t kills = session.Get(SessionStat_Kills);
+
+    uint32_t fired = rules.OnKill(g_ruleState, streak, session.Get(SessionStat_BestStreak), kills);
+    for (size_t i = 0; fired != 0; i++, fired >>= 1)
+    {
+        if (fired & 1)
+        {
+            const AlertRule& rule = rules.Rule(i);
+            RunRule(rule, rule.Trigger == AlertTrigger_KillsEvery ? kills : streak);
+        }
+    }
+}
+
+///----------------------------------------------------------------------------------------------------
+/// CheckSquadRules - Run the alert rules the squad growing fired
+///----------------------------------------------------------------------------------------------------
+static void CheckSquadRules(uint32_t before, uint32_t after)
+{
+    const AlertRules& rules = Settings::Current()->Rules;
+    uint32_t fired = rules.OnSquadSize(before, after);
+    for (size_t i = 0; fired != 0; i++, fired >>= 1)
+    {
+        if (fired & 1)
+            RunRule(rules.Rule(i), after);
+    }
+}
+
+///----------------------------------------------------------------------------------------------------
+/// PollGameState - Refresh the MumbleLink snapshot and react to map changes
+///
+/// Called before each batch of combat records and from the writer thread, so map outputs follow map
+/// changes even when no combat events arrive.
+///----------------------------------------------------------------------------------------------------
+static void PollGameState()
+{
+    uint32_t changes = GameState::Poll();
+    if (changes == GameChange_None)
+        return;
+
+    MarkOutput(OutputPath_MapName);
+    MarkOutput(OutputPath_MapId);
+    OverlayServer::Notify();
+    STREAMLINK_TRACE(ELogLevel_DEBUG, "Map changed: mapType=%u, mapId=%u, isWvW=%s",
+                     GameState::MapType(), GameState::MapId(), GameState::IsInWvW() ? "true" : "false");
+
+    if ((changes & GameChange_LeftWvW) && Settings::Current()->ResetOnLeaveWvW)
+        ApplyCombatChanges(CombatTracker::ResetKillstreak());
+}
+
+///----------------------------------------------------------------------------------------------------
+/// OnSquadUpdate - Handle Unofficial Extras squad update events via Nexus
+///----------------------------------------------------------------------------------------------------
+static void OnSquadUpdate(void* eventArgs)
+{
+    if (!eventArgs) return;
+    STREAMLINK_METRICS_SCOPE(Metrics::Probe_SquadUpdate);
+
+    if (EventRecorder::IsRecording())
+        EventRecorder::RecordSquadUpdate(*static_cast<EvSquadUpdate*>(eventArgs));
+    uint32_t sizeBefore = SquadTracker::Composition().Size;
+    uint32_t changes = SquadTracker::Apply(*static_cast<EvSquadUpdate*>(eventArgs));
+    if (changes == SquadChange_None)
+        return;
+
+    if (changes & SquadChange_InSquad)
+    {
+        MarkOutput(OutputPath_Squad);
+        PublishState();
+    }
+    if (changes & SquadChange_Size)
+    {
+        MarkOutput(OutputPath_SquadSize);
+        CheckSquadRules(sizeBefore, SquadTracker::Composition().Size);
+    }
+    if (changes & SquadChange_Subgroups)
+        MarkOutput(OutputPath_Subgroups);
+    if (changes & SquadChange_Roles)
+    {
+        MarkOutput(OutputPath_Commanders);
+        MarkOutput(OutputPath_Lieutenants);
+    }
+    if (changes & SquadChange_GroupType)
+        MarkOutput(OutputPath_GroupType);
+    if (changes & (SquadChange_Ready | SquadChange_Size))
+        MarkOutput(OutputPath_Ready);
+    OverlayServer::Notify();
+}
+
+///----------------------------------------------------------------------------------------------------
+/// CountRates - Feed one record into the rolling rates (event queue worker thread)
+///
+/// Only adds to the windows; the rate outputs are refreshed by TickRates, not here.
+///----------------------------------------------------------------------------------------------------
+static void CountRates(const CombatRecord& record, uint32_t changes)
+{
+    if (changes & CombatChange_Kill)
+        RateTracker::Add(Rate_Kills, record.Time, 1);
+    if (changes & CombatChange_EnemyDowned)
+        RateTracker::Add(Rate_Downs, record.Time, 1);
+
+    uint32_t damage = CombatTracker::OutgoingDamage(record);
+    if (damage != 0)
+        RateTracker::Add(Rate_Damage, record.Time, damage);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// CountRecord - Add one record to every counter= whose filter it matches (event queue worker thread)
+///----------------------------------------------------------------------------------------------------
+static uint32_t CountRecord(const CombatCounters& counters, const CombatRecord& record)
+{
+    uint32_t matched = counters.Match(record);
+    for (uint32_t bits = matched; bits != 0; bits &= bits - 1)
+        g_counterValues[LowestBit(bits)].fetch_add(1, std::memory_order_relaxed);
+    return matched;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// ProcessCombatBatch - Run the trackers over queued combat records (event queue worker thread)
+///
+/// Outputs are flagged once per batch; alert rules are checked per kill so none is skipped when
+/// several kills land in the same batch.
+///----------------------------------------------------------------------------------------------------
+static void ProcessCombatBatch(const CombatRecord* records, size_t count)
+{
+    STREAMLINK_METRICS_SCOPE(Metrics::Probe_EventBatch);
+    PollGameState();
+
+    // Names captured for this batch's killing blows were queued before their records
+    KillNames names;
+    while (g_killNames.TryPop(names))
+        g_killFeed.Stage(names);
+
+    const CombatCounters& counters = Settings::Current()->Counters;
+    uint32_t counted = 0;
+    uint32_t changes = CombatChange_None;
+    bool enemiesChanged = false;
+    uint64_t latestTime = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const CombatRecord& record = records[i];
+        if (record.HasEvent() && record.Time > latestTime)
+            latestTime = record.Time;
+
+        // Events involving us arrive on both feeds; only the first copy goes any further
+        if (!CombatDispatch::Accept(record))
+            continue;
+        enemiesChanged |= EnemyTracker::OnRecord(record);
+        counted |= CountRecord(counters, record);
+
+        uint32_t recordChanges = CombatDispatch::Dispatch(record);
+        CountRates(record, recordChanges);
+
+        if (recordChanges & CombatChange_Kill)
+        {
+            g_killFeed.Add(record);
+            CheckKillRules();
+        }
+        changes |= recordChanges;
+    }
+    if (latestTime != 0)
+        EventClock::Observe(latestTime);
+    if (enemiesChanged)
+        ApplyEnemyChanges();
+    if (changes & CombatChange_Kill)
+    {
+        KillFeedText text = {};
+        g_killFeed.Render(text.Text, sizeof(text.Text));
+        g_killFeedText.Store(text);
+        MarkOutput(OutputPath_KillFeed);
+    }
+    for (uint32_t bits = counted; bits != 0; bits &= bits - 1)
+        OutputWriter::MarkDirty(g_counterOutputs[LowestBit(bits)]);
+    ApplyCombatChanges(changes);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// QueueCombatEvent - Copy a callback payload for the worker, names first since they die with the call
+///----------------------------------------------------------------------------------------------------
+static void QueueCombatEvent(const EvCombatData& data, ECombatSource source)
+{
+    if (EventRecorder::IsRecording())
+        EventRecorder::RecordCombat(data, source);
+
+    KillNames names;
+    if (CaptureKillNames(data, names))
+        g_killNames.TryPush(names);
+    EventQueue::Push(MakeCombatRecord(data, source));
+}
+
+///----------------------------------------------------------------------------------------------------
+/// OnCombatEvent - Handle ArcDPS combat events via Nexus
+///
+/// Runs on the game's event thread: copy what we track and return, the worker does the rest.
+///----------------------------------------------------------------------------------------------------
+static void OnCombatEvent(void* eventArgs)
+{
+    if (!eventArgs) return;
+    STREAMLINK_METRICS_SCOPE(Metrics::Probe_LocalEvent);
+
+    QueueCombatEvent(*static_cast<EvCombatData*>(eventArgs), CombatSource_Local);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// OnSquadCombatEvent - Handle ArcDPS squad combat events (state changes come through here)
+///----------------------------------------------------------------------------------------------------
+static void OnSquadCombatEvent(void* eventArgs)
+{
+    if (!eventArgs) return;
+    STREAMLINK_METRICS_SCOPE(Metrics::Probe_SquadEvent);
+
+    QueueCombatEvent(*static_cast<EvCombatData*>(eventArgs), CombatSource_Squad);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// TickRates - Refresh the rolling rate outputs once per RateRefreshInterval (writer thread)
+///----------------------------------------------------------------------------------------------------
+static void TickRates()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - g_lastRateRefresh < RateRefreshInterval)
+        return;
+
+    g_lastRateRefresh = now;
+    for (EOutputPath rate : g_rateOutputs)
+        MarkOutput(rate);
+    OverlayServer::Notify();
+}
+
+///----------------------------------------------------------------------------------------------------
+/// TickGauges - Flush the health and barrier outputs when they have moved far enough, at most once per
+///              gauge_interval_ms (writer thread)
+///----------------------------------------------------------------------------------------------------
+static void TickGauges()
+{
+    static const EOutputPath outputs[SelfGauge_Count] = {OutputPath_Health, OutputPath_Barrier};
+
+    const Config& config = *Settings::Current();
+    uint64_t nowMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    bool changed = false;
+    for (uint32_t gauge = 0; gauge < SelfGauge_Count; gauge++)
+    {
+        if (CombatTracker::Gauge(static_cast<ESelfGauge>(gauge)).Poll(nowMs, config.GaugeIntervalMs,
+                                                                       config.GaugeThreshold * 100))
+        {
+            MarkOutput(outputs[gauge]);
+            changed = true;
+        }
+    }
+    if (changed)
+        OverlayServer::Notify();
+}
+
+///----------------------------------------------------------------------------------------------------
+/// TickRuleEvents - Raise the events queued by alert rules (writer thread)
+///----------------------------------------------------------------------------------------------------
+static void TickRuleEvents()
+{
+    RuleEvent events[16];
+    size_t count;
+    while ((count = g_ruleEvents.PopBatch(events, 16)) != 0)
+    {
+        for (size_t i = 0; i < count && g_api; i++)
+            g_api->Events_Raise(events[i].Name, &events[i].Payload);
+    }
+}
+
+///----------------------------------------------------------------------------------------------------
+/// TickEnemies - Age out enemies whose despawn never arrived (writer thread)
+///----------------------------------------------------------------------------------------------------
+static void TickEnemies()
+{
+    if (EnemyTracker::Tick(EventClock::Now()))
+        ApplyEnemyChanges();
+}
+
+///----------------------------------------------------------------------------------------------------
+/// TickMetrics - Rewrite the metrics files periodically while recording (writer thread)
+///----------------------------------------------------------------------------------------------------
+static void TickMetrics()
+{
+    if (!Metrics::IsEnabled())
+        return;
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - g_lastMetricsDump < MetricsDumpInterval)
+        return;
+
+    g_lastMetricsDump = now;
+    MarkOutput(OutputPath_MetricsText);
+    MarkOutput(OutputPath_MetricsJson);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// OnToggleMetrics - EV_STREAMLINK_TOGGLE_METRICS: switch latency recording on or off at runtime
+///----------------------------------------------------------------------------------------------------
+static void OnToggleMetrics(void* eventArgs)
+{
+    (void)eventArgs;
+
+    bool enabled = !Metrics::IsEnabled();
+    Metrics::SetEnabled(enabled);
+    MarkOutput(OutputPath_MetricsText);
+    MarkOutput(OutputPath_MetricsJson);
+    Log::Writef(ELogLevel_INFO, "Latency metrics %s.", enabled ? "enabled" : "disabled");
+}
+
+// Renderer of every configurable output, in EOutputPath order
+static const OUTPUT_RENDER g_outputRenders[OutputPath_Count] = {
+    RenderKillcount,
+    RenderSquadStatus,
+    RenderPlayerStatus,
+    RenderSquadSize,
+    RenderSubgroups,
+    RenderCommanders,
+    RenderLieutenants,
+    RenderGroupType,
+    RenderReady,
+    RenderSquadAlive,
+    RenderSquadDowned,
+    RenderSquadDead,
+    RenderEnemies,
+    RenderEnemyTeams,
+    RenderMapName,
+    RenderMapId,
+    RenderSessionStat<SessionStat_Kills>,
+    RenderSessionStat<SessionStat_Deaths>,
+    RenderSessionStat<SessionStat_Downs>,
+    RenderSessionStat<SessionStat_BestStreak>,
+    RenderKillDeathRatio,
+    RenderRate<Rate_Kills, RateWindow_60s>,
+    RenderRate<Rate_Downs, RateWindow_60s>,
+    RenderRate<Rate_Damage, RateWindow_10s>,
+    RenderKillFeed,
+    RenderGauge<SelfGauge_Health>,
+    RenderGauge<SelfGauge_Barrier>,
+    Metrics::RenderText,
+    Metrics::RenderJson,
+};
+
+///----------------------------------------------------------------------------------------------------
+/// LoadSettings - Read settings.txt (see settings.h for the format) on top of the defaults
+///----------------------------------------------------------------------------------------------------
+static bool LoadSettings(Config& config)
+{
+    size_t rejected = 0;
+    if (!Settings::Load(GetSettingsPath(), config, &rejected))
+        return false;
+
+    if (rejected != 0)
+        Log::Writef(ELogLevel_WARNING, "Settings: ignored %zu unrecognised or invalid line(s).", rejected);
+    return true;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// CounterAt - The counter= in a slot, null past the last one
+///----------------------------------------------------------------------------------------------------
+static const CombatCounter* CounterAt(const Config& config, size_t slot)
+{
+    return slot < config.Counters.Count() ? &config.Counters.Counter(slot) : nullptr;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// ReloadSettings - Apply an edited settings file (writer thread)
+///
+/// Outputs are retargeted and the flush interval, log level, trace file and metrics switch change in
+/// place; the new Config is then published for the event path. Settings that are only read at load
+/// are published too but only take effect after a restart.
+///----------------------------------------------------------------------------------------------------
+static void ReloadSettings()
+{
+    // A missing file is most likely mid-replace; keep what we have
+    Config after;
+    if (!LoadSettings(after))
+        return;
+
+    const Config& before = *Settings::Current();
+    std::string changed = Settings::ChangedKeys(before, after);
+    if (changed.empty())
+        return;
+
+    for (size_t path = 0; path < OutputPath_Count; path++)
+    {
+        if (after.OutputPaths[path] != before.OutputPaths[path])
+            OutputWriter::Retarget(g_outputIds[path], ResolveGamePath(after.OutputPaths[path]));
+    }
+    for (size_t slot = 0; slot < AlertRules::MaxFiles; slot++)
+    {
+        const std::string& path = after.Rules.FilePath(slot);
+        if (path == before.Rules.FilePath(slot))
+            continue;
+
+        // The slot now belongs to another file: start it empty
+        g_ruleTexts[slot].Store(RuleText());
+        OutputWriter::Retarget(g_ruleFileOutputs[slot], ResolveGamePath(path));
+    }
+    for (size_t slot = 0; slot < CombatCounters::MaxCounters; slot++)
+    {
+        const CombatCounter* was = CounterAt(before, slot);
+        const CombatCounter* now = CounterAt(after, slot);
+
+        // A different counter in the slot starts from zero; a counter that only moved file keeps counting
+        if (!was || !now || was->Name != now->Name || was->Expression != now->Expression)
+            g_counterValues[slot].store(0, std::memory_order_relaxed);
+        std::string path = now ? now->FilePath : std::string();
+        if (path != (was ? was->FilePath : std::string()))
+            OutputWriter::Retarget(g_counterOutputs[slot], ResolveGamePath(path));
+    }
+    OutputWriter::SetFlushInterval(after.FlushIntervalMs);
+    Tracing::SetLevel(after.LogLevel);
+    if (after.TraceFile != before.TraceFile)
+        Tracing::SetSink(ResolveGamePath(after.TraceFile));
+    if (after.Metrics != before.Metrics)
+        Metrics::SetEnabled(after.Metrics);
+    if (after.Record != before.Record || after.RecordFile != before.RecordFile)
+    {
+        StopRecording();
+        StartRecording(after);
+    }
+
+    bool restart = Settings::NeedsRestart(before, after);
+    Settings::Publish(after);
+    OutputWriter::MarkAllDirty();
+    Log::Writef(ELogLevel_INFO, "Settings reloaded: %s.", changed.c_str());
+    if (restart)
+        Log::Write(ELogLevel_WARNING, "Settings: server, shared memory, MumbleLink and journal changes apply after a restart.");
+}
+
+///----------------------------------------------------------------------------------------------------
+/// TickSettings - Reload settings.txt once it has been quiet for SettingsDebounce after a change
+///                (writer thread)
+///----------------------------------------------------------------------------------------------------
+static void TickSettings()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (g_settingsWatcher.Poll())
+    {
+        g_settingsPending = true;
+        g_settingsChangedAt = now;
+        return;
+    }
+    if (!g_settingsPending || now - g_settingsChangedAt < SettingsDebounce)
+        return;
+
+    g_settingsPending = false;
+    ReloadSettings();
+}
+
+void Streamlink::Load(AddonAPI* api)
+{
+    g_api = api;
+    Log::SetApi(api);
+
+    // Load settings and publish them for the event path; edits are picked up by TickSettings
+    Config loaded;
+    LoadSettings(loaded);
+    Settings::Publish(loaded);
+    const Config& settings = *Settings::Current();
+
+    // Diagnostics from the event handlers go through the trace ring, drained by the writer thread
+    Tracing::SetLevel(settings.LogLevel);
+    Tracing::SetSink(ResolveGamePath(settings.TraceFile));
+
+    // Latency histograms start empty each session; recording can also be toggled at runtime
+    Metrics::Reset();
+    Metrics::SetEnabled(settings.Metrics);
+    g_lastMetricsDump = std::chrono::steady_clock::now();
+
+    // Open MumbleLink shared memory for WvW detection
+    GameState::Reset();
+    if (MumbleLink::Open(settings.MumbleLink.c_str()))
+    {
+        GameState::Poll();
+        Log::Writef(ELogLevel_INFO, "MumbleLink connected. mapType=%u, mapId=%u, isWvW=%s",
+                    GameState::MapType(), GameState::MapId(), GameState::IsInWvW() ? "true" : "false");
+    }
+    else
+    {
+        Log::Write(ELogLevel_WARNING, "MumbleLink: shared memory not found.");
+    }
+
+    // Reset tracked state
+    CombatTracker::Reset();
+    SquadTracker::Reset();
+    RateTracker::Reset();
+    CombatDispatch::Reset();
+    EnemyTracker::Reset();
+    EventClock::Reset();
+    g_lastRateRefresh = std::chrono::steady_clock::now();
+
+    // Carry on a session that ended recently (crash, addon reload) from the journal
+    std::string journalPath = settings.Journal ? GetAddonFilePath("journal.bin") : std::string();
+    SessionCounters restored;
+    if (!journalPath.empty() &&
+        SessionJournal::Open(journalPath, SessionJournal::WallClockMs(), settings.JournalMaxAgeSec * 1000ull,
+                              restored))
+    {
+        CombatTracker::RestoreSession(restored);
+        Log::Writef(ELogLevel_INFO, "Session restored from journal: killstreak %u, kills %u, deaths %u.",
+                    restored.Get(SessionStat_CurrentStreak), restored.Get(SessionStat_Kills),
+                    restored.Get(SessionStat_Deaths));
+    }
+
+    // Alert rules pick up from the (possibly restored) streak; nothing is left from the last session
+    SessionCounters session = CombatTracker::Session();
+    g_ruleState.Begin(session.Get(SessionStat_CurrentStreak), session.Get(SessionStat_BestStreak));
+    RuleEvent staleEvent;
+    while (g_ruleEvents.TryPop(staleEvent)) {}
+
+    // The kill feed starts empty; skill names cached by an earlier load stay valid
+    KillNames staleNames;
+    while (g_killNames.TryPop(staleNames)) {}
+    g_killFeed.Clear();
+    g_killFeedText.Store(KillFeedText());
+
+    // Register outputs with the writer thread. Paths are resolved and directories created here,
+    // once; callbacks only flag outputs dirty from here on.
+    OutputWriter::Reset();
+    for (size_t path = 0; path < OutputPath_Count; path++)
+        g_outputIds[path] = OutputWriter::Register(ResolveGamePath(settings.OutputPaths[path]), g_outputRenders[path]);
+    for (size_t slot = 0; slot < AlertRules::MaxFiles; slot++)
+    {
+        g_ruleTexts[slot].Store(RuleText());
+        g_ruleFileOutputs[slot] = OutputWriter::Register(ResolveGamePath(settings.Rules.FilePath(slot)),
+                                                         g_ruleRenders[slot]);
+    }
+    for (size_t slot = 0; slot < CombatCounters::MaxCounters; slot++)
+    {
+        const CombatCounter* counter = CounterAt(settings, slot);
+        g_counterValues[slot].store(0, std::memory_order_relaxed);
+        g_counterOutputs[slot] = OutputWriter::Register(ResolveGamePath(counter ? counter->FilePath : std::string()),
+                                                        g_counterRenders[slot]);
+    }
+    OutputWriter::AddTickHook(PollGameState);
+    OutputWriter::AddTickHook(Tracing::Flush);
+    OutputWriter::AddTickHook(TickMetrics);
+    OutputWriter::AddTickHook(TickRates);
+    OutputWriter::AddTickHook(TickEnemies);
+    OutputWriter::AddTickHook(SessionJournal::Flush);
+    OutputWriter::AddTickHook(TickSettings);
+    OutputWriter::AddTickHook(TickRuleEvents);
+    OutputWriter::AddTickHook(TickGauges);
+
+    // Watch settings.txt for edits; its directory has to exist for that
+    std::string settingsPath = GetSettingsPath();
+    g_settingsPending = false;
+    if (!settingsPath.empty())
+    {
+        Platform::CreateDirectories(settingsPath.substr(0, settingsPath.find_last_of("\\/")).c_str());
+        if (!g_settingsWatcher.Watch(settingsPath))
+            Log::Write(ELogLevel_WARNING, "Settings: could not watch settings.txt; changes apply after a restart.");
+    }
+
+    if (settings.SharedMemory)
+    {
+        if (g_statePublisher.Open())
+        {
+            PublishState();
+            Log::Write(ELogLevel_INFO, "Shared memory state published as " STREAMLINK_SHARED_STATE_NAME ".");
+        }
+        else
+        {
+            Log::Write(ELogLevel_WARNING, "Shared memory: could not create state region.");
+        }
+    }
+
+    // Initialize output files
+    OutputWriter::MarkAllDirty();
+    OutputWriter::Start(settings.FlushIntervalMs);
+
+    // Optional push endpoint for browser sources, serving the same renderers as the files
+    OverlayServer::Reset();
+    if (settings.Server)
+    {
+        OverlayServer::AddField("killstreak", RenderKillcount, OverlayServer::Field_Number);
+        OverlayServer::AddField("inSquad", RenderSquadStatus, OverlayServer::Field_Number);
+        OverlayServer::AddField("playerStatus", RenderPlayerStatus, OverlayServer::Field_String);
+        OverlayServer::AddField("squadSize", RenderSquadSize, OverlayServer::Field_Number);
+        OverlayServer::AddField("subgroups", RenderSubgroups, OverlayServer::Field_String);
+        OverlayServer::AddField("commanders", RenderCommanders, OverlayServer::Field_Number);
+        OverlayServer::AddField("lieutenants", RenderLieutenants, OverlayServer::Field_Number);
+        OverlayServer::AddField("groupType", RenderGroupType, OverlayServer::Field_String);
+        OverlayServer::AddField("ready", RenderReady, OverlayServer::Field_String);
+        OverlayServer::AddField("squadAlive", RenderSquadAlive, OverlayServer::Field_Number);
+        OverlayServer::AddField("squadDowned", RenderSquadDowned, OverlayServer::Field_Number);
+        OverlayServer::AddField("squadDead", RenderSquadDead, OverlayServer::Field_Number);
+        OverlayServer::AddField("enemies", RenderEnemies, OverlayServer::Field_Number);
+        OverlayServer::AddField("enemyTeams", RenderEnemyTeams, OverlayServer::Field_String);
+        OverlayServer::AddField("map", RenderMapName, OverlayServer::Field_String);
+        OverlayServer::AddField("mapId", RenderMapId, OverlayServer::Field_Number);
+        OverlayServer::AddField("killFeed", RenderKillFeed, OverlayServer::Field_String);
+        OverlayServer::AddField("health", RenderGauge<SelfGauge_Health>, OverlayServer::Field_Number);
+        OverlayServer::AddField("barrier", RenderGauge<SelfGauge_Barrier>, OverlayServer::Field_Number);
+        for (const SessionOutput& stat : g_sessionOutputs)
+            OverlayServer::AddField(stat.fieldName, stat.render, OverlayServer::Field_Number);
+        for (const RateField& rate : g_rateFields)
+            OverlayServer::AddField(rate.name, rate.render, OverlayServer::Field_Number);
+
+        if (OverlayServer::Start(settings.ServerPort))
+            Log::Writef(ELogLevel_INFO, "Overlay server listening on http://127.0.0.1:%u/state", OverlayServer::Port());
+        else
+            Log::Writef(ELogLevel_WARNING, "Overlay server: could not listen on port %u.", settings.ServerPort);
+    }
+
+    // Opt-in recording of the raw callback streams, for replaying a session later
+    StartRecording(settings);
+
+    // Combat tracking runs on the event queue worker, fed by the ArcDPS callbacks below
+    EventQueue::Reset();
+    EventQueue::Start(ProcessCombatBatch);
+
+    // Subscribe to ArcDPS combat events
+    api->Events_Subscribe(EV_ARCDPS_COMBATEVENT_LOCAL_RAW, OnCombatEvent);
+    api->Events_Subscribe(EV_ARCDPS_COMBATEVENT_SQUAD_RAW, OnSquadCombatEvent);
+
+    // Subscribe to Unofficial Extras squad events (requires ArcdpsIntegration addon)
+    api->Events_Subscribe(EV_UNOFFICIAL_EXTRAS_SQUAD_UPDATE, OnSquadUpdate);
+
+    // Runtime switch for latency metrics, raised by other addons or keybind helpers
+    api->Events_Subscribe(EV_STREAMLINK_TOGGLE_METRICS, OnToggleMetrics);
+
+    Log::Write(ELogLevel_INFO, "Addon loaded successfully.");
+}
+
+void Streamlink::Unload()
+{
+    if (g_api)
+    {
+        // Unsubscribe from events
+        g_api->Events_Unsubscribe(EV_ARCDPS_COMBATEVENT_LOCAL_RAW, OnCombatEvent);
+        g_api->Events_Unsubscribe(EV_ARCDPS_COMBATEVENT_SQUAD_RAW, OnSquadCombatEvent);
+        g_api->Events_Unsubscribe(EV_UNOFFICIAL_EXTRAS_SQUAD_UPDATE, OnSquadUpdate);
+        g_api->Events_Unsubscribe(EV_STREAMLINK_TOGGLE_METRICS, OnToggleMetrics);
+
+        Log::Write(ELogLevel_INFO, "Addon unloaded.");
+    }
+
+    // Process whatever the callbacks queued before they were unsubscribed
+    EventQueue::Stop();
+    if (EventQueue::Dropped() != 0)
+    {
+        Log::Writef(ELogLevel_WARNING, "Event queue dropped %llu records (%llu critical).",
+                    (unsigned long long)EventQueue::Dropped(), (unsigned long long)EventQueue::DroppedCritical());
+    }
+
+    // Final file writes: stop the writer thread, which flushes anything still pending. Its tick hooks
+    // read MumbleLink and publish state, so both stay open until it has exited.
+    OutputWriter::MarkAllDirty();
+    OutputWriter::Stop();
+
+    // TickSettings ran on the writer thread; nothing polls the watch any more
+    g_settingsWatcher.Close();
+
+    // Events are unsubscribed and settings reloads have stopped; write out the rest of the recording
+    StopRecording();
+    EventRecorder::Shutdown();
+
+    // The writer has appended everything queued; close the journal with the session summary
+    SessionJournal::Close(CombatTracker::Session(), SessionJournal::WallClockMs());
+
+    // Nothing can notify the server any more
+    OverlayServer::Stop();
+
+    // Events are unsubscribed and the writer has stopped, so nothing can be publishing any more
+    g_statePublisher.Close();
+
+    // Clean up MumbleLink
+    MumbleLink::Close();
+
+    // Clear squad members
+    SquadTracker::Reset();
+
+    Tracing::Shutdown();
+
+    // Every thread that could hold a Config has stopped
+    Settings::Reset();
+    Log::SetApi(nullptr);
+    g_api = nullptr;
+}
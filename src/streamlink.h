@@ -0,0 +1,35 @@
+///----------------------------------------------------------------------------------------------------
+/// Streamlink - Addon lifecycle and event wiring
+///
+/// Load() and Unload() are the Nexus entry points. They subscribe the event handlers, which feed the
+/// trackers and flag the affected outputs for the writer thread. Nothing in here depends on Windows;
+/// the DLL shell in nexus_streamlink.cpp and the host tests both drive the addon through these.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_H
+#define STREAMLINK_H
+
+#include <cstdint>
+
+#include "Nexus.h"
+
+/// Raise (payload ignored) to switch latency metrics recording on or off
+#define EV_STREAMLINK_TOGGLE_METRICS "EV_STREAMLINK_TOGGLE_METRICS"
+
+/// Payload of the events raised by "event" actions of alert rules (the event name comes from the rule)
+struct StreamlinkRuleEvent
+{
+    uint32_t Trigger;   // 0 streak, 1 kills_every, 2 best_streak, 3 squad_size
+    uint32_t Value;     // the streak, session kill count or squad size that fired the rule
+};
+
+namespace Streamlink
+{
+    /// Called when addon is loaded
+    void Load(AddonAPI* api);
+
+    /// Called when addon is unloaded
+    void Unload();
+}
+
+#endif
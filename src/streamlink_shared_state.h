@@ -0,0 +1,89 @@
+///----------------------------------------------------------------------------------------------------
+/// Streamlink Shared State - Public layout of the shared memory state region
+///
+/// When shared memory output is enabled the addon keeps a StreamlinkSharedState in a named region
+/// (STREAMLINK_SHARED_STATE_NAME; on POSIX "/" + that name). Every field is a 32-bit little-endian
+/// integer at a fixed offset, so readers in any language can map the region and read it directly.
+///
+/// Torn-free reads use the Sequence counter: it is odd while the addon is writing. Read Sequence,
+/// copy the payload, read Sequence again, and accept the copy only if both values are equal and even.
+/// ReadStreamlinkSharedState() below does exactly that for C++ readers.
+///
+/// New fields are only ever appended (taking from Reserved) together with a Version bump; Size is the
+/// number of bytes the writer knows about.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_SHARED_STATE_H
+#define STREAMLINK_SHARED_STATE_H
+
+#include <atomic>
+#include <cstdint>
+
+#define STREAMLINK_SHARED_STATE_NAME    "StreamlinkState"
+#define STREAMLINK_SHARED_STATE_MAGIC   0x4B4E4C53u  /* "SLNK" */
+#define STREAMLINK_SHARED_STATE_VERSION 1u
+
+enum EStreamlinkPlayerStatus : uint32_t
+{
+    StreamlinkPlayerStatus_Alive  = 0,
+    StreamlinkPlayerStatus_Downed = 1,
+    StreamlinkPlayerStatus_Dead   = 2
+};
+
+struct StreamlinkSharedState
+{
+    std::atomic<uint32_t> Magic;          // 0:  STREAMLINK_SHARED_STATE_MAGIC once initialised
+    std::atomic<uint32_t> Version;        // 4:  STREAMLINK_SHARED_STATE_VERSION
+    std::atomic<uint32_t> Size;           // 8:  sizeof(StreamlinkSharedState)
+    std::atomic<uint32_t> Sequence;       // 12: odd while an update is in progress
+
+    std::atomic<uint32_t> KillCount;      // 16: current WvW killstreak
+    std::atomic<uint32_t> InSquad;        // 20: 1 if in a squad or party
+    std::atomic<uint32_t> PlayerStatus;   // 24: EStreamlinkPlayerStatus
+
+    std::atomic<uint32_t> Reserved[25];   // 28: zero, for future fields
+};
+
+static_assert(sizeof(StreamlinkSharedState) == 128, "StreamlinkSharedState layout is fixed");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "atomics must match the plain layout");
+
+/// Plain copy of the payload for readers.
+struct StreamlinkStateSnapshot
+{
+    uint32_t Sequence;
+    uint32_t KillCount;
+    uint32_t InSquad;
+    uint32_t PlayerStatus;
+};
+
+///----------------------------------------------------------------------------------------------------
+/// ReadStreamlinkSharedState - Copy a consistent snapshot. Returns false if the region is not
+///                             initialised or a writer kept it busy for every attempt.
+///----------------------------------------------------------------------------------------------------
+inline bool ReadStreamlinkSharedState(const StreamlinkSharedState* state, StreamlinkStateSnapshot& out,
+                                      int maxAttempts = 64)
+{
+    if (!state || state->Magic.load(std::memory_order_acquire) != STREAMLINK_SHARED_STATE_MAGIC)
+        return false;
+
+    for (int attempt = 0; attempt < maxAttempts; attempt++)
+    {
+        uint32_t before = state->Sequence.load(std::memory_order_acquire);
+        if (before & 1)
+            continue;
+
+        out.KillCount = state->KillCount.load(std::memory_order_relaxed);
+        out.InSquad = state->InSquad.load(std::memory_order_relaxed);
+        out.PlayerStatus = state->PlayerStatus.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (state->Sequence.load(std::memory_order_relaxed) == before)
+        {
+            out.Sequence = before;
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
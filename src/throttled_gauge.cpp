@@ -0,0 +1,36 @@
+///----------------------------------------------------------------------------------------------------
+/// Throttled Gauge - A fast-moving percentage whose output is refreshed at a bounded rate
+///----------------------------------------------------------------------------------------------------
+
+#include "throttled_gauge.h"
+
+bool ThrottledGauge::Poll(uint64_t nowMs, uint32_t minIntervalMs, uint32_t threshold)
+{
+    uint32_t latest = Latest();
+    uint32_t published = Published();
+    if (latest == published)
+        return false;
+
+    // The first value (and a reset back to Unknown) always counts as a move
+    if (latest != Unknown && published != Unknown && latest != 0 && latest != Full)
+    {
+        uint32_t moved = latest > published ? latest - published : published - latest;
+        if (moved < threshold)
+            return false;
+    }
+    if (m_everPublished && nowMs - m_publishedAtMs < minIntervalMs)
+        return false;
+
+    m_published.store(latest, std::memory_order_relaxed);
+    m_publishedAtMs = nowMs;
+    m_everPublished = true;
+    return true;
+}
+
+void ThrottledGauge::Reset()
+{
+    m_latest.store(Unknown, std::memory_order_relaxed);
+    m_published.store(Unknown, std::memory_order_relaxed);
+    m_publishedAtMs = 0;
+    m_everPublished = false;
+}
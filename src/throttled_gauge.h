@@ -0,0 +1,47 @@
+///----------------------------------------------------------------------------------------------------
+/// Throttled Gauge - A fast-moving percentage whose output is refreshed at a bounded rate
+///
+/// Values are ArcDPS percentages times 100 (0 to 10000). Set() only stores the newest value, so
+/// however often it changes, an update costs one relaxed store. Poll(), called periodically by the
+/// one thread that owns the output, publishes the newest value when it has moved at least threshold
+/// away from the published one and at least minIntervalMs have passed since the last publish, and
+/// reports whether the output needs rewriting. Reaching exactly 0 or Full (an empty or full bar)
+/// ignores the threshold, so a bar never gets stuck just short of either end; it still waits for the
+/// interval. Published() may be read from any thread.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_THROTTLED_GAUGE_H
+#define STREAMLINK_THROTTLED_GAUGE_H
+
+#include <atomic>
+#include <cstdint>
+
+class ThrottledGauge
+{
+public:
+    static constexpr uint32_t Full = 10000;          // 100%
+    static constexpr uint32_t Unknown = UINT32_MAX;  // nothing seen yet
+
+    /// Stores the newest value, clamped to Full. Any thread.
+    void Set(uint32_t value)
+    {
+        m_latest.store(value < Full ? value : Full, std::memory_order_relaxed);
+    }
+
+    uint32_t Latest() const { return m_latest.load(std::memory_order_relaxed); }
+    uint32_t Published() const { return m_published.load(std::memory_order_relaxed); }
+
+    /// Publishes the newest value if it is due (see above). True if Published() changed. Owner only.
+    bool Poll(uint64_t nowMs, uint32_t minIntervalMs, uint32_t threshold);
+
+    /// Back to Unknown. Not concurrently with Poll.
+    void Reset();
+
+private:
+    std::atomic<uint32_t> m_latest{Unknown};
+    std::atomic<uint32_t> m_published{Unknown};
+    uint64_t              m_publishedAtMs = 0;
+    bool                  m_everPublished = false;
+};
+
+#endif
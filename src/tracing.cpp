@@ -0,0 +1,261 @@
+///----------------------------------------------------------------------------------------------------
+/// Tracing - Level-gated, lazily formatted diagnostics for the event hot paths
+///----------------------------------------------------------------------------------------------------
+
+#include "tracing.h"
+
+#include <chrono>
+#include <cstdio>
+
+#include "log.h"
+#include "mpsc_ring.h"
+
+namespace
+{
+    struct TraceRecord
+    {
+        uint64_t    timestampNs;
+        const char* format;
+        uint8_t     level;
+        uint8_t     argCount;
+        uint64_t    args[Tracing::MaxArgs];
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    MpscRing<TraceRecord, 4096> g_ring;
+    std::atomic<uint64_t>       g_dropped{0};
+    uint64_t                    g_droppedReported = 0;
+    Clock::time_point           g_epoch = Clock::now();
+    FILE*                       g_file = nullptr;
+}
+
+std::atomic<int> Tracing::g_level{ELogLevel_INFO};
+
+void Tracing::SetLevel(int level)
+{
+    if (level < LevelOff) level = LevelOff;
+    if (level > ELogLevel_TRACE) level = ELogLevel_TRACE;
+    g_level.store(level, std::memory_order_relaxed);
+}
+
+int Tracing::Level()
+{
+    return g_level.load(std::memory_order_relaxed);
+}
+
+bool Tracing::ParseLevel(const char* text, int& level)
+{
+    static const char* const names[] = {"off", "critical", "warning", "info", "debug", "trace"};
+    for (int i = 0; i <= ELogLevel_TRACE; i++)
+    {
+        if (strcmp(text, names[i]) == 0)
+        {
+            level = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Tracing::SetSink(const std::string& filePath)
+{
+    if (g_file)
+    {
+        fclose(g_file);
+        g_file = nullptr;
+    }
+    if (!filePath.empty())
+        g_file = fopen(filePath.c_str(), "a");
+}
+
+void Tracing::Push(ELogLevel level, const char* format, const uint64_t* args, size_t argCount)
+{
+    TraceRecord record;
+    record.timestampNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - g_epoch).count());
+    record.format = format;
+    record.level = static_cast<uint8_t>(level);
+    record.argCount = static_cast<uint8_t>(argCount);
+    for (size_t i = 0; i < argCount && i < MaxArgs; i++)
+        record.args[i] = args[i];
+
+    if (!g_ring.TryPush(record))
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// FormatRecord - printf-style formatting over the captured 64-bit arguments
+///
+/// Each conversion is handed to snprintf on its own, with any length modifier replaced by the one
+/// matching how the argument was widened when it was captured.
+///----------------------------------------------------------------------------------------------------
+static void FormatRecord(const TraceRecord& record, char* out, size_t outSize)
+{
+    size_t pos = 0;
+    size_t arg = 0;
+    const char* p = record.format;
+
+    auto append = [&](int written)
+    {
+        if (written > 0)
+            pos += static_cast<size_t>(written);
+        if (pos >= outSize)
+            pos = outSize - 1;
+    };
+
+    while (*p && pos + 1 < outSize)
+    {
+        if (*p != '%')
+        {
+            out[pos++] = *p++;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            out[pos++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Copy flags, width and precision; drop length modifiers
+        char spec[24];
+        size_t specLen = 0;
+        spec[specLen++] = *p++;
+        while (*p && strchr("-+ #0123456789.", *p) && specLen < sizeof(spec) - 4)
+            spec[specLen++] = *p++;
+        while (*p && strchr("hljztL", *p))
+            p++;
+
+        char conversion = *p ? *p++ : 's';
+        uint64_t value = arg < record.argCount ? record.args[arg] : 0;
+        arg++;
+
+        switch (conversion)
+        {
+            case 'd':
+            case 'i':
+                spec[specLen++] = 'l';
+                spec[specLen++] = 'l';
+                spec[specLen++] = conversion;
+                spec[specLen] = '\0';
+                append(snprintf(out + pos, outSize - pos, spec, static_cast<long long>(value)));
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+                spec[specLen++] = 'l';
+                spec[specLen++] = 'l';
+                spec[specLen++] = conversion;
+                spec[specLen] = '\0';
+                append(snprintf(out + pos, outSize - pos, spec, static_cast<unsigned long long>(value)));
+                break;
+            case 'c':
+                spec[specLen++] = 'c';
+                spec[specLen] = '\0';
+                append(snprintf(out + pos, outSize - pos, spec, static_cast<int>(value)));
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            {
+                double d;
+                memcpy(&d, &value, sizeof(d));
+                spec[specLen++] = conversion;
+                spec[specLen] = '\0';
+                append(snprintf(out + pos, outSize - pos, spec, d));
+                break;
+            }
+            case 'p':
+                spec[specLen++] = 'p';
+                spec[specLen] = '\0';
+                append(snprintf(out + pos, outSize - pos, spec, reinterpret_cast<void*>(static_cast<uintptr_t>(value))));
+                break;
+            default:
+            {
+                const char* text = reinterpret_cast<const char*>(static_cast<uintptr_t>(value));
+                spec[specLen++] = 's';
+                spec[specLen] = '\0';
+                append(snprintf(out + pos, outSize - pos, spec, text ? text : "(null)"));
+                break;
+            }
+        }
+    }
+    out[pos] = '\0';
+}
+
+static const char* LevelTag(uint8_t level)
+{
+    switch (level)
+    {
+        case ELogLevel_CRITICAL: return "CRIT";
+        case ELogLevel_WARNING:  return "WARN";
+        case ELogLevel_INFO:     return "INFO";
+        case ELogLevel_DEBUG:    return "DEBUG";
+        default:                 return "TRACE";
+    }
+}
+
+void Tracing::Flush()
+{
+    TraceRecord batch[64];
+    char text[512];
+    bool wroteFile = false;
+
+    for (;;)
+    {
+        size_t count = g_ring.PopBatch(batch, sizeof(batch) / sizeof(batch[0]));
+        if (count == 0)
+            break;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            FormatRecord(batch[i], text, sizeof(text));
+            if (g_file)
+            {
+                fprintf(g_file, "[%12.6f] %-5s %s\n", static_cast<double>(batch[i].timestampNs) * 1e-9,
+                        LevelTag(batch[i].level), text);
+                wroteFile = true;
+            }
+            else
+            {
+                Log::Write(static_cast<ELogLevel>(batch[i].level), text);
+            }
+        }
+    }
+
+    uint64_t dropped = g_dropped.load(std::memory_order_relaxed);
+    if (dropped != g_droppedReported)
+    {
+        snprintf(text, sizeof(text), "Tracing: %llu records dropped (ring full)",
+                 static_cast<unsigned long long>(dropped - g_droppedReported));
+        g_droppedReported = dropped;
+        if (g_file)
+        {
+            fprintf(g_file, "%s\n", text);
+            wroteFile = true;
+        }
+        else
+        {
+            Log::Write(ELogLevel_WARNING, text);
+        }
+    }
+
+    if (wroteFile)
+        fflush(g_file);
+}
+
+void Tracing::Shutdown()
+{
+    Flush();
+    SetSink(std::string());
+}
+
+uint64_t Tracing::Dropped()
+{
+    return g_dropped.load(std::memory_order_relaxed);
+}
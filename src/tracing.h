@@ -0,0 +1,117 @@
+///----------------------------------------------------------------------------------------------------
+/// Tracing - Level-gated, lazily formatted diagnostics for the event hot paths
+///
+/// STREAMLINK_TRACE(level, format, args...) costs one relaxed load and a branch when the level is
+/// disabled: the arguments are not evaluated and nothing is formatted. When enabled it copies the
+/// format pointer and the raw argument values into a compact binary record on a lock-free ring.
+/// The writer thread drains the ring, formats each record and hands the text to the sink (the Nexus
+/// log or a trace file).
+///
+/// Because formatting happens later, format must be a string literal and every %s argument must
+/// point to storage that outlives the record (string literals, static tables). Up to MaxArgs
+/// arguments are supported.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_TRACING_H
+#define STREAMLINK_TRACING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "Nexus.h"
+
+namespace Tracing
+{
+    constexpr int    LevelOff = 0;
+    constexpr size_t MaxArgs = 6;
+
+    /// Current level, cached for the hot path. Records at or below it (CRITICAL=1 .. TRACE=5) pass.
+    extern std::atomic<int> g_level;
+
+    inline bool IsEnabled(ELogLevel level)
+    {
+        return static_cast<int>(level) <= g_level.load(std::memory_order_relaxed);
+    }
+
+    /// Sets the level at runtime (LevelOff disables everything).
+    void SetLevel(int level);
+    int  Level();
+
+    /// Parses "off", "critical", "warning", "info", "debug" or "trace".
+    bool ParseLevel(const char* text, int& level);
+
+    /// Sends formatted records to the Nexus log (empty path) or appends them to a file.
+    void SetSink(const std::string& filePath);
+
+    /// Formats and emits every pending record. Consumer side: writer thread or shutdown only.
+    void Flush();
+
+    /// Flushes and closes the trace file.
+    void Shutdown();
+
+    /// Records lost because the ring was full.
+    uint64_t Dropped();
+
+    /// Enqueues a record; use STREAMLINK_TRACE instead of calling this directly.
+    void Push(ELogLevel level, const char* format, const uint64_t* args, size_t argCount);
+
+    ///------------------------------------------------------------------------------------------------
+    /// Argument capture: every argument is stored as 64 raw bits and reinterpreted at format time
+    ///------------------------------------------------------------------------------------------------
+    template <typename T>
+    inline typename std::enable_if<std::is_integral<T>::value, uint64_t>::type ToArg(T value)
+    {
+        using Wide = typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type;
+        return static_cast<uint64_t>(static_cast<Wide>(value));
+    }
+
+    template <typename T>
+    inline typename std::enable_if<std::is_enum<T>::value, uint64_t>::type ToArg(T value)
+    {
+        return ToArg(static_cast<typename std::underlying_type<T>::type>(value));
+    }
+
+    template <typename T>
+    inline typename std::enable_if<std::is_floating_point<T>::value, uint64_t>::type ToArg(T value)
+    {
+        double d = static_cast<double>(value);
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        return bits;
+    }
+
+    template <typename T>
+    inline uint64_t ToArg(T* value)
+    {
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value));
+    }
+
+    template <typename... Args>
+    inline void Emit(ELogLevel level, const char* format, Args... args)
+    {
+        static_assert(sizeof...(Args) <= MaxArgs, "too many trace arguments");
+        const uint64_t packed[sizeof...(Args) + 1] = {ToArg(args)..., 0};
+        Push(level, format, packed, sizeof...(Args));
+    }
+
+    /// Never called; lets the compiler check trace formats like printf formats.
+#if defined(__GNUC__)
+    __attribute__((format(printf, 1, 2)))
+#endif
+    inline void CheckFormat(const char*, ...) {}
+}
+
+#define STREAMLINK_TRACE(level, ...)                      \
+    do                                                    \
+    {                                                     \
+        if (Tracing::IsEnabled(level))                    \
+        {                                                 \
+            if (false) Tracing::CheckFormat(__VA_ARGS__); \
+            Tracing::Emit(level, __VA_ARGS__);            \
+        }                                                 \
+    } while (0)
+
+#endif
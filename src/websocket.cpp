@@ -0,0 +1,184 @@
+///----------------------------------------------------------------------------------------------------
+/// WebSocket - The parts of RFC 6455 the overlay server needs
+///----------------------------------------------------------------------------------------------------
+
+#include "websocket.h"
+
+#include <cstring>
+
+static uint32_t RotateLeft(uint32_t value, int bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Sha1Block - Process one 64-byte block
+///----------------------------------------------------------------------------------------------------
+static void Sha1Block(uint32_t state[5], const uint8_t block[64])
+{
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++)
+    {
+        w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) |
+               (uint32_t(block[i * 4 + 2]) << 8) | uint32_t(block[i * 4 + 3]);
+    }
+    for (int i = 16; i < 80; i++)
+        w[i] = RotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (int i = 0; i < 80; i++)
+    {
+        uint32_t f, k;
+        if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+        else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+        else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+        else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+
+        uint32_t temp = RotateLeft(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = RotateLeft(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+void WebSocket::Sha1(const void* data, size_t length, uint8_t digest[20])
+{
+    uint32_t state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    size_t offset = 0;
+    for (; offset + 64 <= length; offset += 64)
+        Sha1Block(state, bytes + offset);
+
+    // Final block(s): remaining bytes, 0x80, zero padding, 64-bit big-endian bit length
+    uint8_t tail[128] = {};
+    size_t remaining = length - offset;
+    memcpy(tail, bytes + offset, remaining);
+    tail[remaining] = 0x80;
+    size_t tailSize = (remaining + 1 + 8 <= 64) ? 64 : 128;
+    uint64_t bitLength = static_cast<uint64_t>(length) * 8;
+    for (int i = 0; i < 8; i++)
+        tail[tailSize - 1 - i] = static_cast<uint8_t>(bitLength >> (i * 8));
+
+    Sha1Block(state, tail);
+    if (tailSize == 128)
+        Sha1Block(state, tail + 64);
+
+    for (int i = 0; i < 5; i++)
+    {
+        digest[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+    }
+}
+
+void WebSocket::AcceptKey(const char* clientKey, size_t clientKeyLength, char* out)
+{
+    static const char Guid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    static const char Base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    char combined[128];
+    if (clientKeyLength > sizeof(combined) - sizeof(Guid))
+        clientKeyLength = sizeof(combined) - sizeof(Guid);
+    memcpy(combined, clientKey, clientKeyLength);
+    memcpy(combined + clientKeyLength, Guid, sizeof(Guid) - 1);
+
+    uint8_t digest[21] = {};
+    Sha1(combined, clientKeyLength + sizeof(Guid) - 1, digest);
+
+    // 20 bytes -> 28 base64 characters, the last one padding
+    size_t pos = 0;
+    for (size_t i = 0; i < 20; i += 3)
+    {
+        uint32_t group = (uint32_t(digest[i]) << 16) | (uint32_t(digest[i + 1]) << 8) |
+                         (i + 2 < 20 ? uint32_t(digest[i + 2]) : 0);
+        out[pos++] = Base64[(group >> 18) & 0x3F];
+        out[pos++] = Base64[(group >> 12) & 0x3F];
+        out[pos++] = Base64[(group >> 6) & 0x3F];
+        out[pos++] = (i + 2 < 20) ? Base64[group & 0x3F] : '=';
+    }
+    out[pos] = '\0';
+}
+
+size_t WebSocket::EncodeHeader(uint8_t opcode, uint64_t payloadLength, uint8_t* out)
+{
+    out[0] = static_cast<uint8_t>(0x80 | (opcode & 0x0F));
+    if (payloadLength < 126)
+    {
+        out[1] = static_cast<uint8_t>(payloadLength);
+        return 2;
+    }
+    if (payloadLength <= 0xFFFF)
+    {
+        out[1] = 126;
+        out[2] = static_cast<uint8_t>(payloadLength >> 8);
+        out[3] = static_cast<uint8_t>(payloadLength);
+        return 4;
+    }
+
+    out[1] = 127;
+    for (int i = 0; i < 8; i++)
+        out[2 + i] = static_cast<uint8_t>(payloadLength >> ((7 - i) * 8));
+    return 10;
+}
+
+bool WebSocket::ParseFrame(const uint8_t* data, size_t length, Frame& frame)
+{
+    if (length < 2)
+        return false;
+
+    frame.final = (data[0] & 0x80) != 0;
+    frame.opcode = data[0] & 0x0F;
+    frame.masked = (data[1] & 0x80) != 0;
+
+    uint64_t payloadLength = data[1] & 0x7F;
+    size_t pos = 2;
+    if (payloadLength == 126)
+    {
+        if (length < 4)
+            return false;
+        payloadLength = (uint64_t(data[2]) << 8) | data[3];
+        pos = 4;
+    }
+    else if (payloadLength == 127)
+    {
+        if (length < 10)
+            return false;
+        payloadLength = 0;
+        for (int i = 0; i < 8; i++)
+            payloadLength = (payloadLength << 8) | data[2 + i];
+        pos = 10;
+    }
+
+    if (frame.masked)
+    {
+        if (length < pos + 4)
+            return false;
+        memcpy(frame.mask, data + pos, 4);
+        pos += 4;
+    }
+
+    if (payloadLength > length - pos)
+        return false;
+
+    frame.headerSize = pos;
+    frame.payloadLength = static_cast<size_t>(payloadLength);
+    return true;
+}
+
+void WebSocket::Unmask(const Frame& frame, uint8_t* payload)
+{
+    if (!frame.masked)
+        return;
+    for (size_t i = 0; i < frame.payloadLength; i++)
+        payload[i] ^= frame.mask[i & 3];
+}
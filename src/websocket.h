@@ -0,0 +1,59 @@
+///----------------------------------------------------------------------------------------------------
+/// WebSocket - The parts of RFC 6455 the overlay server needs
+///
+/// Handshake key derivation (SHA-1 + base64), unmasked server frames and parsing of masked client
+/// frames. No extensions, no fragmentation on send; fragmented client messages are ignored.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_WEBSOCKET_H
+#define STREAMLINK_WEBSOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace WebSocket
+{
+    enum EOpcode : uint8_t
+    {
+        Opcode_Continuation = 0x0,
+        Opcode_Text         = 0x1,
+        Opcode_Binary       = 0x2,
+        Opcode_Close        = 0x8,
+        Opcode_Ping         = 0x9,
+        Opcode_Pong         = 0xA
+    };
+
+    /// Length of a Sec-WebSocket-Accept value, without terminator.
+    constexpr size_t AcceptKeyLength = 28;
+
+    /// Sec-WebSocket-Accept for a client's Sec-WebSocket-Key. out must hold AcceptKeyLength + 1.
+    void AcceptKey(const char* clientKey, size_t clientKeyLength, char* out);
+
+    /// Largest header EncodeHeader writes.
+    constexpr size_t MaxHeaderSize = 10;
+
+    /// Writes a final, unmasked frame header for a payload of the given length; returns its size.
+    size_t EncodeHeader(uint8_t opcode, uint64_t payloadLength, uint8_t* out);
+
+    struct Frame
+    {
+        uint8_t  opcode;
+        bool     final;
+        size_t   headerSize;      // bytes before the payload
+        size_t   payloadLength;
+        uint8_t  mask[4];
+        bool     masked;
+    };
+
+    /// Parses a frame header at the start of data. Returns false until the whole frame (header and
+    /// payload) is available.
+    bool ParseFrame(const uint8_t* data, size_t length, Frame& frame);
+
+    /// Unmasks a client payload in place.
+    void Unmask(const Frame& frame, uint8_t* payload);
+
+    /// SHA-1 of a buffer (exposed for tests).
+    void Sha1(const void* data, size_t length, uint8_t digest[20]);
+}
+
+#endif
@@ -0,0 +1,220 @@
+///----------------------------------------------------------------------------------------------------
+/// Stub AddonAPI - In-process stand-in for Nexus used by host tests and benchmarks
+///----------------------------------------------------------------------------------------------------
+
+#include "stub_addon_api.h"
+#include "event_queue.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    struct Subscription
+    {
+        std::string   identifier;
+        EVENT_CONSUME callback;
+    };
+
+    AddonAPI                  g_api = {};
+    std::string               g_gameDir;
+    std::string               g_addonDirBuffer;
+    std::vector<Subscription> g_subscriptions;
+    std::vector<std::string>  g_alerts;
+    std::vector<std::string>  g_logs;
+    std::mutex                g_recordMutex;
+    bool                      g_recordDebugLogs = true;
+}
+
+static void StubLog(ELogLevel level, const char* channel, const char* message)
+{
+    (void)channel;
+    if (!g_recordDebugLogs && level >= ELogLevel_DEBUG)
+        return;
+    std::lock_guard<std::mutex> lock(g_recordMutex);
+    g_logs.push_back(message);
+}
+
+static void StubSendAlert(const char* message)
+{
+    std::lock_guard<std::mutex> lock(g_recordMutex);
+    g_alerts.push_back(message);
+}
+
+static const char* StubGetGameDirectory()
+{
+    return g_gameDir.c_str();
+}
+
+static const char* StubGetAddonDirectory(const char* name)
+{
+    g_addonDirBuffer = g_gameDir + "/addons/" + (name ? name : "");
+    return g_addonDirBuffer.c_str();
+}
+
+static void StubRaise(const char* identifier, void* eventData)
+{
+    StubApi::Raise(identifier, eventData);
+}
+
+static void StubRaiseNotification(const char* identifier)
+{
+    StubApi::Raise(identifier, nullptr);
+}
+
+static void StubSubscribe(const char* identifier, EVENT_CONSUME callback)
+{
+    g_subscriptions.push_back({identifier, callback});
+}
+
+static void StubUnsubscribe(const char* identifier, EVENT_CONSUME callback)
+{
+    for (size_t i = 0; i < g_subscriptions.size(); i++)
+    {
+        if (g_subscriptions[i].identifier == identifier && g_subscriptions[i].callback == callback)
+        {
+            g_subscriptions.erase(g_subscriptions.begin() + static_cast<std::ptrdiff_t>(i));
+            return;
+        }
+    }
+}
+
+AddonAPI* StubApi::Create(const char* testName)
+{
+    Destroy();
+
+    const char* tmp = getenv("TMPDIR");
+    std::string pattern = std::string(tmp && tmp[0] ? tmp : "/tmp") + "/streamlink_" + testName + "_XXXXXX";
+    std::vector<char> buffer(pattern.begin(), pattern.end());
+    buffer.push_back('\0');
+    if (!mkdtemp(buffer.data()))
+        return nullptr;
+    g_gameDir = buffer.data();
+
+    g_api = {};
+    g_api.Log = StubLog;
+    g_api.GUI_SendAlert = StubSendAlert;
+    g_api.Paths_GetGameDirectory = StubGetGameDirectory;
+    g_api.Paths_GetAddonDirectory = StubGetAddonDirectory;
+    g_api.Events_Raise = StubRaise;
+    g_api.Events_RaiseNotification = StubRaiseNotification;
+    g_api.Events_Subscribe = StubSubscribe;
+    g_api.Events_Unsubscribe = StubUnsubscribe;
+    return &g_api;
+}
+
+void StubApi::Destroy()
+{
+    if (!g_gameDir.empty())
+    {
+        std::string command = "rm -rf '" + g_gameDir + "'";
+        if (system(command.c_str()) != 0)
+            fprintf(stderr, "warning: could not remove %s\n", g_gameDir.c_str());
+    }
+    g_gameDir.clear();
+    g_subscriptions.clear();
+    ClearRecorded();
+}
+
+void StubApi::Raise(const char* identifier, void* eventArgs)
+{
+    for (size_t i = 0; i < g_subscriptions.size(); i++)
+    {
+        if (g_subscriptions[i].identifier == identifier)
+            g_subscriptions[i].callback(eventArgs);
+    }
+
+    // Combat records are processed on the event queue worker; keep raises synchronous for tests
+    EventQueue::WaitProcessed();
+}
+
+size_t StubApi::SubscriberCount(const char* identifier)
+{
+    size_t count = 0;
+    for (const Subscription& sub : g_subscriptions)
+    {
+        if (sub.identifier == identifier)
+            count++;
+    }
+    return count;
+}
+
+EVENT_CONSUME StubApi::Subscriber(const char* identifier)
+{
+    for (const Subscription& sub : g_subscriptions)
+    {
+        if (sub.identifier == identifier)
+            return sub.callback;
+    }
+    return nullptr;
+}
+
+const std::string& StubApi::GameDirectory()
+{
+    return g_gameDir;
+}
+
+std::string StubApi::AddonDirectory()
+{
+    return g_gameDir + "/addons/streamlink";
+}
+
+std::string StubApi::GamePath(const char* relativePath)
+{
+    return g_gameDir + "/" + relativePath;
+}
+
+void StubApi::WriteSettings(const char* contents)
+{
+    std::string addons = g_gameDir + "/addons";
+    mkdir(addons.c_str(), 0755);
+    mkdir(AddonDirectory().c_str(), 0755);
+
+    std::string path = AddonDirectory() + "/settings.txt";
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f)
+        return;
+    fputs(contents, f);
+    fclose(f);
+}
+
+std::string StubApi::ReadFile(const std::string& path)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f)
+        return "<missing>";
+
+    std::string contents;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+        contents.append(buffer, n);
+    fclose(f);
+    return contents;
+}
+
+const std::vector<std::string>& StubApi::Alerts()
+{
+    return g_alerts;
+}
+
+const std::vector<std::string>& StubApi::Logs()
+{
+    return g_logs;
+}
+
+void StubApi::ClearRecorded()
+{
+    std::lock_guard<std::mutex> lock(g_recordMutex);
+    g_alerts.clear();
+    g_logs.clear();
+}
+
+void StubApi::SetRecordDebugLogs(bool record)
+{
+    g_recordDebugLogs = record;
+}
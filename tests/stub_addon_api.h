@@ -0,0 +1,53 @@
+///----------------------------------------------------------------------------------------------------
+/// Stub AddonAPI - In-process stand-in for Nexus used by host tests and benchmarks
+///
+/// Records event subscriptions so tests can raise synthetic payloads through the real handlers, keeps
+/// alerts and log lines for inspection, and points the game directory at a scratch folder.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_STUB_ADDON_API_H
+#define STREAMLINK_STUB_ADDON_API_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Nexus.h"
+
+namespace StubApi
+{
+    /// Builds the API with a fresh scratch game directory under the system temp folder.
+    AddonAPI* Create(const char* testName);
+
+    /// Removes the scratch directory and forgets everything recorded.
+    void Destroy();
+
+    /// Delivers a payload to every subscriber of the identifier, like Nexus would.
+    void Raise(const char* identifier, void* eventArgs);
+
+    size_t SubscriberCount(const char* identifier);
+
+    /// First callback subscribed to the identifier, or nullptr. Lets benchmarks skip the lookup.
+    EVENT_CONSUME Subscriber(const char* identifier);
+
+    const std::string& GameDirectory();
+    std::string AddonDirectory();
+
+    /// Convenience: full path of a file under the game directory.
+    std::string GamePath(const char* relativePath);
+
+    /// Writes <addon dir>/settings.txt, creating the directory.
+    void WriteSettings(const char* contents);
+
+    /// Reads a whole file, or returns "<missing>".
+    std::string ReadFile(const std::string& path);
+
+    const std::vector<std::string>& Alerts();
+    const std::vector<std::string>& Logs();
+    void ClearRecorded();
+
+    /// Drop DEBUG/TRACE log lines instead of recording them (benchmarks).
+    void SetRecordDebugLogs(bool record);
+}
+
+#endif
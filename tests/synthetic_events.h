@@ -0,0 +1,203 @@
+///----------------------------------------------------------------------------------------------------
+/// Synthetic Events - Builders for ArcDPS / Unofficial Extras payloads and a fake MumbleLink
+///
+/// Each SyntheticCombatEvent owns its CombatEvent and agents, so the EvCombatData it hands out stays
+/// valid for as long as the object lives, just like a real payload during its callback.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_SYNTHETIC_EVENTS_H
+#define STREAMLINK_SYNTHETIC_EVENTS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+#include "ArcDPS.h"
+#include "UnofficialExtras.h"
+#include "mumble_link.h"
+#include "shared_memory.h"
+
+/// Agent description used by the builders
+struct SyntheticAgent
+{
+    uintptr_t   id = 0;
+    uint32_t    profession = 0;
+    uint16_t    team = 0;
+    bool        isSelf = false;
+    const char* name = nullptr;
+};
+
+constexpr uint32_t ProfessionGuardian = 1;
+constexpr uint32_t ProfessionRevenant = 9;
+constexpr uint32_t SpeciesNpc = 0x1234;   // NPCs report a species ID instead of a profession
+
+struct SyntheticCombatEvent
+{
+    ArcDPS::CombatEvent ev = {};
+    ArcDPS::AgentShort  src = {};
+    ArcDPS::AgentShort  dst = {};
+    EvCombatData        data = {};
+    char                nameStorage[2][64] = {};
+
+    SyntheticCombatEvent() = default;
+    SyntheticCombatEvent(const SyntheticCombatEvent& other) { *this = other; }
+    SyntheticCombatEvent& operator=(const SyntheticCombatEvent& other)
+    {
+        ev = other.ev;
+        src = other.src;
+        dst = other.dst;
+        data = other.data;
+        memcpy(nameStorage, other.nameStorage, sizeof(nameStorage));
+        Relink(other);
+        return *this;
+    }
+
+    void SetAgents(const SyntheticAgent& source, const SyntheticAgent& destination)
+    {
+        Fill(src, source, nameStorage[0]);
+        Fill(dst, destination, nameStorage[1]);
+        data.src = &src;
+        data.dst = &dst;
+        ev.SourceAgent = source.id;
+        ev.DestinationAgent = destination.id;
+    }
+
+private:
+    static void Fill(ArcDPS::AgentShort& agent, const SyntheticAgent& desc, char* storage)
+    {
+        agent.ID = desc.id;
+        agent.Profession = desc.profession;
+        agent.Team = desc.team;
+        agent.IsSelf = desc.isSelf ? 1 : 0;
+        agent.Name = nullptr;
+        if (desc.name)
+        {
+            snprintf(storage, 64, "%s", desc.name);
+            agent.Name = storage;
+        }
+    }
+
+    void Relink(const SyntheticCombatEvent& other)
+    {
+        data.ev = other.data.ev ? &ev : nullptr;
+        data.src = other.data.src ? &src : nullptr;
+        data.dst = other.data.dst ? &dst : nullptr;
+        src.Name = other.src.Name ? nameStorage[0] : nullptr;
+        dst.Name = other.dst.Name ? nameStorage[1] : nullptr;
+    }
+};
+
+/// Null-ev agent notification, as sent when ArcDPS starts tracking an agent
+inline SyntheticCombatEvent MakeAgentAdded(const SyntheticAgent& agent)
+{
+    SyntheticCombatEvent e;
+    e.SetAgents(agent, SyntheticAgent{});
+    e.data.ev = nullptr;
+    e.data.dst = nullptr;
+    return e;
+}
+
+/// Null-ev agent notification for an agent leaving tracking (reported with profession 0)
+inline SyntheticCombatEvent MakeAgentRemoved(const SyntheticAgent& agent)
+{
+    SyntheticAgent removed = agent;
+    removed.profession = 0;
+    return MakeAgentAdded(removed);
+}
+
+/// Null-ev target change notification: src is the new target, with profession 0 and elite 1
+inline SyntheticCombatEvent MakeTargetChanged(const SyntheticAgent& target)
+{
+    SyntheticCombatEvent e = MakeAgentRemoved(target);
+    e.src.Specialization = 1;
+    return e;
+}
+
+/// Non-statechange strike with the given result
+inline SyntheticCombatEvent MakeStrike(uint64_t time, const SyntheticAgent& source, const SyntheticAgent& target,
+                                       uint8_t result, uint32_t skillId = 0, int32_t value = 0)
+{
+    SyntheticCombatEvent e;
+    e.SetAgents(source, target);
+    e.ev.Time = time;
+    e.ev.Result = result;
+    e.ev.SkillID = skillId;
+    e.ev.Value = value;
+    e.ev.IFF = ArcDPS::IFF_FOE;
+    e.data.ev = &e.ev;
+    return e;
+}
+
+inline SyntheticCombatEvent MakeKillingBlow(uint64_t time, const SyntheticAgent& killer, const SyntheticAgent& victim,
+                                            uint32_t skillId = 0)
+{
+    return MakeStrike(time, killer, victim, ArcDPS::CBTR_KILLINGBLOW, skillId);
+}
+
+/// State change about source (CBTS_CHANGEDOWN, CBTS_SPAWN, ...). Some state changes carry their
+/// value in dst_agent, e.g. CBTS_HEALTHPCTUPDATE as percent * 100.
+inline SyntheticCombatEvent MakeStateChange(uint64_t time, const SyntheticAgent& source, uint8_t statechange,
+                                            uint64_t dstAgentValue = 0)
+{
+    SyntheticCombatEvent e;
+    e.SetAgents(source, SyntheticAgent{});
+    e.ev.Time = time;
+    e.ev.IsStatechange = statechange;
+    e.ev.DestinationAgent = dstAgentValue;
+    e.data.ev = &e.ev;
+    return e;
+}
+
+inline UnofficialExtras::UserInfo MakeUser(const char* accountName, UnofficialExtras::UserRole role,
+                                           uint8_t subgroup = 0, bool ready = false,
+                                           UnofficialExtras::ChannelType type = UnofficialExtras::ChannelType::Squad)
+{
+    UnofficialExtras::UserInfo user = {};
+    user.AccountName = accountName;
+    user.Role = role;
+    user.Subgroup = subgroup;
+    user.ReadyStatus = ready;
+    user.GroupType = type;
+    return user;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// FakeMumbleLink - Creates a process-unique MumbleLink region the addon can open by name
+///----------------------------------------------------------------------------------------------------
+class FakeMumbleLink
+{
+public:
+    bool Create(const char* suffix)
+    {
+        snprintf(m_name, sizeof(m_name), "StreamlinkMumble_%d_%s", static_cast<int>(getpid()), suffix);
+        if (!m_memory.Create(m_name, sizeof(LinkedMem)))
+            return false;
+        memset(m_memory.Data(), 0, sizeof(LinkedMem));
+        return true;
+    }
+
+    const char* Name() const { return m_name; }
+    LinkedMem* Mem() { return static_cast<LinkedMem*>(m_memory.Data()); }
+
+    void SetMap(uint32_t mapType, uint32_t mapId)
+    {
+        MumbleContext* ctx = reinterpret_cast<MumbleContext*>(Mem()->context);
+        ctx->mapType = mapType;
+        ctx->mapId = mapId;
+        Mem()->uiTick++;
+    }
+
+    void Tick() { Mem()->uiTick++; }
+
+private:
+    SharedMemory m_memory;
+    char         m_name[96] = {};
+};
+
+constexpr uint32_t MapTypeEternalBattlegrounds = 9;
+constexpr uint32_t MapTypePublic = 5;
+constexpr uint32_t MapIdEternalBattlegrounds = 38;
+constexpr uint32_t MapIdLionsArch = 50;
+
+#endif
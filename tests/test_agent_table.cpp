@@ -0,0 +1,173 @@
+///----------------------------------------------------------------------------------------------------
+/// Agent table tests - insert/update/evict, incremental counts, deletion with probe runs, capacity,
+/// allocations
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "agent_table.h"
+#include "test_common.h"
+
+// Counts heap allocations so tests can check that table updates never allocate
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        abort();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+/// Counts by walking the table the slow way, to check the incremental ones
+static uint32_t CountByLookup(const AgentTable& table, uint64_t firstId, uint64_t count, PlayerStatus status)
+{
+    uint32_t n = 0;
+    for (uint64_t id = firstId; id < firstId + count; id++)
+    {
+        const AgentEntry* entry = table.Find(id);
+        if (entry && entry->Status == status)
+            n++;
+    }
+    return n;
+}
+
+static void TestSetUpdateRemove()
+{
+    AgentTable table;
+    CHECK_EQ(table.Size(), 0u);
+    CHECK(table.Find(0x1000) == nullptr);
+
+    CHECK(table.Set(0x1000, PlayerStatus::Alive, 1, 7));
+    CHECK(table.Set(0x1001, PlayerStatus::Downed, 4, 7));
+    CHECK_EQ(table.Size(), 2u);
+    CHECK_EQ(table.Count(PlayerStatus::Alive), 1u);
+    CHECK_EQ(table.Count(PlayerStatus::Downed), 1u);
+
+    const AgentEntry* entry = table.Find(0x1001);
+    CHECK(entry != nullptr);
+    if (entry)
+    {
+        CHECK_EQ(entry->Profession, 4u);
+        CHECK_EQ(entry->Team, uint16_t(7));
+        CHECK(entry->Status == PlayerStatus::Downed);
+    }
+
+    // Same values again are not a change; a new state moves the counts
+    CHECK(!table.Set(0x1000, PlayerStatus::Alive, 1, 7));
+    CHECK(table.SetStatus(0x1000, PlayerStatus::Dead));
+    CHECK(!table.SetStatus(0x1000, PlayerStatus::Dead));
+    CHECK(!table.SetStatus(0x2000, PlayerStatus::Dead));   // unknown agents are not added
+    CHECK_EQ(table.Count(PlayerStatus::Alive), 0u);
+    CHECK_EQ(table.Count(PlayerStatus::Dead), 1u);
+    CHECK_EQ(table.Size(), 2u);
+
+    CHECK(table.Remove(0x1000));
+    CHECK(!table.Remove(0x1000));
+    CHECK_EQ(table.Count(PlayerStatus::Dead), 0u);
+    CHECK_EQ(table.Size(), 1u);
+
+    table.Clear();
+    CHECK_EQ(table.Size(), 0u);
+    CHECK_EQ(table.Count(PlayerStatus::Downed), 0u);
+}
+
+static void TestRemovalKeepsOtherAgentsReachable()
+{
+    AgentTable table;
+    const uint64_t first = 5000;
+    const uint64_t count = AgentTable::MaxAgents;
+    static const PlayerStatus States[3] = {PlayerStatus::Alive, PlayerStatus::Downed, PlayerStatus::Dead};
+    for (uint64_t i = 0; i < count; i++)
+        table.Set(first + i, States[i % 3], 1 + static_cast<uint32_t>(i % 9), 3);
+    CHECK_EQ(table.Size(), size_t(count));
+
+    // Evict every fourth agent; the rest must still be found through shifted probe runs
+    for (uint64_t i = 0; i < count; i += 4)
+        table.Remove(first + i);
+
+    bool allCorrect = true;
+    size_t found = 0;
+    for (uint64_t i = 0; i < count; i++)
+    {
+        const AgentEntry* entry = table.Find(first + i);
+        bool expected = (i % 4) != 0;
+        if ((entry != nullptr) != expected)
+            allCorrect = false;
+        if (entry)
+        {
+            found++;
+            if (entry->Status != States[i % 3] || entry->Profession != 1 + i % 9)
+                allCorrect = false;
+        }
+    }
+    CHECK(allCorrect);
+    CHECK_EQ(found, table.Size());
+    for (PlayerStatus status : States)
+        CHECK_EQ(table.Count(status), CountByLookup(table, first, count, status));
+}
+
+static void TestFullTableIgnoresNewAgents()
+{
+    AgentTable table;
+    for (uint64_t id = 1; id <= AgentTable::MaxAgents; id++)
+        table.Set(id, PlayerStatus::Alive, 1, 1);
+
+    CHECK(!table.Set(AgentTable::MaxAgents + 1, PlayerStatus::Alive, 1, 1));
+    CHECK_EQ(table.Size(), AgentTable::MaxAgents);
+    CHECK_EQ(table.Count(PlayerStatus::Alive), uint32_t(AgentTable::MaxAgents));
+
+    // Existing agents still update, and a freed slot takes a new agent
+    CHECK(table.SetStatus(1, PlayerStatus::Downed));
+    CHECK(table.Remove(2));
+    CHECK(table.Set(AgentTable::MaxAgents + 1, PlayerStatus::Alive, 1, 1));
+    CHECK(table.Find(AgentTable::MaxAgents + 1) != nullptr);
+}
+
+static void TestChurnDoesNotAllocate()
+{
+    AgentTable* table = new AgentTable();
+    size_t before = g_allocations.load();
+
+    // Agents spawning, changing state and despawning through a long fight
+    for (uint64_t round = 0; round < 200; round++)
+    {
+        for (uint64_t i = 0; i < 60; i++)
+        {
+            uint64_t id = round * 17 + i;
+            table->Set(id, PlayerStatus::Alive, 2, 5);
+            table->SetStatus(id, (i & 1) ? PlayerStatus::Downed : PlayerStatus::Dead);
+        }
+        for (uint64_t i = 0; i < 60; i += 2)
+            table->Remove(round * 17 + i);
+    }
+
+    CHECK_EQ(g_allocations.load(), before);
+    CHECK(table->Size() <= AgentTable::MaxAgents);
+    CHECK_EQ(table->Count(PlayerStatus::Alive) + table->Count(PlayerStatus::Downed) +
+             table->Count(PlayerStatus::Dead), uint32_t(table->Size()));
+    delete table;
+}
+
+int main()
+{
+    RUN_TEST(TestSetUpdateRemove);
+    RUN_TEST(TestRemovalKeepsOtherAgentsReachable);
+    RUN_TEST(TestFullTableIgnoresNewAgents);
+    RUN_TEST(TestChurnDoesNotAllocate);
+    return TEST_MAIN_RESULT();
+}
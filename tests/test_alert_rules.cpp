@@ -0,0 +1,185 @@
+///----------------------------------------------------------------------------------------------------
+/// Alert rule tests - rule parsing, each trigger's lookup, file slots, message formatting
+///----------------------------------------------------------------------------------------------------
+
+#include <string>
+
+#include "alert_rules.h"
+#include "test_common.h"
+
+static const uint32_t Milestones[] = {5, 10};
+
+static AlertRules Compile(const char* const* lines, size_t count)
+{
+    AlertRules rules;
+    for (size_t i = 0; i < count; i++)
+        CHECK(rules.Add(lines[i]));
+    rules.Compile(Milestones, 2);
+    return rules;
+}
+
+static void TestParse()
+{
+    AlertRules rules;
+    CHECK(rules.Add("streak 3, 1,3 | alert Streak {n} | event EV_TEST_STREAK"));
+    CHECK(rules.Add("kills_every 10 | file out/kills.txt {n} kills"));
+    CHECK(rules.Add("best_streak|alert"));
+    CHECK(rules.Add("squad_size 20,10 | file out/squad.txt"));
+    CHECK_EQ(rules.Count(), size_t(5));   // plus the built-in milestone rule
+
+    const AlertRule& streak = rules.Rule(1);
+    CHECK_EQ(streak.Trigger, AlertTrigger_Streak);
+    CHECK_EQ(streak.Actions, uint8_t(AlertAction_Alert | AlertAction_Event));
+    CHECK_EQ(streak.ValueCount, uint8_t(2));
+    CHECK(streak.Values[0] == 1 && streak.Values[1] == 3);
+    CHECK(streak.AlertMessage == "Streak {n}");
+    CHECK(streak.EventName == "EV_TEST_STREAK");
+
+    CHECK(rules.Rule(2).FilePath == "out/kills.txt" && rules.Rule(2).FileMessage == "{n} kills");
+    CHECK(rules.Rule(3).AlertMessage == "New best streak: {n}!");
+    CHECK(rules.Rule(4).FileMessage == "{n}");
+
+    // Malformed rules are rejected whole
+    CHECK(!rules.Add(""));
+    CHECK(!rules.Add("streak 5"));                   // no action
+    CHECK(!rules.Add("streak | alert"));             // no values
+    CHECK(!rules.Add("streak 2000 | alert"));        // past MaxThreshold
+    CHECK(!rules.Add("kills_every 5,10 | alert"));   // one interval per rule
+    CHECK(!rules.Add("best_streak 3 | alert"));
+    CHECK(!rules.Add("deaths 3 | alert"));
+    CHECK(!rules.Add("streak 3 | shout"));
+    CHECK(!rules.Add("streak 3 | file"));
+    CHECK(!rules.Add("streak 3 | event two words"));
+    CHECK_EQ(rules.Count(), size_t(5));
+}
+
+static void TestStreakAndBuiltIn()
+{
+    const char* lines[] = {"streak 3,10 | event EV_TEST"};
+    AlertRules rules = Compile(lines, 1);
+    AlertRuleState state;
+    state.Begin(0, 0);
+
+    uint32_t fired[11] = {};
+    for (uint32_t streak = 1; streak <= 10; streak++)
+        fired[streak] = rules.OnKill(state, streak, streak, streak);
+    CHECK_EQ(fired[3], 2u);
+    CHECK_EQ(fired[5], 1u);          // milestones= rule
+    CHECK_EQ(fired[10], 3u);         // both
+    CHECK_EQ(fired[4] | fired[6] | fired[9], 0u);
+
+    // No milestones: the built-in rule is off
+    AlertRules none;
+    none.Compile(nullptr, 0);
+    CHECK_EQ(none.OnKill(state, 5, 5, 11), 0u);
+}
+
+static void TestKillsEvery()
+{
+    const char* lines[] = {"kills_every 3 | alert", "kills_every 4 | alert"};
+    AlertRules rules = Compile(lines, 2);
+    AlertRuleState state;
+    state.Begin(0, 0);
+
+    std::string log;
+    for (uint32_t kills = 1; kills <= 12; kills++)
+    {
+        // Streak resets every other kill so the built-in rule stays quiet
+        uint32_t fired = rules.OnKill(state, 1 + (kills & 1), 2, kills);
+        if (fired)
+            log += std::to_string(kills) + ":" + std::to_string(fired) + " ";
+    }
+    CHECK(log == "3:2 4:4 6:2 8:4 9:2 12:6 ");
+
+    // New rules mid-session start from the current count, not from zero
+    const char* other[] = {"kills_every 5 | alert"};
+    AlertRules reloaded = Compile(other, 1);
+    CHECK_EQ(reloaded.OnKill(state, 1, 2, 14), 0u);
+    CHECK_EQ(reloaded.OnKill(state, 2, 2, 15), 2u);
+}
+
+static void TestBestStreak()
+{
+    const char* lines[] = {"best_streak | alert"};
+    AlertRules rules = Compile(lines, 1);
+    AlertRuleState state;
+    state.Begin(0, 0);
+
+    // The first streak of a session has no previous best to beat
+    CHECK_EQ(rules.OnKill(state, 1, 1, 1), 0u);
+    CHECK_EQ(rules.OnKill(state, 2, 2, 2), 0u);
+
+    // After a death: fires once, on the kill that passes 2
+    CHECK_EQ(rules.OnKill(state, 1, 2, 3), 0u);
+    CHECK_EQ(rules.OnKill(state, 2, 2, 4), 0u);
+    CHECK_EQ(rules.OnKill(state, 3, 3, 5), 2u);
+    CHECK_EQ(rules.OnKill(state, 4, 4, 6), 0u);
+
+    // Restored mid-streak below the best: still fires when the best is passed
+    state.Begin(2, 4);
+    CHECK_EQ(rules.OnKill(state, 3, 4, 7), 0u);
+    CHECK_EQ(rules.OnKill(state, 4, 4, 8), 0u);
+    CHECK_EQ(rules.OnKill(state, 5, 5, 9), 3u);   // and milestone 5
+}
+
+static void TestSquadSize()
+{
+    const char* lines[] = {"squad_size 10,20 | alert", "squad_size 15 | alert"};
+    AlertRules rules = Compile(lines, 2);
+
+    CHECK_EQ(rules.OnSquadSize(0, 9), 0u);
+    CHECK_EQ(rules.OnSquadSize(9, 10), 2u);
+    CHECK_EQ(rules.OnSquadSize(10, 10), 0u);
+    CHECK_EQ(rules.OnSquadSize(12, 8), 0u);      // shrinking never fires
+    CHECK_EQ(rules.OnSquadSize(8, 16), 6u);      // a jump crosses 10 and 15 at once
+    CHECK_EQ(rules.OnSquadSize(16, 20), 2u);
+    CHECK_EQ(rules.OnSquadSize(20, 5000), 0u);   // past MaxThreshold is clamped
+}
+
+static void TestFileSlots()
+{
+    const char* lines[] = {"streak 2 | file a.txt", "streak 3 | file b.txt", "squad_size 5 | file a.txt {n} up"};
+    AlertRules rules = Compile(lines, 3);
+    CHECK(rules.FilePath(0) == "a.txt");
+    CHECK(rules.FilePath(1) == "b.txt");
+    CHECK(rules.FilePath(2).empty());
+    CHECK_EQ(rules.Rule(3).FileSlot, uint8_t(0));
+
+    CHECK(rules.SameRules(Compile(lines, 3)));
+    CHECK(!rules.SameRules(Compile(lines, 2)));
+}
+
+static void TestFormat()
+{
+    char buffer[32];
+    CHECK_EQ(AlertRules::Format("Killstreak: {n}!", 25, buffer, sizeof(buffer)), size_t(15));
+    CHECK(std::string(buffer) == "Killstreak: 25!");
+    AlertRules::Format("{n}/{n} {x}", 7, buffer, sizeof(buffer));
+    CHECK(std::string(buffer) == "7/7 {x}");
+    CHECK_EQ(AlertRules::Format("a long message that does not fit", 1, buffer, 8), size_t(7));
+}
+
+static void TestTableLimit()
+{
+    AlertRules rules;
+    for (size_t i = 1; i < AlertRules::MaxRules; i++)
+        CHECK(rules.Add("streak " + std::to_string(i) + " | alert"));
+    CHECK(!rules.Add("streak 99 | alert"));
+
+    rules.Compile(Milestones, 2);
+    AlertRuleState state;
+    CHECK_EQ(rules.OnKill(state, 31, 31, 31), uint32_t(1) << 31);
+}
+
+int main()
+{
+    RUN_TEST(TestParse);
+    RUN_TEST(TestStreakAndBuiltIn);
+    RUN_TEST(TestKillsEvery);
+    RUN_TEST(TestBestStreak);
+    RUN_TEST(TestSquadSize);
+    RUN_TEST(TestFileSlots);
+    RUN_TEST(TestFormat);
+    RUN_TEST(TestTableLimit);
+    return TEST_MAIN_RESULT();
+}
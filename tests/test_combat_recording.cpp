@@ -0,0 +1,268 @@
+///----------------------------------------------------------------------------------------------------
+/// Combat recording tests - round trip of every field, name interning, delta sizes, name table
+/// resets, damaged and unknown records
+///----------------------------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "combat_recording.h"
+#include "synthetic_events.h"
+#include "test_common.h"
+
+static const SyntheticAgent Self{0x100, ProfessionGuardian, 1, true, "Self"};
+static const SyntheticAgent Enemy{0x200, ProfessionRevenant, 2, false, "Enemy.1234"};
+
+static RecordedCombat Capture(const SyntheticCombatEvent& e, ECombatSource source = CombatSource_Local)
+{
+    RecordedCombat combat;
+    CaptureCombat(e.data, source, combat);
+    return combat;
+}
+
+static bool SameAgent(const RecordedAgent& a, const RecordedAgent& b)
+{
+    return a.ID == b.ID && a.Profession == b.Profession && a.Specialization == b.Specialization &&
+           a.IsSelf == b.IsSelf && a.Team == b.Team && strcmp(a.Name, b.Name) == 0;
+}
+
+static bool SameCombat(const RecordedCombat& a, const RecordedCombat& b)
+{
+    if (a.EventId != b.EventId || a.Revision != b.Revision || a.Source != b.Source || a.Flags != b.Flags ||
+        strcmp(a.SkillName, b.SkillName) != 0)
+    {
+        return false;
+    }
+    if ((a.Flags & Recorded_HasEvent) && memcmp(&a.Ev, &b.Ev, sizeof(a.Ev)) != 0)
+        return false;
+    if ((a.Flags & Recorded_HasSrc) && !SameAgent(a.Src, b.Src))
+        return false;
+    return !(a.Flags & Recorded_HasDst) || SameAgent(a.Dst, b.Dst);
+}
+
+static std::vector<uint8_t> Encode(const std::vector<RecordedCombat>& combats)
+{
+    RecordingEncoder encoder;
+    std::vector<uint8_t> bytes;
+    encoder.Begin(1234567890123ull, bytes);
+    for (const RecordedCombat& combat : combats)
+        encoder.Combat(combat, bytes);
+    return bytes;
+}
+
+static size_t CountCombat(RecordingReader& reader)
+{
+    size_t count = 0;
+    RecordingEntry entry;
+    while (reader.Next(entry))
+        count += entry.Kind == RecordingEntry::Combat;
+    return count;
+}
+
+static void TestRoundTripEveryField()
+{
+    std::vector<RecordedCombat> combats;
+
+    SyntheticCombatEvent strike = MakeStrike(1000, Self, Enemy, ArcDPS::CBTR_CRIT, 5555, -1234);
+    strike.data.id = 77;
+    strike.data.revision = 1;
+    strike.data.skillname = const_cast<char*>("Whirling Axe");
+    strike.src.Specialization = 27;
+    strike.ev.BuffDamage = 99;
+    strike.ev.OverstackValue = 3;
+    strike.ev.SourceInstanceID = 10;
+    strike.ev.DestinationInstanceID = 11;
+    strike.ev.SrcMasterInstanceID = 12;
+    strike.ev.DestinationMasterInstanceID = 13;
+    strike.ev.IsBuffRemove = 2;
+    strike.ev.IsFlanking = 1;
+    strike.ev.PAD64 = 0xAB;
+    combats.push_back(Capture(strike, CombatSource_Squad));
+
+    // Agent notification: no event, no destination; then an event with an empty skill name
+    SyntheticCombatEvent added = MakeAgentAdded(Enemy);
+    added.data.id = 78;
+    combats.push_back(Capture(added));
+    SyntheticCombatEvent health = MakeStateChange(1001, Self, ArcDPS::CBTS_HEALTHPCTUPDATE, 5000);
+    health.data.id = 79;
+    health.data.skillname = const_cast<char*>("");
+    combats.push_back(Capture(health));
+
+    // Agent ids that differ from the event's fields, and a null name
+    SyntheticCombatEvent odd = MakeKillingBlow(900, Self, SyntheticAgent{0x300, ProfessionRevenant, 2, false, nullptr});
+    odd.data.id = 80;
+    odd.ev.SourceAgent = 0xFFFFFFFFFFFF;
+    combats.push_back(Capture(odd));
+
+    std::vector<uint8_t> bytes = Encode(combats);
+    RecordingReader reader;
+    CHECK(reader.Open(bytes.data(), bytes.size()));
+    CHECK_EQ(reader.StartedAtMs(), 1234567890123ull);
+
+    RecordingEntry entry;
+    for (const RecordedCombat& expected : combats)
+    {
+        CHECK(reader.Next(entry));
+        CHECK(entry.Kind == RecordingEntry::Combat);
+        CHECK(SameCombat(entry.CombatData, expected));
+    }
+    CHECK(!reader.Next(entry));
+    CHECK(!reader.Damaged());
+
+    // Null and empty names stay apart
+    CHECK(combats[2].Flags & Recorded_SkillName);
+    CHECK(!(combats[1].Flags & Recorded_SkillName));
+    CHECK(!(combats[3].Flags & Recorded_DstName));
+    CHECK(!(combats[1].Flags & Recorded_HasEvent));
+}
+
+static void TestSquadUpdateRoundTrip()
+{
+    UnofficialExtras::UserInfo users[3] = {
+        MakeUser("Lead.1111", UnofficialExtras::UserRole::SquadLeader, 1, true, UnofficialExtras::ChannelType::Squad),
+        MakeUser("Member.2222", UnofficialExtras::UserRole::Member, 3, false, UnofficialExtras::ChannelType::Squad),
+        MakeUser(nullptr, UnofficialExtras::UserRole::None, 0, false, UnofficialExtras::ChannelType::Party)};
+    users[0].JoinTime = 1700000000;
+    users[1].JoinTime = 1700000005;
+
+    RecordedUser recorded[3];
+    for (int i = 0; i < 3; i++)
+        CaptureUser(users[i], recorded[i]);
+
+    RecordingEncoder encoder;
+    std::vector<uint8_t> bytes;
+    encoder.Begin(0, bytes);
+    encoder.SquadUpdate(recorded, 3, bytes);
+    encoder.SquadUpdate(recorded, 0, bytes);
+
+    RecordingReader reader;
+    CHECK(reader.Open(bytes.data(), bytes.size()));
+    RecordingEntry entry;
+    CHECK(reader.Next(entry));
+    CHECK(entry.Kind == RecordingEntry::SquadUpdate);
+    CHECK_EQ(entry.Users.size(), 3u);
+    for (size_t i = 0; i < entry.Users.size() && i < 3; i++)
+    {
+        const RecordedUser& user = entry.Users[i];
+        CHECK(strcmp(user.AccountName, recorded[i].AccountName) == 0);
+        CHECK_EQ(user.HasName, recorded[i].HasName);
+        CHECK_EQ(user.JoinTime, recorded[i].JoinTime);
+        CHECK_EQ(user.Role, recorded[i].Role);
+        CHECK_EQ(user.Subgroup, recorded[i].Subgroup);
+        CHECK_EQ(user.ReadyStatus, recorded[i].ReadyStatus);
+        CHECK_EQ(user.GroupType, recorded[i].GroupType);
+    }
+    CHECK(!entry.Users[2].HasName);
+    CHECK(reader.Next(entry));
+    CHECK(entry.Users.empty());
+    CHECK(!reader.Next(entry));
+    CHECK(!reader.Damaged());
+}
+
+static void TestRepeatedEventsAreSmall()
+{
+    // A steady stream of strikes between the same agents with the same skill
+    std::vector<RecordedCombat> combats;
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        SyntheticCombatEvent strike = MakeStrike(5000 + i * 3, Self, Enemy, ArcDPS::CBTR_NORMAL, 5555, 1500);
+        strike.data.id = 100 + i;
+        strike.data.skillname = const_cast<char*>("Whirling Axe");
+        combats.push_back(Capture(strike));
+    }
+    std::vector<uint8_t> bytes = Encode(combats);
+
+    // Each name appears once in the file
+    std::string text(bytes.begin(), bytes.end());
+    CHECK(text.find("Whirling Axe") != std::string::npos);
+    CHECK(text.find("Whirling Axe", text.find("Whirling Axe") + 1) == std::string::npos);
+    CHECK(text.find("Enemy.1234", text.find("Enemy.1234") + 1) == std::string::npos);
+
+    // Under 40 bytes a record, against 64 for the CombatEvent alone
+    CHECK(bytes.size() < combats.size() * 40);
+
+    RecordingReader reader;
+    CHECK(reader.Open(bytes.data(), bytes.size()));
+    CHECK_EQ(CountCombat(reader), combats.size());
+}
+
+static void TestNameTableResets()
+{
+    RecordingEncoder encoder;
+    std::vector<uint8_t> bytes;
+    encoder.Begin(0, bytes);
+
+    std::vector<std::string> names;
+    std::vector<RecordedCombat> combats;
+    for (uint32_t i = 0; i < RecordingEncoder::MaxNames + 100; i++)
+        names.push_back("Player." + std::to_string(i));
+    for (uint32_t i = 0; i < names.size(); i++)
+    {
+        SyntheticAgent target{0x200 + i, ProfessionRevenant, 2, false, names[i].c_str()};
+        SyntheticCombatEvent strike = MakeStrike(i, Self, target, ArcDPS::CBTR_NORMAL);
+        strike.data.id = i;
+        combats.push_back(Capture(strike));
+        encoder.Combat(combats.back(), bytes);
+    }
+    CHECK(encoder.NameCount() < RecordingEncoder::MaxNames);
+
+    // Every record still decodes to its own names
+    RecordingReader reader;
+    CHECK(reader.Open(bytes.data(), bytes.size()));
+    RecordingEntry entry;
+    size_t i = 0;
+    for (; reader.Next(entry); i++)
+    {
+        if (i < combats.size() && !SameCombat(entry.CombatData, combats[i]))
+            break;
+    }
+    CHECK_EQ(i, combats.size());
+    CHECK(!reader.Damaged());
+}
+
+static void TestDamagedAndUnknownRecords()
+{
+    std::vector<RecordedCombat> combats;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        SyntheticCombatEvent strike = MakeStrike(10 + i, Self, Enemy, ArcDPS::CBTR_NORMAL, 1);
+        strike.data.id = i;
+        combats.push_back(Capture(strike));
+    }
+    std::vector<uint8_t> bytes = Encode(combats);
+
+    // A record type from a newer version is skipped
+    std::vector<uint8_t> withUnknown(bytes.begin(), bytes.begin() + CombatRecording::HeaderSize);
+    withUnknown.insert(withUnknown.end(), {3, 0x7F, 1, 2});
+    withUnknown.insert(withUnknown.end(), bytes.begin() + CombatRecording::HeaderSize, bytes.end());
+    RecordingReader reader;
+    CHECK(reader.Open(withUnknown.data(), withUnknown.size()));
+    CHECK_EQ(CountCombat(reader), 3u);
+    CHECK(!reader.Damaged());
+
+    // Cut off mid-record: the complete records before it are kept
+    CHECK(reader.Open(bytes.data(), bytes.size() - 2));
+    CHECK_EQ(CountCombat(reader), 2u);
+    CHECK(reader.Damaged());
+
+    // Not a recording
+    CHECK(!reader.Open(bytes.data(), CombatRecording::HeaderSize - 1));
+    std::vector<uint8_t> wrongMagic = bytes;
+    wrongMagic[0] = 'X';
+    CHECK(!reader.Open(wrongMagic.data(), wrongMagic.size()));
+    std::vector<uint8_t> wrongVersion = bytes;
+    wrongVersion[4] = CombatRecording::Version + 1;
+    CHECK(!reader.Open(wrongVersion.data(), wrongVersion.size()));
+}
+
+int main()
+{
+    RUN_TEST(TestRoundTripEveryField);
+    RUN_TEST(TestSquadUpdateRoundTrip);
+    RUN_TEST(TestRepeatedEventsAreSmall);
+    RUN_TEST(TestNameTableResets);
+    RUN_TEST(TestDamagedAndUnknownRecords);
+    return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,47 @@
+///----------------------------------------------------------------------------------------------------
+/// Test Common - Minimal assertion helpers for the host test executables
+///
+/// Each test is a plain executable registered with CTest; it returns non-zero if any CHECK failed.
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_TEST_COMMON_H
+#define STREAMLINK_TEST_COMMON_H
+
+#include <cstdio>
+
+static int g_testFailures = 0;
+
+#define CHECK(cond)                                                                 \
+    do                                                                              \
+    {                                                                               \
+        if (!(cond))                                                                \
+        {                                                                           \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            g_testFailures++;                                                       \
+        }                                                                           \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                      \
+    do                                                                                      \
+    {                                                                                       \
+        auto _va = (a);                                                                     \
+        auto _vb = (b);                                                                     \
+        if (!(_va == _vb))                                                                  \
+        {                                                                                   \
+            fprintf(stderr, "%s:%d: CHECK_EQ failed: %s == %s (%lld vs %lld)\n", __FILE__, \
+                    __LINE__, #a, #b, (long long)_va, (long long)_vb);                     \
+            g_testFailures++;                                                               \
+        }                                                                                   \
+    } while (0)
+
+#define RUN_TEST(fn)                           \
+    do                                         \
+    {                                          \
+        int _before = g_testFailures;          \
+        fn();                                  \
+        printf("%s %s\n", g_testFailures == _before ? "[ OK ]" : "[FAIL]", #fn); \
+    } while (0)
+
+#define TEST_MAIN_RESULT() (g_testFailures == 0 ? 0 : 1)
+
+#endif
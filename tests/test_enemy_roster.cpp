@@ -0,0 +1,188 @@
+///----------------------------------------------------------------------------------------------------
+/// Enemy roster tests - per-team counts, team changes, timer wheel aging, long gaps, capacity,
+/// allocations
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "enemy_roster.h"
+#include "test_common.h"
+
+// Counts heap allocations so tests can check that roster updates never allocate
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        abort();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+static constexpr uint16_t Red = 705;
+static constexpr uint16_t Blue = 432;
+static constexpr uint16_t Green = 2739;
+
+static void TestTeamCounts()
+{
+    EnemyRoster roster;
+    CHECK(roster.Seen(1, Red, 1000));
+    CHECK(roster.Seen(2, Red, 1000));
+    CHECK(roster.Seen(3, Blue, 1000));
+    CHECK(!roster.Seen(1, Red, 2000));   // refresh only
+    CHECK_EQ(roster.Size(), size_t(3));
+    CHECK_EQ(roster.TeamCount(Red), 2u);
+    CHECK_EQ(roster.TeamCount(Blue), 1u);
+    CHECK_EQ(roster.TeamCount(Green), 0u);
+
+    // Team change moves the count
+    CHECK(roster.Seen(2, Green, 2000));
+    CHECK_EQ(roster.TeamCount(Red), 1u);
+    CHECK_EQ(roster.TeamCount(Green), 1u);
+
+    EnemyTeamCount teams[EnemyRoster::MaxTeams];
+    size_t count = roster.Teams(teams, EnemyRoster::MaxTeams);
+    CHECK_EQ(count, size_t(3));
+    uint32_t total = 0;
+    for (size_t t = 0; t < count; t++)
+        total += teams[t].Count;
+    CHECK_EQ(total, 3u);
+
+    CHECK(roster.Remove(3));
+    CHECK(!roster.Remove(3));
+    CHECK_EQ(roster.TeamCount(Blue), 0u);
+    CHECK_EQ(roster.Teams(teams, EnemyRoster::MaxTeams), size_t(2));
+
+    roster.Clear();
+    CHECK_EQ(roster.Size(), size_t(0));
+    CHECK(!roster.Contains(1));
+}
+
+static void TestAgingOnTheWheel()
+{
+    EnemyRoster roster(10000);
+    roster.Expire(100000);
+    roster.Seen(1, Red, 100000);
+    roster.Seen(2, Red, 100000);
+    roster.Seen(3, Blue, 105000);
+
+    // Agent 1 keeps being seen; 2 goes quiet; 3 is seen later
+    for (uint64_t t = 101000; t <= 112000; t += 1000)
+    {
+        roster.Seen(1, Red, t);
+        roster.Expire(t);
+    }
+    CHECK(roster.Contains(1));
+    CHECK(!roster.Contains(2));   // quiet for more than 10 s
+    CHECK(roster.Contains(3));
+    CHECK_EQ(roster.TeamCount(Red), 1u);
+
+    // Nothing is dropped before its full timeout
+    CHECK_EQ(roster.Expire(114000), size_t(0));
+    CHECK(roster.Contains(3));
+    CHECK_EQ(roster.Expire(116000), size_t(1));
+    CHECK(!roster.Contains(3));
+    CHECK_EQ(roster.TeamCount(Blue), 0u);
+
+    CHECK_EQ(roster.Expire(123000), size_t(1));
+    CHECK_EQ(roster.Size(), size_t(0));
+}
+
+static void TestLongGapExpiresEverything()
+{
+    EnemyRoster roster(30000);
+    for (uint64_t id = 1; id <= 100; id++)
+        roster.Seen(id, (id & 1) ? Red : Green, 5000 + id);
+
+    // Far past every timeout and more than a full wheel turn later
+    CHECK_EQ(roster.Expire(5000000), size_t(100));
+    CHECK_EQ(roster.Size(), size_t(0));
+    CHECK_EQ(roster.TeamCount(Red), 0u);
+
+    // The wheel keeps working afterwards
+    roster.Seen(7, Blue, 5000500);
+    CHECK_EQ(roster.Expire(5020000), size_t(0));
+    CHECK_EQ(roster.Expire(5040000), size_t(1));
+}
+
+static void TestCapacityAndTeamSlots()
+{
+    EnemyRoster roster;
+    for (uint64_t id = 1; id <= EnemyRoster::MaxAgents; id++)
+        CHECK(roster.Seen(id * 977, Red, 1000));
+    CHECK(!roster.Seen(99999999, Red, 1000));
+    CHECK_EQ(roster.Size(), EnemyRoster::MaxAgents);
+    CHECK_EQ(roster.TeamCount(Red), uint32_t(EnemyRoster::MaxAgents));
+
+    // Every other agent despawns; the rest stay reachable through shifted probe runs
+    for (uint64_t id = 1; id <= EnemyRoster::MaxAgents; id += 2)
+        roster.Remove(id * 977);
+    bool reachable = true;
+    for (uint64_t id = 1; id <= EnemyRoster::MaxAgents; id++)
+        reachable = reachable && roster.Contains(id * 977) == ((id & 1) == 0);
+    CHECK(reachable);
+    CHECK_EQ(roster.TeamCount(Red), uint32_t(EnemyRoster::MaxAgents / 2));
+
+    // Team slots are finite; a new agent on one team too many is ignored
+    roster.Clear();
+    for (uint16_t t = 0; t < EnemyRoster::MaxTeams; t++)
+        CHECK(roster.Seen(t + 1, static_cast<uint16_t>(100 + t), 1000));
+    CHECK(!roster.Seen(50, 999, 1000));
+    CHECK(!roster.Seen(1, 999, 1000));   // existing agent keeps its team
+    CHECK_EQ(roster.TeamCount(100), 1u);
+}
+
+static void TestZergChurnDoesNotAllocate()
+{
+    EnemyRoster* roster = new EnemyRoster(20000);
+    size_t before = g_allocations.load();
+
+    // Waves of 200 players spawning, fighting and leaving, some despawns lost
+    uint64_t time = 1000000;
+    for (uint64_t wave = 0; wave < 50; wave++)
+    {
+        for (uint64_t i = 0; i < 200; i++)
+            roster->Seen(wave * 1000 + i, (i % 3) == 0 ? Red : Blue, time);
+        for (uint64_t step = 0; step < 10; step++)
+        {
+            time += 500;
+            for (uint64_t i = 0; i < 200; i += 7)
+                roster->Seen(wave * 1000 + i, (i % 3) == 0 ? Red : Blue, time);
+            roster->Expire(time);
+        }
+        for (uint64_t i = 0; i < 200; i += 2)
+            roster->Remove(wave * 1000 + i);
+    }
+
+    CHECK_EQ(g_allocations.load(), before);
+    CHECK(roster->Size() <= EnemyRoster::MaxAgents);
+    CHECK_EQ(roster->TeamCount(Red) + roster->TeamCount(Blue), uint32_t(roster->Size()));
+
+    roster->Expire(time + 60000);
+    CHECK_EQ(roster->Size(), size_t(0));
+    delete roster;
+}
+
+int main()
+{
+    RUN_TEST(TestTeamCounts);
+    RUN_TEST(TestAgingOnTheWheel);
+    RUN_TEST(TestLongGapExpiresEverything);
+    RUN_TEST(TestCapacityAndTeamSlots);
+    RUN_TEST(TestZergChurnDoesNotAllocate);
+    return TEST_MAIN_RESULT();
+}
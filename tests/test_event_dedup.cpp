@@ -0,0 +1,113 @@
+///----------------------------------------------------------------------------------------------------
+/// Event dedup tests - cross-feed copies dropped in any order, same-feed repeats kept, lagging feeds
+///----------------------------------------------------------------------------------------------------
+
+#include <cstdint>
+
+#include "combat_record.h"
+#include "event_dedup.h"
+#include "test_common.h"
+
+static CombatRecord Strike(uint64_t time, uint64_t src, uint64_t dst, int32_t value, ECombatSource source)
+{
+    CombatRecord record = {};
+    record.Flags = CombatRecord_HasEvent | CombatRecord_HasSrc | CombatRecord_HasDst;
+    record.Time = time;
+    record.SrcId = src;
+    record.DstId = dst;
+    record.Value = value;
+    record.SkillId = 5491;
+    record.Source = source;
+    return record;
+}
+
+static void TestCopiesDroppedInEitherOrder()
+{
+    EventDedup dedup;
+    CHECK(dedup.Accept(Strike(100, 1, 2, 500, CombatSource_Local)));
+    CHECK(!dedup.Accept(Strike(100, 1, 2, 500, CombatSource_Squad)));
+    CHECK(dedup.Accept(Strike(101, 1, 2, 500, CombatSource_Squad)));
+    CHECK(!dedup.Accept(Strike(101, 1, 2, 500, CombatSource_Local)));
+
+    // Per-feed fields do not make copies look different
+    CombatRecord local = Strike(102, 1, 2, 500, CombatSource_Local);
+    CombatRecord squad = local;
+    squad.Source = CombatSource_Squad;
+    squad.Id = local.Id + 77;
+    squad.Flags |= CombatRecord_SrcIsSelf;
+    CHECK(dedup.Accept(local));
+    CHECK(!dedup.Accept(squad));
+    CHECK_EQ(dedup.Duplicates(), uint64_t(3));
+}
+
+static void TestDifferentEventsAreKept()
+{
+    EventDedup dedup;
+    CHECK(dedup.Accept(Strike(100, 1, 2, 500, CombatSource_Local)));
+    CHECK(dedup.Accept(Strike(100, 1, 2, 501, CombatSource_Squad)));   // another amount
+    CHECK(dedup.Accept(Strike(100, 1, 3, 500, CombatSource_Squad)));   // another target
+    CHECK(dedup.Accept(Strike(100, 4, 2, 500, CombatSource_Squad)));   // another source
+
+    CombatRecord down = Strike(100, 1, 2, 500, CombatSource_Squad);
+    down.Result = ArcDPS::CBTR_DOWNED;
+    CHECK(dedup.Accept(down));
+
+    // Agent notifications mean different things on each feed
+    CombatRecord added = {};
+    added.Flags = CombatRecord_HasSrc;
+    CHECK(dedup.Accept(added));
+    added.Source = CombatSource_Squad;
+    CHECK(dedup.Accept(added));
+    CHECK_EQ(dedup.Duplicates(), uint64_t(0));
+}
+
+static void TestSameFeedRepeatsMatchOneForOne()
+{
+    // A multi-hit skill lands three identical hits; the other feed reports the same three
+    EventDedup dedup;
+    size_t accepted = 0;
+    for (int i = 0; i < 3; i++)
+        accepted += dedup.Accept(Strike(100, 1, 2, 500, CombatSource_Local)) ? 1 : 0;
+    accepted += dedup.Accept(Strike(100, 1, 2, 500, CombatSource_Squad)) ? 1 : 0;
+    accepted += dedup.Accept(Strike(100, 1, 2, 500, CombatSource_Squad)) ? 1 : 0;
+    accepted += dedup.Accept(Strike(100, 1, 2, 500, CombatSource_Local)) ? 1 : 0;   // a fourth hit
+    accepted += dedup.Accept(Strike(100, 1, 2, 500, CombatSource_Squad)) ? 1 : 0;
+    accepted += dedup.Accept(Strike(100, 1, 2, 500, CombatSource_Squad)) ? 1 : 0;
+    CHECK_EQ(accepted, size_t(4));
+    CHECK_EQ(dedup.Duplicates(), uint64_t(4));
+}
+
+static void TestInterleavedStreams()
+{
+    // Both feeds replay the same 5000 events, the squad feed lagging 64 events behind and swapping
+    // neighbours
+    EventDedup dedup;
+    const uint64_t Events = 5000;
+    const uint64_t Lag = 64;
+    size_t accepted = 0;
+    for (uint64_t i = 0; i < Events + Lag; i++)
+    {
+        if (i < Events)
+            accepted += dedup.Accept(Strike(1000 + i, 1, 2 + i % 7, 100 + i % 13, CombatSource_Local)) ? 1 : 0;
+        if (i >= Lag)
+        {
+            uint64_t j = (i - Lag) ^ 1;
+            accepted += dedup.Accept(Strike(1000 + j, 1, 2 + j % 7, 100 + j % 13, CombatSource_Squad)) ? 1 : 0;
+        }
+    }
+    CHECK_EQ(accepted, size_t(Events));
+    CHECK_EQ(dedup.Duplicates(), uint64_t(Events));
+
+    dedup.Clear();
+    CHECK_EQ(dedup.Duplicates(), uint64_t(0));
+    CHECK(dedup.Accept(Strike(1000, 1, 2, 100, CombatSource_Squad)));
+}
+
+int main()
+{
+    RUN_TEST(TestCopiesDroppedInEitherOrder);
+    RUN_TEST(TestDifferentEventsAreKept);
+    RUN_TEST(TestSameFeedRepeatsMatchOneForOne);
+    RUN_TEST(TestInterleavedStreams);
+    return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,182 @@
+///----------------------------------------------------------------------------------------------------
+/// Event filter tests - expression parsing, short-circuit layout, field semantics, counter definitions
+///----------------------------------------------------------------------------------------------------
+
+#include <string>
+
+#include "combat_counters.h"
+#include "event_filter.h"
+#include "test_common.h"
+
+static CombatRecord MakeRecord(uint8_t result, uint32_t skill, bool srcSelf, uint32_t dstProfession, int32_t value = 0)
+{
+    CombatRecord record = {};
+    record.Flags = CombatRecord_HasEvent | CombatRecord_HasSrc | CombatRecord_HasDst |
+                   (srcSelf ? CombatRecord_SrcIsSelf : 0);
+    record.Result = result;
+    record.SkillId = skill;
+    record.DstProfession = dstProfession;
+    record.Value = value;
+    record.Iff = ArcDPS::IFF_FOE;
+    return record;
+}
+
+static bool Matches(const char* expression, const CombatRecord& record)
+{
+    EventFilter filter;
+    CHECK(filter.Compile(expression));
+    return filter.Matches(MakeFilterFields(record));
+}
+
+static void TestKillExpression()
+{
+    EventFilter filter;
+    CHECK(filter.Compile("result==KILLINGBLOW && src.self && dst.profession in 1..9 && skill==12345"));
+    CHECK_EQ(filter.TestCount(), size_t(4));
+
+    CHECK(filter.Matches(MakeFilterFields(MakeRecord(ArcDPS::CBTR_KILLINGBLOW, 12345, true, 9))));
+    CHECK(!filter.Matches(MakeFilterFields(MakeRecord(ArcDPS::CBTR_KILLINGBLOW, 12345, false, 9))));
+    CHECK(!filter.Matches(MakeFilterFields(MakeRecord(ArcDPS::CBTR_KILLINGBLOW, 12345, true, 0x1234))));
+    CHECK(!filter.Matches(MakeFilterFields(MakeRecord(ArcDPS::CBTR_KILLINGBLOW, 999, true, 1))));
+    CHECK(!filter.Matches(MakeFilterFields(MakeRecord(ArcDPS::CBTR_DOWNED, 12345, true, 1))));
+
+    // An uncompiled filter matches nothing
+    EventFilter empty;
+    CHECK(!empty.Matches(MakeFilterFields(MakeRecord(0, 0, false, 0))));
+}
+
+static void TestOperators()
+{
+    CombatRecord strike = MakeRecord(ArcDPS::CBTR_CRIT, 100, true, 1, -250);
+
+    CHECK(Matches("skill!=5", strike));
+    CHECK(!Matches("skill!=100", strike));
+    CHECK(Matches("skill<101 && skill<=100 && skill>99 && skill>=100", strike));
+    CHECK(!Matches("skill<100", strike));
+    CHECK(!Matches("skill>100", strike));
+
+    // Signed fields keep their order
+    CHECK(Matches("value<0", strike));
+    CHECK(Matches("value in -300..-200", strike));
+    CHECK(!Matches("value>=0", strike));
+    CHECK(Matches("value>-251", strike));
+
+    // Named constants belong to their field
+    CHECK(Matches("result==CRIT && iff==FOE && dst.profession==GUARDIAN", strike));
+    CHECK(Matches("result==1", strike));
+
+    // Numbers are decimal even with a leading zero; hex needs 0x
+    CHECK(Matches("skill==0100", strike));
+    CHECK(Matches("skill==0x64 && skill==0X64", strike));
+    CHECK(Matches("value in -0x100..-0250", strike));
+    CHECK(Matches("dst.self==0 && !dst.self", strike));
+}
+
+static void TestPrecedenceAndNegation()
+{
+    CombatRecord strike = MakeRecord(ArcDPS::CBTR_NORMAL, 7, false, 3);
+
+    // && binds tighter than ||
+    CHECK(Matches("skill==1 || skill==7 && dst.profession==3", strike));
+    CHECK(!Matches("(skill==1 || skill==7) && dst.profession==4", strike));
+    CHECK(Matches("skill==1 && dst.profession==4 || skill==7", strike));
+
+    // ! over a group swaps both outcomes of everything inside
+    CHECK(Matches("!(skill==1 || dst.profession==4)", strike));
+    CHECK(!Matches("!(skill==7 && dst.profession==3)", strike));
+    CHECK(Matches("!!(skill==7)", strike));
+    CHECK(Matches("!(skill==7 && !src.self) || dst.profession in 3..3", strike));
+}
+
+static void TestRejected()
+{
+    static const char* const bad[] = {
+        "",
+        "result==",
+        "result==NOPE",
+        "skill==KILLINGBLOW",
+        "nosuch==1",
+        "skill==1.5",
+        "skill==99999999999",
+        "skill==0x",
+        "skill==0x1g",
+        "(result==1",
+        "result==1)",
+        "result==1 &&",
+        "&& result==1",
+        "skill in 5..1",
+        "skill in 1",
+        "result==1 2",
+        "!=1",
+        "result=1",
+    };
+    for (const char* expression : bad)
+    {
+        EventFilter filter;
+        if (filter.Compile(expression))
+            fprintf(stderr, "accepted: %s\n", expression);
+        CHECK_EQ(filter.TestCount(), size_t(0));
+    }
+
+    // MaxTests comparisons fit, one more does not
+    std::string expression = "skill==0";
+    for (size_t i = 1; i < EventFilter::MaxTests; i++)
+        expression += " || skill==" + std::to_string(i);
+    EventFilter filter;
+    CHECK(filter.Compile(expression));
+    CHECK(filter.Matches(MakeFilterFields(MakeRecord(0, 31, false, 0))));
+    CHECK(!filter.Compile(expression + " || skill==99"));
+    CHECK_EQ(filter.TestCount(), EventFilter::MaxTests);   // unchanged
+
+    std::string deep(40, '(');
+    CHECK(!filter.Compile(deep + "skill==1" + std::string(40, ')')));
+}
+
+static void TestCounters()
+{
+    CombatCounters counters;
+    CHECK(counters.Add("kills | result==KILLINGBLOW && src.self"));
+    CHECK(counters.Add("crits|result==CRIT|file overlay/crits.txt"));
+    CHECK(counters.Add("foes | iff==FOE"));
+    CHECK(counters.Add("control | result==INTERRUPT || result==CROWDCONTROL | file cc.txt"));
+    CHECK_EQ(counters.Count(), size_t(4));
+    CHECK(counters.Counter(3).Expression == "result==INTERRUPT || result==CROWDCONTROL");
+    CHECK(counters.Counter(3).FilePath == "cc.txt");
+    CHECK(counters.Counter(0).FilePath == "addons/streamlink/kills.txt");
+    CHECK(counters.Counter(1).FilePath == "overlay/crits.txt");
+    CHECK(counters.Counter(1).Expression == "result==CRIT");
+
+    CHECK(!counters.Add("kills | skill==1"));           // name taken
+    CHECK(!counters.Add("bad name | skill==1"));
+    CHECK(!counters.Add("nofilter"));
+    CHECK(!counters.Add("broken | skill=="));
+    CHECK(!counters.Add("x | skill==1 | alert hi"));
+    CHECK(!counters.Add("x | skill==1 | file "));
+    CHECK_EQ(counters.Count(), size_t(4));
+
+    CHECK_EQ(counters.Match(MakeRecord(ArcDPS::CBTR_KILLINGBLOW, 0, true, 1)), 5u);
+    CHECK_EQ(counters.Match(MakeRecord(ArcDPS::CBTR_CRIT, 0, true, 1)), 6u);
+
+    // Agent notifications have no event fields to test
+    CombatRecord notification = {};
+    notification.Iff = ArcDPS::IFF_FOE;
+    CHECK_EQ(counters.Match(notification), 0u);
+
+    CombatCounters same;
+    CHECK(same.Add("kills | result==KILLINGBLOW && src.self"));
+    CHECK(same.Add("crits|result==CRIT|file overlay/crits.txt"));
+    CHECK(!same.SameCounters(counters));
+    CHECK(same.Add("foes | iff==FOE"));
+    CHECK(same.Add("control | result==INTERRUPT || result==CROWDCONTROL | file cc.txt"));
+    CHECK(same.SameCounters(counters));
+}
+
+int main()
+{
+    RUN_TEST(TestKillExpression);
+    RUN_TEST(TestOperators);
+    RUN_TEST(TestPrecedenceAndNegation);
+    RUN_TEST(TestRejected);
+    RUN_TEST(TestCounters);
+    return TEST_MAIN_RESULT();
+}
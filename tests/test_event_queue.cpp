@@ -0,0 +1,244 @@
+///----------------------------------------------------------------------------------------------------
+/// Event queue tests - record capture, drop policy with the critical reserve, batching and ordering
+/// under several producers
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "event_queue.h"
+#include "synthetic_events.h"
+#include "test_common.h"
+
+namespace
+{
+    std::vector<CombatRecord> g_received;
+    size_t                    g_batches = 0;
+    size_t                    g_largestBatch = 0;
+}
+
+static void CollectBatch(const CombatRecord* records, size_t count)
+{
+    g_received.insert(g_received.end(), records, records + count);
+    g_batches++;
+    if (count > g_largestBatch)
+        g_largestBatch = count;
+}
+
+static void ClearReceived()
+{
+    g_received.clear();
+    g_batches = 0;
+    g_largestBatch = 0;
+}
+
+static void TestRecordCopiesTrackedFields()
+{
+    SyntheticAgent self{0x10, ProfessionGuardian, 3, true, "Self"};
+    SyntheticAgent enemy{0x20, ProfessionRevenant, 7, false, "Enemy"};
+    SyntheticCombatEvent kill = MakeKillingBlow(1234, self, enemy, 5492);
+    kill.data.id = 99;
+
+    CombatRecord record = MakeCombatRecord(kill.data, CombatSource_Local);
+    CHECK(record.HasEvent());
+    CHECK(record.SrcIsSelf());
+    CHECK(!record.DstIsSelf());
+    CHECK_EQ(record.Source, uint8_t(CombatSource_Local));
+    CHECK_EQ(record.Time, uint64_t(1234));
+    CHECK_EQ(record.Id, uint64_t(99));
+    CHECK_EQ(record.SrcId, uint64_t(0x10));
+    CHECK_EQ(record.DstId, uint64_t(0x20));
+    CHECK_EQ(record.DstProfession, ProfessionRevenant);
+    CHECK_EQ(record.SrcTeam, uint16_t(3));
+    CHECK_EQ(record.DstTeam, uint16_t(7));
+    CHECK_EQ(record.SkillId, uint32_t(5492));
+    CHECK_EQ(record.Result, uint8_t(ArcDPS::CBTR_KILLINGBLOW));
+    CHECK_EQ(record.Iff, uint8_t(ArcDPS::IFF_FOE));
+    CHECK(EventQueue::IsCritical(record));
+
+    SyntheticCombatEvent added = MakeAgentAdded(self);
+    CombatRecord agent = MakeCombatRecord(added.data, CombatSource_Squad);
+    CHECK(!agent.HasEvent());
+    CHECK(agent.SrcIsSelf());
+    CHECK_EQ(agent.Flags & CombatRecord_HasDst, 0);
+    CHECK(EventQueue::IsCritical(agent));
+
+    SyntheticCombatEvent strike = MakeStrike(1, enemy, self, ArcDPS::CBTR_NORMAL, 0, -500);
+    CombatRecord hit = MakeCombatRecord(strike.data, CombatSource_Local);
+    CHECK_EQ(hit.Value, -500);
+    CHECK(hit.DstIsSelf());
+    CHECK(!EventQueue::IsCritical(hit));
+}
+
+static void TestDropPolicyKeepsCriticalReserve()
+{
+    ClearReceived();
+    EventQueue::Reset();
+    uint64_t processedBefore = EventQueue::Processed();
+
+    SyntheticAgent enemy{0x20, ProfessionRevenant, 7, false, nullptr};
+    SyntheticAgent self{0x10, ProfessionGuardian, 3, true, nullptr};
+    CombatRecord strike = MakeCombatRecord(MakeStrike(1, self, enemy, ArcDPS::CBTR_NORMAL).data, CombatSource_Local);
+    CombatRecord down = MakeCombatRecord(MakeStateChange(2, self, ArcDPS::CBTS_CHANGEDOWN).data, CombatSource_Squad);
+
+    // Worker not running yet: fill the ring with ordinary records until the policy refuses them
+    size_t accepted = 0;
+    for (size_t i = 0; i < EventQueue::Capacity; i++)
+    {
+        strike.Time = i;
+        if (EventQueue::Push(strike))
+            accepted++;
+    }
+    CHECK_EQ(accepted, EventQueue::Capacity - EventQueue::CriticalReserve);
+    CHECK_EQ(EventQueue::Dropped(), uint64_t(EventQueue::CriticalReserve));
+    CHECK_EQ(EventQueue::DroppedCritical(), uint64_t(0));
+
+    // The reserve still takes state changes, until the ring is really full
+    size_t criticalAccepted = 0;
+    for (size_t i = 0; i < EventQueue::CriticalReserve + 10; i++)
+    {
+        down.Time = accepted + i;
+        if (EventQueue::Push(down))
+            criticalAccepted++;
+    }
+    CHECK_EQ(criticalAccepted, EventQueue::CriticalReserve);
+    CHECK_EQ(EventQueue::DroppedCritical(), uint64_t(10));
+    CHECK_EQ(EventQueue::Dropped(), uint64_t(EventQueue::CriticalReserve + 10));
+
+    // Everything accepted is processed in order, in bounded batches
+    EventQueue::Start(CollectBatch);
+    EventQueue::WaitProcessed();
+    EventQueue::Stop();
+
+    CHECK_EQ(g_received.size(), EventQueue::Capacity);
+    CHECK_EQ(EventQueue::Processed() - processedBefore, uint64_t(EventQueue::Capacity));
+    CHECK(g_largestBatch <= EventQueue::MaxBatch);
+    CHECK(g_batches >= EventQueue::Capacity / EventQueue::MaxBatch);
+    bool ordered = true;
+    for (size_t i = 1; i < g_received.size(); i++)
+        ordered = ordered && g_received[i].Time == g_received[i - 1].Time + 1;
+    CHECK(ordered);
+    CHECK_EQ(g_received.back().IsStatechange, uint8_t(ArcDPS::CBTS_CHANGEDOWN));
+}
+
+static void TestPositionFloodKeepsKillsAndDowns()
+{
+    ClearReceived();
+    EventQueue::Reset();
+
+    // Movement and percentage updates are refused at the reserve like strikes
+    SyntheticAgent self{0x10, ProfessionGuardian, 3, true, "Self"};
+    SyntheticAgent enemy{0x20, ProfessionRevenant, 7, false, "Enemy"};
+    CombatRecord position = MakeCombatRecord(MakeStateChange(1, enemy, ArcDPS::CBTS_POSITION, 0).data, CombatSource_Local);
+    CombatRecord health = MakeCombatRecord(MakeStateChange(1, self, ArcDPS::CBTS_HEALTHPCTUPDATE, 5000).data, CombatSource_Local);
+    CHECK(!EventQueue::IsCritical(position));
+    CHECK(!EventQueue::IsCritical(health));
+
+    size_t accepted = 0;
+    for (size_t i = 0; i < EventQueue::Capacity; i++)
+        accepted += EventQueue::Push(position);
+    CHECK_EQ(accepted, EventQueue::Capacity - EventQueue::CriticalReserve);
+    CHECK(!EventQueue::Push(health));
+
+    // Killing blows and downs still fit
+    CombatRecord kill = MakeCombatRecord(MakeKillingBlow(2, self, enemy).data, CombatSource_Local);
+    CombatRecord down = MakeCombatRecord(MakeStrike(3, self, enemy, ArcDPS::CBTR_DOWNED, 0, -900).data, CombatSource_Local);
+    CHECK(EventQueue::IsCritical(down));
+    for (uint32_t i = 0; i < EventQueue::CriticalReserve / 2; i++)
+    {
+        CHECK(EventQueue::Push(kill));
+        CHECK(EventQueue::Push(down));
+    }
+
+    EventQueue::Start(CollectBatch);
+    EventQueue::WaitProcessed();
+    EventQueue::Stop();
+
+    size_t kills = 0;
+    size_t downs = 0;
+    for (const CombatRecord& record : g_received)
+    {
+        kills += record.Result == ArcDPS::CBTR_KILLINGBLOW && !record.IsStatechange;
+        downs += record.Result == ArcDPS::CBTR_DOWNED && !record.IsStatechange;
+    }
+    CHECK_EQ(kills, size_t(EventQueue::CriticalReserve / 2));
+    CHECK_EQ(downs, size_t(EventQueue::CriticalReserve / 2));
+}
+
+static void TestStopProcessesPending()
+{
+    ClearReceived();
+    EventQueue::Start(CollectBatch);
+
+    SyntheticAgent self{0x10, ProfessionGuardian, 3, true, nullptr};
+    CombatRecord record = MakeCombatRecord(MakeAgentAdded(self).data, CombatSource_Local);
+    for (int i = 0; i < 100; i++)
+        EventQueue::Push(record);
+    EventQueue::Stop();
+
+    CHECK_EQ(g_received.size(), size_t(100));
+}
+
+static void TestProducersKeepTheirOrder()
+{
+    constexpr uint32_t Producers = 4;
+    constexpr uint32_t PerProducer = 20000;
+
+    ClearReceived();
+    EventQueue::Reset();
+    EventQueue::Start(CollectBatch);
+
+    std::vector<std::thread> threads;
+    std::atomic<uint64_t> retries{0};
+    for (uint32_t p = 0; p < Producers; p++)
+    {
+        threads.emplace_back([p, &retries]
+        {
+            CombatRecord record = {};
+            record.Flags = CombatRecord_HasEvent;
+            record.IsStatechange = ArcDPS::CBTS_CHANGEUP;
+            record.SrcId = p;
+            for (uint32_t i = 0; i < PerProducer; i++)
+            {
+                record.Time = i;
+                while (!EventQueue::Push(record))
+                {
+                    retries.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads)
+        t.join();
+    EventQueue::WaitProcessed();
+    EventQueue::Stop();
+
+    CHECK_EQ(g_received.size(), size_t(Producers * PerProducer));
+    CHECK_EQ(EventQueue::Dropped(), retries.load());
+
+    uint64_t next[Producers] = {};
+    bool ordered = true;
+    for (const CombatRecord& record : g_received)
+    {
+        if (record.SrcId >= Producers || record.Time != next[record.SrcId])
+        {
+            ordered = false;
+            break;
+        }
+        next[record.SrcId]++;
+    }
+    CHECK(ordered);
+}
+
+int main()
+{
+    RUN_TEST(TestRecordCopiesTrackedFields);
+    RUN_TEST(TestDropPolicyKeepsCriticalReserve);
+    RUN_TEST(TestPositionFloodKeepsKillsAndDowns);
+    RUN_TEST(TestStopProcessesPending);
+    RUN_TEST(TestProducersKeepTheirOrder);
+    return TEST_MAIN_RESULT();
+}
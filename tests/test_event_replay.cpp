@@ -0,0 +1,755 @@
+///----------------------------------------------------------------------------------------------------
+/// Event replay tests - drive the real handlers through a stub AddonAPI with synthetic payloads
+///----------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "alert_rules.h"
+#include "combat_dispatch.h"
+#include "combat_recording.h"
+#include "combat_tracker.h"
+#include "enemy_tracker.h"
+#include "rate_tracker.h"
+#include "squad_tracker.h"
+#include "streamlink.h"
+#include "stub_addon_api.h"
+#include "synthetic_events.h"
+#include "test_common.h"
+
+static const SyntheticAgent Self{0x100, ProfessionGuardian, 1, true, "Self"};
+static const SyntheticAgent SelfById{0x100, ProfessionGuardian, 1, false, "Self"};
+static const SyntheticAgent Enemy{0x200, ProfessionRevenant, 2, false, "Enemy"};
+static const SyntheticAgent EnemyNpc{0x300, SpeciesNpc, 2, false, "Guard"};
+static const SyntheticAgent Ally{0x400, ProfessionGuardian, 1, false, "Ally"};
+
+static FakeMumbleLink g_mumble;
+
+static void RaiseLocal(SyntheticCombatEvent e)
+{
+    StubApi::Raise(EV_ARCDPS_COMBATEVENT_LOCAL_RAW, &e.data);
+}
+
+static void RaiseSquad(SyntheticCombatEvent e)
+{
+    StubApi::Raise(EV_ARCDPS_COMBATEVENT_SQUAD_RAW, &e.data);
+}
+
+static void RaiseSquadUpdate(UnofficialExtras::UserInfo* users, uint64_t count)
+{
+    EvSquadUpdate update{users, count};
+    StubApi::Raise(EV_UNOFFICIAL_EXTRAS_SQUAD_UPDATE, &update);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// LoadAddon - Fresh scratch dir, settings pointing at the fake MumbleLink, addon loaded in WvW
+///----------------------------------------------------------------------------------------------------
+static AddonAPI* LoadAddon(const char* testName, const char* extraSettings = "")
+{
+    AddonAPI* api = StubApi::Create(testName);
+    std::string settings = std::string("addons/streamlink/killstreak.txt\nmumble_link=") + g_mumble.Name() + "\n" +
+                           extraSettings;
+    StubApi::WriteSettings(settings.c_str());
+    g_mumble.SetMap(MapTypeEternalBattlegrounds, MapIdEternalBattlegrounds);
+    Streamlink::Load(api);
+    return api;
+}
+
+static void TestLoadSubscribesAndWritesInitialFiles()
+{
+    LoadAddon("load");
+    CHECK_EQ(StubApi::SubscriberCount(EV_ARCDPS_COMBATEVENT_LOCAL_RAW), 1u);
+    CHECK_EQ(StubApi::SubscriberCount(EV_ARCDPS_COMBATEVENT_SQUAD_RAW), 1u);
+    CHECK_EQ(StubApi::SubscriberCount(EV_UNOFFICIAL_EXTRAS_SQUAD_UPDATE), 1u);
+
+    Streamlink::Unload();
+    CHECK_EQ(StubApi::SubscriberCount(EV_ARCDPS_COMBATEVENT_LOCAL_RAW), 0u);
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/killstreak.txt")) == "0");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/squad.txt")) == "0");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/playerstatus.txt")) == "alive");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/squadsize.txt")) == "0");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/subgroups.txt")) == "");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/grouptype.txt")) == "none");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/ready.txt")) == "0/0");
+    StubApi::Destroy();
+}
+
+static void TestKillsCountOnlyForSelfAgainstPlayersInWvW()
+{
+    LoadAddon("kills");
+
+    RaiseLocal(MakeKillingBlow(1, Self, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 1u);
+
+    // NPC victims and other people's kills do not count
+    RaiseLocal(MakeKillingBlow(2, Self, EnemyNpc));
+    RaiseLocal(MakeKillingBlow(3, Ally, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 1u);
+
+    // Outside WvW nothing counts
+    g_mumble.SetMap(MapTypePublic, MapIdLionsArch);
+    RaiseLocal(MakeKillingBlow(4, Self, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 1u);
+
+    // Armistice Bastion counts as WvW despite its map type
+    g_mumble.SetMap(MapTypePublic, 1315);
+    RaiseLocal(MakeKillingBlow(5, Self, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 2u);
+
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/killstreak.txt")) == "2");
+    StubApi::Destroy();
+}
+
+static void TestSelfIdTrackingAttributesKills()
+{
+    LoadAddon("selfid");
+
+    // Without a known self ID an agent that is not flagged IsSelf is not us
+    RaiseLocal(MakeKillingBlow(1, SelfById, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 0u);
+
+    RaiseLocal(MakeAgentAdded(Self));
+    CHECK_EQ(CombatTracker::SelfId(), Self.id);
+
+    RaiseLocal(MakeKillingBlow(2, SelfById, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 1u);
+
+    Streamlink::Unload();
+    StubApi::Destroy();
+}
+
+static void TestDeathResetsStreak()
+{
+    LoadAddon("death");
+
+    for (uint64_t t = 0; t < 3; t++)
+        RaiseLocal(MakeKillingBlow(t, Self, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 3u);
+
+    // Killing blow on us
+    RaiseLocal(MakeKillingBlow(10, Enemy, Self));
+    CHECK_EQ(CombatTracker::KillCount(), 0u);
+
+    // CHANGEDEAD on us
+    RaiseLocal(MakeKillingBlow(11, Self, Enemy));
+    RaiseSquad(MakeStateChange(12, Self, ArcDPS::CBTS_CHANGEDEAD));
+    CHECK_EQ(CombatTracker::KillCount(), 0u);
+    CHECK(CombatTracker::Status() == PlayerStatus::Dead);
+
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/killstreak.txt")) == "0");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/playerstatus.txt")) == "dead");
+    StubApi::Destroy();
+}
+
+static void TestSessionStats()
+{
+    LoadAddon("session", "deaths_file=addons/streamlink/stats/deaths.txt\nkd_file=\n");
+
+    // Two downs and three kills, then a death, then one more kill
+    RaiseLocal(MakeStrike(1, Self, Enemy, ArcDPS::CBTR_DOWNED));
+    RaiseLocal(MakeStrike(2, Self, EnemyNpc, ArcDPS::CBTR_DOWNED));   // NPCs do not count
+    RaiseLocal(MakeStrike(3, Ally, Enemy, ArcDPS::CBTR_DOWNED));      // nor do allies' downs
+    RaiseLocal(MakeStrike(4, Self, Enemy, ArcDPS::CBTR_DOWNED));
+    for (uint64_t t = 10; t < 13; t++)
+        RaiseLocal(MakeKillingBlow(t, Self, Enemy));
+    RaiseLocal(MakeKillingBlow(20, Enemy, Self));
+    RaiseSquad(MakeStateChange(21, Self, ArcDPS::CBTS_CHANGEDEAD));
+    RaiseSquad(MakeStateChange(22, Self, ArcDPS::CBTS_CHANGEUP));
+    RaiseLocal(MakeKillingBlow(30, Self, Enemy));
+
+    SessionCounters session = CombatTracker::Session();
+    CHECK_EQ(session.Get(SessionStat_Kills), 4u);
+    CHECK_EQ(session.Get(SessionStat_Deaths), 1u);   // killing blow and CHANGEDEAD are one death
+    CHECK_EQ(session.Get(SessionStat_Downs), 2u);
+    CHECK_EQ(session.Get(SessionStat_CurrentStreak), 1u);
+    CHECK_EQ(session.Get(SessionStat_BestStreak), 3u);
+    CHECK_EQ(CombatTracker::KillCount(), 1u);
+
+    // Deaths outside WvW are not part of the WvW session
+    g_mumble.SetMap(MapTypePublic, MapIdLionsArch);
+    RaiseSquad(MakeStateChange(40, Self, ArcDPS::CBTS_CHANGEDEAD));
+    CHECK_EQ(CombatTracker::Session().Get(SessionStat_Deaths), 1u);
+
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/kills.txt")) == "4");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/stats/deaths.txt")) == "1");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/deaths.txt")) == "<missing>");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/downs.txt")) == "2");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/beststreak.txt")) == "3");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/kd.txt")) == "<missing>");
+    StubApi::Destroy();
+}
+
+static void TestKillDeathRatio()
+{
+    SessionCounters counters;
+    CHECK(SessionStats::KillDeathRatio(counters) == 0.0);
+    SessionStats::Apply(counters, SessionEvent_Kill);
+    SessionStats::Apply(counters, SessionEvent_Kill);
+    SessionStats::Apply(counters, SessionEvent_Kill);
+    CHECK(SessionStats::KillDeathRatio(counters) == 3.0);
+    SessionStats::Apply(counters, SessionEvent_Death);
+    SessionStats::Apply(counters, SessionEvent_Death);
+    CHECK(SessionStats::KillDeathRatio(counters) == 1.5);
+    CHECK_EQ(counters.Get(SessionStat_CurrentStreak), 0u);
+    CHECK_EQ(counters.Get(SessionStat_BestStreak), 3u);
+}
+
+static void TestRollingRates()
+{
+    LoadAddon("rates", "downs_pm_file=\n");
+
+    // Three kills and a down on players, plus strikes and a condition tick we deal
+    const uint64_t start = 50000;
+    for (uint64_t i = 0; i < 3; i++)
+        RaiseLocal(MakeKillingBlow(start + i, Self, Enemy));
+    RaiseLocal(MakeStrike(start + 10, Self, Enemy, ArcDPS::CBTR_DOWNED));
+    RaiseLocal(MakeStrike(start + 20, Self, Enemy, ArcDPS::CBTR_CRIT, 0, 4000));
+    RaiseLocal(MakeStrike(start + 30, Self, EnemyNpc, ArcDPS::CBTR_NORMAL, 0, 3000));
+    SyntheticCombatEvent tick = MakeStrike(start + 40, Self, Enemy, ArcDPS::CBTR_NORMAL);
+    tick.ev.Buff = 1;
+    tick.ev.BuffDamage = 500;
+    RaiseLocal(tick);
+
+    // None of these are our outgoing damage
+    RaiseLocal(MakeStrike(start + 50, Enemy, Self, ArcDPS::CBTR_NORMAL, 0, 9000));
+    RaiseLocal(MakeStrike(start + 60, Self, Enemy, ArcDPS::CBTR_BLOCK));
+    SyntheticCombatEvent resisted = tick;
+    resisted.ev.Time = start + 70;
+    resisted.ev.Result = 1;
+    RaiseLocal(resisted);
+
+    uint64_t now = start + 100;
+    CHECK_EQ(RateTracker::Total(Rate_Kills, RateWindow_60s, now), uint64_t(3));
+    CHECK_EQ(RateTracker::Total(Rate_Downs, RateWindow_60s, now), uint64_t(1));
+    CHECK_EQ(RateTracker::Total(Rate_Damage, RateWindow_10s, now), uint64_t(7500));
+
+    // Final flush writes the rates as of unload (well inside every window)
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/kpm.txt")) == "3.0");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/dps.txt")) == "750");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/downspm.txt")) == "<missing>");
+    StubApi::Destroy();
+}
+
+static void TestMilestoneAlerts()
+{
+    LoadAddon("milestones");
+
+    for (uint64_t t = 0; t < 10; t++)
+        RaiseLocal(MakeKillingBlow(t, Self, Enemy));
+
+    const std::vector<std::string>& alerts = StubApi::Alerts();
+    CHECK_EQ(alerts.size(), 2u);
+    if (alerts.size() == 2)
+    {
+        CHECK(alerts[0] == "Killstreak: 5!");
+        CHECK(alerts[1] == "Killstreak: 10!");
+    }
+
+    Streamlink::Unload();
+    StubApi::Destroy();
+}
+
+static std::vector<StreamlinkRuleEvent> g_ruleEvents;
+
+static void OnTestRuleEvent(void* eventArgs)
+{
+    g_ruleEvents.push_back(*static_cast<StreamlinkRuleEvent*>(eventArgs));
+}
+
+static void TestAlertRules()
+{
+    using UnofficialExtras::UserRole;
+    AddonAPI* api = LoadAddon("rules", "milestones=\n"
+                                       "rule=streak 2 | event EV_TEST_RULE | file addons/streamlink/rule.txt streak {n}\n"
+                                       "rule=kills_every 3 | alert {n} kills\n"
+                                       "rule=squad_size 3 | alert Squad of {n}\n");
+    g_ruleEvents.clear();
+    api->Events_Subscribe("EV_TEST_RULE", OnTestRuleEvent);
+
+    for (uint64_t t = 1; t <= 3; t++)
+        RaiseLocal(MakeKillingBlow(t, Self, Enemy));
+
+    // Events are raised from the writer thread
+    for (int i = 0; i < 200 && g_ruleEvents.empty(); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK_EQ(g_ruleEvents.size(), size_t(1));
+    if (g_ruleEvents.size() == 1)
+    {
+        CHECK_EQ(g_ruleEvents[0].Trigger, uint32_t(AlertTrigger_Streak));
+        CHECK_EQ(g_ruleEvents[0].Value, 2u);
+    }
+
+    UnofficialExtras::UserInfo join[] = {
+        MakeUser("Alpha.1234", UserRole::SquadLeader, 1),
+        MakeUser("Bravo.5678", UserRole::Member, 1),
+        MakeUser("Charlie.9012", UserRole::Member, 2),
+        MakeUser("Delta.3456", UserRole::Member, 2),
+    };
+    RaiseSquadUpdate(join, 4);
+
+    const std::vector<std::string>& alerts = StubApi::Alerts();
+    CHECK_EQ(alerts.size(), 2u);
+    if (alerts.size() == 2)
+    {
+        CHECK(alerts[0] == "3 kills");
+        CHECK(alerts[1] == "Squad of 4");
+    }
+
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/rule.txt")) == "streak 2");
+    StubApi::Destroy();
+}
+
+static void TestCombatCounters()
+{
+    LoadAddon("counters", "counter=kills_by_me | result==KILLINGBLOW && src.self && dst.profession in 1..9\n"
+                          "counter=crits | result==CRIT && src.self | file addons/streamlink/crits.txt\n");
+
+    // Both feeds deliver our kill; it counts once
+    RaiseLocal(MakeKillingBlow(1, Self, Enemy));
+    RaiseSquad(MakeKillingBlow(1, Self, Enemy));
+    RaiseLocal(MakeKillingBlow(2, Self, EnemyNpc));
+    RaiseLocal(MakeKillingBlow(3, Ally, Enemy));
+    RaiseLocal(MakeStrike(4, Self, Enemy, ArcDPS::CBTR_CRIT, 100, 500));
+    RaiseLocal(MakeStrike(5, Self, Enemy, ArcDPS::CBTR_NORMAL, 100, 400));
+    RaiseLocal(MakeStrike(6, Self, Enemy, ArcDPS::CBTR_CRIT, 100, 500));
+
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/kills_by_me.txt")) == "1");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/crits.txt")) == "2");
+    StubApi::Destroy();
+}
+
+static void TestKillFeed()
+{
+    LoadAddon("killfeed");
+
+    // Names are only valid during the callback; the feed must have copied them
+    SyntheticCombatEvent kill = MakeKillingBlow(1, Self, Enemy, 4321);
+    kill.data.skillname = const_cast<char*>("Mace Smash");
+    RaiseLocal(kill);
+    RaiseSquad(kill);
+    RaiseLocal(MakeKillingBlow(2, Self, EnemyNpc, 4321));
+    RaiseLocal(MakeKillingBlow(3, Ally, Enemy, 4321));
+    RaiseLocal(MakeKillingBlow(4, Self, Enemy, 999));
+
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/killfeed.txt")) ==
+          "Enemy (Revenant) - Skill #999\nEnemy (Revenant) - Mace Smash");
+    StubApi::Destroy();
+}
+
+static void TestRecorder()
+{
+    LoadAddon("recorder", "record=1\nrecord_file=addons/streamlink/session.slrec\n");
+
+    SyntheticCombatEvent kill = MakeKillingBlow(1, Self, Enemy, 4321);
+    kill.data.skillname = const_cast<char*>("Mace Smash");
+    RaiseLocal(kill);
+    RaiseSquad(kill);
+    RaiseLocal(MakeAgentAdded(Ally));
+    UnofficialExtras::UserInfo join[] = {MakeUser("Alpha.1234", UnofficialExtras::UserRole::SquadLeader),
+                                         MakeUser("Bravo.5678", UnofficialExtras::UserRole::Member)};
+    RaiseSquadUpdate(join, 2);
+    Streamlink::Unload();
+
+    // Unload wrote everything out; the recording holds the raw callbacks in order, names included
+    RecordingReader reader;
+    CHECK(reader.Open(StubApi::GamePath("addons/streamlink/session.slrec")));
+    RecordingEntry entry;
+    CHECK(reader.Next(entry));
+    CHECK(entry.Kind == RecordingEntry::Combat);
+    CHECK_EQ(entry.CombatData.Source, CombatSource_Local);
+    CHECK_EQ(entry.CombatData.Ev.Result, ArcDPS::CBTR_KILLINGBLOW);
+    CHECK(strcmp(entry.CombatData.Dst.Name, "Enemy") == 0);
+    CHECK(strcmp(entry.CombatData.SkillName, "Mace Smash") == 0);
+    CHECK(reader.Next(entry));
+    CHECK_EQ(entry.CombatData.Source, CombatSource_Squad);
+    CHECK(reader.Next(entry));
+    CHECK(!(entry.CombatData.Flags & Recorded_HasEvent));
+    CHECK(strcmp(entry.CombatData.Src.Name, "Ally") == 0);
+    CHECK(reader.Next(entry));
+    CHECK(entry.Kind == RecordingEntry::SquadUpdate);
+    CHECK_EQ(entry.Users.size(), 2u);
+    if (entry.Users.size() == 2)
+        CHECK(strcmp(entry.Users[1].AccountName, "Bravo.5678") == 0);
+    CHECK(!reader.Next(entry));
+    CHECK(!reader.Damaged());
+    StubApi::Destroy();
+}
+
+static void TestHealthAndBarrier()
+{
+    LoadAddon("gauges", "gauge_interval_ms=0\ngauge_threshold=5\n");
+    std::string health = StubApi::GamePath("addons/streamlink/health.txt");
+    std::string barrier = StubApi::GamePath("addons/streamlink/barrier.txt");
+
+    RaiseSquad(MakeStateChange(1, Self, ArcDPS::CBTS_HEALTHPCTUPDATE, 10000));
+    RaiseSquad(MakeStateChange(2, Self, ArcDPS::CBTS_BARRIERPCTUPDATE, 2550));
+    for (int i = 0; i < 200 && (StubApi::ReadFile(health) != "100" || StubApi::ReadFile(barrier) != "25"); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(StubApi::ReadFile(health) == "100");
+    CHECK(StubApi::ReadFile(barrier) == "25");
+
+    RaiseSquad(MakeStateChange(3, Self, ArcDPS::CBTS_HEALTHPCTUPDATE, 6000));
+    for (int i = 0; i < 200 && StubApi::ReadFile(health) != "60"; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(StubApi::ReadFile(health) == "60");
+
+    // Other squad members' health and moves under the threshold never reach the file
+    RaiseSquad(MakeStateChange(4, Ally, ArcDPS::CBTS_HEALTHPCTUPDATE, 1000));
+    RaiseSquad(MakeStateChange(5, Self, ArcDPS::CBTS_HEALTHPCTUPDATE, 5700));
+    CHECK_EQ(CombatTracker::Gauge(SelfGauge_Health).Latest(), 5700u);
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(health) == "60");
+    StubApi::Destroy();
+}
+
+static void TestPlayerStatusTransitions()
+{
+    LoadAddon("status");
+
+    RaiseSquad(MakeStateChange(1, Self, ArcDPS::CBTS_CHANGEDOWN));
+    CHECK(CombatTracker::Status() == PlayerStatus::Downed);
+
+    // Other agents' state changes are ignored
+    RaiseSquad(MakeStateChange(2, Ally, ArcDPS::CBTS_CHANGEUP));
+    CHECK(CombatTracker::Status() == PlayerStatus::Downed);
+
+    RaiseSquad(MakeStateChange(3, Self, ArcDPS::CBTS_CHANGEUP));
+    CHECK(CombatTracker::Status() == PlayerStatus::Alive);
+
+    // Death outside WvW keeps the streak
+    RaiseLocal(MakeKillingBlow(4, Self, Enemy));
+    g_mumble.SetMap(MapTypePublic, MapIdLionsArch);
+    RaiseSquad(MakeStateChange(5, Self, ArcDPS::CBTS_CHANGEDEAD));
+    CHECK(CombatTracker::Status() == PlayerStatus::Dead);
+    CHECK_EQ(CombatTracker::KillCount(), 1u);
+
+    Streamlink::Unload();
+    StubApi::Destroy();
+}
+
+static void TestSquadVitals()
+{
+    LoadAddon("vitals");
+    const SyntheticAgent Member{0x500, 3, 1, false, "Member"};
+
+    // Only agent notifications add squad members; allied players on our team that were never
+    // announced (WvW pugs) are ignored, on the squad feed and the local one alike
+    RaiseSquad(MakeAgentAdded(Self));
+    RaiseSquad(MakeAgentAdded(Ally));
+    RaiseSquad(MakeStateChange(1, Member, ArcDPS::CBTS_CHANGEDOWN));
+    RaiseLocal(MakeStateChange(2, Member, ArcDPS::CBTS_CHANGEDEAD));
+    RaiseSquad(MakeStateChange(3, Enemy, ArcDPS::CBTS_CHANGEDOWN));     // other team
+    RaiseSquad(MakeStateChange(4, EnemyNpc, ArcDPS::CBTS_CHANGEDEAD));  // not a player
+    RaiseSquad(MakeStateChange(5, Ally, ArcDPS::CBTS_CHANGEDEAD));
+
+    SquadVitals vitals = CombatTracker::Vitals();
+    CHECK_EQ(vitals.Alive, 1u);
+    CHECK_EQ(vitals.Downed, 0u);
+    CHECK_EQ(vitals.Dead, 1u);
+
+    // Our own state changes count too
+    RaiseSquad(MakeStateChange(6, Self, ArcDPS::CBTS_CHANGEDOWN));
+    CHECK_EQ(CombatTracker::Vitals().Downed, 1u);
+    RaiseSquad(MakeStateChange(7, Self, ArcDPS::CBTS_CHANGEUP));
+
+    // Despawn and leaving tracking evict
+    RaiseSquad(MakeAgentAdded(Member));
+    RaiseSquad(MakeStateChange(8, Ally, ArcDPS::CBTS_DESPAWN));
+    RaiseSquad(MakeAgentRemoved(Member));
+    vitals = CombatTracker::Vitals();
+    CHECK_EQ(vitals.Alive, 1u);
+    CHECK_EQ(vitals.Downed, 0u);
+    CHECK_EQ(vitals.Dead, 0u);
+
+    // Targeting a member is a null-ev notification with profession 0 too, told apart by elite 1;
+    // it neither removes them nor adds anyone
+    RaiseSquad(MakeTargetChanged(Self));
+    RaiseSquad(MakeTargetChanged(Member));
+    RaiseSquad(MakeTargetChanged(Enemy));
+    vitals = CombatTracker::Vitals();
+    CHECK_EQ(vitals.Alive, 1u);
+    CHECK_EQ(vitals.Downed, 0u);
+    CHECK_EQ(vitals.Dead, 0u);
+
+    // A despawned member counts again once the squad feed announces it
+    RaiseSquad(MakeStateChange(9, Ally, ArcDPS::CBTS_CHANGEDOWN));
+    CHECK_EQ(CombatTracker::Vitals().Downed, 0u);
+    RaiseSquad(MakeAgentAdded(Ally));
+    RaiseSquad(MakeStateChange(10, Ally, ArcDPS::CBTS_CHANGEDOWN));
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/squadalive.txt")) == "1");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/squaddowned.txt")) == "1");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/squaddead.txt")) == "0");
+    StubApi::Destroy();
+}
+
+static void TestEnemyRoster()
+{
+    LoadAddon("enemies");
+    const SyntheticAgent Scout{0x600, 4, 3, false, "Scout"};
+    const SyntheticAgent Roamer{0x700, 6, 3, false, "Roamer"};
+
+    // Our team comes from our own agent; enemies from any event naming them
+    RaiseSquad(MakeAgentAdded(Self));
+    RaiseLocal(MakeStrike(1, Self, Enemy, ArcDPS::CBTR_NORMAL, 0, 1000));
+    RaiseSquad(MakeStateChange(2, Scout, ArcDPS::CBTS_SPAWN));
+    RaiseSquad(MakeStateChange(3, Roamer, ArcDPS::CBTS_POSITION));
+    RaiseLocal(MakeStrike(4, Ally, EnemyNpc, ArcDPS::CBTR_NORMAL, 0, 1000));   // ally and NPC: neither counts
+
+    CHECK_EQ(EnemyTracker::Total(), 3u);
+    EnemyTeamCount teams[EnemyRoster::MaxTeams];
+    CHECK_EQ(EnemyTracker::Teams(teams, EnemyRoster::MaxTeams), size_t(2));
+    CHECK_EQ(teams[0].Team, uint16_t(3));   // largest first
+    CHECK_EQ(teams[0].Count, 2u);
+    CHECK_EQ(teams[1].Team, uint16_t(2));
+
+    // Joining our team or despawning removes an enemy
+    RaiseSquad(MakeStateChange(5, Roamer, ArcDPS::CBTS_TEAMCHANGE, Self.team));
+    RaiseSquad(MakeStateChange(6, Scout, ArcDPS::CBTS_DESPAWN));
+    CHECK_EQ(EnemyTracker::Total(), 1u);
+
+    // A lost despawn ages out once the event clock is far enough ahead
+    CHECK(!EnemyTracker::Tick(6 + EnemyTracker::TimeoutMs - 2000));
+    CHECK(EnemyTracker::Tick(6 + EnemyTracker::TimeoutMs + 2000));
+    CHECK_EQ(EnemyTracker::Total(), 0u);
+
+    RaiseLocal(MakeStrike(40000, Enemy, Self, ArcDPS::CBTR_NORMAL, 0, 1000));
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/enemies.txt")) == "1");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/enemyteams.txt")) == "2: 1");
+    StubApi::Destroy();
+
+    // Outside WvW the roster stays empty
+    LoadAddon("enemies_pve");
+    g_mumble.SetMap(MapTypePublic, MapIdLionsArch);
+    RaiseLocal(MakeStrike(1, Self, Enemy, ArcDPS::CBTR_NORMAL, 0, 1000));
+    CHECK_EQ(EnemyTracker::Total(), 0u);
+    Streamlink::Unload();
+    StubApi::Destroy();
+}
+
+static void TestBothFeedsCountOnce()
+{
+    LoadAddon("dedup");
+    RaiseSquad(MakeAgentAdded(Self));
+    RaiseSquad(MakeAgentAdded(Ally));
+
+    // ArcDPS delivers events involving us on both feeds, in either order
+    const uint64_t start = 50000;
+    RaiseLocal(MakeKillingBlow(start + 1, Self, Enemy));
+    RaiseSquad(MakeKillingBlow(start + 1, Self, Enemy));
+    RaiseSquad(MakeKillingBlow(start + 2, Self, Enemy));
+    RaiseLocal(MakeKillingBlow(start + 2, Self, Enemy));
+    RaiseSquad(MakeStrike(start + 3, Self, Enemy, ArcDPS::CBTR_DOWNED));
+    RaiseLocal(MakeStrike(start + 3, Self, Enemy, ArcDPS::CBTR_DOWNED));
+
+    // Copies further apart, with other events in between
+    RaiseLocal(MakeKillingBlow(start + 4, Self, Enemy));
+    RaiseLocal(MakeStrike(start + 5, Self, Enemy, ArcDPS::CBTR_NORMAL, 0, 1000));
+    RaiseLocal(MakeStrike(start + 5, Self, Enemy, ArcDPS::CBTR_NORMAL, 0, 1000));   // multi-hit: both count
+    RaiseSquad(MakeStateChange(start + 6, Ally, ArcDPS::CBTS_CHANGEDOWN));
+    RaiseSquad(MakeStrike(start + 5, Self, Enemy, ArcDPS::CBTR_NORMAL, 0, 1000));
+    RaiseSquad(MakeKillingBlow(start + 4, Self, Enemy));
+    RaiseLocal(MakeStateChange(start + 6, Ally, ArcDPS::CBTS_CHANGEDOWN));
+    RaiseSquad(MakeStrike(start + 5, Self, Enemy, ArcDPS::CBTR_NORMAL, 0, 1000));
+    RaiseLocal(MakeStrike(start + 7, Self, Enemy, ArcDPS::CBTR_NORMAL, 0, 1000));   // local only
+
+    // Our own death, reported by both
+    RaiseSquad(MakeStateChange(start + 8, Self, ArcDPS::CBTS_CHANGEDEAD));
+    RaiseLocal(MakeStateChange(start + 8, Self, ArcDPS::CBTS_CHANGEDEAD));
+
+    SessionCounters session = CombatTracker::Session();
+    CHECK_EQ(session.Get(SessionStat_Kills), 3u);
+    CHECK_EQ(session.Get(SessionStat_Downs), 1u);
+    CHECK_EQ(session.Get(SessionStat_Deaths), 1u);
+    CHECK_EQ(session.Get(SessionStat_BestStreak), 3u);
+
+    uint64_t now = start + 100;
+    CHECK_EQ(RateTracker::Total(Rate_Kills, RateWindow_60s, now), uint64_t(3));
+    CHECK_EQ(RateTracker::Total(Rate_Downs, RateWindow_60s, now), uint64_t(1));
+    CHECK_EQ(RateTracker::Total(Rate_Damage, RateWindow_10s, now), uint64_t(3000));
+
+    SquadVitals vitals = CombatTracker::Vitals();
+    CHECK_EQ(vitals.Alive, 0u);
+    CHECK_EQ(vitals.Downed, 1u);
+    CHECK_EQ(vitals.Dead, 1u);
+    CHECK_EQ(CombatDispatch::Duplicates(), uint64_t(8));
+
+    // A kill delivered only by the squad feed still counts
+    RaiseSquad(MakeStateChange(start + 9, Self, ArcDPS::CBTS_CHANGEUP));
+    RaiseSquad(MakeKillingBlow(start + 10, Self, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 1u);
+
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/killstreak.txt")) == "1");
+    StubApi::Destroy();
+}
+
+static void TestSessionSurvivesReload()
+{
+    AddonAPI* api = LoadAddon("journal");
+    for (uint64_t t = 1; t <= 3; t++)
+        RaiseLocal(MakeKillingBlow(t, Self, Enemy));
+    RaiseLocal(MakeStrike(4, Self, Enemy, ArcDPS::CBTR_DOWNED));
+    Streamlink::Unload();
+
+    // Reloading within the restore window carries on the streak and the session stats
+    Streamlink::Load(api);
+    CHECK_EQ(CombatTracker::KillCount(), 3u);
+    CHECK_EQ(CombatTracker::Session().Get(SessionStat_Downs), 1u);
+    RaiseLocal(MakeKillingBlow(5, Self, Enemy));
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/killstreak.txt")) == "4");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/kills.txt")) == "4");
+
+    // With restoring switched off the next load starts over
+    StubApi::WriteSettings((std::string("addons/streamlink/killstreak.txt\nmumble_link=") + g_mumble.Name() +
+                            "\njournal_max_age=0\n").c_str());
+    Streamlink::Load(api);
+    CHECK_EQ(CombatTracker::KillCount(), 0u);
+    Streamlink::Unload();
+    StubApi::Destroy();
+}
+
+static void TestSettingsHotReload()
+{
+    LoadAddon("hotreload", "journal=0\n");
+    RaiseLocal(MakeKillingBlow(1, Self, Enemy));
+
+    // Move the killstreak output and change the milestones while loaded
+    StubApi::WriteSettings((std::string("killstreak_file=addons/streamlink/obs/streak.txt\nmilestones=2\n"
+                                        "counter=my_kills | result==KILLINGBLOW && src.self\n"
+                                        "journal=0\nmumble_link=") + g_mumble.Name() + "\n").c_str());
+    std::string moved = StubApi::GamePath("addons/streamlink/obs/streak.txt");
+    for (int i = 0; i < 200 && StubApi::ReadFile(moved) != "1"; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(StubApi::ReadFile(moved) == "1");
+
+    RaiseLocal(MakeKillingBlow(2, Self, Enemy));
+    CHECK_EQ(StubApi::Alerts().size(), 1u);
+    if (StubApi::Alerts().size() == 1)
+        CHECK(StubApi::Alerts()[0] == "Killstreak: 2!");
+
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(moved) == "2");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/killstreak.txt")) == "1");
+
+    // The counter added by the reload counts from then on
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/my_kills.txt")) == "1");
+    StubApi::Destroy();
+}
+
+static void TestSquadMembership()
+{
+    LoadAddon("squad");
+
+    UnofficialExtras::UserInfo join[] = {
+        MakeUser("Alpha.1234", UnofficialExtras::UserRole::SquadLeader),
+        MakeUser("Bravo.5678", UnofficialExtras::UserRole::Member),
+    };
+    RaiseSquadUpdate(join, 2);
+    CHECK(SquadTracker::InSquad());
+
+    UnofficialExtras::UserInfo leaveOne[] = {MakeUser("Alpha.1234", UnofficialExtras::UserRole::None)};
+    RaiseSquadUpdate(leaveOne, 1);
+    CHECK(SquadTracker::InSquad());
+
+    UnofficialExtras::UserInfo leaveAll[] = {MakeUser("Bravo.5678", UnofficialExtras::UserRole::None)};
+    RaiseSquadUpdate(leaveAll, 1);
+    CHECK(!SquadTracker::InSquad());
+
+    RaiseSquadUpdate(join, 2);
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/squad.txt")) == "1");
+    StubApi::Destroy();
+}
+
+static void TestSquadComposition()
+{
+    using UnofficialExtras::UserRole;
+    LoadAddon("composition");
+
+    UnofficialExtras::UserInfo join[] = {
+        MakeUser("Alpha.1234", UserRole::SquadLeader, 1, true),
+        MakeUser("Bravo.5678", UserRole::Lieutenant, 1),
+        MakeUser("Charlie.9012", UserRole::Member, 2, true),
+        MakeUser("Delta.3456", UserRole::Member, 3),
+        MakeUser("Echo.7890", UserRole::Invited, 3),
+    };
+    RaiseSquadUpdate(join, 5);
+
+    SquadComposition composition = SquadTracker::Composition();
+    CHECK_EQ(composition.Size, 4u);
+    CHECK_EQ(composition.Subgroups[1], 2u);
+    CHECK_EQ(composition.Subgroups[2], 1u);
+    CHECK_EQ(composition.Subgroups[3], 1u);
+    CHECK_EQ(composition.Commanders, 1u);
+    CHECK_EQ(composition.Lieutenants, 1u);
+    CHECK_EQ(composition.Ready, 2u);
+
+    // Only what moved is reported: a subgroup swap touches subgroups and nothing else
+    UnofficialExtras::UserInfo move[] = {MakeUser("Delta.3456", UserRole::Member, 2)};
+    EvSquadUpdate moveUpdate{move, 1};
+    CHECK_EQ(SquadTracker::Apply(moveUpdate), SquadChange_Subgroups);
+    CHECK_EQ(SquadTracker::Apply(moveUpdate), SquadChange_None);
+
+    UnofficialExtras::UserInfo readyUp[] = {
+        MakeUser("Bravo.5678", UserRole::Lieutenant, 1, true),
+        MakeUser("Delta.3456", UserRole::Member, 2, true),
+    };
+    RaiseSquadUpdate(readyUp, 2);
+
+    UnofficialExtras::UserInfo leave[] = {MakeUser("Charlie.9012", UserRole::None)};
+    RaiseSquadUpdate(leave, 1);
+
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/squadsize.txt")) == "3");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/subgroups.txt")) == "1: 2\n2: 1");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/commanders.txt")) == "1");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/lieutenants.txt")) == "1");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/grouptype.txt")) == "squad");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/ready.txt")) == "3/3");
+    StubApi::Destroy();
+}
+
+int main()
+{
+    if (!g_mumble.Create("replay"))
+    {
+        fprintf(stderr, "could not create fake MumbleLink\n");
+        return 1;
+    }
+
+    RUN_TEST(TestLoadSubscribesAndWritesInitialFiles);
+    RUN_TEST(TestKillsCountOnlyForSelfAgainstPlayersInWvW);
+    RUN_TEST(TestSelfIdTrackingAttributesKills);
+    RUN_TEST(TestDeathResetsStreak);
+    RUN_TEST(TestSessionStats);
+    RUN_TEST(TestKillDeathRatio);
+    RUN_TEST(TestRollingRates);
+    RUN_TEST(TestMilestoneAlerts);
+    RUN_TEST(TestAlertRules);
+    RUN_TEST(TestCombatCounters);
+    RUN_TEST(TestKillFeed);
+    RUN_TEST(TestRecorder);
+    RUN_TEST(TestHealthAndBarrier);
+    RUN_TEST(TestPlayerStatusTransitions);
+    RUN_TEST(TestSquadVitals);
+    RUN_TEST(TestEnemyRoster);
+    RUN_TEST(TestBothFeedsCountOnce);
+    RUN_TEST(TestSessionSurvivesReload);
+    RUN_TEST(TestSettingsHotReload);
+    RUN_TEST(TestSquadMembership);
+    RUN_TEST(TestSquadComposition);
+    return TEST_MAIN_RESULT();
+}
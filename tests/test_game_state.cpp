@@ -0,0 +1,158 @@
+///----------------------------------------------------------------------------------------------------
+/// Game state tests - map classification, tick-gated polling, map change events and map outputs
+///----------------------------------------------------------------------------------------------------
+
+#include <cstring>
+#include <string>
+
+#include "combat_tracker.h"
+#include "game_state.h"
+#include "mumble_link.h"
+#include "streamlink.h"
+#include "stub_addon_api.h"
+#include "synthetic_events.h"
+#include "test_common.h"
+
+static const SyntheticAgent Self{0x100, ProfessionGuardian, 1, true, "Self"};
+static const SyntheticAgent Enemy{0x200, ProfessionRevenant, 2, false, "Enemy"};
+
+static FakeMumbleLink g_mumble;
+
+static void RaiseLocal(SyntheticCombatEvent e)
+{
+    StubApi::Raise(EV_ARCDPS_COMBATEVENT_LOCAL_RAW, &e.data);
+}
+
+static void TestClassification()
+{
+    CHECK_EQ(GameState::ClassifyMap(MapTypeEternalBattlegrounds, MapIdEternalBattlegrounds), MapFlag_WvW);
+    CHECK_EQ(GameState::ClassifyMap(15, 968), MapFlag_WvW);
+    CHECK_EQ(GameState::ClassifyMap(MapTypePublic, 1315), MapFlag_WvW);
+    CHECK_EQ(GameState::ClassifyMap(MapTypePublic, MapIdLionsArch), MapFlag_None);
+    CHECK_EQ(GameState::ClassifyMap(6, 1234), MapFlag_PvP);
+    CHECK_EQ(GameState::ClassifyMap(MapTypePublic, 350), MapFlag_PvP);
+    CHECK_EQ(GameState::ClassifyMap(0xFFFF, 0), MapFlag_None);
+
+    CHECK(strcmp(GameState::MapName(MapTypeEternalBattlegrounds, MapIdEternalBattlegrounds), "Eternal Battlegrounds") == 0);
+    CHECK(strcmp(GameState::MapName(MapTypePublic, 1315), "Armistice Bastion") == 0);
+    CHECK(strcmp(GameState::MapName(MapTypePublic, 123456), "Open World") == 0);
+    CHECK(strcmp(GameState::MapName(0xFFFF, 123456), "Unknown") == 0);
+}
+
+static void TestPollFollowsTick()
+{
+    CHECK(MumbleLink::Open(g_mumble.Name()));
+    GameState::Reset();
+
+    g_mumble.SetMap(MapTypeEternalBattlegrounds, MapIdEternalBattlegrounds);
+    CHECK_EQ(GameState::Poll(), GameChange_Map | GameChange_EnteredWvW);
+    CHECK(GameState::IsInWvW());
+    CHECK(!GameState::IsInPvP());
+    CHECK_EQ(GameState::MapId(), MapIdEternalBattlegrounds);
+    CHECK_EQ(GameState::MapType(), MapTypeEternalBattlegrounds);
+
+    // Same tick: the context is not read again, even if it changed underneath
+    MumbleContext* ctx = reinterpret_cast<MumbleContext*>(g_mumble.Mem()->context);
+    ctx->mapType = MapTypePublic;
+    ctx->mapId = MapIdLionsArch;
+    CHECK_EQ(GameState::Poll(), GameChange_None);
+    CHECK(GameState::IsInWvW());
+
+    g_mumble.Tick();
+    CHECK_EQ(GameState::Poll(), GameChange_Map | GameChange_LeftWvW);
+    CHECK(!GameState::IsInWvW());
+
+    // A new tick on the same map is not a change
+    g_mumble.Tick();
+    CHECK_EQ(GameState::Poll(), GameChange_None);
+
+    g_mumble.SetMap(2, 350);
+    CHECK_EQ(GameState::Poll(), GameChange_Map);
+    CHECK(GameState::IsInPvP());
+
+    // Losing the link keeps the last known map
+    MumbleLink::Close();
+    CHECK_EQ(GameState::Poll(), GameChange_None);
+    CHECK_EQ(GameState::MapId(), 350u);
+    GameState::Reset();
+}
+
+static AddonAPI* LoadAddon(const char* testName, const char* extraSettings = "")
+{
+    AddonAPI* api = StubApi::Create(testName);
+    std::string settings = std::string("addons/streamlink/killstreak.txt\nmumble_link=") + g_mumble.Name() + "\n" +
+                           extraSettings;
+    StubApi::WriteSettings(settings.c_str());
+    g_mumble.SetMap(MapTypeEternalBattlegrounds, MapIdEternalBattlegrounds);
+    Streamlink::Load(api);
+    return api;
+}
+
+static void TestMapOutputs()
+{
+    LoadAddon("mapoutputs");
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/map.txt")) == "Eternal Battlegrounds");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/mapid.txt")) == "38");
+    StubApi::Destroy();
+
+    // Map changes reach the outputs through the writer thread without any combat events
+    LoadAddon("mapchange");
+    g_mumble.SetMap(MapTypePublic, MapIdLionsArch);
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/map.txt")) == "Lion's Arch");
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/mapid.txt")) == "50");
+    StubApi::Destroy();
+}
+
+static void TestStreakSurvivesLeavingWvWByDefault()
+{
+    LoadAddon("keepstreak");
+    RaiseLocal(MakeKillingBlow(1, Self, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 1u);
+
+    g_mumble.SetMap(MapTypePublic, MapIdLionsArch);
+    RaiseLocal(MakeKillingBlow(2, Self, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 1u);
+
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/killstreak.txt")) == "1");
+    StubApi::Destroy();
+}
+
+static void TestResetOnLeaveWvW()
+{
+    LoadAddon("resetstreak", "reset_on_leave_wvw=1\n");
+    RaiseLocal(MakeKillingBlow(1, Self, Enemy));
+    RaiseLocal(MakeKillingBlow(2, Self, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 2u);
+
+    // Moving between WvW maps keeps the streak
+    g_mumble.SetMap(15, 968);
+    RaiseLocal(MakeKillingBlow(3, Self, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 3u);
+
+    g_mumble.SetMap(MapTypePublic, MapIdLionsArch);
+    RaiseLocal(MakeKillingBlow(4, Self, Enemy));
+    CHECK_EQ(CombatTracker::KillCount(), 0u);
+
+    Streamlink::Unload();
+    CHECK(StubApi::ReadFile(StubApi::GamePath("addons/streamlink/killstreak.txt")) == "0");
+    StubApi::Destroy();
+}
+
+int main()
+{
+    if (!g_mumble.Create("gamestate"))
+    {
+        fprintf(stderr, "could not create fake MumbleLink\n");
+        return 1;
+    }
+
+    RUN_TEST(TestClassification);
+    RUN_TEST(TestPollFollowsTick);
+    RUN_TEST(TestMapOutputs);
+    RUN_TEST(TestStreakSurvivesLeavingWvWByDefault);
+    RUN_TEST(TestResetOnLeaveWvW);
+    return TEST_MAIN_RESULT();
+}
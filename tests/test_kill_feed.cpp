@@ -0,0 +1,232 @@
+///----------------------------------------------------------------------------------------------------
+/// Kill feed tests - capture, pairing names with kills, ring eviction, skill name cache, truncation,
+/// allocations
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include "kill_feed.h"
+#include "synthetic_events.h"
+#include "test_common.h"
+
+// Counts heap allocations so tests can check that recording kills never allocates
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        abort();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+static const SyntheticAgent Self{0x100, ProfessionGuardian, 1, true, "Self"};
+static const SyntheticAgent EnemyNpc{0x300, SpeciesNpc, 2, false, "Guard"};
+static const SyntheticAgent Squadmate{0x400, ProfessionGuardian, 1, false, "Squadmate"};
+
+static SyntheticAgent Enemy(uintptr_t id, const char* name)
+{
+    return SyntheticAgent{id, ProfessionRevenant, 2, false, name};
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Kill - Capture a killing blow the way the callback does, then credit it the way the worker does
+///----------------------------------------------------------------------------------------------------
+static void Kill(KillFeed& feed, SyntheticCombatEvent e, const char* skillName)
+{
+    e.data.skillname = const_cast<char*>(skillName);
+    KillNames names;
+    if (CaptureKillNames(e.data, names))
+        feed.Stage(names);
+    feed.Add(MakeCombatRecord(e.data, CombatSource_Local));
+}
+
+static std::string Render(const KillFeed& feed)
+{
+    char buffer[KillFeed::MaxTextSize];
+    size_t length = feed.Render(buffer, sizeof(buffer));
+    return std::string(buffer, length);
+}
+
+static void TestCapture()
+{
+    KillNames names;
+    SyntheticCombatEvent kill = MakeKillingBlow(10, Self, Enemy(0x200, "Victim.1234"), 5555);
+    kill.data.skillname = const_cast<char*>("Whirling Axe");
+    CHECK(CaptureKillNames(kill.data, names));
+    CHECK_EQ(names.Time, 10u);
+    CHECK_EQ(names.DstId, 0x200u);
+    CHECK_EQ(names.SkillId, 5555u);
+    CHECK(strcmp(names.Victim, "Victim.1234") == 0);
+    CHECK(strcmp(names.Skill, "Whirling Axe") == 0);
+
+    // Not a killing blow, not ours, an NPC, or missing names
+    CHECK(!CaptureKillNames(MakeStrike(11, Self, Enemy(0x200, "Victim"), ArcDPS::CBTR_NORMAL).data, names));
+    CHECK(!CaptureKillNames(MakeKillingBlow(12, Squadmate, Enemy(0x200, "Victim")).data, names));
+    SyntheticCombatEvent noSource = MakeKillingBlow(12, Self, Enemy(0x200, "Victim"));
+    noSource.data.src = nullptr;
+    CHECK(!CaptureKillNames(noSource.data, names));
+    CHECK(!CaptureKillNames(MakeKillingBlow(12, Self, EnemyNpc).data, names));
+    CHECK(!CaptureKillNames(MakeAgentAdded(Self).data, names));
+    CHECK(CaptureKillNames(MakeKillingBlow(13, Self, Enemy(0x200, nullptr)).data, names));
+    CHECK(names.Victim[0] == '\0' && names.Skill[0] == '\0');
+}
+
+static void TestFeedNewestFirstAndBounded()
+{
+    KillFeed feed;
+    CHECK(Render(feed).empty());
+
+    Kill(feed, MakeKillingBlow(1, Self, Enemy(0x201, "First"), 100), "Skill One");
+    CHECK(Render(feed) == "First (Revenant) - Skill One");
+
+    Kill(feed, MakeKillingBlow(2, Self, Enemy(0x202, "Second"), 200), "Skill Two");
+    CHECK(Render(feed) == "Second (Revenant) - Skill Two\nFirst (Revenant) - Skill One");
+
+    for (uint64_t t = 3; t <= 7; t++)
+        Kill(feed, MakeKillingBlow(t, Self, Enemy(0x200 + t, "Later"), 100), "");
+    CHECK_EQ(feed.Count(), KillFeed::MaxKills);
+    std::string text = Render(feed);
+    CHECK(text.find("First") == std::string::npos);
+    CHECK(text.find("Second") == std::string::npos);
+    CHECK(text.compare(0, 28, "Later (Revenant) - Skill One") == 0);   // cached from the first kill
+
+    feed.Clear();
+    CHECK_EQ(feed.Count(), 0u);
+    CHECK(Render(feed).empty());
+    CHECK(strcmp(feed.SkillName(200), "Skill Two") == 0);
+}
+
+static void TestMissingNames()
+{
+    KillFeed feed;
+
+    // A kill whose capture was lost: no victim name, no cached skill name
+    feed.Add(MakeCombatRecord(MakeKillingBlow(1, Self, Enemy(0x201, "Lost"), 321).data, CombatSource_Local));
+    CHECK(Render(feed) == "Unknown (Revenant) - Skill #321");
+
+    // Names only pair with the record of the same kill
+    SyntheticCombatEvent other = MakeKillingBlow(2, Self, Enemy(0x202, "Other"), 321);
+    other.data.skillname = const_cast<char*>("Other Skill");
+    KillNames names;
+    CHECK(CaptureKillNames(other.data, names));
+    feed.Stage(names);
+    feed.Add(MakeCombatRecord(MakeKillingBlow(3, Self, Enemy(0x202, "Other"), 321).data, CombatSource_Local));
+    CHECK(Render(feed).compare(0, 31, "Unknown (Revenant) - Skill #321") == 0);
+    CHECK(feed.SkillName(321) == nullptr);
+}
+
+static void TestOneStagedCopyPerKill()
+{
+    KillFeed feed;
+
+    // Our kill from both feeds, then a wipe's worth of squadmates' kills and more of ours
+    SyntheticCombatEvent ours = MakeKillingBlow(1, Self, Enemy(0x201, "Ours"), 100);
+    ours.data.skillname = const_cast<char*>("Our Skill");
+    KillNames names;
+    for (int feedCopy = 0; feedCopy < 2; feedCopy++)
+    {
+        CHECK(CaptureKillNames(ours.data, names));
+        feed.Stage(names);
+    }
+    for (uint64_t t = 2; t < 2 + 50; t++)
+    {
+        if (CaptureKillNames(MakeKillingBlow(t, Squadmate, Enemy(0x300 + t, "Theirs"), 200).data, names))
+            feed.Stage(names);
+    }
+    for (uint64_t t = 100; t < 100 + KillFeed::MaxPending - 1; t++)
+    {
+        CHECK(CaptureKillNames(MakeKillingBlow(t, Self, Enemy(0x500 + t, "Later"), 300).data, names));
+        feed.Stage(names);
+        feed.Stage(names);
+    }
+
+    // Still pending when the worker credits it
+    feed.Add(MakeCombatRecord(ours.data, CombatSource_Squad));
+    CHECK(Render(feed) == "Ours (Revenant) - Our Skill");
+}
+
+static void TestLongNamesAreCutOnCharacterBoundaries()
+{
+    // 40 two-byte characters: 80 bytes, cut to 31 whole characters within 63 bytes
+    std::string name;
+    for (int i = 0; i < 40; i++)
+        name += "\xC3\xA9";
+    SyntheticCombatEvent kill = MakeKillingBlow(1, Self, Enemy(0x200, "x"), 7);
+    kill.dst.Name = const_cast<char*>(name.c_str());
+    kill.data.skillname = const_cast<char*>(name.c_str());
+
+    KillNames names;
+    CHECK(CaptureKillNames(kill.data, names));
+    CHECK_EQ(strlen(names.Victim), 62u);
+    CHECK_EQ(strlen(names.Skill), 62u);
+
+    // Render never overruns a small buffer
+    KillFeed feed;
+    feed.Stage(names);
+    feed.Add(MakeCombatRecord(kill.data, CombatSource_Local));
+    char small[16];
+    CHECK_EQ(feed.Render(small, sizeof(small)), 15u);
+    CHECK_EQ(strlen(small), 15u);
+}
+
+static void TestSkillCacheIsBounded()
+{
+    KillFeed feed;
+    char skillName[32];
+    for (uint32_t skill = 1; skill <= KillFeed::MaxSkills + 10; skill++)
+    {
+        snprintf(skillName, sizeof(skillName), "Skill %u", skill);
+        Kill(feed, MakeKillingBlow(skill, Self, Enemy(0x200, "Victim"), skill), skillName);
+    }
+    CHECK(strcmp(feed.SkillName(1), "Skill 1") == 0);
+    CHECK(strcmp(feed.SkillName(KillFeed::MaxSkills), "Skill 256") == 0);
+    CHECK(feed.SkillName(KillFeed::MaxSkills + 1) == nullptr);
+    CHECK(Render(feed).compare(0, 30, "Victim (Revenant) - Skill #266") == 0);
+}
+
+static void TestKillsDoNotAllocate()
+{
+    static KillFeed feed;
+    SyntheticCombatEvent kills[8];
+    for (uint32_t i = 0; i < 8; i++)
+        kills[i] = MakeKillingBlow(i + 1, Self, Enemy(0x200 + i, "Victim"), 1000 + i % 3);
+
+    size_t before = g_allocations.load();
+    for (int round = 0; round < 100; round++)
+    {
+        for (SyntheticCombatEvent& kill : kills)
+            Kill(feed, kill, "Skill");
+        char buffer[KillFeed::MaxTextSize];
+        feed.Render(buffer, sizeof(buffer));
+    }
+    CHECK_EQ(g_allocations.load(), before);
+}
+
+int main()
+{
+    RUN_TEST(TestCapture);
+    RUN_TEST(TestFeedNewestFirstAndBounded);
+    RUN_TEST(TestMissingNames);
+    RUN_TEST(TestOneStagedCopyPerKill);
+    RUN_TEST(TestLongNamesAreCutOnCharacterBoundaries);
+    RUN_TEST(TestSkillCacheIsBounded);
+    RUN_TEST(TestKillsDoNotAllocate);
+    return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,153 @@
+///----------------------------------------------------------------------------------------------------
+/// Metrics tests - histogram accuracy, per-thread merge, the runtime switch and the metrics files
+///----------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics.h"
+#include "streamlink.h"
+#include "stub_addon_api.h"
+#include "synthetic_events.h"
+#include "test_common.h"
+
+static void TestPercentilesAreLogLinear()
+{
+    Metrics::Reset();
+
+    // 98 fast samples, 2 slow ones: p50 sits on the fast value, p99 and max on the slow one
+    for (int i = 0; i < 98; i++)
+        Metrics::Record(Metrics::Probe_FileWrite, 1000);
+    Metrics::Record(Metrics::Probe_FileWrite, 100000);
+    Metrics::Record(Metrics::Probe_FileWrite, 100000);
+
+    // The first summary starts the tick rate measurement instead of waiting on it
+    Metrics::Summary s = Metrics::Summarize(Metrics::Probe_FileWrite);
+    CHECK_EQ(s.Count, uint64_t(100));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+    s = Metrics::Summarize(Metrics::Probe_FileWrite);
+    CHECK_EQ(s.Count, uint64_t(100));
+    CHECK(s.Max > 0);
+    CHECK(s.P50 <= s.P99 && s.P99 <= s.Max);
+    CHECK_EQ(s.P99, s.Max);
+
+    // Same tick-to-ns factor on both, so the ratio is the tick ratio within one sub-bucket (~6%)
+    double ratio = static_cast<double>(s.P50) / static_cast<double>(s.Max);
+    CHECK(ratio >= 0.0099 && ratio <= 0.0107);
+
+    CHECK_EQ(Metrics::Summarize(Metrics::Probe_LocalEvent).Count, uint64_t(0));
+}
+
+static void TestThreadsMergeWithoutSharing()
+{
+    Metrics::Reset();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([]
+        {
+            for (int i = 0; i < 5000; i++)
+                Metrics::Record(Metrics::Probe_EventBatch, static_cast<uint64_t>(i));
+        });
+    }
+    for (std::thread& t : threads)
+        t.join();
+
+    CHECK_EQ(Metrics::Summarize(Metrics::Probe_EventBatch).Count, uint64_t(20000));
+    CHECK_EQ(Metrics::Lost(), uint64_t(0));
+
+    // Exited threads hand their slots back, so this many threads never runs out
+    for (size_t round = 0; round < Metrics::MaxThreads * 2; round++)
+        std::thread([] { Metrics::Record(Metrics::Probe_EventBatch, 1); }).join();
+    CHECK_EQ(Metrics::Lost(), uint64_t(0));
+    CHECK_EQ(Metrics::Summarize(Metrics::Probe_EventBatch).Count, uint64_t(20000 + Metrics::MaxThreads * 2));
+}
+
+static void TestScopeHonoursSwitch()
+{
+    Metrics::Reset();
+    Metrics::SetEnabled(false);
+    {
+        STREAMLINK_METRICS_SCOPE(Metrics::Probe_SquadUpdate);
+    }
+    CHECK_EQ(Metrics::Summarize(Metrics::Probe_SquadUpdate).Count, uint64_t(0));
+
+    Metrics::SetEnabled(true);
+    {
+        STREAMLINK_METRICS_SCOPE(Metrics::Probe_SquadUpdate);
+    }
+    Metrics::SetEnabled(false);
+    CHECK_EQ(Metrics::Summarize(Metrics::Probe_SquadUpdate).Count, uint64_t(1));
+}
+
+static void TestRenderFormats()
+{
+    Metrics::Reset();
+    Metrics::Record(Metrics::Probe_LocalEvent, 50);
+
+    char buffer[4096];
+    size_t length = Metrics::RenderText(buffer, sizeof(buffer));
+    std::string text(buffer, length);
+    CHECK(text.find("local_event") != std::string::npos);
+    CHECK(text.find("overlay_refresh") != std::string::npos);
+
+    length = Metrics::RenderJson(buffer, sizeof(buffer));
+    std::string json(buffer, length);
+    CHECK(json.find("\"local_event\":{\"count\":1,") != std::string::npos);
+    CHECK(json.front() == '{');
+    CHECK(json.find("}}") != std::string::npos);
+
+    // A short buffer truncates instead of overflowing
+    length = Metrics::RenderJson(buffer, 16);
+    CHECK(length <= 16);
+}
+
+static void TestAddonWritesMetricsFiles()
+{
+    FakeMumbleLink mumble;
+    CHECK(mumble.Create("metrics"));
+    AddonAPI* api = StubApi::Create("metrics");
+    std::string settings = std::string("addons/streamlink/killstreak.txt\nmumble_link=") + mumble.Name() +
+                           "\nmetrics=1\n";
+    StubApi::WriteSettings(settings.c_str());
+    Streamlink::Load(api);
+    CHECK(Metrics::IsEnabled());
+
+    SyntheticAgent self{0x10, ProfessionGuardian, 1, true, "Self"};
+    SyntheticAgent enemy{0x20, ProfessionRevenant, 2, false, "Enemy"};
+    for (int i = 0; i < 10; i++)
+    {
+        SyntheticCombatEvent e = MakeStrike(static_cast<uint64_t>(i), self, enemy, ArcDPS::CBTR_NORMAL);
+        StubApi::Raise(EV_ARCDPS_COMBATEVENT_LOCAL_RAW, &e.data);
+    }
+
+    // Runtime switch: events while off are not counted
+    StubApi::Raise(EV_STREAMLINK_TOGGLE_METRICS, nullptr);
+    CHECK(!Metrics::IsEnabled());
+    SyntheticCombatEvent ignored = MakeStrike(99, self, enemy, ArcDPS::CBTR_NORMAL);
+    StubApi::Raise(EV_ARCDPS_COMBATEVENT_LOCAL_RAW, &ignored.data);
+
+    Streamlink::Unload();
+    std::string json = StubApi::ReadFile(StubApi::GamePath("addons/streamlink/metrics.json"));
+    CHECK(json.find("\"enabled\":false") != std::string::npos);
+    CHECK(json.find("\"local_event\":{\"count\":10,") != std::string::npos);
+    std::string text = StubApi::ReadFile(StubApi::GamePath("addons/streamlink/metrics.txt"));
+    CHECK(text.find("local_event") != std::string::npos);
+
+    StubApi::Destroy();
+    Metrics::SetEnabled(false);
+}
+
+int main()
+{
+    RUN_TEST(TestPercentilesAreLogLinear);
+    RUN_TEST(TestThreadsMergeWithoutSharing);
+    RUN_TEST(TestScopeHonoursSwitch);
+    RUN_TEST(TestRenderFormats);
+    RUN_TEST(TestAddonWritesMetricsFiles);
+    return TEST_MAIN_RESULT();
+}
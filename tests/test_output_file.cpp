@@ -0,0 +1,116 @@
+///----------------------------------------------------------------------------------------------------
+/// Output file tests - change detection, a refused replace keeps the old file, the writer retries
+///----------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "output_file.h"
+#include "output_writer.h"
+#include "stub_addon_api.h"
+#include "test_common.h"
+
+// A non-empty directory at the output path: nothing can be renamed over it, much like a file another
+// program holds open without delete sharing on Windows
+static void BlockPath(const std::string& path)
+{
+    mkdir(path.c_str(), 0755);
+    FILE* f = fopen((path + "/keep").c_str(), "w");
+    if (f)
+        fclose(f);
+}
+
+static void UnblockPath(const std::string& path)
+{
+    remove((path + "/keep").c_str());
+    rmdir(path.c_str());
+}
+
+static bool Exists(const std::string& path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0;
+}
+
+static std::string g_value = "1";
+
+static size_t RenderValue(char* buffer, size_t size)
+{
+    return static_cast<size_t>(snprintf(buffer, size, "%s", g_value.c_str()));
+}
+
+static void TestWriteSkipsUnchanged()
+{
+    StubApi::Create("output_file");
+    std::string path = StubApi::GamePath("out/value.txt");
+
+    OutputFile file;
+    CHECK(file.Open(path));
+    CHECK(file.Write("12", 2));
+    CHECK(StubApi::ReadFile(path) == "12");
+
+    // Same bytes: not written again, even though the file changed underneath
+    remove(path.c_str());
+    CHECK(file.Write("12", 2));
+    CHECK(!Exists(path));
+    CHECK(file.Write("13", 2));
+    CHECK(StubApi::ReadFile(path) == "13");
+    StubApi::Destroy();
+}
+
+static void TestRefusedReplaceIsNotRewrittenInPlace()
+{
+    StubApi::Create("output_refused");
+    std::string path = StubApi::GamePath("value.txt");
+
+    OutputFile file;
+    CHECK(file.Open(path));
+    BlockPath(path);
+    CHECK(!file.Write("7", 1));
+    CHECK(Exists(path + "/keep"));          // the target was left alone
+    CHECK(!Exists(path + ".tmp"));          // and the temp file removed
+
+    // The failed write was not cached: the same value goes out once the path is free
+    UnblockPath(path);
+    CHECK(file.Write("7", 1));
+    CHECK(StubApi::ReadFile(path) == "7");
+    StubApi::Destroy();
+}
+
+static void TestWriterRetriesRefusedWrites()
+{
+    StubApi::Create("output_retry");
+    std::string path = StubApi::GamePath("value.txt");
+    BlockPath(path);
+
+    g_value = "42";
+    int id = OutputWriter::Register(path, RenderValue);
+    CHECK(id != OutputWriter::InvalidOutput);
+    OutputWriter::Start(10);
+    OutputWriter::MarkDirty(id);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(Exists(path + "/keep"));
+
+    // Nothing marks the output again; the writer keeps it pending until the replace succeeds
+    UnblockPath(path);
+    for (int i = 0; i < 200 && StubApi::ReadFile(path) != "42"; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(StubApi::ReadFile(path) == "42");
+
+    OutputWriter::Stop();
+    OutputWriter::Reset();
+    StubApi::Destroy();
+}
+
+int main()
+{
+    RUN_TEST(TestWriteSkipsUnchanged);
+    RUN_TEST(TestRefusedReplaceIsNotRewrittenInPlace);
+    RUN_TEST(TestWriterRetriesRefusedWrites);
+    return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,256 @@
+///----------------------------------------------------------------------------------------------------
+/// Overlay server tests - HTTP snapshot, WebSocket handshake, pushed deltas and control frames,
+/// against a local client over loopback
+///----------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#include "combat_tracker.h"
+#include "net.h"
+#include "overlay_server.h"
+#include "streamlink.h"
+#include "stub_addon_api.h"
+#include "synthetic_events.h"
+#include "test_common.h"
+#include "websocket.h"
+
+static const SyntheticAgent Self{0x100, ProfessionGuardian, 1, true, "Self"};
+static const SyntheticAgent Enemy{0x200, ProfessionRevenant, 2, false, "Enemy"};
+
+static FakeMumbleLink g_mumble;
+
+static void RaiseLocal(SyntheticCombatEvent e)
+{
+    StubApi::Raise(EV_ARCDPS_COMBATEVENT_LOCAL_RAW, &e.data);
+}
+
+static void LoadAddon(const char* testName, const char* extraSettings)
+{
+    AddonAPI* api = StubApi::Create(testName);
+    std::string settings = std::string("addons/streamlink/killstreak.txt\nmumble_link=") + g_mumble.Name() + "\n" +
+                           extraSettings;
+    StubApi::WriteSettings(settings.c_str());
+    g_mumble.SetMap(MapTypeEternalBattlegrounds, MapIdEternalBattlegrounds);
+    Streamlink::Load(api);
+}
+
+///----------------------------------------------------------------------------------------------------
+/// TestClient - Loopback client with timeouts, so a broken server fails the test instead of hanging
+///----------------------------------------------------------------------------------------------------
+class TestClient
+{
+public:
+    explicit TestClient(uint16_t port) : m_socket(Net::ConnectLoopback(port)) {}
+    ~TestClient() { Net::Close(m_socket); }
+
+    bool SendAll(const void* data, size_t length)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (length > 0 && std::chrono::steady_clock::now() < deadline)
+        {
+            Net::PollEntry entry{m_socket, true, false, false};
+            Net::Poll(&entry, 1, 50);
+            long sent = Net::Send(m_socket, bytes, length);
+            if (sent < 0)
+                return false;
+            bytes += sent;
+            length -= static_cast<size_t>(sent);
+        }
+        return length == 0;
+    }
+
+    /// Reads until predicate(buffer) holds, the peer closes, or the timeout expires.
+    template <typename Predicate>
+    bool ReadUntil(Predicate predicate, int timeoutMs = 2000)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (!predicate(m_buffer))
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+                return false;
+
+            Net::PollEntry entry{m_socket, false, false, false};
+            Net::Poll(&entry, 1, 50);
+            char chunk[4096];
+            long received = Net::Recv(m_socket, chunk, sizeof(chunk));
+            if (received < 0)
+            {
+                m_closed = true;
+                return predicate(m_buffer);
+            }
+            m_buffer.append(chunk, static_cast<size_t>(received));
+        }
+        return true;
+    }
+
+    bool WaitClosed()
+    {
+        ReadUntil([this](const std::string&) { return m_closed; });
+        return m_closed;
+    }
+
+    /// Pops one complete WebSocket frame from the buffer.
+    bool ReadFrame(uint8_t& opcode, std::string& payload)
+    {
+        WebSocket::Frame frame;
+        auto complete = [&frame](const std::string& buffer)
+        {
+            return WebSocket::ParseFrame(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size(), frame);
+        };
+        if (!ReadUntil(complete))
+            return false;
+
+        opcode = frame.opcode;
+        payload = m_buffer.substr(frame.headerSize, frame.payloadLength);
+        m_buffer.erase(0, frame.headerSize + frame.payloadLength);
+        return !frame.masked;
+    }
+
+    /// Sends a masked client frame, as browsers do.
+    bool SendFrame(uint8_t opcode, const std::string& payload)
+    {
+        uint8_t header[WebSocket::MaxHeaderSize + 4];
+        size_t headerSize = WebSocket::EncodeHeader(opcode, payload.size(), header);
+        header[1] |= 0x80;
+        const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+        memcpy(header + headerSize, mask, 4);
+
+        std::string frame(reinterpret_cast<const char*>(header), headerSize + 4);
+        for (size_t i = 0; i < payload.size(); i++)
+            frame += static_cast<char>(payload[i] ^ mask[i & 3]);
+        return SendAll(frame.data(), frame.size());
+    }
+
+    std::string& Buffer() { return m_buffer; }
+
+private:
+    Net::Socket m_socket;
+    std::string m_buffer;
+    bool        m_closed = false;
+};
+
+static bool Contains(const std::string& text, const char* needle)
+{
+    return text.find(needle) != std::string::npos;
+}
+
+static void TestHandshakePrimitives()
+{
+    uint8_t digest[20];
+    WebSocket::Sha1("abc", 3, digest);
+    CHECK_EQ(digest[0], 0xA9);
+    CHECK_EQ(digest[19], 0x9D);
+
+    // RFC 6455 section 1.3 example
+    char accept[WebSocket::AcceptKeyLength + 1];
+    const char* key = "dGhlIHNhbXBsZSBub25jZQ==";
+    WebSocket::AcceptKey(key, strlen(key), accept);
+    CHECK(strcmp(accept, "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") == 0);
+
+    uint8_t header[WebSocket::MaxHeaderSize];
+    CHECK_EQ(WebSocket::EncodeHeader(WebSocket::Opcode_Text, 100, header), 2u);
+    CHECK_EQ(WebSocket::EncodeHeader(WebSocket::Opcode_Text, 1000, header), 4u);
+    CHECK_EQ(WebSocket::EncodeHeader(WebSocket::Opcode_Text, 70000, header), 10u);
+}
+
+static void TestServerDisabledByDefault()
+{
+    LoadAddon("serveroff", "");
+    CHECK_EQ(OverlayServer::Port(), 0);
+    Streamlink::Unload();
+    StubApi::Destroy();
+}
+
+static void TestHttpSnapshot()
+{
+    LoadAddon("serverhttp", "server=1\nserver_port=0\n");
+    uint16_t port = OverlayServer::Port();
+    CHECK(port != 0);
+
+    RaiseLocal(MakeKillingBlow(1, Self, Enemy));
+    {
+        TestClient client(port);
+        const char request[] = "GET /state HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+        CHECK(client.SendAll(request, sizeof(request) - 1));
+        CHECK(client.WaitClosed());
+        CHECK(Contains(client.Buffer(), "HTTP/1.1 200 OK"));
+        CHECK(Contains(client.Buffer(), "application/json"));
+        CHECK(Contains(client.Buffer(), "\"killstreak\":1"));
+        CHECK(Contains(client.Buffer(), "\"playerStatus\":\"alive\""));
+        CHECK(Contains(client.Buffer(), "\"map\":\"Eternal Battlegrounds\""));
+    }
+    {
+        TestClient client(port);
+        const char request[] = "GET /nothing HTTP/1.1\r\n\r\n";
+        CHECK(client.SendAll(request, sizeof(request) - 1));
+        CHECK(client.WaitClosed());
+        CHECK(Contains(client.Buffer(), "404"));
+    }
+
+    Streamlink::Unload();
+    CHECK_EQ(OverlayServer::Port(), 0);
+    StubApi::Destroy();
+}
+
+static void TestWebSocketPushesDeltas()
+{
+    LoadAddon("serverws", "server=1\nserver_port=0\n");
+    TestClient client(OverlayServer::Port());
+
+    const char request[] = "GET /state HTTP/1.1\r\nHost: 127.0.0.1\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                           "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    CHECK(client.SendAll(request, sizeof(request) - 1));
+    CHECK(client.ReadUntil([](const std::string& b) { return b.find("\r\n\r\n") != std::string::npos; }));
+    CHECK(Contains(client.Buffer(), "101 Switching Protocols"));
+    CHECK(Contains(client.Buffer(), "Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo="));
+    client.Buffer().erase(0, client.Buffer().find("\r\n\r\n") + 4);
+
+    uint8_t opcode = 0;
+    std::string payload;
+    CHECK(client.ReadFrame(opcode, payload));
+    CHECK_EQ(opcode, WebSocket::Opcode_Text);
+    CHECK(Contains(payload, "\"type\":\"snapshot\""));
+    CHECK(Contains(payload, "\"killstreak\":0"));
+
+    // A kill is pushed as a delta holding only what changed
+    RaiseLocal(MakeKillingBlow(1, Self, Enemy));
+    CHECK(client.ReadFrame(opcode, payload));
+    CHECK(Contains(payload, "\"type\":\"delta\""));
+    CHECK(Contains(payload, "\"killstreak\":1"));
+    CHECK(!Contains(payload, "playerStatus"));
+
+    RaiseLocal(MakeKillingBlow(2, Self, Enemy));
+    CHECK(client.ReadFrame(opcode, payload));
+    CHECK(Contains(payload, "\"killstreak\":2"));
+
+    CHECK(client.SendFrame(WebSocket::Opcode_Ping, "hi"));
+    CHECK(client.ReadFrame(opcode, payload));
+    CHECK_EQ(opcode, WebSocket::Opcode_Pong);
+    CHECK(payload == "hi");
+
+    CHECK(client.SendFrame(WebSocket::Opcode_Close, ""));
+    CHECK(client.ReadFrame(opcode, payload));
+    CHECK_EQ(opcode, WebSocket::Opcode_Close);
+    CHECK(client.WaitClosed());
+
+    Streamlink::Unload();
+    StubApi::Destroy();
+}
+
+int main()
+{
+    if (!g_mumble.Create("overlay"))
+    {
+        fprintf(stderr, "could not create fake MumbleLink\n");
+        return 1;
+    }
+
+    RUN_TEST(TestHandshakePrimitives);
+    RUN_TEST(TestServerDisabledByDefault);
+    RUN_TEST(TestHttpSnapshot);
+    RUN_TEST(TestWebSocketPushesDeltas);
+    return TEST_MAIN_RESULT();
+}
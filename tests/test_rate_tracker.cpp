@@ -0,0 +1,127 @@
+///----------------------------------------------------------------------------------------------------
+/// Rate tracker tests - sliding window bucketing, expiry, late events, rate scaling and the event clock
+///----------------------------------------------------------------------------------------------------
+
+#include <cstdint>
+
+#include "event_clock.h"
+#include "rate_tracker.h"
+#include "sliding_window.h"
+#include "test_common.h"
+
+static void TestWindowSumsWithinWindow()
+{
+    SlidingWindow window(10000);   // 50 buckets of 200 ms
+    CHECK_EQ(window.WindowMs(), 10000u);
+    CHECK_EQ(window.Sum(0), uint64_t(0));
+
+    window.Add(1000, 5);
+    window.Add(1100, 7);
+    window.Add(5000, 3);
+    CHECK_EQ(window.Sum(5000), uint64_t(15));
+    CHECK_EQ(window.Sum(10999), uint64_t(15));
+
+    // The 1000 ms bucket leaves once the window has moved a full length past it
+    CHECK_EQ(window.Sum(11000), uint64_t(3));
+    CHECK_EQ(window.Sum(14999), uint64_t(3));
+    CHECK_EQ(window.Sum(15000), uint64_t(0));
+}
+
+static void TestWindowLateAndOldEvents()
+{
+    SlidingWindow window(10000);
+    window.Add(20000, 1);
+
+    // Slightly out of order still counts; older than the window does not
+    window.Add(19500, 2);
+    window.Add(9000, 100);
+    CHECK_EQ(window.Sum(20000), uint64_t(3));
+
+    // Querying an earlier time never moves the window back
+    CHECK_EQ(window.Sum(100), uint64_t(3));
+}
+
+static void TestWindowLongGapClearsEverything()
+{
+    SlidingWindow window(10000);
+    for (uint64_t t = 0; t < 10000; t += 100)
+        window.Add(t, 1);
+    CHECK_EQ(window.Sum(9999), uint64_t(100));
+
+    window.Add(1000000, 4);
+    CHECK_EQ(window.Sum(1000000), uint64_t(4));
+
+    window.Clear();
+    CHECK_EQ(window.Sum(1000000), uint64_t(0));
+}
+
+static void TestWindowRunningTotalMatchesBuckets()
+{
+    // Steady stream of one event every 50 ms: a 10 s window always holds about 200
+    SlidingWindow window(10000);
+    bool steady = true;
+    for (uint64_t t = 0; t < 60000; t += 50)
+    {
+        window.Add(t, 1);
+        if (t >= 10000)
+        {
+            uint64_t sum = window.Sum(t);
+            steady = steady && sum >= 196 && sum <= 201;
+        }
+    }
+    CHECK(steady);
+}
+
+static void TestRatesScaleToUnits()
+{
+    RateTracker::Reset();
+
+    const uint64_t start = 100000;
+    for (uint64_t i = 0; i < 6; i++)
+        RateTracker::Add(Rate_Kills, start + i * 1000, 1);
+    RateTracker::Add(Rate_Damage, start, 20000);
+    RateTracker::Add(Rate_Damage, start + 5000, 30000);
+    uint64_t now = start + 5000;
+
+    CHECK_EQ(RateTracker::Total(Rate_Kills, RateWindow_10s, now), uint64_t(6));
+    CHECK(RateTracker::Rate(Rate_Kills, RateWindow_10s, now) == 36.0);    // 6 kills in 10 s
+    CHECK(RateTracker::Rate(Rate_Kills, RateWindow_60s, now) == 6.0);
+    CHECK(RateTracker::Rate(Rate_Kills, RateWindow_5min, now) == 1.2);
+    CHECK(RateTracker::Rate(Rate_Damage, RateWindow_10s, now) == 5000.0);  // 50k damage in 10 s
+    CHECK(RateTracker::Rate(Rate_Downs, RateWindow_60s, now) == 0.0);
+
+    // Kills age out of the short window first
+    CHECK(RateTracker::Rate(Rate_Kills, RateWindow_10s, start + 20000) == 0.0);
+    CHECK(RateTracker::Rate(Rate_Kills, RateWindow_60s, start + 20000) == 6.0);
+
+    RateTracker::Reset();
+    CHECK_EQ(RateTracker::Total(Rate_Kills, RateWindow_5min, now), uint64_t(0));
+}
+
+static void TestEventClockFollowsNewestEvent()
+{
+    EventClock::Reset();
+    CHECK_EQ(EventClock::Now(), uint64_t(0));
+
+    EventClock::Observe(100000);
+    uint64_t now = EventClock::Now();
+    CHECK(now >= 100000 && now < 101000);
+
+    // An older event does not pull it back; the clock keeps running between events
+    EventClock::Observe(50000);
+    CHECK(EventClock::Now() >= now);
+
+    EventClock::Reset();
+    CHECK_EQ(EventClock::Now(), uint64_t(0));
+}
+
+int main()
+{
+    RUN_TEST(TestWindowSumsWithinWindow);
+    RUN_TEST(TestWindowLateAndOldEvents);
+    RUN_TEST(TestWindowLongGapClearsEverything);
+    RUN_TEST(TestWindowRunningTotalMatchesBuckets);
+    RUN_TEST(TestRatesScaleToUnits);
+    RUN_TEST(TestEventClockFollowsNewestEvent);
+    return TEST_MAIN_RESULT();
+}
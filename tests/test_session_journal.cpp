@@ -0,0 +1,294 @@
+///----------------------------------------------------------------------------------------------------
+/// Session journal tests - replay and restore window, torn and corrupted tails, compaction, history
+///----------------------------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "session_journal.h"
+#include "test_common.h"
+
+static const uint64_t Minute = 60 * 1000;
+static const uint64_t Start = 1700000000000ull;   // some wall-clock time, in ms
+
+static std::string ScratchPath(const char* name)
+{
+    const char* tmp = getenv("TMPDIR");
+    std::string path = std::string(tmp && tmp[0] ? tmp : "/tmp") + "/streamlink_journal_" + name + "_" +
+                       std::to_string(static_cast<int>(getpid())) + "/journal.bin";
+    remove(path.c_str());
+    return path;
+}
+
+static void RemoveScratch(const std::string& path)
+{
+    remove(path.c_str());
+    rmdir(path.substr(0, path.find_last_of('/')).c_str());
+}
+
+static SessionCounters Counters(uint32_t kills, uint32_t deaths, uint32_t streak)
+{
+    SessionCounters counters;
+    counters.Values[SessionStat_Kills] = kills;
+    counters.Values[SessionStat_Deaths] = deaths;
+    counters.Values[SessionStat_CurrentStreak] = streak;
+    counters.Values[SessionStat_BestStreak] = streak;
+    return counters;
+}
+
+static long FileSize(const std::string& path)
+{
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f)
+        return -1;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+static void TestRestoreWithinWindow()
+{
+    std::string path = ScratchPath("restore");
+    SessionCounters restored;
+    CHECK(!SessionJournal::Open(path, Start, 10 * Minute, restored));
+    CHECK_EQ(SessionJournal::Session(), 1u);
+
+    SessionJournal::Record(Counters(1, 0, 1), Start + 1000);
+    SessionJournal::Record(Counters(2, 0, 2), Start + 2000);
+    SessionJournal::Flush();
+    SessionJournal::Record(Counters(3, 0, 3), Start + 3000);
+    SessionJournal::Flush();   // then the game crashes: no summary
+
+    CHECK(SessionJournal::Open(path, Start + 5 * Minute, 10 * Minute, restored));
+    CHECK_EQ(restored.Get(SessionStat_Kills), 3u);
+    CHECK_EQ(restored.Get(SessionStat_CurrentStreak), 3u);
+    CHECK_EQ(SessionJournal::Session(), 1u);   // same session carries on
+
+    SessionJournal::Record(Counters(4, 1, 0), Start + 6 * Minute);
+    SessionJournal::Close(Counters(4, 1, 0), Start + 7 * Minute);
+
+    // Too old: a new session starts from zero, the history stays
+    restored = SessionCounters();
+    CHECK(!SessionJournal::Open(path, Start + 30 * Minute, 10 * Minute, restored));
+    CHECK_EQ(restored.Get(SessionStat_Kills), 0u);
+    CHECK_EQ(SessionJournal::Session(), 2u);
+    SessionJournal::Close(Counters(0, 0, 0), Start + 31 * Minute);
+
+    JournalReader reader;
+    CHECK(reader.Open(path.c_str()));
+    CHECK(!reader.Damaged());
+    CHECK_EQ(reader.Count(), size_t(6));
+    if (reader.Count() == 6)
+    {
+        CHECK_EQ(reader.Records()[4].Type, uint16_t(JournalRecord_Summary));
+        CHECK_EQ(reader.Records()[4].Stats[SessionStat_Deaths], 1u);
+        CHECK_EQ(reader.Records()[5].Session, 2u);
+    }
+    reader.Close();
+
+    // A window of 0 never restores
+    CHECK(!SessionJournal::Open(path, Start + 31 * Minute, 0, restored));
+    SessionJournal::Close(Counters(0, 0, 0), Start + 31 * Minute);
+    RemoveScratch(path);
+}
+
+static void TestTornAndCorruptedTails()
+{
+    std::string path = ScratchPath("torn");
+    SessionCounters restored;
+    SessionJournal::Open(path, Start, 10 * Minute, restored);
+    for (uint32_t k = 1; k <= 5; k++)
+        SessionJournal::Record(Counters(k, 0, k), Start + k * 1000);
+    SessionJournal::Flush();
+    SessionJournal::Close(Counters(5, 0, 5), Start + 6000);
+    long complete = FileSize(path);
+
+    // Half a record appended by a crash mid-write is ignored
+    FILE* f = fopen(path.c_str(), "ab");
+    const char garbage[30] = "half a record from a crash";
+    fwrite(garbage, 1, sizeof(garbage), f);
+    fclose(f);
+
+    JournalReader reader;
+    CHECK(reader.Open(path.c_str()));
+    CHECK(reader.Damaged());
+    CHECK_EQ(reader.Count(), size_t(6));
+    reader.Close();
+
+    // A flipped bit in the last whole record fails its checksum: the one before it is restored
+    f = fopen(path.c_str(), "r+b");
+    fseek(f, complete - 8, SEEK_SET);
+    fputc(0x5A, f);
+    fclose(f);
+
+    CHECK(SessionJournal::Open(path, Start + Minute, 10 * Minute, restored));
+    CHECK_EQ(restored.Get(SessionStat_Kills), 5u);
+    CHECK_EQ(restored.Get(SessionStat_CurrentStreak), 5u);
+
+    // The damaged tail is cut off before anything else is appended
+    SessionJournal::Record(Counters(6, 0, 6), Start + 2 * Minute);
+    SessionJournal::Close(Counters(6, 0, 6), Start + 2 * Minute);
+    CHECK(reader.Open(path.c_str()));
+    CHECK(!reader.Damaged());
+    CHECK_EQ(reader.Count(), size_t(3));   // compacted to the last record, then two appends
+    reader.Close();
+
+    // Not a journal at all: replaced by a fresh one
+    f = fopen(path.c_str(), "wb");
+    fputs("killstreak=5\n", f);
+    fclose(f);
+    CHECK(!SessionJournal::Open(path, Start, 10 * Minute, restored));
+    SessionJournal::Close(Counters(1, 0, 1), Start);
+    CHECK(reader.Open(path.c_str()));
+    CHECK_EQ(reader.Count(), size_t(1));
+    reader.Close();
+    RemoveScratch(path);
+}
+
+static std::string ReadAll(const std::string& path)
+{
+    std::string bytes;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f)
+        return bytes;
+    char chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), f)) != 0)
+        bytes.append(chunk, read);
+    fclose(f);
+    return bytes;
+}
+
+static void TestRefusedCompactionKeepsJournal()
+{
+    std::string path = ScratchPath("refused");
+    SessionCounters restored;
+    SessionJournal::Open(path, Start, 10 * Minute, restored);
+    SessionJournal::Record(Counters(3, 0, 3), Start + 1000);
+    SessionJournal::Close(Counters(3, 0, 3), Start + 2000);
+
+    FILE* f = fopen(path.c_str(), "ab");
+    fputs("torn", f);
+    fclose(f);
+    std::string before = ReadAll(path);
+
+    // A non-empty directory where the rewrite goes: the replace is refused
+    std::string blocked = path + ".tmp";
+    mkdir(blocked.c_str(), 0755);
+    fclose(fopen((blocked + "/keep").c_str(), "w"));
+
+    CHECK(SessionJournal::Open(path, Start + Minute, 10 * Minute, restored));
+    SessionJournal::Record(Counters(4, 0, 4), Start + Minute);
+    SessionJournal::Flush();
+    SessionJournal::Flush();
+    CHECK(ReadAll(path) == before);
+
+    // Once the rewrite goes through, the snapshots that waited follow it
+    remove((blocked + "/keep").c_str());
+    rmdir(blocked.c_str());
+    SessionJournal::Flush();
+    JournalReader reader;
+    CHECK(reader.Open(path.c_str()));
+    CHECK(!reader.Damaged());
+    CHECK_EQ(reader.Count(), size_t(2));
+    CHECK_EQ(reader.Records()[1].Stats[SessionStat_Kills], 4u);
+    reader.Close();
+    SessionJournal::Close(Counters(4, 0, 4), Start + Minute);
+    RemoveScratch(path);
+}
+
+static void TestFullQueueKeepsNewestSnapshot()
+{
+    std::string path = ScratchPath("full");
+    SessionCounters restored;
+    SessionJournal::Open(path, Start, 10 * Minute, restored);
+
+    // Far more snapshots than the queue holds before the writer gets to them
+    const uint32_t Snapshots = 1000;
+    for (uint32_t k = 1; k <= Snapshots; k++)
+        SessionJournal::Record(Counters(k, 0, k), Start + k);
+    SessionJournal::Flush();
+
+    JournalReader reader;
+    CHECK(reader.Open(path.c_str()));
+    CHECK(reader.Count() > 0 && reader.Count() < Snapshots);
+    CHECK_EQ(reader.Records()[reader.Count() - 1].Stats[SessionStat_Kills], Snapshots);
+    reader.Close();
+
+    // Snapshots after the drain queue normally again and stay in order
+    SessionJournal::Record(Counters(Snapshots + 1, 0, 1), Start + Snapshots + 1);
+    SessionJournal::Flush();
+    CHECK(reader.Open(path.c_str()));
+    CHECK_EQ(reader.Records()[reader.Count() - 1].Stats[SessionStat_Kills], Snapshots + 1);
+    reader.Close();
+
+    SessionJournal::Close(Counters(Snapshots + 1, 0, 1), Start + Snapshots + 2);
+    CHECK(SessionJournal::Open(path, Start + Minute, 10 * Minute, restored));
+    CHECK_EQ(restored.Get(SessionStat_Kills), Snapshots + 1);
+    SessionJournal::Close(restored, Start + Minute);
+    RemoveScratch(path);
+}
+
+static void TestCompactionKeepsSessionHistory()
+{
+    std::string path = ScratchPath("compact");
+    SessionCounters restored;
+
+    // Ten short sessions, far enough apart that none is restored
+    uint64_t now = Start;
+    for (uint32_t session = 1; session <= 10; session++)
+    {
+        SessionJournal::Open(path, now, Minute, restored);
+        CHECK_EQ(SessionJournal::Session(), session);
+        for (uint32_t k = 1; k <= 20; k++)
+            SessionJournal::Record(Counters(k, 0, k), now + k);
+        SessionJournal::Flush();
+        SessionJournal::Close(Counters(20 + session, 1, 0), now + 100);
+        now += 60 * Minute;
+    }
+
+    // One long session pushes the file past the threshold; the writer compacts on its next pass
+    SessionJournal::Open(path, now, Minute, restored);
+    for (uint32_t k = 1; k <= SessionJournal::CompactThreshold; k++)
+    {
+        SessionJournal::Record(Counters(k, 0, k), now + k);
+        if ((k & 127) == 0)
+            SessionJournal::Flush();
+    }
+    SessionJournal::Flush();
+    SessionJournal::Flush();
+
+    JournalReader reader;
+    CHECK(reader.Open(path.c_str()));
+    CHECK(reader.Count() < SessionJournal::CompactThreshold / 16);   // history plus the appends since
+    bool history = reader.Count() >= 11;
+    for (uint32_t session = 1; history && session <= 10; session++)
+    {
+        const JournalRecord& summary = reader.Records()[session - 1];
+        history = summary.Session == session && summary.Type == JournalRecord_Summary &&
+                  summary.Stats[SessionStat_Kills] == 20 + session;
+    }
+    CHECK(history);
+    reader.Close();
+
+    SessionJournal::Close(Counters(SessionJournal::CompactThreshold, 0, 0), now + Minute);
+    CHECK(SessionJournal::Open(path, now + 2 * Minute, 10 * Minute, restored));
+    CHECK_EQ(restored.Get(SessionStat_Kills), uint32_t(SessionJournal::CompactThreshold));
+    SessionJournal::Close(restored, now + 2 * Minute);
+    RemoveScratch(path);
+}
+
+int main()
+{
+    RUN_TEST(TestRestoreWithinWindow);
+    RUN_TEST(TestTornAndCorruptedTails);
+    RUN_TEST(TestRefusedCompactionKeepsJournal);
+    RUN_TEST(TestFullQueueKeepsNewestSnapshot);
+    RUN_TEST(TestCompactionKeepsSessionHistory);
+    return TEST_MAIN_RESULT();
+}
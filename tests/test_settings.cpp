@@ -0,0 +1,239 @@
+///----------------------------------------------------------------------------------------------------
+/// Settings tests - key=value parsing, legacy first line, validation, config publication, file watch
+///----------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include "Nexus.h"
+#include "file_watcher.h"
+#include "settings.h"
+#include "test_common.h"
+
+static void TestDefaults()
+{
+    Config config = Settings::Defaults();
+    CHECK(config.OutputPaths[OutputPath_Killstreak] == "addons/streamlink/killstreak.txt");
+    CHECK(config.OutputPaths[OutputPath_MetricsJson] == "addons/streamlink/metrics.json");
+    CHECK(config.MumbleLink == "MumbleLink");
+    CHECK_EQ(config.FlushIntervalMs, 100u);
+    CHECK_EQ(config.LogLevel, int(ELogLevel_INFO));
+    CHECK(config.Journal && !config.Server && !config.SharedMemory);
+    CHECK_EQ(config.MilestoneCount, size_t(5));
+    CHECK_EQ(config.Milestones[4], 100u);
+}
+
+static void TestParseKeys()
+{
+    Config config = Settings::Defaults();
+    size_t rejected = Settings::Parse("# comment\n"
+                                      "; also a comment\n"
+                                      "  squad_file = overlay/squad.txt  \r\n"
+                                      "player_status_file=overlay/status.txt\n"
+                                      "kd_file=\n"
+                                      "\n"
+                                      "server=yes\n"
+                                      "shared_memory=on\n"
+                                      "reset_on_leave_wvw=true\n"
+                                      "journal=off\n"
+                                      "server_port=8080\n"
+                                      "flush_interval_ms=250\n"
+                                      "gauge_interval_ms=0\n"
+                                      "gauge_threshold=5\n"
+                                      "log_level=debug\n"
+                                      "mumble_link=MumbleLink_2\n",
+                                      config);
+    CHECK_EQ(rejected, size_t(0));
+    CHECK(config.OutputPaths[OutputPath_Squad] == "overlay/squad.txt");
+    CHECK(config.OutputPaths[OutputPath_PlayerStatus] == "overlay/status.txt");
+    CHECK(config.OutputPaths[OutputPath_KillDeathRatio].empty());
+    CHECK(config.OutputPaths[OutputPath_Killstreak] == "addons/streamlink/killstreak.txt");
+    CHECK(config.Server && config.SharedMemory && config.ResetOnLeaveWvW && !config.Journal);
+    CHECK_EQ(config.ServerPort, uint16_t(8080));
+    CHECK_EQ(config.FlushIntervalMs, 250u);
+    CHECK_EQ(config.GaugeIntervalMs, 0u);
+    CHECK_EQ(config.GaugeThreshold, 5u);
+    CHECK_EQ(config.LogLevel, int(ELogLevel_DEBUG));
+    CHECK(config.MumbleLink == "MumbleLink_2");
+}
+
+static void TestLegacyFirstLine()
+{
+    Config config = Settings::Defaults();
+    CHECK_EQ(Settings::Parse("obs/streak.txt\nshared_memory=1\n", config), size_t(0));
+    CHECK(config.OutputPaths[OutputPath_Killstreak] == "obs/streak.txt");
+    CHECK(config.SharedMemory);
+
+    // Only the first line may be a bare path
+    config = Settings::Defaults();
+    CHECK_EQ(Settings::Parse("server=1\nobs/streak.txt\n", config), size_t(1));
+    CHECK(config.OutputPaths[OutputPath_Killstreak] == "addons/streamlink/killstreak.txt");
+}
+
+static void TestLongLinesAreKeptWhole()
+{
+    // Well past any line buffer: the value arrives complete and the next line still parses
+    std::string path = "overlay/" + std::string(1500, 'a') + "/squad.txt";
+    Config config = Settings::Defaults();
+    CHECK_EQ(Settings::Parse("squad_file=" + path + "\nserver=1\n", config), size_t(0));
+    CHECK(config.OutputPaths[OutputPath_Squad] == path);
+    CHECK(config.Server);
+
+    // An over-long value that is invalid is rejected, not shortened into a valid one
+    config = Settings::Defaults();
+    CHECK_EQ(Settings::Parse("server=1" + std::string(1100, ' ') + "x\n", config), size_t(1));
+    CHECK(!config.Server);
+}
+
+static void TestInvalidValuesKeepDefaults()
+{
+    Config config = Settings::Defaults();
+    size_t rejected = Settings::Parse("server=maybe\n"
+                                      "server_port=70000\n"
+                                      "flush_interval_ms=1\n"
+                                      "flush_interval_ms=fast\n"
+                                      "gauge_threshold=101\n"
+                                      "log_level=loud\n"
+                                      "mumble_link=\n"
+                                      "no_such_key=1\n"
+                                      "milestones=5,x\n",
+                                      config);
+    CHECK_EQ(rejected, size_t(9));
+    Config defaults = Settings::Defaults();
+    CHECK(Settings::ChangedKeys(defaults, config).empty());
+}
+
+static void TestMilestones()
+{
+    Config config = Settings::Defaults();
+    CHECK_EQ(Settings::Parse("milestones=50, 3,3 ,1000\n", config), size_t(0));
+    CHECK_EQ(config.MilestoneCount, size_t(3));
+    CHECK(config.Milestones[0] == 3 && config.Milestones[1] == 50 && config.Milestones[2] == 1000);
+
+    // They become the built-in streak alert rule
+    AlertRuleState state;
+    CHECK_EQ(config.Rules.OnKill(state, 3, 3, 3), 1u);
+    CHECK_EQ(config.Rules.OnKill(state, 5, 5, 5), 0u);
+
+    CHECK_EQ(Settings::Parse("milestones=\n", config), size_t(0));
+    CHECK_EQ(config.MilestoneCount, size_t(0));
+    CHECK_EQ(config.Rules.OnKill(state, 3, 5, 8), 0u);
+}
+
+static void TestChangedKeysAndRestart()
+{
+    Config before = Settings::Defaults();
+    Config after = before;
+    Settings::Parse("squad_file=x.txt\nlog_level=trace\nmilestones=7\ncounter=crits | result==CRIT\n", after);
+    CHECK(Settings::ChangedKeys(before, after) == "squad_file, milestones, counter, log_level");
+    CHECK_EQ(after.Counters.Count(), size_t(1));
+    CHECK(!Settings::NeedsRestart(before, after));
+
+    Settings::Parse("server_port=1\n", after);
+    CHECK(Settings::NeedsRestart(before, after));
+}
+
+static void TestPublishKeepsOldConfigsAlive()
+{
+    const Config* defaults = Settings::Current();
+    CHECK_EQ(defaults->FlushIntervalMs, 100u);
+
+    Config first = Settings::Defaults();
+    first.FlushIntervalMs = 200;
+    Settings::Publish(first);
+    const Config* held = Settings::Current();
+    CHECK(held != defaults);
+    CHECK_EQ(held->FlushIntervalMs, 200u);
+
+    // A reader holding the old pointer still sees a complete, unchanged config
+    Config second = Settings::Defaults();
+    second.FlushIntervalMs = 300;
+    Settings::Publish(second);
+    CHECK_EQ(Settings::Current()->FlushIntervalMs, 300u);
+    CHECK_EQ(held->FlushIntervalMs, 200u);
+
+    Settings::Reset();
+    CHECK(Settings::Current() == defaults);
+}
+
+static void WriteText(const std::string& path, const char* text)
+{
+    FILE* f = fopen(path.c_str(), "wb");
+    if (f)
+    {
+        fputs(text, f);
+        fclose(f);
+    }
+}
+
+/// Polls for up to a second, as the writer thread would
+static bool WaitForChange(FileWatcher& watcher)
+{
+    for (int i = 0; i < 100; i++)
+    {
+        if (watcher.Poll())
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+static void TestFileWatcher()
+{
+    const char* tmp = getenv("TMPDIR");
+    std::string directory = std::string(tmp && tmp[0] ? tmp : "/tmp") + "/streamlink_settings_" +
+                            std::to_string(static_cast<int>(getpid()));
+    mkdir(directory.c_str(), 0755);
+    std::string path = directory + "/settings.txt";
+    std::string other = directory + "/killstreak.txt";
+    std::string temp = directory + "/settings.txt.tmp";
+
+    FileWatcher watcher;
+    CHECK(!watcher.Watch(directory + "/missing/settings.txt"));
+    CHECK(watcher.Watch(path));
+    CHECK(!watcher.Poll());
+
+    // Writing the file, even before it existed, is seen
+    WriteText(path, "server=1\n");
+    CHECK(WaitForChange(watcher));
+    CHECK(!watcher.Poll());
+
+    // Outputs written next to it are not
+    WriteText(other, "3");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(!watcher.Poll());
+
+    // Nor is the temp file on its own, but renaming it over the settings is
+    WriteText(temp, "server=0\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(!watcher.Poll());
+    rename(temp.c_str(), path.c_str());
+    CHECK(WaitForChange(watcher));
+
+    watcher.Close();
+    CHECK(!watcher.IsOpen());
+    CHECK(!watcher.Poll());
+
+    remove(path.c_str());
+    remove(other.c_str());
+    rmdir(directory.c_str());
+}
+
+int main()
+{
+    RUN_TEST(TestDefaults);
+    RUN_TEST(TestParseKeys);
+    RUN_TEST(TestLegacyFirstLine);
+    RUN_TEST(TestLongLinesAreKeptWhole);
+    RUN_TEST(TestInvalidValuesKeepDefaults);
+    RUN_TEST(TestMilestones);
+    RUN_TEST(TestChangedKeysAndRestart);
+    RUN_TEST(TestPublishKeepsOldConfigsAlive);
+    RUN_TEST(TestFileWatcher);
+    return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,138 @@
+///----------------------------------------------------------------------------------------------------
+/// Shared state publication tests - publisher and reader over POSIX shared memory
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "shared_memory.h"
+#include "state_publisher.h"
+#include "streamlink_shared_state.h"
+#include "test_common.h"
+
+static void MakeRegionName(char* buffer, size_t size, const char* suffix)
+{
+    snprintf(buffer, size, "StreamlinkTest_%d_%s", static_cast<int>(getpid()), suffix);
+}
+
+static void TestReaderSeesPublishedState()
+{
+    char name[64];
+    MakeRegionName(name, sizeof(name), "basic");
+
+    StatePublisher publisher;
+    CHECK(publisher.Open(name));
+
+    SharedMemory reader;
+    CHECK(reader.OpenReadOnly(name, sizeof(StreamlinkSharedState)));
+    const StreamlinkSharedState* state = static_cast<const StreamlinkSharedState*>(reader.Data());
+
+    StreamlinkStateSnapshot snapshot;
+    CHECK(ReadStreamlinkSharedState(state, snapshot));
+    CHECK_EQ(snapshot.KillCount, 0u);
+    CHECK_EQ(state->Version.load(), STREAMLINK_SHARED_STATE_VERSION);
+    CHECK_EQ(state->Size.load(), static_cast<uint32_t>(sizeof(StreamlinkSharedState)));
+
+    publisher.Publish([](StreamlinkSharedState& s)
+    {
+        s.KillCount.store(7, std::memory_order_relaxed);
+        s.InSquad.store(1, std::memory_order_relaxed);
+        s.PlayerStatus.store(StreamlinkPlayerStatus_Downed, std::memory_order_relaxed);
+    });
+
+    CHECK(ReadStreamlinkSharedState(state, snapshot));
+    CHECK_EQ(snapshot.KillCount, 7u);
+    CHECK_EQ(snapshot.InSquad, 1u);
+    CHECK_EQ(snapshot.PlayerStatus, static_cast<uint32_t>(StreamlinkPlayerStatus_Downed));
+    CHECK_EQ(snapshot.Sequence, 2u);
+
+    // Closing the publisher invalidates the region for readers that still have it mapped
+    publisher.Close();
+    CHECK(!ReadStreamlinkSharedState(state, snapshot));
+}
+
+static void TestOpenMissingRegionFails()
+{
+    char name[64];
+    MakeRegionName(name, sizeof(name), "missing");
+
+    SharedMemory reader;
+    CHECK(!reader.OpenReadOnly(name, sizeof(StreamlinkSharedState)));
+    CHECK(!reader.IsOpen());
+}
+
+static void TestSnapshotsAreNeverTorn()
+{
+    char name[64];
+    MakeRegionName(name, sizeof(name), "stress");
+
+    StatePublisher publisher;
+    CHECK(publisher.Open(name));
+
+    SharedMemory reader;
+    CHECK(reader.OpenReadOnly(name, sizeof(StreamlinkSharedState)));
+    const StreamlinkSharedState* state = static_cast<const StreamlinkSharedState*>(reader.Data());
+
+    // Every write keeps KillCount, InSquad and PlayerStatus derived from one counter, so any
+    // mixed snapshot breaks the relation
+    constexpr int WritersCount = 3;
+    constexpr uint32_t WritesPerWriter = 200000;
+    std::atomic<uint32_t> counter{0};
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::atomic<int> reads{0};
+
+    std::thread readerThread([&]
+    {
+        while (!done.load())
+        {
+            StreamlinkStateSnapshot snapshot;
+            if (!ReadStreamlinkSharedState(state, snapshot))
+                continue;
+            reads++;
+            if (snapshot.InSquad != (snapshot.KillCount & 1) || snapshot.PlayerStatus != snapshot.KillCount % 3)
+                torn++;
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int w = 0; w < WritersCount; w++)
+    {
+        writers.emplace_back([&]
+        {
+            for (uint32_t i = 0; i < WritesPerWriter; i++)
+            {
+                publisher.Publish([&](StreamlinkSharedState& s)
+                {
+                    uint32_t value = counter.fetch_add(1) + 1;
+                    s.KillCount.store(value, std::memory_order_relaxed);
+                    s.InSquad.store(value & 1, std::memory_order_relaxed);
+                    s.PlayerStatus.store(value % 3, std::memory_order_relaxed);
+                });
+            }
+        });
+    }
+    for (auto& t : writers)
+        t.join();
+    done.store(true);
+    readerThread.join();
+
+    CHECK_EQ(torn.load(), 0);
+    CHECK(reads.load() > 0);
+
+    StreamlinkStateSnapshot final;
+    CHECK(ReadStreamlinkSharedState(state, final));
+    CHECK_EQ(final.KillCount, WritersCount * WritesPerWriter);
+    CHECK_EQ(final.Sequence, 2 * WritersCount * WritesPerWriter);
+}
+
+int main()
+{
+    RUN_TEST(TestReaderSeesPublishedState);
+    RUN_TEST(TestOpenMissingRegionFails);
+    RUN_TEST(TestSnapshotsAreNeverTorn);
+    return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,187 @@
+///----------------------------------------------------------------------------------------------------
+/// Squad roster tests - membership, per-member state, deletion with probe runs, capacity, allocations
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "squad_roster.h"
+#include "synthetic_events.h"
+#include "test_common.h"
+
+using UnofficialExtras::UserRole;
+
+// Counts heap allocations so tests can check that roster updates never allocate
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        abort();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+static char g_names[SquadRoster::MaxMembers + 8][32];
+
+static const char* NameFor(size_t i)
+{
+    snprintf(g_names[i], sizeof(g_names[i]), "Player%zu.%04zu", i, (i * 7919) % 10000);
+    return g_names[i];
+}
+
+static void TestAddUpdateRemove()
+{
+    SquadRoster roster;
+    CHECK_EQ(roster.Size(), 0u);
+
+    SquadRosterChange change = roster.Apply(MakeUser("Commander.1234", UserRole::SquadLeader, 1, false));
+    CHECK(!change.WasMember);
+    CHECK(change.IsMember);
+    CHECK_EQ(roster.Size(), 1u);
+
+    // Same account again: updated in place, previous state reported
+    change = roster.Apply(MakeUser("Commander.1234", UserRole::SquadLeader, 2, true));
+    CHECK(change.WasMember);
+    CHECK(change.IsMember);
+    CHECK_EQ(change.Before.Subgroup, 1);
+    CHECK(!change.Before.ReadyStatus);
+    CHECK_EQ(change.After.Subgroup, 2);
+    CHECK_EQ(roster.Size(), 1u);
+
+    const SquadMemberState* state = roster.Find("Commander.1234");
+    CHECK(state != nullptr);
+    if (state)
+    {
+        CHECK(state->Role == UserRole::SquadLeader);
+        CHECK_EQ(state->Subgroup, 2);
+        CHECK(state->ReadyStatus);
+        CHECK(state->GroupType == UnofficialExtras::ChannelType::Squad);
+    }
+
+    // Names are compared exactly
+    CHECK(roster.Find("commander.1234") == nullptr);
+
+    change = roster.Apply(MakeUser("Commander.1234", UserRole::None));
+    CHECK(change.WasMember);
+    CHECK(!change.IsMember);
+    CHECK(change.Before.Role == UserRole::SquadLeader);
+    CHECK_EQ(roster.Size(), 0u);
+    CHECK(roster.Find("Commander.1234") == nullptr);
+
+    // Removing someone who is not there, or a user without a name, changes nothing
+    change = roster.Apply(MakeUser("Nobody.0001", UserRole::Invalid));
+    CHECK(!change.WasMember);
+    CHECK(!change.IsMember);
+    UnofficialExtras::UserInfo unnamed = MakeUser(nullptr, UserRole::Member);
+    change = roster.Apply(unnamed);
+    CHECK(!change.IsMember);
+    CHECK_EQ(roster.Size(), 0u);
+}
+
+static void TestRemovalKeepsOtherMembersReachable()
+{
+    SquadRoster roster;
+    const size_t count = SquadRoster::MaxMembers;
+    for (size_t i = 0; i < count; i++)
+        roster.Apply(MakeUser(NameFor(i), UserRole::Member, static_cast<uint8_t>(i % 15)));
+    CHECK_EQ(roster.Size(), count);
+
+    // Remove every third member; the rest must still be found through shifted probe runs
+    for (size_t i = 0; i < count; i += 3)
+        roster.Apply(MakeUser(g_names[i], UserRole::None));
+
+    size_t found = 0;
+    bool allCorrect = true;
+    for (size_t i = 0; i < count; i++)
+    {
+        const SquadMemberState* state = roster.Find(g_names[i]);
+        bool expected = (i % 3) != 0;
+        if ((state != nullptr) != expected)
+            allCorrect = false;
+        if (state)
+        {
+            found++;
+            if (state->Subgroup != i % 15)
+                allCorrect = false;
+        }
+    }
+    CHECK(allCorrect);
+    CHECK_EQ(found, roster.Size());
+
+    roster.Clear();
+    CHECK_EQ(roster.Size(), 0u);
+    CHECK(roster.Find(g_names[1]) == nullptr);
+}
+
+static void TestFullRosterIgnoresNewMembers()
+{
+    SquadRoster roster;
+    for (size_t i = 0; i < SquadRoster::MaxMembers; i++)
+        roster.Apply(MakeUser(NameFor(i), UserRole::Member));
+
+    SquadRosterChange change = roster.Apply(MakeUser(NameFor(SquadRoster::MaxMembers), UserRole::Member));
+    CHECK(!change.IsMember);
+    CHECK_EQ(roster.Size(), SquadRoster::MaxMembers);
+
+    // Existing members can still be updated, and a leave makes room again
+    change = roster.Apply(MakeUser(g_names[0], UserRole::Lieutenant));
+    CHECK(change.IsMember);
+    roster.Apply(MakeUser(g_names[1], UserRole::None));
+    change = roster.Apply(MakeUser(g_names[SquadRoster::MaxMembers], UserRole::Member));
+    CHECK(change.IsMember);
+}
+
+static void TestLongNamesAreTruncated()
+{
+    char longName[128];
+    memset(longName, 'a', sizeof(longName) - 1);
+    longName[sizeof(longName) - 1] = '\0';
+
+    SquadRoster roster;
+    CHECK(roster.Apply(MakeUser(longName, UserRole::Member)).IsMember);
+    CHECK(roster.Find(longName) != nullptr);
+    CHECK(roster.Apply(MakeUser(longName, UserRole::None)).WasMember);
+    CHECK_EQ(roster.Size(), 0u);
+}
+
+static void TestUpdatesDoNotAllocate()
+{
+    static SquadRoster roster;
+    for (size_t i = 0; i < 50; i++)
+        NameFor(i);
+
+    size_t before = g_allocations.load();
+    for (int round = 0; round < 10; round++)
+    {
+        for (size_t i = 0; i < 50; i++)
+            roster.Apply(MakeUser(g_names[i], UserRole::Member, static_cast<uint8_t>(round)));
+        for (size_t i = 0; i < 50; i++)
+            roster.Apply(MakeUser(g_names[i], UserRole::None));
+    }
+    CHECK_EQ(g_allocations.load(), before);
+}
+
+int main()
+{
+    RUN_TEST(TestAddUpdateRemove);
+    RUN_TEST(TestRemovalKeepsOtherMembersReachable);
+    RUN_TEST(TestFullRosterIgnoresNewMembers);
+    RUN_TEST(TestLongNamesAreTruncated);
+    RUN_TEST(TestUpdatesDoNotAllocate);
+    return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,186 @@
+///----------------------------------------------------------------------------------------------------
+/// State block tests - seqlock snapshots under concurrent writers and readers, and the trackers
+/// publishing through the block
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "seqlock.h"
+#include "state_block.h"
+#include "synthetic_events.h"
+#include "test_common.h"
+
+namespace
+{
+    struct Wide
+    {
+        uint64_t Words[12];
+    };
+
+    /// Every field of the state set to the same value, so a torn read shows up as a mismatch
+    void Stamp(TrackedState& state, uint32_t value)
+    {
+        for (uint32_t& stat : state.Session.Values)
+            stat = value;
+        state.SelfId = value;
+        state.Status = static_cast<PlayerStatus>(value % 3);
+        state.Vitals.Alive = value;
+        state.Vitals.Downed = value;
+        state.Vitals.Dead = value;
+        state.InSquad = (value & 1) != 0;
+        state.Squad.Size = value;
+        for (uint32_t g = 0; g < SquadComposition::MaxSubgroups; g++)
+            state.Squad.Subgroups[g] = value;
+        state.Squad.Commanders = value;
+        state.Squad.Lieutenants = value;
+        state.Squad.Ready = value;
+        state.Squad.InParty = value;
+        state.Squad.InSquad = value;
+    }
+
+    bool IsConsistent(const TrackedState& state)
+    {
+        uint32_t value = state.Session.Values[0];
+        bool ok = state.SelfId == value && state.Status == static_cast<PlayerStatus>(value % 3) &&
+                  state.InSquad == ((value & 1) != 0) && state.Vitals.Alive == value &&
+                  state.Vitals.Downed == value && state.Vitals.Dead == value && state.Squad.Size == value &&
+                  state.Squad.Commanders == value && state.Squad.Lieutenants == value &&
+                  state.Squad.Ready == value && state.Squad.InParty == value && state.Squad.InSquad == value;
+        for (uint32_t g = 0; g < SquadComposition::MaxSubgroups; g++)
+            ok = ok && state.Squad.Subgroups[g] == value;
+        for (uint32_t stat : state.Session.Values)
+            ok = ok && stat == value;
+        return ok;
+    }
+}
+
+static void TestSeqlockStoreLoad()
+{
+    Seqlock<Wide> lock;
+    Wide initial = lock.Load();
+    CHECK_EQ(initial.Words[0], uint64_t(0));
+    CHECK_EQ(initial.Words[11], uint64_t(0));
+
+    uint64_t seq = lock.Sequence();
+    Wide value = {};
+    for (uint64_t i = 0; i < 12; i++)
+        value.Words[i] = i * 7;
+    lock.Store(value);
+    CHECK_EQ(lock.Sequence(), seq + 2);
+
+    lock.Update([](Wide& v) { v.Words[11] += 1; });
+    Wide loaded = lock.Load();
+    CHECK_EQ(loaded.Words[3], uint64_t(21));
+    CHECK_EQ(loaded.Words[11], uint64_t(78));
+    CHECK_EQ(lock.Sequence() & 1, uint64_t(0));
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Writers increment a counter stamped into every field while readers check each snapshot is whole.
+/// Also reports throughput, so a contention regression is visible in the test log.
+///----------------------------------------------------------------------------------------------------
+static void TestConcurrentWritersAndReaders()
+{
+    constexpr uint32_t Writers = 3;
+    constexpr uint32_t Readers = 3;
+    constexpr uint32_t UpdatesPerWriter = 20000;
+
+    StateBlock::Reset();
+
+    std::atomic<uint32_t> writersDone{0};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> backwards{0};
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < Readers; r++)
+    {
+        threads.emplace_back([&]
+        {
+            uint64_t localReads = 0;
+            uint32_t last = 0;
+            do
+            {
+                TrackedState state = StateBlock::Read();
+                if (!IsConsistent(state))
+                    torn.fetch_add(1, std::memory_order_relaxed);
+                if (state.Session.Values[0] < last)
+                    backwards.fetch_add(1, std::memory_order_relaxed);
+                last = state.Session.Values[0];
+                localReads++;
+            } while (writersDone.load(std::memory_order_acquire) < Writers);
+            reads.fetch_add(localReads, std::memory_order_relaxed);
+        });
+    }
+    for (uint32_t w = 0; w < Writers; w++)
+    {
+        threads.emplace_back([&]
+        {
+            for (uint32_t i = 0; i < UpdatesPerWriter; i++)
+                StateBlock::Update([](TrackedState& state) { Stamp(state, state.Session.Values[0] + 1); });
+            writersDone.fetch_add(1, std::memory_order_release);
+        });
+    }
+    for (std::thread& t : threads)
+        t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    TrackedState final = StateBlock::Read();
+    CHECK(IsConsistent(final));
+    CHECK_EQ(final.Session.Values[0], Writers * UpdatesPerWriter);   // no update lost between writers
+    CHECK_EQ(torn.load(), uint64_t(0));
+    CHECK_EQ(backwards.load(), uint64_t(0));
+    CHECK(reads.load() >= Readers);
+
+    printf("  %u writers x %u updates, %u readers: %.0f updates/s, %.0f reads/s\n", Writers, UpdatesPerWriter,
+           Readers, Writers * UpdatesPerWriter / seconds, static_cast<double>(reads.load()) / seconds);
+    StateBlock::Reset();
+}
+
+static void TestTrackersPublishThroughBlock()
+{
+    StateBlock::Reset();
+    CombatTracker::Reset();
+    SquadTracker::Reset();
+
+    SyntheticCombatEvent added = MakeAgentAdded(SyntheticAgent{0x77, ProfessionGuardian, 1, true, nullptr});
+    CombatTracker::OnAgentNotification(MakeCombatRecord(added.data, CombatSource_Local));
+    CHECK_EQ(StateBlock::Read().SelfId, uint64_t(0x77));
+
+    uint64_t seq = StateBlock::Sequence();
+    UnofficialExtras::UserInfo users[2] = {
+        MakeUser("Lead.1234", UnofficialExtras::UserRole::SquadLeader, 1),
+        MakeUser("Member.5678", UnofficialExtras::UserRole::Member, 2, true),
+    };
+    EvSquadUpdate update = {users, 2};
+    CHECK(SquadTracker::Apply(update) & SquadChange_InSquad);
+    CHECK(StateBlock::Sequence() != seq);
+
+    TrackedState state = StateBlock::Read();
+    CHECK(state.InSquad);
+    CHECK_EQ(state.Squad.Size, uint32_t(2));
+    CHECK_EQ(state.Squad.Commanders, uint32_t(1));
+    CHECK_EQ(state.Squad.Ready, uint32_t(1));
+    CHECK_EQ(state.SelfId, uint64_t(0x77));   // squad updates leave combat fields alone
+
+    SquadTracker::Reset();
+    CombatTracker::Reset();
+    state = StateBlock::Read();
+    CHECK(!state.InSquad);
+    CHECK_EQ(state.Squad.Size, uint32_t(0));
+    CHECK_EQ(state.SelfId, uint64_t(0));
+}
+
+int main()
+{
+    RUN_TEST(TestSeqlockStoreLoad);
+    RUN_TEST(TestConcurrentWritersAndReaders);
+    RUN_TEST(TestTrackersPublishThroughBlock);
+    return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,97 @@
+///----------------------------------------------------------------------------------------------------
+/// Throttled gauge tests - first value, threshold, interval, full and empty, bounded write rate
+///----------------------------------------------------------------------------------------------------
+
+#include <cstdint>
+
+#include "test_common.h"
+#include "throttled_gauge.h"
+
+static void TestFirstValuePublishesAtOnce()
+{
+    ThrottledGauge gauge;
+    CHECK_EQ(gauge.Published(), ThrottledGauge::Unknown);
+    CHECK(!gauge.Poll(0, 250, 100));
+
+    gauge.Set(7321);
+    CHECK_EQ(gauge.Latest(), 7321u);
+    CHECK(gauge.Poll(1000, 250, 100));
+    CHECK_EQ(gauge.Published(), 7321u);
+    CHECK(!gauge.Poll(2000, 250, 100));   // nothing new
+
+    gauge.Set(20000);
+    CHECK_EQ(gauge.Latest(), ThrottledGauge::Full);
+}
+
+static void TestThresholdAndInterval()
+{
+    ThrottledGauge gauge;
+    gauge.Set(5000);
+    CHECK(gauge.Poll(1000, 250, 100));
+
+    // Under the threshold: held back however long it waits
+    gauge.Set(5099);
+    CHECK(!gauge.Poll(1300, 250, 100));
+    CHECK(!gauge.Poll(9000, 250, 100));
+    CHECK_EQ(gauge.Published(), 5000u);
+
+    // Past it in either direction, but only once the interval has passed
+    gauge.Set(5100);
+    CHECK(gauge.Poll(9000, 250, 100));
+    gauge.Set(4000);
+    CHECK(!gauge.Poll(9249, 250, 100));
+    CHECK(gauge.Poll(9250, 250, 100));
+    CHECK_EQ(gauge.Published(), 4000u);
+
+    // Threshold 0 and interval 0: every change is written
+    gauge.Set(4001);
+    CHECK(gauge.Poll(9250, 0, 0));
+    CHECK_EQ(gauge.Published(), 4001u);
+}
+
+static void TestFullAndEmptyIgnoreThreshold()
+{
+    ThrottledGauge gauge;
+    gauge.Set(9950);
+    CHECK(gauge.Poll(0, 250, 100));
+
+    gauge.Set(ThrottledGauge::Full);
+    CHECK(!gauge.Poll(100, 250, 100));   // still waits for the interval
+    CHECK(gauge.Poll(250, 250, 100));
+    CHECK_EQ(gauge.Published(), ThrottledGauge::Full);
+
+    gauge.Set(50);
+    CHECK(gauge.Poll(500, 250, 100));
+    gauge.Set(0);
+    CHECK(gauge.Poll(750, 250, 100));
+    CHECK_EQ(gauge.Published(), 0u);
+
+    gauge.Reset();
+    CHECK_EQ(gauge.Latest(), ThrottledGauge::Unknown);
+    CHECK_EQ(gauge.Published(), ThrottledGauge::Unknown);
+    gauge.Set(0);
+    CHECK(gauge.Poll(0, 250, 100));
+}
+
+static void TestWriteRateIsBounded()
+{
+    // A value swinging every millisecond for ten seconds, polled every millisecond
+    ThrottledGauge gauge;
+    uint32_t publishes = 0;
+    for (uint64_t now = 0; now < 10000; now++)
+    {
+        gauge.Set(static_cast<uint32_t>((now * 337) % ThrottledGauge::Full));
+        publishes += gauge.Poll(now, 250, 100);
+    }
+    CHECK(publishes <= 10000 / 250 + 1);
+    CHECK(publishes >= 10000 / 250 - 1);
+}
+
+int main()
+{
+    RUN_TEST(TestFirstValuePublishesAtOnce);
+    RUN_TEST(TestThresholdAndInterval);
+    RUN_TEST(TestFullAndEmptyIgnoreThreshold);
+    RUN_TEST(TestWriteRateIsBounded);
+    return TEST_MAIN_RESULT();
+}
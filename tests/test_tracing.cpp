@@ -0,0 +1,172 @@
+///----------------------------------------------------------------------------------------------------
+/// Tracing tests - level gating, deferred formatting, ring overflow and the MPSC ring itself
+///----------------------------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "mpsc_ring.h"
+#include "test_common.h"
+#include "tracing.h"
+
+static std::string MakeTracePath(const char* suffix)
+{
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/streamlink_trace_%d_%s.log", static_cast<int>(getpid()), suffix);
+    unlink(path);
+    return path;
+}
+
+static std::string ReadAll(const std::string& path)
+{
+    std::string content;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return content;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        content.append(buffer, n);
+    fclose(file);
+    return content;
+}
+
+static int g_evaluations = 0;
+
+static int CountedArg()
+{
+    return ++g_evaluations;
+}
+
+static void TestDisabledLevelSkipsArguments()
+{
+    std::string path = MakeTracePath("gating");
+    Tracing::SetSink(path);
+    Tracing::SetLevel(ELogLevel_INFO);
+
+    g_evaluations = 0;
+    STREAMLINK_TRACE(ELogLevel_DEBUG, "debug %d", CountedArg());
+    CHECK_EQ(g_evaluations, 0);
+    STREAMLINK_TRACE(ELogLevel_INFO, "info %d", CountedArg());
+    CHECK_EQ(g_evaluations, 1);
+
+    Tracing::SetLevel(Tracing::LevelOff);
+    STREAMLINK_TRACE(ELogLevel_CRITICAL, "critical %d", CountedArg());
+    CHECK_EQ(g_evaluations, 1);
+
+    Tracing::Shutdown();
+    std::string content = ReadAll(path);
+    CHECK(content.find("info 1") != std::string::npos);
+    CHECK(content.find("debug") == std::string::npos);
+    CHECK(content.find("critical") == std::string::npos);
+    unlink(path.c_str());
+}
+
+static void TestDeferredFormatting()
+{
+    std::string path = MakeTracePath("format");
+    Tracing::SetSink(path);
+    Tracing::SetLevel(ELogLevel_TRACE);
+
+    uint8_t small = 200;
+    int16_t negative = -42;
+    uint64_t wide = 0xFFFFFFFFFFull;
+    STREAMLINK_TRACE(ELogLevel_TRACE, "u=%u d=%d x=%llx s=%s f=%.2f pct=100%%",
+                     (unsigned)small, (int)negative, (unsigned long long)wide, "static", 1.5);
+    STREAMLINK_TRACE(ELogLevel_WARNING, "padded [%5u] [%-3d]", 7u, 1);
+    Tracing::Shutdown();
+
+    std::string content = ReadAll(path);
+    CHECK(content.find("u=200 d=-42 x=ffffffffff s=static f=1.50 pct=100%") != std::string::npos);
+    CHECK(content.find("padded [    7] [1  ]") != std::string::npos);
+    CHECK(content.find("WARN") != std::string::npos);
+    unlink(path.c_str());
+    Tracing::SetLevel(ELogLevel_INFO);
+}
+
+static void TestOverflowIsCountedAndReported()
+{
+    std::string path = MakeTracePath("overflow");
+    Tracing::SetSink(path);
+    Tracing::SetLevel(ELogLevel_INFO);
+
+    uint64_t before = Tracing::Dropped();
+    for (unsigned i = 0; i < 5000; i++)
+        STREAMLINK_TRACE(ELogLevel_INFO, "record %u", i);
+    CHECK(Tracing::Dropped() > before);
+
+    Tracing::Shutdown();
+    std::string content = ReadAll(path);
+    CHECK(content.find("record 0\n") != std::string::npos);
+    CHECK(content.find("records dropped") != std::string::npos);
+    unlink(path.c_str());
+}
+
+static void TestRingMultipleProducers()
+{
+    static MpscRing<uint64_t, 1024> ring;
+    constexpr int Producers = 4;
+    constexpr uint64_t PerProducer = 50000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Producers; t++)
+    {
+        threads.emplace_back([t]()
+        {
+            for (uint64_t i = 1; i <= PerProducer; i++)
+            {
+                uint64_t value = (static_cast<uint64_t>(t) << 32) | i;
+                while (!ring.TryPush(value))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // Values from each producer must arrive complete and in that producer's order
+    uint64_t lastSeen[Producers] = {};
+    uint64_t received = 0;
+    bool ordered = true;
+    uint64_t batch[64];
+    while (received < Producers * PerProducer)
+    {
+        size_t count = ring.PopBatch(batch, 64);
+        if (count == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t producer = static_cast<size_t>(batch[i] >> 32);
+            uint64_t seq = batch[i] & 0xFFFFFFFFull;
+            if (producer >= Producers || seq != lastSeen[producer] + 1)
+                ordered = false;
+            else
+                lastSeen[producer] = seq;
+        }
+        received += count;
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    CHECK(ordered);
+    CHECK_EQ(received, Producers * PerProducer);
+    uint64_t leftover;
+    CHECK(!ring.TryPop(leftover));
+}
+
+int main()
+{
+    RUN_TEST(TestDisabledLevelSkipsArguments);
+    RUN_TEST(TestDeferredFormatting);
+    RUN_TEST(TestOverflowIsCountedAndReported);
+    RUN_TEST(TestRingMultipleProducers);
+    return TEST_MAIN_RESULT();
+}
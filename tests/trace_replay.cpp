@@ -0,0 +1,418 @@
+///----------------------------------------------------------------------------------------------------
+/// Trace Replay - Combat traces for replaying through the real handlers
+///----------------------------------------------------------------------------------------------------
+
+#include "trace_replay.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "event_queue.h"
+#include "stub_addon_api.h"
+
+const char* TraceKindName(TraceKind kind)
+{
+    switch (kind)
+    {
+        case TraceKind::Local:       return "local";
+        case TraceKind::Squad:       return "squad";
+        case TraceKind::AgentAdded:  return "agent";
+        case TraceKind::SquadUpdate: return "squad_update";
+        case TraceKind::MapChange:   return "map";
+        default:                     return "?";
+    }
+}
+
+size_t Trace::CountOf(TraceKind kind) const
+{
+    size_t count = 0;
+    for (const TraceEvent& e : events)
+    {
+        if (e.kind == kind)
+            count++;
+    }
+    return count;
+}
+
+///----------------------------------------------------------------------------------------------------
+/// Rng - Small deterministic xorshift generator so traces are reproducible from a seed
+///----------------------------------------------------------------------------------------------------
+namespace
+{
+    struct Rng
+    {
+        uint64_t state;
+
+        explicit Rng(uint64_t seed) : state(seed ? seed : 0x9E3779B97F4A7C15ull) {}
+
+        uint32_t Next()
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return static_cast<uint32_t>(state >> 16);
+        }
+
+        uint32_t Below(uint32_t n) { return n ? Next() % n : 0; }
+    };
+}
+
+static TraceEvent MakeCombat(TraceKind kind, uint64_t time, const SyntheticAgent& src, const SyntheticAgent& dst,
+                             uint8_t result, uint8_t statechange, uint32_t skill, int32_t value)
+{
+    TraceEvent e = {};
+    e.kind = kind;
+    e.time = time;
+    e.src = src;
+    e.dst = dst;
+    e.result = result;
+    e.statechange = statechange;
+    e.skill = skill;
+    e.value = value;
+    e.iff = src.team != dst.team ? ArcDPS::IFF_FOE : ArcDPS::IFF_FRIEND;
+    return e;
+}
+
+static void AppendSquadUpdate(Trace& out, const std::vector<SyntheticAgent>& allies, bool join)
+{
+    TraceEvent e = {};
+    e.kind = TraceKind::SquadUpdate;
+    e.userBegin = static_cast<uint32_t>(out.users.size());
+    e.userCount = static_cast<uint32_t>(allies.size());
+
+    for (size_t i = 0; i < allies.size(); i++)
+    {
+        UnofficialExtras::UserRole role = UnofficialExtras::UserRole::None;
+        if (join)
+            role = i == 0 ? UnofficialExtras::UserRole::SquadLeader
+                 : i < 3  ? UnofficialExtras::UserRole::Lieutenant
+                          : UnofficialExtras::UserRole::Member;
+        out.users.push_back(MakeUser(out.accountNames[i].c_str(), role, static_cast<uint8_t>(1 + i / 5),
+                                     join && (i % 3 == 0)));
+    }
+    out.events.push_back(e);
+}
+
+void GenerateFight(const FightParams& params, Trace& out)
+{
+    out = Trace();
+    Rng rng(params.seed);
+
+    SyntheticAgent self{1000, ProfessionGuardian, 1, true, nullptr};
+    std::vector<SyntheticAgent> allies, enemies, npcs;
+    for (uint32_t i = 0; i < params.squadSize; i++)
+    {
+        allies.push_back(SyntheticAgent{2000 + i, 1 + i % 9, 1, false, nullptr});
+        char name[32];
+        snprintf(name, sizeof(name), "Ally%u.%04u", i, i * 7 % 10000);
+        out.accountNames.push_back(name);
+    }
+    for (uint32_t i = 0; i < params.enemies; i++)
+        enemies.push_back(SyntheticAgent{5000 + i, 1 + i % 9, static_cast<uint16_t>(2 + i % 2), false, nullptr});
+    for (uint32_t i = 0; i < params.npcs; i++)
+        npcs.push_back(SyntheticAgent{9000 + i, 5000 + i, 4, false, nullptr});
+
+    uint64_t time = 1000000;
+
+    TraceEvent map = {};
+    map.kind = TraceKind::MapChange;
+    map.mapType = MapTypeEternalBattlegrounds;
+    map.mapId = MapIdEternalBattlegrounds;
+    out.events.push_back(map);
+
+    TraceEvent added = {};
+    added.kind = TraceKind::AgentAdded;
+    added.src = self;
+    out.events.push_back(added);
+
+    if (!allies.empty())
+        AppendSquadUpdate(out, allies, true);
+
+    auto pick = [&](const std::vector<SyntheticAgent>& v) -> const SyntheticAgent&
+    {
+        return v.empty() ? self : v[rng.Below(static_cast<uint32_t>(v.size()))];
+    };
+
+    for (uint32_t i = 0; i < params.events; i++)
+    {
+        time += 1 + rng.Below(5);
+        uint32_t roll = rng.Below(1000);
+        uint32_t skill = 100 + rng.Below(400);
+
+        if (roll < 600)
+        {
+            // Our own hits on enemies
+            uint8_t result = rng.Below(3) == 0 ? ArcDPS::CBTR_CRIT : ArcDPS::CBTR_NORMAL;
+            out.events.push_back(MakeCombat(TraceKind::Local, time, self, pick(enemies), result, 0, skill,
+                                            static_cast<int32_t>(200 + rng.Below(3000))));
+        }
+        else if (roll < 750)
+        {
+            // Incoming and allied hits
+            const SyntheticAgent& src = rng.Below(2) ? pick(enemies) : pick(allies);
+            const SyntheticAgent& dst = src.team == 1 ? pick(enemies) : self;
+            out.events.push_back(MakeCombat(TraceKind::Local, time, src, dst, ArcDPS::CBTR_NORMAL, 0, skill,
+                                            static_cast<int32_t>(100 + rng.Below(2000))));
+        }
+        else if (roll < 800)
+        {
+            // Killing blows: ours on players, ours on NPCs, and allies' kills
+            uint32_t which = rng.Below(4);
+            const SyntheticAgent& src = which < 2 ? self : pick(allies);
+            const SyntheticAgent& dst = which == 1 ? pick(npcs) : pick(enemies);
+            out.events.push_back(MakeCombat(TraceKind::Local, time, src, dst, ArcDPS::CBTR_KILLINGBLOW, 0, skill, 0));
+        }
+        else if (roll < 850)
+        {
+            out.events.push_back(MakeCombat(TraceKind::Local, time, self, pick(enemies), ArcDPS::CBTR_DOWNED, 0,
+                                            skill, 0));
+        }
+        else if (roll < 851)
+        {
+            // We die now and then, resetting the streak
+            out.events.push_back(MakeCombat(TraceKind::Local, time, pick(enemies), self,
+                                            ArcDPS::CBTR_KILLINGBLOW, 0, skill, 0));
+            out.events.push_back(MakeCombat(TraceKind::Squad, time, self, SyntheticAgent{},
+                                            0, ArcDPS::CBTS_CHANGEDEAD, 0, 0));
+            out.events.push_back(MakeCombat(TraceKind::Squad, time + 1, self, SyntheticAgent{},
+                                            0, ArcDPS::CBTS_CHANGEUP, 0, 0));
+        }
+        else if (roll < 970)
+        {
+            // Squad members going down, dying and getting back up
+            static const uint8_t changes[] = {ArcDPS::CBTS_CHANGEDOWN, ArcDPS::CBTS_CHANGEDEAD, ArcDPS::CBTS_CHANGEUP};
+            const SyntheticAgent& who = rng.Below(20) == 0 ? self : pick(allies);
+            out.events.push_back(MakeCombat(TraceKind::Squad, time, who, SyntheticAgent{}, 0,
+                                            changes[rng.Below(3)], 0, 0));
+        }
+        else if (roll < 985)
+        {
+            TraceEvent e = MakeCombat(TraceKind::Squad, time, self, SyntheticAgent{}, 0,
+                                      ArcDPS::CBTS_HEALTHPCTUPDATE, 0, 0);
+            e.dst.id = rng.Below(10001);
+            out.events.push_back(e);
+        }
+        else
+        {
+            // Squad feed also carries plain strikes for squad members
+            out.events.push_back(MakeCombat(TraceKind::Squad, time, pick(allies), pick(enemies),
+                                            ArcDPS::CBTR_NORMAL, 0, skill,
+                                            static_cast<int32_t>(100 + rng.Below(2000))));
+        }
+
+        if (params.squadStormEvery && !allies.empty() && (i + 1) % params.squadStormEvery == 0)
+        {
+            AppendSquadUpdate(out, allies, false);
+            AppendSquadUpdate(out, allies, true);
+        }
+    }
+}
+
+bool SaveTrace(const Trace& trace, const char* path)
+{
+    FILE* f = fopen(path, "w");
+    if (!f)
+        return false;
+
+    fprintf(f, "# streamlink trace v1\n");
+    for (const TraceEvent& e : trace.events)
+    {
+        switch (e.kind)
+        {
+            case TraceKind::Local:
+            case TraceKind::Squad:
+                fprintf(f, "%c %" PRIu64 " %" PRIuPTR " %u %d %u %" PRIuPTR " %u %d %u %u %u %u %d %u\n",
+                        e.kind == TraceKind::Local ? 'L' : 'S', e.time,
+                        e.src.id, e.src.profession, e.src.isSelf ? 1 : 0, e.src.team,
+                        e.dst.id, e.dst.profession, e.dst.isSelf ? 1 : 0, e.dst.team,
+                        e.result, e.statechange, e.skill, e.value, e.iff);
+                break;
+            case TraceKind::AgentAdded:
+                fprintf(f, "A %" PRIuPTR " %u %d %u\n", e.src.id, e.src.profession, e.src.isSelf ? 1 : 0, e.src.team);
+                break;
+            case TraceKind::SquadUpdate:
+                fprintf(f, "U %u\n", e.userCount);
+                for (uint32_t i = 0; i < e.userCount; i++)
+                {
+                    const UnofficialExtras::UserInfo& u = trace.users[e.userBegin + i];
+                    fprintf(f, "%s %u %u %u %u\n", u.AccountName, static_cast<unsigned>(u.Role), u.Subgroup,
+                            u.ReadyStatus ? 1 : 0, static_cast<unsigned>(u.GroupType));
+                }
+                break;
+            case TraceKind::MapChange:
+                fprintf(f, "M %u %u\n", e.mapType, e.mapId);
+                break;
+            default:
+                break;
+        }
+    }
+    return fclose(f) == 0;
+}
+
+bool LoadTrace(const char* path, Trace& out)
+{
+    out = Trace();
+    FILE* f = fopen(path, "r");
+    if (!f)
+        return false;
+
+    char line[512];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f))
+    {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+            continue;
+
+        TraceEvent e = {};
+        char tag = line[0];
+        if (tag == 'L' || tag == 'S')
+        {
+            uintptr_t srcId, dstId;
+            unsigned srcProf, srcTeam, dstProf, dstTeam, result, statechange, skill, iff;
+            int srcSelf, dstSelf, value;
+            if (sscanf(line + 1, "%" SCNu64 " %" SCNuPTR " %u %d %u %" SCNuPTR " %u %d %u %u %u %u %d %u",
+                       &e.time, &srcId, &srcProf, &srcSelf, &srcTeam, &dstId, &dstProf, &dstSelf, &dstTeam,
+                       &result, &statechange, &skill, &value, &iff) != 14)
+            {
+                ok = false;
+                break;
+            }
+            e.kind = tag == 'L' ? TraceKind::Local : TraceKind::Squad;
+            e.src = SyntheticAgent{srcId, srcProf, static_cast<uint16_t>(srcTeam), srcSelf != 0, nullptr};
+            e.dst = SyntheticAgent{dstId, dstProf, static_cast<uint16_t>(dstTeam), dstSelf != 0, nullptr};
+            e.result = static_cast<uint8_t>(result);
+            e.statechange = static_cast<uint8_t>(statechange);
+            e.skill = skill;
+            e.value = value;
+            e.iff = static_cast<uint8_t>(iff);
+        }
+        else if (tag == 'A')
+        {
+            uintptr_t id;
+            unsigned prof, team;
+            int self;
+            if (sscanf(line + 1, "%" SCNuPTR " %u %d %u", &id, &prof, &self, &team) != 4)
+            {
+                ok = false;
+                break;
+            }
+            e.kind = TraceKind::AgentAdded;
+            e.src = SyntheticAgent{id, prof, static_cast<uint16_t>(team), self != 0, nullptr};
+        }
+        else if (tag == 'U')
+        {
+            unsigned count;
+            if (sscanf(line + 1, "%u", &count) != 1)
+            {
+                ok = false;
+                break;
+            }
+            e.kind = TraceKind::SquadUpdate;
+            e.userBegin = static_cast<uint32_t>(out.users.size());
+            e.userCount = count;
+            for (unsigned i = 0; i < count && ok; i++)
+            {
+                char account[128];
+                unsigned role, subgroup, ready, groupType;
+                if (!fgets(line, sizeof(line), f) ||
+                    sscanf(line, "%127s %u %u %u %u", account, &role, &subgroup, &ready, &groupType) != 5)
+                {
+                    ok = false;
+                    break;
+                }
+                out.accountNames.push_back(account);
+                out.users.push_back(MakeUser(out.accountNames.back().c_str(),
+                                             static_cast<UnofficialExtras::UserRole>(role),
+                                             static_cast<uint8_t>(subgroup), ready != 0,
+                                             static_cast<UnofficialExtras::ChannelType>(groupType)));
+            }
+        }
+        else if (tag == 'M')
+        {
+            if (sscanf(line + 1, "%u %u", &e.mapType, &e.mapId) != 2)
+            {
+                ok = false;
+                break;
+            }
+            e.kind = TraceKind::MapChange;
+        }
+        else
+        {
+            ok = false;
+            break;
+        }
+        out.events.push_back(e);
+    }
+    fclose(f);
+    return ok;
+}
+
+bool TraceReplayer::Bind(FakeMumbleLink* mumble)
+{
+    m_mumble = mumble;
+    m_local = StubApi::Subscriber(EV_ARCDPS_COMBATEVENT_LOCAL_RAW);
+    m_squad = StubApi::Subscriber(EV_ARCDPS_COMBATEVENT_SQUAD_RAW);
+    m_squadUpdate = StubApi::Subscriber(EV_UNOFFICIAL_EXTRAS_SQUAD_UPDATE);
+    return m_local && m_squad && m_squadUpdate;
+}
+
+void TraceReplayer::Prepare(const Trace& trace, const TraceEvent& event)
+{
+    m_kind = event.kind;
+    switch (event.kind)
+    {
+        case TraceKind::Local:
+        case TraceKind::Squad:
+            m_combat = SyntheticCombatEvent();
+            m_combat.SetAgents(event.src, event.dst);
+            m_combat.ev.Time = event.time;
+            m_combat.ev.Result = event.result;
+            m_combat.ev.IsStatechange = event.statechange;
+            m_combat.ev.SkillID = event.skill;
+            m_combat.ev.Value = event.value;
+            m_combat.ev.IFF = event.iff;
+            if (event.statechange)
+                m_combat.ev.DestinationAgent = event.dst.id;
+            m_combat.data.ev = &m_combat.ev;
+            break;
+        case TraceKind::AgentAdded:
+            m_combat = MakeAgentAdded(event.src);
+            break;
+        case TraceKind::SquadUpdate:
+            m_update.UpdatedUsers = const_cast<UnofficialExtras::UserInfo*>(trace.users.data() + event.userBegin);
+            m_update.UpdatedUsersCount = event.userCount;
+            break;
+        case TraceKind::MapChange:
+            m_mapType = event.mapType;
+            m_mapId = event.mapId;
+            break;
+        default:
+            break;
+    }
+}
+
+void TraceReplayer::Dispatch()
+{
+    switch (m_kind)
+    {
+        case TraceKind::Local:
+        case TraceKind::AgentAdded:
+            m_local(&m_combat.data);
+            break;
+        case TraceKind::Squad:
+            m_squad(&m_combat.data);
+            break;
+        case TraceKind::SquadUpdate:
+            m_squadUpdate(&m_update);
+            break;
+        case TraceKind::MapChange:
+            // Records queued before the map change must still be judged against the old map
+            EventQueue::WaitProcessed();
+            if (m_mumble)
+                m_mumble->SetMap(m_mapType, m_mapId);
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,118 @@
+///----------------------------------------------------------------------------------------------------
+/// Trace Replay - Combat traces for replaying through the real handlers
+///
+/// A Trace is a compact, in-memory list of LOCAL_RAW / SQUAD_RAW combat events, Unofficial Extras
+/// squad update batches and map changes. Traces can be generated (a synthetic WvW fight), saved and
+/// loaded as text, and replayed event by event through the subscribed handlers.
+///
+/// Text format, one record per line ('#' starts a comment):
+///   L|S time src_id src_prof src_self src_team dst_id dst_prof dst_self dst_team result statechange skill value iff
+///       combat event on LOCAL_RAW (L) or SQUAD_RAW (S)
+///   A src_id src_prof src_self src_team
+///       null-ev agent notification on LOCAL_RAW
+///   U count
+///       squad update batch; followed by count lines "account role subgroup ready grouptype"
+///   M map_type map_id
+///       MumbleLink map change
+///----------------------------------------------------------------------------------------------------
+
+#ifndef STREAMLINK_TRACE_REPLAY_H
+#define STREAMLINK_TRACE_REPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "Nexus.h"
+#include "UnofficialExtras.h"
+#include "synthetic_events.h"
+
+enum class TraceKind : uint8_t
+{
+    Local,        // EV_ARCDPS_COMBATEVENT_LOCAL_RAW with an event
+    Squad,        // EV_ARCDPS_COMBATEVENT_SQUAD_RAW with an event
+    AgentAdded,   // EV_ARCDPS_COMBATEVENT_LOCAL_RAW with a null event
+    SquadUpdate,  // EV_UNOFFICIAL_EXTRAS_SQUAD_UPDATE
+    MapChange,    // MumbleLink map switch
+    Count
+};
+
+const char* TraceKindName(TraceKind kind);
+
+/// One record; agents are stored by value, names are not kept
+struct TraceEvent
+{
+    TraceKind      kind;
+    uint8_t        result;
+    uint8_t        statechange;
+    uint8_t        iff;
+    uint32_t       skill;
+    int32_t        value;
+    uint64_t       time;
+    SyntheticAgent src;
+    SyntheticAgent dst;
+    uint32_t       userBegin;   // SquadUpdate: index into Trace::users
+    uint32_t       userCount;
+    uint32_t       mapType;     // MapChange
+    uint32_t       mapId;
+};
+
+struct Trace
+{
+    std::vector<TraceEvent>                 events;
+    std::vector<UnofficialExtras::UserInfo> users;
+    std::deque<std::string>                 accountNames;  // stable storage for users[].AccountName
+
+    size_t CountOf(TraceKind kind) const;
+};
+
+/// Parameters of the synthetic fight generator
+struct FightParams
+{
+    uint32_t events = 200000;     // combat events to emit (squad update batches come on top)
+    uint32_t squadSize = 50;      // allies in our squad
+    uint32_t enemies = 60;        // enemy players in range
+    uint32_t npcs = 20;           // guards, siege, etc.
+    uint32_t seed = 12345;
+    uint32_t squadStormEvery = 20000;   // a full leave/join storm of the squad every N events
+};
+
+/// Generates a WvW fight: mostly strikes, bursts of killing blows and downs, squad members going
+/// down/dead/up, and periodic squad update storms.
+void GenerateFight(const FightParams& params, Trace& out);
+
+bool SaveTrace(const Trace& trace, const char* path);
+bool LoadTrace(const char* path, Trace& out);
+
+///----------------------------------------------------------------------------------------------------
+/// TraceReplayer - Delivers trace events straight to the callbacks the addon subscribed
+///----------------------------------------------------------------------------------------------------
+class TraceReplayer
+{
+public:
+    /// Looks up the subscribed callbacks; call after Streamlink::Load.
+    bool Bind(FakeMumbleLink* mumble);
+
+    /// Builds the payload for one event (not part of the handler cost).
+    void Prepare(const Trace& trace, const TraceEvent& event);
+
+    /// Invokes the handler for the prepared event.
+    void Dispatch();
+
+    TraceKind PreparedKind() const { return m_kind; }
+
+private:
+    EVENT_CONSUME        m_local = nullptr;
+    EVENT_CONSUME        m_squad = nullptr;
+    EVENT_CONSUME        m_squadUpdate = nullptr;
+    FakeMumbleLink*      m_mumble = nullptr;
+    TraceKind            m_kind = TraceKind::Local;
+    SyntheticCombatEvent m_combat;
+    EvSquadUpdate        m_update = {};
+    uint32_t             m_mapType = 0;
+    uint32_t             m_mapId = 0;
+};
+
+#endif
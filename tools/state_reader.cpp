@@ -0,0 +1,59 @@
+///----------------------------------------------------------------------------------------------------
+/// State Reader - Sample consumer of the StreamlinkState shared memory region
+///
+/// Maps the region read-only and prints the state whenever its sequence number changes. Reading a
+/// snapshot costs no syscalls, so a real overlay would simply do this once per frame.
+///
+/// Usage: streamlink_state_reader [region name] [poll count]
+///----------------------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "shared_memory.h"
+#include "streamlink_shared_state.h"
+
+static const char* PlayerStatusName(uint32_t status)
+{
+    switch (status)
+    {
+        case StreamlinkPlayerStatus_Downed: return "downed";
+        case StreamlinkPlayerStatus_Dead:   return "dead";
+        default:                            return "alive";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* name = argc > 1 ? argv[1] : STREAMLINK_SHARED_STATE_NAME;
+    long polls = argc > 2 ? strtol(argv[2], nullptr, 10) : -1;
+
+    SharedMemory memory;
+    if (!memory.OpenReadOnly(name, sizeof(StreamlinkSharedState)))
+    {
+        fprintf(stderr, "Shared memory region '%s' not found. Is shared_memory=1 set?\n", name);
+        return 1;
+    }
+
+    const StreamlinkSharedState* state = static_cast<const StreamlinkSharedState*>(memory.Data());
+    if (state->Version.load() != STREAMLINK_SHARED_STATE_VERSION)
+        fprintf(stderr, "Warning: region version %u, reader built for %u\n", state->Version.load(),
+                STREAMLINK_SHARED_STATE_VERSION);
+
+    uint32_t lastSequence = UINT32_MAX;
+    for (long i = 0; polls < 0 || i < polls; i++)
+    {
+        StreamlinkStateSnapshot snapshot;
+        if (ReadStreamlinkSharedState(state, snapshot) && snapshot.Sequence != lastSequence)
+        {
+            lastSequence = snapshot.Sequence;
+            printf("seq=%u kills=%u squad=%u status=%s\n", snapshot.Sequence, snapshot.KillCount,
+                   snapshot.InSquad, PlayerStatusName(snapshot.PlayerStatus));
+            fflush(stdout);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+    }
+    return 0;
+}